@@ -0,0 +1,354 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "batch-resolver.hpp"
+#include "logger.hpp"
+#include "validator/validation-policy-ndns.hpp"
+
+#include <boost/asio/post.hpp>
+
+#include <algorithm>
+
+namespace ndn {
+namespace ndns {
+
+NDNS_LOG_INIT(BatchResolver);
+
+BatchResolver::BatchResolver(Face& face, size_t concurrency,
+                             const time::milliseconds& interestLifetime,
+                             security::Validator* validator,
+                             size_t nsCacheSize)
+  : m_face(face)
+  , m_scheduler(face.getIoContext())
+  , m_concurrency(concurrency)
+  , m_interestLifetime(interestLifetime)
+  , m_validator(validator)
+  , m_nsCache(make_unique<NsCache>(face.getIoContext(), nsCacheSize))
+  , m_rttTable(make_shared<RttTable>())
+  , m_validationCache(make_unique<ValidationCache>())
+{
+  BOOST_ASSERT(m_concurrency > 0);
+
+  if (m_validator != nullptr) {
+    auto policy = dynamic_cast<ValidationPolicyNdns*>(&m_validator->getPolicy());
+    if (policy != nullptr) {
+      m_validationCache->scheduleEpochBumps(m_scheduler, policy->getAnchorRefreshPeriod());
+    }
+  }
+}
+
+BatchResolver::~BatchResolver()
+{
+  // break the reference cycles between in-flight resolutions and their controllers
+  for (auto& [key, resolution] : m_resolutions) {
+    resolution->controller.reset();
+  }
+}
+
+void
+BatchResolver::add(const Name& dstLabel, const name::Component& rrType,
+                   const QuerySucceedCallback& onSucceed, const QueryFailCallback& onFail)
+{
+  ResolutionKey key{dstLabel, rrType};
+  auto it = m_resolutions.find(key);
+  if (it != m_resolutions.end()) {
+    NDNS_LOG_TRACE("merge with queued or in-flight resolution: " << dstLabel << " " << rrType);
+    it->second->callbacks.emplace_back(onSucceed, onFail);
+    return;
+  }
+
+  auto resolution = make_shared<Resolution>();
+  resolution->dstLabel = dstLabel;
+  resolution->rrType = rrType;
+  resolution->callbacks.emplace_back(onSucceed, onFail);
+  m_resolutions.emplace(std::move(key), resolution);
+  m_queue.push_back(std::move(resolution));
+
+  if (m_isStarted) {
+    fillWindow();
+  }
+}
+
+void
+BatchResolver::start(const SummaryCallback& onFinish)
+{
+  m_isStarted = true;
+  m_onFinish = onFinish;
+  m_startTime = time::steady_clock::now();
+  m_latencies.clear();
+  m_summary = Summary();
+  m_nsCacheHitsAtStart = m_nsCache->getNHits();
+  m_nsCacheMissesAtStart = m_nsCache->getNMisses();
+
+  fillWindow();
+  checkFinished();
+}
+
+void
+BatchResolver::fillWindow()
+{
+  while (m_nInFlight < m_concurrency && !m_queue.empty()) {
+    auto resolution = std::move(m_queue.front());
+    m_queue.pop_front();
+    startResolution(resolution);
+  }
+}
+
+void
+BatchResolver::startResolution(const shared_ptr<Resolution>& resolution)
+{
+  NDNS_LOG_DEBUG("start resolution: " << resolution->dstLabel << " " << resolution->rrType);
+
+  ++m_nInFlight;
+  ++m_summary.nResolutions;
+  resolution->startTime = time::steady_clock::now();
+  resolution->controller = make_shared<IterativeQueryController>(
+    resolution->dstLabel, resolution->rrType, m_interestLifetime,
+    [this, resolution] (const Data& data, const Response& response) {
+      finishResolution(resolution, &data, &response, 0, "");
+    },
+    [this, resolution] (uint32_t errCode, const std::string& errMsg) {
+      finishResolution(resolution, nullptr, nullptr, errCode, errMsg);
+    },
+    m_face, m_validator, m_nsCache.get());
+  resolution->controller->setStartComponentIndex(m_startComponentIndex);
+  resolution->controller->setRttTable(m_rttTable);
+  resolution->controller->setValidationCache(m_validationCache.get());
+  resolution->controller->setInterestExpresser(bind(&BatchResolver::expressInterest, this,
+                                                    resolution.get(), _1, _2, _3, _4));
+
+  try {
+    resolution->controller->start();
+  }
+  catch (const std::exception& e) {
+    NDNS_LOG_WARN("cannot start resolution of " << resolution->dstLabel << ": " << e.what());
+    finishResolution(resolution, nullptr, nullptr, 0, e.what());
+  }
+}
+
+void
+BatchResolver::finishResolution(const shared_ptr<Resolution>& resolution, const Data* data,
+                                const Response* response, uint32_t errCode,
+                                const std::string& errMsg)
+{
+  if (resolution->controller == nullptr) {
+    // already finished
+    return;
+  }
+
+  auto latency = time::steady_clock::now() - resolution->startTime;
+  m_latencies.push_back(latency);
+  NDNS_LOG_DEBUG("resolution of " << resolution->dstLabel << " " << resolution->rrType
+                 << (data != nullptr ? " succeeded" : " failed") << " after " << latency);
+
+  m_resolutions.erase({resolution->dstLabel, resolution->rrType});
+  --m_nInFlight;
+
+  // Data or Nacks arriving later must not reach the controller
+  cancelPendingInterests(*resolution);
+  // the controller is still on the call stack, release it after the current event
+  boost::asio::post(m_face.getIoContext(), [controller = std::move(resolution->controller)] {});
+
+  for (const auto& [onSucceed, onFail] : resolution->callbacks) {
+    if (data != nullptr) {
+      ++m_summary.nSucceeded;
+      if (onSucceed != nullptr)
+        onSucceed(*data, *response);
+    }
+    else {
+      ++m_summary.nFailed;
+      if (onFail != nullptr)
+        onFail(errCode, errMsg);
+    }
+  }
+
+  m_fillEvent = m_scheduler.schedule(0_ns, [this] {
+    fillWindow();
+    checkFinished();
+  });
+}
+
+void
+BatchResolver::expressInterest(Resolution* requester,
+                               const Interest& interest, const DataCallback& afterSatisfied,
+                               const NackCallback& afterNacked, const TimeoutCallback& afterTimeout)
+{
+  auto it = m_pendingInterests.find(interest.getName());
+  if (it != m_pendingInterests.end() && it->second.requesters.count(requester) > 0) {
+    // a retransmission or a hedge: keep the callbacks of the current step of the requester
+    NDNS_LOG_TRACE("resend in-flight Interest: " << interest.getName());
+    it->second.requesters[requester] = {afterSatisfied, afterNacked, afterTimeout};
+    sendPendingInterest(it->second, interest);
+    return;
+  }
+  if (it != m_pendingInterests.end()) {
+    NDNS_LOG_TRACE("merge with in-flight Interest: " << interest.getName());
+    it->second.requesters.emplace(requester, Callbacks{afterSatisfied, afterNacked, afterTimeout});
+    requester->pendingInterests.insert(interest.getName());
+    ++m_summary.nMergedInterests;
+    return;
+  }
+
+  auto& entry = m_pendingInterests[interest.getName()];
+  entry.requesters.emplace(requester, Callbacks{afterSatisfied, afterNacked, afterTimeout});
+  requester->pendingInterests.insert(interest.getName());
+
+  sendPendingInterest(entry, interest);
+}
+
+void
+BatchResolver::sendPendingInterest(PendingInterest& entry, const Interest& interest)
+{
+  ++m_summary.nInterests;
+  entry.handles.push_back(m_face.expressInterest(interest,
+                                                 bind(&BatchResolver::onPendingData, this, _1, _2),
+                                                 bind(&BatchResolver::onPendingNack, this, _1, _2),
+                                                 bind(&BatchResolver::onPendingTimeout, this, _1)));
+  ++entry.nOutstanding;
+}
+
+std::vector<BatchResolver::Callbacks>
+BatchResolver::erasePendingInterest(std::map<Name, PendingInterest>::iterator it)
+{
+  std::vector<Callbacks> callbacks;
+  for (auto& [requester, requesterCallbacks] : it->second.requesters) {
+    requester->pendingInterests.erase(it->first);
+    callbacks.push_back(std::move(requesterCallbacks));
+  }
+  m_pendingInterests.erase(it);
+  return callbacks;
+}
+
+void
+BatchResolver::cancelPendingInterests(Resolution& requester)
+{
+  for (const auto& name : requester.pendingInterests) {
+    auto it = m_pendingInterests.find(name);
+    if (it == m_pendingInterests.end())
+      continue;
+
+    it->second.requesters.erase(&requester);
+    if (it->second.requesters.empty()) {
+      NDNS_LOG_TRACE("cancel Interest without requester: " << name);
+      m_pendingInterests.erase(it);
+    }
+  }
+  requester.pendingInterests.clear();
+}
+
+void
+BatchResolver::onPendingData(const Interest& interest, const Data& data)
+{
+  auto it = m_pendingInterests.find(interest.getName());
+  if (it == m_pendingInterests.end())
+    return;
+
+  for (const auto& callbacks : erasePendingInterest(it)) {
+    callbacks.onData(interest, data);
+  }
+}
+
+void
+BatchResolver::onPendingNack(const Interest& interest, const lp::Nack& nack)
+{
+  auto it = m_pendingInterests.find(interest.getName());
+  if (it == m_pendingInterests.end())
+    return;
+
+  // keep the entry while other copies of the Interest are outstanding
+  std::vector<Callbacks> callbacks;
+  if (--it->second.nOutstanding == 0) {
+    callbacks = erasePendingInterest(it);
+  }
+  else {
+    for (const auto& requester : it->second.requesters) {
+      callbacks.push_back(requester.second);
+    }
+  }
+  for (const auto& requesterCallbacks : callbacks) {
+    requesterCallbacks.onNack(interest, nack);
+  }
+}
+
+void
+BatchResolver::onPendingTimeout(const Interest& interest)
+{
+  auto it = m_pendingInterests.find(interest.getName());
+  if (it == m_pendingInterests.end())
+    return;
+
+  if (--it->second.nOutstanding > 0) {
+    return;
+  }
+  for (const auto& callbacks : erasePendingInterest(it)) {
+    callbacks.onTimeout(interest);
+  }
+}
+
+void
+BatchResolver::checkFinished()
+{
+  if (!m_isStarted || !m_queue.empty() || m_nInFlight > 0) {
+    return;
+  }
+
+  m_summary.totalTime = time::steady_clock::now() - m_startTime;
+  m_summary.nNsCacheHits = m_nsCache->getNHits() - m_nsCacheHitsAtStart;
+  m_summary.nNsCacheMisses = m_nsCache->getNMisses() - m_nsCacheMissesAtStart;
+  if (!m_latencies.empty()) {
+    std::sort(m_latencies.begin(), m_latencies.end());
+    size_t n = m_latencies.size();
+    time::nanoseconds sum = 0_ns;
+    for (const auto& latency : m_latencies) {
+      sum += latency;
+    }
+    m_summary.minLatency = m_latencies.front();
+    m_summary.meanLatency = sum / n;
+    m_summary.p50Latency = m_latencies[(n - 1) * 50 / 100];
+    m_summary.p99Latency = m_latencies[(n - 1) * 99 / 100];
+    m_summary.maxLatency = m_latencies.back();
+  }
+
+  NDNS_LOG_INFO("batch finished: " << m_summary);
+  if (m_onFinish != nullptr) {
+    m_onFinish(m_summary);
+  }
+}
+
+std::ostream&
+operator<<(std::ostream& os, const BatchResolver::Summary& summary)
+{
+  os << "succeeded=" << summary.nSucceeded
+     << " failed=" << summary.nFailed
+     << " resolutions=" << summary.nResolutions
+     << " interests=" << summary.nInterests
+     << " mergedInterests=" << summary.nMergedInterests
+     << " nsCache(hits/misses)=" << summary.nNsCacheHits << "/" << summary.nNsCacheMisses
+     << " totalTime=" << time::duration_cast<time::milliseconds>(summary.totalTime)
+     << " latency(min/mean/p50/p99/max)="
+     << time::duration_cast<time::milliseconds>(summary.minLatency).count() << "/"
+     << time::duration_cast<time::milliseconds>(summary.meanLatency).count() << "/"
+     << time::duration_cast<time::milliseconds>(summary.p50Latency).count() << "/"
+     << time::duration_cast<time::milliseconds>(summary.p99Latency).count() << "/"
+     << time::duration_cast<time::milliseconds>(summary.maxLatency).count() << " ms";
+  return os;
+}
+
+} // namespace ndns
+} // namespace ndn
@@ -0,0 +1,227 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDNS_CLIENTS_BATCH_RESOLVER_HPP
+#define NDNS_CLIENTS_BATCH_RESOLVER_HPP
+
+#include "iterative-query-controller.hpp"
+#include "ns-cache.hpp"
+
+#include <ndn-cxx/util/scheduler.hpp>
+
+#include <deque>
+#include <map>
+#include <set>
+
+namespace ndn {
+namespace ndns {
+
+/**
+ * @brief resolves many (label, rrType) pairs on one Face
+ *
+ * At most `concurrency` resolutions run at the same time; the remaining ones wait in a queue.
+ * Identical (label, rrType) pairs are resolved only once, and identical Interests sent by
+ * concurrent resolutions (e.g., NS queries for a shared ancestor zone) are merged into a single
+ * Interest on the Face. Resolutions also share one NS cache, so delegations learned by one
+ * resolution are reused by the following ones, and so are the RTT estimates of name servers
+ * and the responses that already passed validation.
+ */
+class BatchResolver : boost::noncopyable
+{
+public:
+  /**
+   * @brief aggregate statistics of a batch
+   */
+  struct Summary
+  {
+    size_t nSucceeded = 0; ///< number of added items that succeeded
+    size_t nFailed = 0; ///< number of added items that failed
+    size_t nResolutions = 0; ///< number of distinct (label, rrType) pairs resolved
+    size_t nInterests = 0; ///< number of Interests expressed on the Face
+    size_t nMergedInterests = 0; ///< number of Interests satisfied by an in-flight Interest
+    size_t nNsCacheHits = 0; ///< number of NS lookups answered by the shared NS cache
+    size_t nNsCacheMisses = 0; ///< number of lookups not answered by the shared NS cache
+    time::nanoseconds totalTime = 0_ns; ///< time between start() and the end of the batch
+    time::nanoseconds minLatency = 0_ns;
+    time::nanoseconds meanLatency = 0_ns;
+    time::nanoseconds p50Latency = 0_ns;
+    time::nanoseconds p99Latency = 0_ns;
+    time::nanoseconds maxLatency = 0_ns;
+  };
+
+  using SummaryCallback = std::function<void(const Summary&)>;
+
+  /**
+   * @param face the Face on which all resolutions are performed
+   * @param concurrency maximum number of resolutions running at the same time, must be positive
+   * @param interestLifetime lifetime of Interests sent by each resolution
+   * @param validator if not nullptr, intermediate responses are validated
+   * @param nsCacheSize capacity of the NS cache shared by all resolutions
+   */
+  BatchResolver(Face& face, size_t concurrency,
+                const time::milliseconds& interestLifetime = DEFAULT_INTEREST_LIFETIME,
+                security::Validator* validator = nullptr,
+                size_t nsCacheSize = 500);
+
+  ~BatchResolver();
+
+  /**
+   * @brief set the number of leading components of every label that are globally routable
+   * @sa IterativeQueryController::setStartComponentIndex
+   */
+  void
+  setStartComponentIndex(size_t startIndex)
+  {
+    m_startComponentIndex = startIndex;
+  }
+
+  /**
+   * @brief add a (label, rrType) pair to the batch
+   *
+   * Items can be added before and after start(). Exactly one of @p onSucceed and @p onFail is
+   * invoked for each added item.
+   */
+  void
+  add(const Name& dstLabel, const name::Component& rrType,
+      const QuerySucceedCallback& onSucceed, const QueryFailCallback& onFail);
+
+  /**
+   * @brief start resolving the added items
+   * @param onFinish invoked once every added item has completed
+   */
+  void
+  start(const SummaryCallback& onFinish = nullptr);
+
+  size_t
+  getNQueued() const
+  {
+    return m_queue.size();
+  }
+
+  size_t
+  getNInFlight() const
+  {
+    return m_nInFlight;
+  }
+
+private:
+  struct Resolution
+  {
+    Name dstLabel;
+    name::Component rrType;
+    std::vector<std::pair<QuerySucceedCallback, QueryFailCallback>> callbacks;
+    time::steady_clock::time_point startTime;
+    shared_ptr<IterativeQueryController> controller;
+    std::set<Name> pendingInterests; ///< names of the PendingInterest entries it requested
+  };
+
+  struct Callbacks
+  {
+    DataCallback onData;
+    NackCallback onNack;
+    TimeoutCallback onTimeout;
+  };
+
+  struct PendingInterest
+  {
+    /// callbacks of each resolution waiting for the Interest, the latest ones it registered
+    std::map<Resolution*, Callbacks> requesters;
+    std::vector<ScopedPendingInterestHandle> handles; ///< retransmissions and hedges included
+    size_t nOutstanding = 0; ///< Interests neither Nacked nor timed out
+  };
+
+  using ResolutionKey = std::pair<Name, name::Component>;
+
+  void
+  fillWindow();
+
+  void
+  startResolution(const shared_ptr<Resolution>& resolution);
+
+  void
+  finishResolution(const shared_ptr<Resolution>& resolution, const Data* data,
+                   const Response* response, uint32_t errCode, const std::string& errMsg);
+
+  void
+  expressInterest(Resolution* requester,
+                  const Interest& interest, const DataCallback& afterSatisfied,
+                  const NackCallback& afterNacked, const TimeoutCallback& afterTimeout);
+
+  void
+  sendPendingInterest(PendingInterest& entry, const Interest& interest);
+
+  /**
+   * @brief erase @p it, which cancels the Interests of the entry
+   * @return the callbacks of the requesters of the entry
+   */
+  std::vector<Callbacks>
+  erasePendingInterest(std::map<Name, PendingInterest>::iterator it);
+
+  /**
+   * @brief remove the callbacks of @p requester from the entries it requested, and erase the
+   *        entries that no other resolution waits for
+   */
+  void
+  cancelPendingInterests(Resolution& requester);
+
+  void
+  onPendingData(const Interest& interest, const Data& data);
+
+  void
+  onPendingNack(const Interest& interest, const lp::Nack& nack);
+
+  void
+  onPendingTimeout(const Interest& interest);
+
+  void
+  checkFinished();
+
+private:
+  Face& m_face;
+  Scheduler m_scheduler;
+  const size_t m_concurrency;
+  const time::milliseconds m_interestLifetime;
+  security::Validator* m_validator;
+  unique_ptr<NsCache> m_nsCache;
+  shared_ptr<RttTable> m_rttTable;
+  unique_ptr<ValidationCache> m_validationCache;
+  size_t m_startComponentIndex = 0;
+
+  std::deque<shared_ptr<Resolution>> m_queue;
+  std::map<ResolutionKey, shared_ptr<Resolution>> m_resolutions;
+  std::map<Name, PendingInterest> m_pendingInterests;
+  size_t m_nInFlight = 0;
+  scheduler::ScopedEventId m_fillEvent; ///< cancelled when the BatchResolver is destroyed
+
+  bool m_isStarted = false;
+  SummaryCallback m_onFinish;
+  time::steady_clock::time_point m_startTime;
+  std::vector<time::nanoseconds> m_latencies;
+  size_t m_nsCacheHitsAtStart = 0;
+  size_t m_nsCacheMissesAtStart = 0;
+  Summary m_summary;
+};
+
+std::ostream&
+operator<<(std::ostream& os, const BatchResolver::Summary& summary);
+
+} // namespace ndns
+} // namespace ndn
+
+#endif // NDNS_CLIENTS_BATCH_RESOLVER_HPP
@@ -1,6 +1,6 @@
 /* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
 /*
- * Copyright (c) 2014-2022, Regents of the University of California.
+ * Copyright (c) 2014-2024, Regents of the University of California.
  *
  * This file is part of NDNS (Named Data Networking Domain Name Service).
  * See AUTHORS.md for complete list of NDNS authors and contributors.
@@ -19,7 +19,9 @@
 
 #include "iterative-query-controller.hpp"
 #include "logger.hpp"
+#include "tracepoints.hpp"
 
+#include <algorithm>
 #include <sstream>
 
 namespace ndn {
@@ -34,28 +36,72 @@ IterativeQueryController::IterativeQueryController(const Name& dstLabel,
                                                    const QueryFailCallback& onFail,
                                                    Face& face,
                                                    security::Validator* validator,
-                                                   ndn::InMemoryStorage* cache)
+                                                   NsCache* cache)
   : QueryController(dstLabel, rrType, interestLifetime, onSucceed, onFail, face)
   , m_validator(validator)
   , m_step(QUERY_STEP_QUERY_NS)
   , m_nFinishedComps(0)
   , m_nTryComps(1)
   , m_nsCache(cache)
+  , m_scheduler(face.getIoContext())
+  , m_rttTable(make_shared<RttTable>())
+  , m_resolutionBudget(interestLifetime * 4)
 {
 }
 
+IterativeQueryController::~IterativeQueryController()
+{
+  if (m_segmentFetcher != nullptr) {
+    m_segmentFetcher->stop();
+  }
+}
+
 void
-IterativeQueryController::onTimeout(const Interest& interest)
+IterativeQueryController::onTimeout(const Interest& interest, bool isFailureRecorded)
 {
   NDNS_LOG_INFO("[* !! *] timeout happens: " << interest.getName());
   NDNS_LOG_TRACE(*this);
-  this->abort();
+
+  record(TimelineEvent::TIMEOUT, interest.getName(), m_delegations.empty() ? Name() : m_rttKey);
+  m_retxEvent.cancel();
+  m_hedgeEvent.cancel();
+  if (!isFailureRecorded) {
+    m_rttTable->recordFailure(m_rttKey);
+  }
+  m_rttTable->backoffRto(m_rttKey);
+
+  if (m_nRetries >= m_maxRetries) {
+    NDNS_LOG_DEBUG("give up " << interest.getName() << " after " << m_nRetries << " retries");
+    this->abort();
+    return;
+  }
+  if (time::steady_clock::now() - m_startTime >= m_resolutionBudget) {
+    NDNS_LOG_DEBUG("resolution budget " << m_resolutionBudget << " exhausted");
+    this->abort();
+    return;
+  }
+
+  ++m_nRetries;
+  ++m_nTotalRetries;
+  if (!m_delegations.empty()) {
+    // move on to the next name server of the zone
+    m_primary = (m_primary + 1) % m_delegations.size();
+  }
+  NDNS_LOG_DEBUG("[* <- *] retransmit (" << m_nRetries << "/" << m_maxRetries << ") "
+                 << m_lastInterest.getName());
+  this->sendInterest();
 }
 
 void
 IterativeQueryController::abort()
 {
   NDNS_LOG_DEBUG("abort iterative query");
+  NDNS_TRACE1(resolver_abort, static_cast<int>(m_step));
+  m_step = QUERY_STEP_ABORT;
+  ++m_stepSeq;
+  m_retxEvent.cancel();
+  m_hedgeEvent.cancel();
+  notifyTimeline();
   if (m_onFail != nullptr)
     m_onFail(0, "abort");
   else
@@ -71,6 +117,15 @@ IterativeQueryController::onData(const ndn::Interest& interest, const Data& data
   NDNS_LOG_TRACE("[* -> *] get a " << contentType
                  << " Response: " << data.getName());
 
+  if (contentType == NDNS_SEGMENT) {
+    this->onSegmentedData(interest, data);
+    return;
+  }
+
+  if (m_resolverCache != nullptr && m_validator != nullptr) {
+    m_responseToPersist.emplace(interest.getName(), data);
+  }
+
   const Data* toBeValidatedData = nullptr;
   if (contentType == NDNS_NACK) {
     m_doe = Data(data.getContent().blockFromValue());
@@ -85,13 +140,72 @@ IterativeQueryController::onData(const ndn::Interest& interest, const Data& data
     this->onDataValidated(*toBeValidatedData, contentType);
   }
   else {
-    m_validator->validate(*toBeValidatedData,
-                          bind(&IterativeQueryController::onDataValidated, this, _1, contentType),
-                          [this] (const Data& data, const security::ValidationError& err) {
-                            NDNS_LOG_WARN("data: " << data.getName() << " fails verification");
-                            this->abort();
-                          }
-                          );
+    record(TimelineEvent::VALIDATION_START, toBeValidatedData->getName());
+    auto validationStart = time::steady_clock::now();
+    auto onValidated = [this, contentType, validationStart] (const Data& data) {
+      record(TimelineEvent::VALIDATION_END, data.getName(), Name(),
+             time::steady_clock::now() - validationStart);
+      this->onDataValidated(data, contentType);
+    };
+    auto onFailed = [this, validationStart] (const Data& data,
+                                             const security::ValidationError& err) {
+      record(TimelineEvent::VALIDATION_END, data.getName(), Name(),
+             time::steady_clock::now() - validationStart, NDNS_UNKNOWN, false);
+      NDNS_LOG_WARN("data: " << data.getName() << " fails verification");
+      this->abort();
+    };
+
+    if (m_validationCache != nullptr) {
+      m_validationCache->validate(*m_validator, *toBeValidatedData, onValidated, onFailed);
+    }
+    else {
+      m_validator->validate(*toBeValidatedData, onValidated, onFailed);
+    }
+  }
+}
+
+void
+IterativeQueryController::onSegmentedData(const Interest& interest, const Data& data)
+{
+  if (data.getName().empty() || !data.getName().get(-1).isSegment()) {
+    NDNS_LOG_WARN("segment " << data.getName() << " does not end with a segment number");
+    this->abort();
+    return;
+  }
+
+  Name versionedName = data.getName().getPrefix(-1);
+  NDNS_LOG_DEBUG("[* <- *] fetch segmented record: " << versionedName);
+  record(TimelineEvent::INTEREST_SENT, versionedName);
+  auto fetchStart = time::steady_clock::now();
+  m_segmentFetcher = fetchRecordSegments(m_face, interest, versionedName,
+    [this, interest, versionedName, fetchStart] (const Data& reassembled) {
+      record(TimelineEvent::DATA_RECEIVED, versionedName, Name(),
+             time::steady_clock::now() - fetchStart,
+             NdnsContentType(reassembled.getContentType()));
+      m_segmentFetcher.reset();
+      // the record is validated like a response received in one packet
+      this->onData(interest, reassembled);
+    },
+    [this] (const std::string& reason) {
+      NDNS_LOG_WARN(reason);
+      m_segmentFetcher.reset();
+      this->abort();
+    });
+}
+
+void
+IterativeQueryController::onCachedData(const Interest& interest, const Data& data)
+{
+  NdnsContentType contentType = NdnsContentType(data.getContentType());
+  NDNS_LOG_TRACE("[* -> *] get a cached " << contentType << " Response: " << data.getName());
+
+  m_responseToPersist.reset();
+  if (contentType == NDNS_NACK) {
+    m_doe = Data(data.getContent().blockFromValue());
+    this->onDataValidated(m_doe, NDNS_DOE);
+  }
+  else {
+    this->onDataValidated(data, contentType);
   }
 }
 
@@ -101,6 +215,13 @@ IterativeQueryController::onDataValidated(const Data& data, NdnsContentType cont
   if (m_nsCache != nullptr && contentType == NDNS_LINK) {
     m_nsCache->insert(data);
   }
+  if (m_responseToPersist) {
+    m_resolverCache->insert(m_responseToPersist->first, m_responseToPersist->second, true);
+    m_responseToPersist.reset();
+  }
+  record(TimelineEvent::STEP_END, data.getName(), Name(),
+         time::steady_clock::now() - m_stepStartTime, contentType);
+  NDNS_TRACE2(resolver_step_done, static_cast<int>(m_step), static_cast<int>(contentType));
 
   switch (m_step) {
   case QUERY_STEP_QUERY_NS:
@@ -169,6 +290,7 @@ IterativeQueryController::onDataValidated(const Data& data, NdnsContentType cont
   else if (m_step == QUERY_STEP_ANSWER_STUB) {
     NDNS_LOG_TRACE("query ends: " << *this);
     Response re = this->parseFinalResponse(data);
+    notifyTimeline();
     if (m_onSucceed != nullptr)
       m_onSucceed(data, re);
     else
@@ -187,6 +309,8 @@ IterativeQueryController::hasEnded()
 void
 IterativeQueryController::start()
 {
+  m_startTime = time::steady_clock::now();
+  m_timeline.clear();
   if (m_dstLabel.size() == m_nFinishedComps)
     m_step = QUERY_STEP_QUERY_RR;
 
@@ -198,8 +322,13 @@ IterativeQueryController::start()
 void
 IterativeQueryController::express(const Interest& interest)
 {
+  m_stepStartTime = time::steady_clock::now();
+  NDNS_TRACE3(resolver_step_start, static_cast<int>(m_step),
+              interest.getName().wireEncode().data(), interest.getName().wireEncode().size());
   if (m_nsCache != nullptr) {
     shared_ptr<const Data> cachedData = m_nsCache->find(interest);
+    record(cachedData != nullptr ? TimelineEvent::CACHE_HIT : TimelineEvent::CACHE_MISS,
+           interest.getName(), Name(), time::steady_clock::now() - m_stepStartTime);
     if (cachedData != nullptr) {
       NDNS_LOG_DEBUG("[* cached *] NS record has been cached before: "
                      << interest.getName());
@@ -208,14 +337,186 @@ IterativeQueryController::express(const Interest& interest)
     }
   }
 
+  if (m_resolverCache != nullptr) {
+    auto lookupStart = time::steady_clock::now();
+    shared_ptr<const Data> cachedData = m_resolverCache->find(interest.getName());
+    record(cachedData != nullptr ? TimelineEvent::CACHE_HIT : TimelineEvent::CACHE_MISS,
+           interest.getName(), Name(), time::steady_clock::now() - lookupStart);
+    if (cachedData != nullptr) {
+      NDNS_LOG_DEBUG("[* cached *] response found in resolver cache: " << interest.getName());
+      onCachedData(interest, *cachedData);
+      return;
+    }
+  }
+
+  m_lastInterest = interest;
+  m_nRetries = 0;
+  m_pendingInterests.clear();
+  m_attempts.clear();
+  m_primary = 0;
+  m_hasHedged = false;
+
+  // contact the name servers of the zone in the order of their past performance
+  auto hint = interest.getForwardingHint();
+  m_delegations = m_rttTable->rankDelegations({hint.begin(), hint.end()});
+
   NDNS_LOG_DEBUG("[* <- *] send a Query: " << interest.getName());
-  m_face.expressInterest(interest,
-                         bind(&IterativeQueryController::onData, this, _1, _2),
-                         bind(&IterativeQueryController::onTimeout, this, _1), // nack
-                         bind(&IterativeQueryController::onTimeout, this, _1)
-                         );
+  this->sendInterest();
+}
+
+void
+IterativeQueryController::sendInterest()
+{
+  m_rttKey = this->sendAttempt(m_primary);
+  record(m_nRetries == 0 ? TimelineEvent::INTEREST_SENT : TimelineEvent::INTEREST_RETRANSMITTED,
+         m_lastInterest.getName(), m_delegations.empty() ? Name() : m_rttKey);
+
+  // the RTO never exceeds the Interest lifetime nor the remaining resolution budget
+  auto budgetLeft = m_resolutionBudget - (time::steady_clock::now() - m_startTime);
+  auto rto = std::min({m_rttTable->getRto(m_rttKey),
+                       time::nanoseconds(m_interestLifetime),
+                       std::max(budgetLeft, time::nanoseconds(0))});
+  m_retxEvent = m_scheduler.schedule(rto, [this, interest = m_lastInterest] {
+    onTimeout(interest);
+  });
+
+  if (m_delegations.size() > 1 && !m_hasHedged && m_hedgingDelay > 0_ns) {
+    // race the next name server if the chosen one is slower than it used to be
+    auto srtt = m_rttTable->getSmoothedRtt(m_rttKey);
+    auto delay = srtt < 0_ns ? m_hedgingDelay : std::min(m_hedgingDelay, 2 * srtt);
+    if (delay < rto) {
+      m_hedgeEvent = m_scheduler.schedule(delay, [this] {
+        m_hasHedged = true;
+        ++m_nHedges;
+        size_t index = (m_primary + 1) % m_delegations.size();
+        NDNS_LOG_DEBUG("[* <- *] hedge " << m_lastInterest.getName()
+                       << " via " << m_delegations[index]);
+        this->sendAttempt(index);
+        record(TimelineEvent::INTEREST_HEDGED, m_lastInterest.getName(), m_delegations[index]);
+      });
+    }
+  }
+}
+
+Name
+IterativeQueryController::sendAttempt(size_t delegationIndex)
+{
+  Interest interest(m_lastInterest);
+  interest.refreshNonce();
+  if (!m_delegations.empty()) {
+    interest.setForwardingHint({m_delegations.at(delegationIndex)});
+  }
+
+  Name key = this->getAttemptKey(interest);
+  Attempt& attempt = m_attempts[key];
+  attempt.sentTime = time::steady_clock::now();
+  attempt.isNacked = false;
+  ++attempt.nSent;
+
+  uint64_t seq = m_stepSeq;
+  auto onDataCb = [this, seq] (const Interest& i, const Data& d) { onNetworkData(seq, i, d); };
+  auto onNackCb = [this, seq] (const Interest& i, const lp::Nack&) { onNetworkNack(seq, i); };
+  // the retransmission timer fires before the Interest expires, Face timeouts are redundant
+  auto onTimeoutCb = [] (const Interest& i) {
+    NDNS_LOG_TRACE("Interest expired: " << i.getName());
+  };
+
+  if (m_expresser != nullptr) {
+    m_expresser(interest, onDataCb, onNackCb, onTimeoutCb);
+  }
+  else {
+    m_pendingInterests.emplace_back(m_face.expressInterest(interest, onDataCb, onNackCb,
+                                                           onTimeoutCb));
+  }
+  return key;
 }
 
+Name
+IterativeQueryController::getAttemptKey(const Interest& interest) const
+{
+  // RTT is tracked per name server: the delegation used as forwarding hint, or the zone itself
+  auto hint = interest.getForwardingHint();
+  return hint.empty() ? m_dstLabel.getPrefix(m_nFinishedComps) : Name(hint.front());
+}
+
+void
+IterativeQueryController::onNetworkData(uint64_t stepSeq, const Interest& interest,
+                                        const Data& data)
+{
+  if (stepSeq != m_stepSeq) {
+    NDNS_LOG_TRACE("ignore stale Data: " << data.getName());
+    return;
+  }
+  ++m_stepSeq;
+  m_retxEvent.cancel();
+  m_hedgeEvent.cancel();
+
+  // Karn's algorithm: the RTT of a retransmitted Interest is ambiguous
+  Name key = this->getAttemptKey(interest);
+  auto it = m_attempts.find(key);
+  if (it != m_attempts.end() && it->second.nSent == 1) {
+    m_rttTable->addMeasurement(key, time::steady_clock::now() - it->second.sentTime);
+  }
+  if (key != m_rttKey) {
+    NDNS_LOG_DEBUG("answered via " << key << " instead of " << m_rttKey);
+  }
+  record(TimelineEvent::DATA_RECEIVED, data.getName(), m_delegations.empty() ? Name() : key,
+         time::steady_clock::now() - m_stepStartTime, NdnsContentType(data.getContentType()));
+
+  onData(interest, data);
+}
+
+void
+IterativeQueryController::onNetworkNack(uint64_t stepSeq, const Interest& interest)
+{
+  if (stepSeq != m_stepSeq) {
+    NDNS_LOG_TRACE("ignore stale Nack: " << interest.getName());
+    return;
+  }
+  NDNS_LOG_INFO("[* !! *] Nack received: " << interest.getName());
+
+  Name key = this->getAttemptKey(interest);
+  record(TimelineEvent::NACK_RECEIVED, interest.getName(), m_delegations.empty() ? Name() : key);
+  m_rttTable->recordFailure(key);
+  m_attempts[key].isNacked = true;
+
+  bool hasOutstanding = std::any_of(m_attempts.begin(), m_attempts.end(),
+                                    [] (const auto& attempt) { return !attempt.second.isNacked; });
+  if (hasOutstanding) {
+    // another name server of the zone may still answer
+    return;
+  }
+  // the failures of the Nacked name servers are already recorded
+  onTimeout(interest, true);
+}
+
+void
+IterativeQueryController::record(TimelineEvent::Type type, const Name& name, const Name& via,
+                                 time::nanoseconds duration, NdnsContentType contentType,
+                                 bool isSuccess)
+{
+  if (m_timelineObserver == nullptr) {
+    return;
+  }
+
+  TimelineEvent event;
+  event.type = type;
+  event.time = time::steady_clock::now();
+  event.name = name;
+  event.via = via;
+  event.duration = duration;
+  event.contentType = contentType;
+  event.isSuccess = isSuccess;
+  m_timeline.add(std::move(event));
+}
+
+void
+IterativeQueryController::notifyTimeline()
+{
+  if (m_timelineObserver != nullptr) {
+    m_timelineObserver(m_timeline);
+  }
+}
 
 const Response
 IterativeQueryController::parseFinalResponse(const Data& data)
@@ -23,14 +23,40 @@
 #include "ndns-enum.hpp"
 #include "query-controller.hpp"
 #include "response.hpp"
+#include "clients/ns-cache.hpp"
+#include "clients/resolution-timeline.hpp"
+#include "clients/resolver-cache.hpp"
+#include "clients/rtt-table.hpp"
+#include "util/segmented-record.hpp"
+#include "validator/validation-cache.hpp"
 #include "validator/validator.hpp"
 
-#include <ndn-cxx/ims/in-memory-storage.hpp>
 #include <ndn-cxx/link.hpp>
+#include <ndn-cxx/util/scheduler.hpp>
+
+#include <map>
+#include <optional>
 
 namespace ndn {
 namespace ndns {
 
+/**
+ * @brief function used by IterativeQueryController to send an Interest to the network
+ *
+ * The default implementation is Face::expressInterest. A different function can be supplied
+ * to share in-flight Interests among several controllers (see BatchResolver).
+ */
+using InterestExpresser = std::function<void(const Interest& interest,
+                                             const DataCallback& afterSatisfied,
+                                             const NackCallback& afterNacked,
+                                             const TimeoutCallback& afterTimeout)>;
+
+/**
+ * @brief function notified with the timeline of a resolution, right before the result is
+ *        delivered to the succeed or fail callback
+ */
+using TimelineObserver = std::function<void(const ResolutionTimeline& timeline)>;
+
 /**
  * @brief controller which iteratively query a target label
  */
@@ -56,7 +82,9 @@ public:
                            const time::milliseconds& interestLifetime,
                            const QuerySucceedCallback& onSucceed, const QueryFailCallback& onFail,
                            Face& face, security::Validator* validator = nullptr,
-                           ndn::InMemoryStorage* cache = nullptr);
+                           NsCache* cache = nullptr);
+
+  ~IterativeQueryController() override;
 
   void
   start() override;
@@ -72,6 +100,22 @@ NDNS_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   void
   onData(const ndn::Interest& interest, const Data& data);
 
+  /**
+   * @brief called when the answer to @p interest is the first segment of a segmented record
+   *
+   * The remaining segments are fetched, and the reassembled record is processed as if it
+   * had been received in one packet.
+   */
+  void
+  onSegmentedData(const Interest& interest, const Data& data);
+
+  /**
+   * @brief called with a response found in the persistent resolver cache, which has been
+   * validated before being stored
+   */
+  void
+  onCachedData(const Interest& interest, const Data& data);
+
   /**
    * @brief called when any data are validated.
    * It will unwrap the NACK record,
@@ -81,11 +125,17 @@ NDNS_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   onDataValidated(const Data& data, NdnsContentType contentType);
 
   /**
-   * @brief change the Controller state according to timeout. For current,
-   * abort the query when timeout
+   * @brief called when the Interest of the current step is considered lost, i.e., its
+   * retransmission timer fires or it is Nacked.
+   *
+   * The Interest is retransmitted with a backed-off RTO, unless the retry limit or the
+   * resolution time budget is exhausted, in which case the query is aborted.
+   *
+   * @param isFailureRecorded whether the failure of the name server was already recorded in
+   *                          the RTT table, e.g., when it sent a Nack
    */
   void
-  onTimeout(const Interest& interest);
+  onTimeout(const Interest& interest, bool isFailureRecorded = false);
 
   void
   abort();
@@ -103,6 +153,43 @@ NDNS_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   void
   express(const Interest& interest);
 
+  /**
+   * @brief (re)send the Interest of the current step through the primary delegation,
+   * and schedule its retransmission and hedging timers
+   */
+  void
+  sendInterest();
+
+  /**
+   * @brief send the Interest of the current step through one delegation
+   * @return the RTT table key of the attempt
+   */
+  Name
+  sendAttempt(size_t delegationIndex);
+
+  Name
+  getAttemptKey(const Interest& interest) const;
+
+  /**
+   * @brief append an event to the timeline, if a timeline observer is set
+   */
+  void
+  record(TimelineEvent::Type type, const Name& name, const Name& via = Name(),
+         time::nanoseconds duration = 0_ns, NdnsContentType contentType = NDNS_UNKNOWN,
+         bool isSuccess = true);
+
+  void
+  notifyTimeline();
+
+  /**
+   * @brief called when a Data answering an Interest of step @p stepSeq is received
+   */
+  void
+  onNetworkData(uint64_t stepSeq, const Interest& interest, const Data& data);
+
+  void
+  onNetworkNack(uint64_t stepSeq, const Interest& interest);
+
 public:
   void
   setStartComponentIndex(size_t finished) override
@@ -128,6 +215,108 @@ public:
     return m_nTryComps;
   }
 
+  /**
+   * @brief set the function used to send Interests to the network
+   *
+   * Interests satisfied from the NS cache never reach this function.
+   * If @p expresser is empty, Interests are expressed directly on the Face.
+   */
+  void
+  setInterestExpresser(InterestExpresser expresser)
+  {
+    m_expresser = std::move(expresser);
+  }
+
+  /**
+   * @brief set the RTT table used to compute retransmission timeouts
+   *
+   * By default each controller has its own table. Sharing a table among controllers lets
+   * later resolutions benefit from the RTT measured by earlier ones.
+   */
+  void
+  setRttTable(shared_ptr<RttTable> rttTable)
+  {
+    BOOST_ASSERT(rttTable != nullptr);
+    m_rttTable = std::move(rttTable);
+  }
+
+  /**
+   * @brief set the number of retransmissions of each Interest before the query is aborted
+   */
+  void
+  setMaxRetries(size_t maxRetries)
+  {
+    m_maxRetries = maxRetries;
+  }
+
+  /**
+   * @brief set the total time a resolution may take, including all retransmissions
+   */
+  void
+  setResolutionBudget(time::nanoseconds budget)
+  {
+    m_resolutionBudget = budget;
+  }
+
+  /**
+   * @brief set the maximum delay before the Interest of a step is raced through a second
+   * delegation of the zone, zero disables hedging
+   *
+   * The actual delay is twice the smoothed RTT of the first delegation, if it is shorter.
+   */
+  void
+  setHedgingDelay(time::nanoseconds delay)
+  {
+    m_hedgingDelay = delay;
+  }
+
+  /**
+   * @brief set the persistent cache consulted before sending each Interest
+   *
+   * Responses validated by this controller are stored in @p cache. Without a validator,
+   * the controller only reads from @p cache.
+   */
+  void
+  setResolverCache(ResolverCache* cache)
+  {
+    m_resolverCache = cache;
+  }
+
+  /**
+   * @brief set the cache of validation results consulted before validating each response
+   *
+   * Responses identical to a packet that already passed validation are accepted without
+   * being validated again. The cache is only used when the controller has a validator.
+   */
+  void
+  setValidationCache(ValidationCache* cache)
+  {
+    m_validationCache = cache;
+  }
+
+  /**
+   * @brief set the function notified with the timeline of the resolution
+   *
+   * Events are recorded only when an observer is set.
+   */
+  void
+  setTimelineObserver(TimelineObserver observer)
+  {
+    m_timelineObserver = std::move(observer);
+  }
+
+  size_t
+  getNRetransmissions() const
+  {
+    return m_nTotalRetries;
+  }
+
+  size_t
+  getNHedges() const
+  {
+    return m_nHedges;
+  }
+
 private:
   bool
   isAbsentByDoe(const Data& data) const;
@@ -155,7 +344,46 @@ private:
   Block m_lastLink;
   Data m_doe;
   Name m_lastLabelType;
-  ndn::InMemoryStorage* m_nsCache;
+  NsCache* m_nsCache;
+  InterestExpresser m_expresser;
+  ResolverCache* m_resolverCache = nullptr;
+  ValidationCache* m_validationCache = nullptr;
+  std::optional<std::pair<Name, Data>> m_responseToPersist; ///< (Interest name, response)
+
+  Scheduler m_scheduler;
+  shared_ptr<RttTable> m_rttTable;
+  size_t m_maxRetries = 3;
+  time::nanoseconds m_resolutionBudget;
+  time::steady_clock::time_point m_startTime;
+
+  time::nanoseconds m_hedgingDelay = 200_ms;
+
+  struct Attempt
+  {
+    time::steady_clock::time_point sentTime;
+    size_t nSent = 0;
+    bool isNacked = false;
+  };
+
+  // retransmission state of the current step
+  Interest m_lastInterest;
+  std::vector<Name> m_delegations; ///< ranked forwarding hint of the current step
+  size_t m_primary = 0; ///< index of the delegation in use
+  std::map<Name, Attempt> m_attempts;
+  Name m_rttKey;
+  uint64_t m_stepSeq = 0; ///< incremented whenever a step completes, to ignore stale responses
+  size_t m_nRetries = 0;
+  size_t m_nTotalRetries = 0;
+  bool m_hasHedged = false;
+  size_t m_nHedges = 0;
+  time::steady_clock::time_point m_stepStartTime;
+  scheduler::ScopedEventId m_retxEvent;
+  scheduler::ScopedEventId m_hedgeEvent;
+
+  TimelineObserver m_timelineObserver;
+  ResolutionTimeline m_timeline;
+  std::vector<ScopedPendingInterestHandle> m_pendingInterests;
+  shared_ptr<SegmentFetcher> m_segmentFetcher;
 };
 
 std::ostream&
@@ -0,0 +1,102 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "multi-response.hpp"
+
+namespace ndn {
+namespace ndns {
+
+/**
+ * @return whether the DoE record @p doe proves the absence of @p labelType, i.e., of the label
+ *         followed by the RR type
+ */
+static bool
+isCoveredByDoe(const Data& doe, const Name& labelType)
+{
+  std::pair<Name, Name> range;
+  try {
+    range = Response::wireDecodeDoe(doe.getContent());
+  }
+  catch (const ndn::tlv::Error&) {
+    return false;
+  }
+
+  if (range.first < labelType && labelType < range.second) {
+    return true;
+  }
+  // the last range of the zone wraps around to its first label
+  return range.second < range.first && (labelType < range.first || range.second < labelType);
+}
+
+MultiResponse::MultiResponse(const Response& response)
+{
+  if (response.getContentType() != NDNS_MULTI) {
+    NDN_THROW(Error("Response is not an answer to a multi-type query"));
+  }
+
+  auto rrTypes = label::parseMultiRrType(response.getRrType());
+  const auto& rrs = response.getRrs();
+  if (rrTypes.empty() || rrTypes.size() != rrs.size()) {
+    NDN_THROW(Error("Multi-type answer carries " + to_string(rrs.size()) + " records for " +
+                    to_string(rrTypes.size()) + " requested types"));
+  }
+
+  Name zonePrefix(response.getZone());
+  zonePrefix.append(response.getQueryType());
+  for (size_t i = 0; i < rrs.size(); ++i) {
+    if (rrs[i].type() != ndn::tlv::Data) {
+      NDN_THROW(Error("Unexpected TLV-TYPE " + to_string(rrs[i].type()) +
+                      " in multi-type answer"));
+    }
+    Data data(rrs[i]);
+    const Name& name = data.getName();
+    Name labelType(response.getRrLabel());
+    labelType.append(rrTypes[i]);
+
+    bool exists = data.getContentType() != NDNS_DOE;
+    if (exists) {
+      // <zone>/NDNS/<label>/<type>/<version>
+      Name expected(zonePrefix);
+      expected.append(labelType);
+      if (name.size() != expected.size() + 1 || !expected.isPrefixOf(name)) {
+        NDN_THROW(Error("Record " + name.toUri() + " does not answer " + expected.toUri()));
+      }
+    }
+    else if (name.size() < 2 || !zonePrefix.isPrefixOf(name) ||
+             name.get(-2) != label::DOE_RR_TYPE || !isCoveredByDoe(data, labelType)) {
+      NDN_THROW(Error("DoE record " + name.toUri() + " does not prove the absence of " +
+                      labelType.toUri()));
+    }
+    m_records.push_back({rrTypes[i], std::move(data), exists});
+  }
+}
+
+const MultiResponse::Record*
+MultiResponse::find(const name::Component& rrType) const
+{
+  for (const auto& record : m_records) {
+    if (record.rrType == rrType) {
+      return &record;
+    }
+  }
+  return nullptr;
+}
+
+} // namespace ndns
+} // namespace ndn
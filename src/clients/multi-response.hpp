@@ -0,0 +1,86 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDNS_CLIENTS_MULTI_RESPONSE_HPP
+#define NDNS_CLIENTS_MULTI_RESPONSE_HPP
+
+#include "response.hpp"
+
+#include <vector>
+
+namespace ndn {
+namespace ndns {
+
+/**
+ * @brief records carried by the answer to a multi-type query
+ *
+ * A multi-type query asks for several RR types of a label at once, its type component being
+ * made by label::makeMultiRrType(), e.g.:
+ *
+ *     IterativeQueryController ctr(label, label::makeMultiRrType({TXT_RR_TYPE, APPCERT_RR_TYPE}),
+ *                                  ...);
+ *
+ * The NDNS_MULTI answer carries, for each requested type in the order of the request, either
+ * the signed record of that type or the signed DoE record proving its absence.
+ */
+class MultiResponse
+{
+public:
+  class Error : public ndn::tlv::Error
+  {
+  public:
+    using ndn::tlv::Error::Error;
+  };
+
+  struct Record
+  {
+    name::Component rrType;
+    Data data; ///< the record, or the DoE record if the record does not exist
+    bool exists;
+  };
+
+  /**
+   * @brief decode the records carried by @p response
+   * @throw Error @p response is not the answer to a multi-type query, or it does not carry
+   *              one record per requested type, each being the record of the requested label
+   *              and type or a DoE record of the zone proving its absence
+   */
+  explicit
+  MultiResponse(const Response& response);
+
+  const std::vector<Record>&
+  getRecords() const
+  {
+    return m_records;
+  }
+
+  /**
+   * @return the record of @p rrType, or nullptr if @p rrType was not requested
+   */
+  const Record*
+  find(const name::Component& rrType) const;
+
+private:
+  std::vector<Record> m_records;
+};
+
+} // namespace ndns
+} // namespace ndn
+
+#endif // NDNS_CLIENTS_MULTI_RESPONSE_HPP
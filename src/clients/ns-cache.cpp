@@ -0,0 +1,241 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ns-cache.hpp"
+#include "logger.hpp"
+
+#include <algorithm>
+
+namespace ndn {
+namespace ndns {
+
+NDNS_LOG_INIT(NsCache);
+
+/**
+ * @brief number of the oldest probation entries among which the victim is chosen
+ */
+constexpr size_t N_EVICTION_CANDIDATES = 4;
+
+constexpr uint8_t MAX_FREQUENCY = 15;
+
+NsCache::NsCache(boost::asio::io_service& io, size_t limit)
+  : InMemoryStorage(limit)
+  , m_scheduler(io)
+  , m_protectedLimit(limit * 8 / 10)
+  , m_sampleLimit(limit * 10)
+{
+  BOOST_ASSERT(limit > 0);
+
+  m_sketchWidth = 64;
+  while (m_sketchWidth < limit && m_sketchWidth < (1 << 20)) {
+    m_sketchWidth <<= 1;
+  }
+  m_sketch.resize(m_sketchWidth * 4);
+}
+
+/**
+ * @return the name under which lookups of @p name are counted, without version
+ */
+static Name
+getFrequencyKey(const Name& name)
+{
+  if (!name.empty() && name.get(-1).isVersion()) {
+    return name.getPrefix(-1);
+  }
+  return name;
+}
+
+std::array<size_t, 4>
+NsCache::getSketchIndices(const Name& name) const
+{
+  uint64_t hash = std::hash<Name>()(getFrequencyKey(name));
+  std::array<size_t, 4> indices;
+  for (size_t row = 0; row < indices.size(); ++row) {
+    // splitmix64 finalizer, with a different seed for each row
+    uint64_t h = hash + (row + 1) * 0x9e3779b97f4a7c15ULL;
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    indices[row] = row * m_sketchWidth + (h & (m_sketchWidth - 1));
+  }
+  return indices;
+}
+
+uint8_t
+NsCache::estimateFrequency(const Name& name) const
+{
+  uint8_t frequency = MAX_FREQUENCY;
+  for (size_t index : getSketchIndices(name)) {
+    frequency = std::min(frequency, m_sketch[index]);
+  }
+  return frequency;
+}
+
+void
+NsCache::recordAccess(const Name& name)
+{
+  for (size_t index : getSketchIndices(name)) {
+    if (m_sketch[index] < MAX_FREQUENCY) {
+      ++m_sketch[index];
+    }
+  }
+
+  if (++m_nSamples >= m_sampleLimit) {
+    // age the counters, so that names popular a long time ago can be evicted
+    for (auto& counter : m_sketch) {
+      counter >>= 1;
+    }
+    m_nSamples /= 2;
+  }
+}
+
+void
+NsCache::insert(const Data& data, time::nanoseconds lifetime)
+{
+  m_insertLifetime = lifetime;
+  InMemoryStorage::insert(data);
+  m_insertLifetime.reset();
+}
+
+shared_ptr<const Data>
+NsCache::find(const Interest& interest)
+{
+  auto data = InMemoryStorage::find(interest);
+  if (data == nullptr) {
+    ++m_nMisses;
+  }
+  return data;
+}
+
+shared_ptr<const Data>
+NsCache::find(const Name& name)
+{
+  auto data = InMemoryStorage::find(name);
+  if (data == nullptr) {
+    ++m_nMisses;
+  }
+  return data;
+}
+
+void
+NsCache::afterInsert(InMemoryStorageEntry* entry)
+{
+  ++m_nInsertions;
+  recordAccess(entry->getName());
+
+  m_probation.push_front(entry);
+  Record& record = m_records[entry];
+  record.segment = Segment::PROBATION;
+  record.position = m_probation.begin();
+
+  auto lifetime = m_insertLifetime.value_or(entry->getData().getFreshnessPeriod());
+  if (lifetime > 0_ns) {
+    record.expiry = m_scheduler.schedule(lifetime, [this, entry] { expire(entry); });
+  }
+}
+
+void
+NsCache::afterAccess(InMemoryStorageEntry* entry)
+{
+  ++m_nHits;
+  recordAccess(entry->getName());
+
+  auto it = m_records.find(entry);
+  if (it == m_records.end()) {
+    return;
+  }
+
+  Record& record = it->second;
+  if (record.segment == Segment::PROTECTED) {
+    m_protected.splice(m_protected.begin(), m_protected, record.position);
+    return;
+  }
+
+  // promote to the protected segment, demoting its least recently used entry if it is full
+  m_protected.splice(m_protected.begin(), m_probation, record.position);
+  record.segment = Segment::PROTECTED;
+  if (m_protected.size() > m_protectedLimit && m_protected.size() > 1) {
+    auto* demoted = m_protected.back();
+    m_probation.splice(m_probation.begin(), m_protected, std::prev(m_protected.end()));
+    m_records[demoted].segment = Segment::PROBATION;
+  }
+}
+
+void
+NsCache::beforeErase(InMemoryStorageEntry* entry)
+{
+  forget(entry);
+}
+
+void
+NsCache::forget(InMemoryStorageEntry* entry)
+{
+  auto it = m_records.find(entry);
+  if (it == m_records.end()) {
+    return;
+  }
+
+  auto& list = it->second.segment == Segment::PROBATION ? m_probation : m_protected;
+  list.erase(it->second.position);
+  m_records.erase(it);
+}
+
+bool
+NsCache::evictItem()
+{
+  InMemoryStorageEntry* victim = nullptr;
+  if (!m_probation.empty()) {
+    // the least frequently used among the oldest probation entries, the oldest one on ties
+    uint8_t minFrequency = MAX_FREQUENCY + 1;
+    size_t nCandidates = 0;
+    for (auto it = m_probation.rbegin();
+         it != m_probation.rend() && nCandidates < N_EVICTION_CANDIDATES; ++it, ++nCandidates) {
+      uint8_t frequency = estimateFrequency((*it)->getName());
+      if (frequency < minFrequency) {
+        minFrequency = frequency;
+        victim = *it;
+      }
+    }
+  }
+  else if (!m_protected.empty()) {
+    victim = m_protected.back();
+  }
+
+  if (victim == nullptr) {
+    return false;
+  }
+
+  NDNS_LOG_TRACE("evict " << victim->getName());
+  ++m_nEvictions;
+  Name fullName = victim->getFullName();
+  forget(victim);
+  eraseImpl(fullName);
+  return true;
+}
+
+void
+NsCache::expire(InMemoryStorageEntry* entry)
+{
+  NDNS_LOG_TRACE("expire " << entry->getName());
+  ++m_nExpirations;
+  erase(entry->getFullName(), false);
+}
+
+} // namespace ndns
+} // namespace ndn
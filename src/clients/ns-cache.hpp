@@ -0,0 +1,187 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDNS_CLIENTS_NS_CACHE_HPP
+#define NDNS_CLIENTS_NS_CACHE_HPP
+
+#include "common.hpp"
+
+#include <ndn-cxx/ims/in-memory-storage.hpp>
+#include <ndn-cxx/util/scheduler.hpp>
+
+#include <boost/asio/io_service.hpp>
+
+#include <array>
+#include <list>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace ndn {
+namespace ndns {
+
+/**
+ * @brief cache of NS responses with frequency-aware replacement and FreshnessPeriod expiry
+ *
+ * Replacement is segmented LRU: a new entry enters the probation segment and is promoted to
+ * the protected segment (80% of the capacity) when it is found again. When the cache is full,
+ * the victim is the least frequently used of the oldest probation entries, frequencies being
+ * estimated by a count-min sketch that remembers names after their eviction (TinyLFU).
+ * One-off delegations are thus evicted before popular ones, even popular ones that have
+ * just been re-inserted.
+ *
+ * Entries are removed when their FreshnessPeriod elapses; entries without FreshnessPeriod
+ * are kept until evicted.
+ */
+class NsCache : public InMemoryStorage
+{
+public:
+  NsCache(boost::asio::io_service& io, size_t limit);
+
+  using InMemoryStorage::insert;
+
+  /**
+   * @brief insert @p data, which expires after @p lifetime instead of its FreshnessPeriod
+   *
+   * Used for responses that were received some time ago, e.g., NS links saved across restarts.
+   */
+  void
+  insert(const Data& data, time::nanoseconds lifetime);
+
+  /**
+   * @brief find the entry satisfying @p interest, counting a miss if there is none
+   */
+  shared_ptr<const Data>
+  find(const Interest& interest);
+
+  /**
+   * @brief find the entry named @p name, counting a miss if there is none
+   */
+  shared_ptr<const Data>
+  find(const Name& name);
+
+  /**
+   * @return number of lookups answered from the cache
+   */
+  size_t
+  getNHits() const
+  {
+    return m_nHits;
+  }
+
+  /**
+   * @return number of lookups not answered from the cache
+   */
+  size_t
+  getNMisses() const
+  {
+    return m_nMisses;
+  }
+
+  size_t
+  getNInsertions() const
+  {
+    return m_nInsertions;
+  }
+
+  size_t
+  getNEvictions() const
+  {
+    return m_nEvictions;
+  }
+
+  size_t
+  getNExpirations() const
+  {
+    return m_nExpirations;
+  }
+
+NDNS_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  /**
+   * @return estimated number of recent lookups of @p name, saturated at 15
+   */
+  uint8_t
+  estimateFrequency(const Name& name) const;
+
+protected:
+  void
+  afterInsert(InMemoryStorageEntry* entry) override;
+
+  void
+  afterAccess(InMemoryStorageEntry* entry) override;
+
+  void
+  beforeErase(InMemoryStorageEntry* entry) override;
+
+  bool
+  evictItem() override;
+
+private:
+  enum class Segment {
+    PROBATION,
+    PROTECTED,
+  };
+
+  using EntryList = std::list<InMemoryStorageEntry*>; ///< most recently used first
+
+  struct Record
+  {
+    Segment segment;
+    EntryList::iterator position;
+    scheduler::ScopedEventId expiry;
+  };
+
+  void
+  recordAccess(const Name& name);
+
+  void
+  forget(InMemoryStorageEntry* entry);
+
+  void
+  expire(InMemoryStorageEntry* entry);
+
+  std::array<size_t, 4>
+  getSketchIndices(const Name& name) const;
+
+private:
+  Scheduler m_scheduler;
+  const size_t m_protectedLimit;
+  std::optional<time::nanoseconds> m_insertLifetime; ///< lifetime of the entry being inserted
+
+  EntryList m_probation;
+  EntryList m_protected;
+  std::unordered_map<const InMemoryStorageEntry*, Record> m_records;
+
+  // count-min sketch of 4 rows, counters are halved every m_sampleLimit accesses
+  std::vector<uint8_t> m_sketch;
+  size_t m_sketchWidth;
+  size_t m_nSamples = 0;
+  const size_t m_sampleLimit;
+
+  size_t m_nHits = 0;
+  size_t m_nMisses = 0;
+  size_t m_nInsertions = 0;
+  size_t m_nEvictions = 0;
+  size_t m_nExpirations = 0;
+};
+
+} // namespace ndns
+} // namespace ndn
+
+#endif // NDNS_CLIENTS_NS_CACHE_HPP
@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resolution-timeline.hpp"
+
+#include <algorithm>
+
+namespace ndn {
+namespace ndns {
+
+std::ostream&
+operator<<(std::ostream& os, TimelineEvent::Type type)
+{
+  switch (type) {
+  case TimelineEvent::INTEREST_SENT:
+    return os << "InterestSent";
+  case TimelineEvent::INTEREST_RETRANSMITTED:
+    return os << "InterestRetransmitted";
+  case TimelineEvent::INTEREST_HEDGED:
+    return os << "InterestHedged";
+  case TimelineEvent::CACHE_HIT:
+    return os << "CacheHit";
+  case TimelineEvent::CACHE_MISS:
+    return os << "CacheMiss";
+  case TimelineEvent::DATA_RECEIVED:
+    return os << "DataReceived";
+  case TimelineEvent::NACK_RECEIVED:
+    return os << "NackReceived";
+  case TimelineEvent::TIMEOUT:
+    return os << "Timeout";
+  case TimelineEvent::VALIDATION_START:
+    return os << "ValidationStart";
+  case TimelineEvent::VALIDATION_END:
+    return os << "ValidationEnd";
+  case TimelineEvent::STEP_END:
+    return os << "StepEnd";
+  }
+  return os << "Unknown";
+}
+
+ResolutionTimeline::Breakdown
+ResolutionTimeline::getBreakdown() const
+{
+  Breakdown breakdown;
+  if (m_events.empty()) {
+    return breakdown;
+  }
+
+  breakdown.total = m_events.back().time - m_events.front().time;
+  for (const auto& event : m_events) {
+    switch (event.type) {
+    case TimelineEvent::INTEREST_RETRANSMITTED:
+      ++breakdown.nRetransmissions;
+      [[fallthrough]];
+    case TimelineEvent::INTEREST_SENT:
+    case TimelineEvent::INTEREST_HEDGED:
+      ++breakdown.nInterests;
+      break;
+    case TimelineEvent::CACHE_HIT:
+      ++breakdown.nCacheHits;
+      [[fallthrough]];
+    case TimelineEvent::CACHE_MISS:
+      breakdown.cache += event.duration;
+      break;
+    case TimelineEvent::DATA_RECEIVED:
+      breakdown.network += event.duration;
+      break;
+    case TimelineEvent::VALIDATION_END:
+      breakdown.validation += event.duration;
+      break;
+    case TimelineEvent::STEP_END:
+      ++breakdown.nSteps;
+      break;
+    default:
+      break;
+    }
+  }
+
+  breakdown.other = std::max(breakdown.total - breakdown.network - breakdown.validation -
+                             breakdown.cache, time::nanoseconds(0));
+  return breakdown;
+}
+
+std::ostream&
+operator<<(std::ostream& os, const ResolutionTimeline& timeline)
+{
+  const auto& events = timeline.getEvents();
+  if (events.empty()) {
+    return os;
+  }
+
+  auto start = events.front().time;
+  for (const auto& event : events) {
+    os << "+" << time::duration_cast<time::microseconds>(event.time - start).count() << "us "
+       << event.type << " " << event.name;
+    if (!event.via.empty()) {
+      os << " via=" << event.via;
+    }
+    if (event.type == TimelineEvent::DATA_RECEIVED || event.type == TimelineEvent::STEP_END) {
+      os << " type=" << event.contentType;
+    }
+    if (event.type == TimelineEvent::VALIDATION_END) {
+      os << (event.isSuccess ? " valid" : " invalid");
+    }
+    if (event.duration > 0_ns) {
+      os << " duration=" << time::duration_cast<time::microseconds>(event.duration).count()
+         << "us";
+    }
+    os << "\n";
+  }
+  return os;
+}
+
+std::ostream&
+operator<<(std::ostream& os, const ResolutionTimeline::Breakdown& breakdown)
+{
+  auto ms = [] (time::nanoseconds d) {
+    return time::duration_cast<time::microseconds>(d).count() / 1000.0;
+  };
+  os << "total=" << ms(breakdown.total) << "ms"
+     << " network=" << ms(breakdown.network) << "ms"
+     << " validation=" << ms(breakdown.validation) << "ms"
+     << " cache=" << ms(breakdown.cache) << "ms"
+     << " other=" << ms(breakdown.other) << "ms"
+     << " steps=" << breakdown.nSteps
+     << " interests=" << breakdown.nInterests
+     << " retransmissions=" << breakdown.nRetransmissions
+     << " cacheHits=" << breakdown.nCacheHits;
+  return os;
+}
+
+} // namespace ndns
+} // namespace ndn
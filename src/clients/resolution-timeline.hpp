@@ -0,0 +1,130 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDNS_CLIENTS_RESOLUTION_TIMELINE_HPP
+#define NDNS_CLIENTS_RESOLUTION_TIMELINE_HPP
+
+#include "common.hpp"
+#include "ndns-enum.hpp"
+
+#include <ndn-cxx/util/time.hpp>
+
+#include <vector>
+
+namespace ndn {
+namespace ndns {
+
+/**
+ * @brief an event in the life of a resolution
+ */
+struct TimelineEvent
+{
+  enum Type {
+    INTEREST_SENT, ///< first Interest of a step
+    INTEREST_RETRANSMITTED,
+    INTEREST_HEDGED, ///< Interest raced through another delegation
+    CACHE_HIT, ///< the step was answered from the NS cache
+    CACHE_MISS,
+    DATA_RECEIVED,
+    NACK_RECEIVED,
+    TIMEOUT, ///< retransmission timer fired
+    VALIDATION_START,
+    VALIDATION_END,
+    STEP_END, ///< the response of a step has been accepted
+  };
+
+  Type type;
+  time::steady_clock::time_point time;
+  Name name; ///< Interest or Data name
+  Name via; ///< delegation used as forwarding hint, if any
+  /**
+   * @brief time spent in the event: cache lookup for CACHE_HIT and CACHE_MISS,
+   *        network round trip since the first Interest of the step for DATA_RECEIVED,
+   *        validation for VALIDATION_END, whole step for STEP_END
+   */
+  time::nanoseconds duration = 0_ns;
+  NdnsContentType contentType = NDNS_UNKNOWN; ///< for DATA_RECEIVED and STEP_END
+  bool isSuccess = true; ///< for VALIDATION_END
+};
+
+std::ostream&
+operator<<(std::ostream& os, TimelineEvent::Type type);
+
+/**
+ * @brief structured record of the steps of one resolution
+ *
+ * @sa IterativeQueryController::setTimelineObserver
+ */
+class ResolutionTimeline
+{
+public:
+  /**
+   * @brief time spent in each activity of a resolution
+   */
+  struct Breakdown
+  {
+    time::nanoseconds total = 0_ns; ///< from the first to the last event
+    time::nanoseconds network = 0_ns;
+    time::nanoseconds validation = 0_ns;
+    time::nanoseconds cache = 0_ns;
+    time::nanoseconds other = 0_ns; ///< total minus the above, e.g., local processing
+    size_t nSteps = 0;
+    size_t nInterests = 0; ///< including retransmissions and hedges
+    size_t nRetransmissions = 0;
+    size_t nCacheHits = 0;
+  };
+
+  void
+  add(TimelineEvent event)
+  {
+    m_events.push_back(std::move(event));
+  }
+
+  const std::vector<TimelineEvent>&
+  getEvents() const
+  {
+    return m_events;
+  }
+
+  void
+  clear()
+  {
+    m_events.clear();
+  }
+
+  Breakdown
+  getBreakdown() const;
+
+private:
+  std::vector<TimelineEvent> m_events;
+};
+
+/**
+ * @brief print one line per event, with the time elapsed since the first event
+ */
+std::ostream&
+operator<<(std::ostream& os, const ResolutionTimeline& timeline);
+
+std::ostream&
+operator<<(std::ostream& os, const ResolutionTimeline::Breakdown& breakdown);
+
+} // namespace ndns
+} // namespace ndn
+
+#endif // NDNS_CLIENTS_RESOLUTION_TIMELINE_HPP
@@ -0,0 +1,212 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "resolver-cache.hpp"
+#include "logger.hpp"
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/path.hpp>
+
+#include <cstdlib>
+
+namespace ndn {
+namespace ndns {
+
+NDNS_LOG_INIT(ResolverCache);
+
+const std::string RESOLVER_CACHE_SCHEMA = R"SQL(
+CREATE TABLE IF NOT EXISTS entries (
+  key       BLOB NOT NULL PRIMARY KEY,
+  data      BLOB NOT NULL,
+  expires   INTEGER NOT NULL,
+  validated INTEGER NOT NULL
+);
+)SQL";
+
+// expired entries are purged once every this many insertions
+const size_t EVICTION_INTERVAL = 256;
+
+// how long a writer waits for another process holding the write lock
+const int BUSY_TIMEOUT_MS = 100;
+
+static int64_t
+now()
+{
+  return time::toUnixTimestamp(time::system_clock::now()).count();
+}
+
+ResolverCache::ResolverCache(const std::string& path, size_t mmapSize)
+  : m_path(path.empty() ? getDefaultPath() : path)
+{
+  int res = sqlite3_open_v2(m_path.data(), &m_conn,
+                            SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX,
+#ifdef DISABLE_SQLITE3_FS_LOCKING
+                            "unix-dotfile"
+#else
+                            nullptr
+#endif
+                            );
+  if (res != SQLITE_OK) {
+    sqlite3_close(m_conn);
+    m_conn = nullptr;
+    NDN_THROW(Error("Cannot open the resolver cache: " + m_path));
+  }
+
+  sqlite3_busy_timeout(m_conn, BUSY_TIMEOUT_MS);
+
+  // WAL lets readers proceed while a writer appends, and a crash only loses uncommitted
+  // transactions; synchronous=NORMAL is durable enough for a cache
+  std::string pragmas = "PRAGMA journal_mode=WAL; PRAGMA synchronous=NORMAL; "
+                        "PRAGMA mmap_size=" + std::to_string(mmapSize) + ";";
+  if (sqlite3_exec(m_conn, pragmas.data(), nullptr, nullptr, nullptr) != SQLITE_OK) {
+    NDNS_LOG_WARN("Cannot configure the resolver cache: " << sqlite3_errmsg(m_conn));
+  }
+
+  if (sqlite3_exec(m_conn, RESOLVER_CACHE_SCHEMA.data(), nullptr, nullptr, nullptr) != SQLITE_OK) {
+    std::string msg = sqlite3_errmsg(m_conn);
+    sqlite3_close(m_conn);
+    m_conn = nullptr;
+    NDN_THROW(Error("Cannot initialize the resolver cache " + m_path + ": " + msg));
+  }
+
+  try {
+    m_findStmt = prepare("SELECT data FROM entries "
+                         "WHERE key = ?1 AND expires > ?2 AND validated >= ?3");
+    m_insertStmt = prepare("INSERT INTO entries (key, data, expires, validated) "
+                           "VALUES (?1, ?2, ?3, ?4) "
+                           "ON CONFLICT(key) DO UPDATE SET data = excluded.data, "
+                           "expires = excluded.expires, validated = excluded.validated "
+                           "WHERE excluded.validated >= entries.validated "
+                           "OR entries.expires <= ?5");
+  }
+  catch (const Error&) {
+    sqlite3_finalize(m_findStmt);
+    sqlite3_close(m_conn);
+    m_conn = nullptr;
+    throw;
+  }
+
+  evictExpired();
+  NDNS_LOG_DEBUG("open resolver cache: " << m_path);
+}
+
+ResolverCache::~ResolverCache()
+{
+  sqlite3_finalize(m_findStmt);
+  sqlite3_finalize(m_insertStmt);
+  if (m_conn != nullptr) {
+    sqlite3_close(m_conn);
+  }
+}
+
+sqlite3_stmt*
+ResolverCache::prepare(const char* sql)
+{
+  sqlite3_stmt* stmt = nullptr;
+  if (sqlite3_prepare_v2(m_conn, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+    NDN_THROW(Error(std::string("Cannot prepare statement: ") + sql));
+  }
+  return stmt;
+}
+
+shared_ptr<const Data>
+ResolverCache::find(const Name& key, bool mustBeValidated)
+{
+  const Block& keyWire = key.wireEncode();
+  sqlite3_bind_blob(m_findStmt, 1, keyWire.data(), keyWire.size(), SQLITE_STATIC);
+  sqlite3_bind_int64(m_findStmt, 2, now());
+  sqlite3_bind_int(m_findStmt, 3, mustBeValidated ? 1 : 0);
+
+  shared_ptr<Data> data;
+  int rc = sqlite3_step(m_findStmt);
+  if (rc == SQLITE_ROW) {
+    span wire(static_cast<const uint8_t*>(sqlite3_column_blob(m_findStmt, 0)),
+              sqlite3_column_bytes(m_findStmt, 0));
+    try {
+      data = make_shared<Data>(Block(wire));
+    }
+    catch (const std::exception& e) {
+      NDNS_LOG_WARN("Ignore malformed entry " << key << ": " << e.what());
+    }
+  }
+  else if (rc != SQLITE_DONE) {
+    NDNS_LOG_DEBUG("Cannot read " << key << ": " << sqlite3_errmsg(m_conn));
+  }
+  sqlite3_reset(m_findStmt);
+  sqlite3_clear_bindings(m_findStmt);
+
+  NDNS_LOG_TRACE((data != nullptr ? "hit " : "miss ") << key);
+  return data;
+}
+
+void
+ResolverCache::insert(const Name& key, const Data& data, bool isValidated)
+{
+  auto freshness = data.getFreshnessPeriod();
+  if (freshness <= 0_ms) {
+    return;
+  }
+
+  int64_t timestamp = now();
+  const Block& keyWire = key.wireEncode();
+  const Block& dataWire = data.wireEncode();
+  sqlite3_bind_blob(m_insertStmt, 1, keyWire.data(), keyWire.size(), SQLITE_STATIC);
+  sqlite3_bind_blob(m_insertStmt, 2, dataWire.data(), dataWire.size(), SQLITE_STATIC);
+  sqlite3_bind_int64(m_insertStmt, 3, timestamp + freshness.count());
+  sqlite3_bind_int(m_insertStmt, 4, isValidated ? 1 : 0);
+  sqlite3_bind_int64(m_insertStmt, 5, timestamp);
+
+  if (sqlite3_step(m_insertStmt) != SQLITE_DONE) {
+    NDNS_LOG_DEBUG("Cannot store " << key << ": " << sqlite3_errmsg(m_conn));
+  }
+  sqlite3_reset(m_insertStmt);
+  sqlite3_clear_bindings(m_insertStmt);
+
+  if (++m_nInserts % EVICTION_INTERVAL == 0) {
+    evictExpired();
+  }
+}
+
+size_t
+ResolverCache::evictExpired()
+{
+  std::string sql = "DELETE FROM entries WHERE expires <= " + std::to_string(now());
+  if (sqlite3_exec(m_conn, sql.data(), nullptr, nullptr, nullptr) != SQLITE_OK) {
+    NDNS_LOG_DEBUG("Cannot evict expired entries: " << sqlite3_errmsg(m_conn));
+    return 0;
+  }
+  return static_cast<size_t>(sqlite3_changes(m_conn));
+}
+
+std::string
+ResolverCache::getDefaultPath()
+{
+  boost::filesystem::path dir(".");
+  const char* home = std::getenv("HOME");
+  if (home != nullptr) {
+    dir = boost::filesystem::path(home) / ".ndn";
+  }
+
+  boost::system::error_code ec;
+  boost::filesystem::create_directories(dir, ec);
+  return (dir / "ndns-resolver-cache.db").string();
+}
+
+} // namespace ndns
+} // namespace ndn
@@ -0,0 +1,115 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDNS_CLIENTS_RESOLVER_CACHE_HPP
+#define NDNS_CLIENTS_RESOLVER_CACHE_HPP
+
+#include "common.hpp"
+
+#include <ndn-cxx/data.hpp>
+
+#include <sqlite3.h>
+
+namespace ndn {
+namespace ndns {
+
+/**
+ * @brief persistent resolver cache shared by client processes
+ *
+ * Responses (delegations, answers, and NACKs carrying DoE ranges) are stored in an SQLite file,
+ * keyed by the name of the Interest they answer, and expire after their FreshnessPeriod.
+ * The file is opened in WAL mode with a memory-mapped read path, so any number of processes can
+ * read it concurrently while one of them writes, and a crashed writer never corrupts it.
+ *
+ * Each entry records whether the response has been validated. Only validated entries may be
+ * used without validation.
+ */
+class ResolverCache : boost::noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    using std::runtime_error::runtime_error;
+  };
+
+  /**
+   * @brief open or create the cache file
+   * @param path path of the cache file, getDefaultPath() if empty
+   * @param mmapSize number of bytes of the file that may be memory-mapped
+   * @throw Error the file cannot be opened
+   */
+  explicit
+  ResolverCache(const std::string& path = "", size_t mmapSize = 64 * 1024 * 1024);
+
+  ~ResolverCache();
+
+  /**
+   * @brief find the unexpired response to an Interest named @p key
+   * @param mustBeValidated if true, unvalidated entries are ignored
+   * @return the response, or nullptr if there is none
+   */
+  shared_ptr<const Data>
+  find(const Name& key, bool mustBeValidated = true);
+
+  /**
+   * @brief store @p data as the response to an Interest named @p key
+   *
+   * Data without FreshnessPeriod are not stored. An unvalidated response does not replace an
+   * unexpired validated one. Failures (e.g., the file is locked by another writer for longer
+   * than the busy timeout) are logged and ignored.
+   */
+  void
+  insert(const Name& key, const Data& data, bool isValidated);
+
+  /**
+   * @brief delete expired entries
+   * @return the number of deleted entries
+   */
+  size_t
+  evictExpired();
+
+  const std::string&
+  getPath() const
+  {
+    return m_path;
+  }
+
+  /**
+   * @return $HOME/.ndn/ndns-resolver-cache.db
+   */
+  static std::string
+  getDefaultPath();
+
+private:
+  sqlite3_stmt*
+  prepare(const char* sql);
+
+private:
+  std::string m_path;
+  sqlite3* m_conn = nullptr;
+  sqlite3_stmt* m_findStmt = nullptr;
+  sqlite3_stmt* m_insertStmt = nullptr;
+  size_t m_nInserts = 0;
+};
+
+} // namespace ndns
+} // namespace ndn
+
+#endif // NDNS_CLIENTS_RESOLVER_CACHE_HPP
@@ -0,0 +1,155 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rtt-table.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ndn {
+namespace ndns {
+
+RttTable::RttTable(const Options& options)
+  : m_options(options)
+{
+  BOOST_ASSERT(m_options.minRto <= m_options.maxRto);
+  BOOST_ASSERT(m_options.maxEntries > 0);
+}
+
+RttTable::Entry&
+RttTable::findOrInsert(const Name& key)
+{
+  auto it = m_entries.find(key);
+  if (it == m_entries.end()) {
+    if (m_entries.size() >= m_options.maxEntries) {
+      // evict the least recently used entry
+      auto victim = std::min_element(m_entries.begin(), m_entries.end(),
+                                     [] (const auto& a, const auto& b) {
+                                       return a.second.lastUsed < b.second.lastUsed;
+                                     });
+      m_entries.erase(victim);
+    }
+    it = m_entries.emplace(key, Entry()).first;
+    it->second.rto = m_options.initialRto;
+  }
+  it->second.lastUsed = time::steady_clock::now();
+  return it->second;
+}
+
+time::nanoseconds
+RttTable::clampRto(time::nanoseconds rto) const
+{
+  return std::clamp(rto, m_options.minRto, m_options.maxRto);
+}
+
+void
+RttTable::addMeasurement(const Name& key, time::nanoseconds rtt)
+{
+  BOOST_ASSERT(rtt >= 0_ns);
+  Entry& entry = findOrInsert(key);
+
+  if (entry.srtt < 0_ns) {
+    entry.srtt = rtt;
+    entry.rttVar = rtt / 2;
+  }
+  else {
+    double delta = std::abs(static_cast<double>((entry.srtt - rtt).count()));
+    entry.rttVar = time::nanoseconds(static_cast<time::nanoseconds::rep>(
+      (1 - m_options.beta) * entry.rttVar.count() + m_options.beta * delta));
+    entry.srtt = time::nanoseconds(static_cast<time::nanoseconds::rep>(
+      (1 - m_options.alpha) * entry.srtt.count() + m_options.alpha * rtt.count()));
+  }
+
+  entry.rto = clampRto(entry.srtt + m_options.k * entry.rttVar);
+  entry.nFailures = 0;
+}
+
+void
+RttTable::recordFailure(const Name& key)
+{
+  Entry& entry = findOrInsert(key);
+  ++entry.nFailures;
+  entry.lastFailure = time::steady_clock::now();
+}
+
+time::nanoseconds
+RttTable::getScore(const Name& key) const
+{
+  auto it = m_entries.find(key);
+  if (it == m_entries.end()) {
+    return m_options.minRto;
+  }
+
+  const Entry& entry = it->second;
+  time::nanoseconds score = entry.srtt < 0_ns ? m_options.minRto : entry.srtt;
+  if (entry.nFailures > 0 &&
+      time::steady_clock::now() - entry.lastFailure < m_options.failureMemory) {
+    score *= 1 << std::min<size_t>(entry.nFailures, 10);
+  }
+  return score;
+}
+
+std::vector<Name>
+RttTable::rankDelegations(std::vector<Name> delegations) const
+{
+  std::vector<std::pair<time::nanoseconds, Name>> scored;
+  scored.reserve(delegations.size());
+  for (auto& delegation : delegations) {
+    auto score = getScore(delegation);
+    scored.emplace_back(score, std::move(delegation));
+  }
+  std::stable_sort(scored.begin(), scored.end(),
+                   [] (const auto& a, const auto& b) { return a.first < b.first; });
+
+  delegations.clear();
+  for (auto& item : scored) {
+    delegations.push_back(std::move(item.second));
+  }
+  return delegations;
+}
+
+void
+RttTable::backoffRto(const Name& key)
+{
+  Entry& entry = findOrInsert(key);
+  entry.rto = clampRto(entry.rto * 2);
+}
+
+time::nanoseconds
+RttTable::getRto(const Name& key) const
+{
+  auto it = m_entries.find(key);
+  if (it == m_entries.end()) {
+    return m_options.initialRto;
+  }
+  return it->second.rto;
+}
+
+time::nanoseconds
+RttTable::getSmoothedRtt(const Name& key) const
+{
+  auto it = m_entries.find(key);
+  if (it == m_entries.end()) {
+    return -1_ns;
+  }
+  return it->second.srtt;
+}
+
+} // namespace ndns
+} // namespace ndn
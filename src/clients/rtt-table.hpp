@@ -0,0 +1,141 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDNS_CLIENTS_RTT_TABLE_HPP
+#define NDNS_CLIENTS_RTT_TABLE_HPP
+
+#include "common.hpp"
+
+#include <ndn-cxx/util/time.hpp>
+
+#include <map>
+#include <vector>
+
+namespace ndn {
+namespace ndns {
+
+/**
+ * @brief RTT estimates and failure history of the name servers contacted by the resolver
+ *
+ * Entries are keyed by the name through which a name server is reached, i.e., a delegation
+ * name used as forwarding hint, or the zone name when no forwarding hint is used.
+ * The retransmission timeout (RTO) of each entry is computed as in RFC 6298.
+ */
+class RttTable : boost::noncopyable
+{
+public:
+  struct Options
+  {
+    double alpha = 0.125; ///< weight of a new sample in the smoothed RTT
+    double beta = 0.25; ///< weight of a new sample in the RTT variation
+    int k = 4; ///< RTT variation multiplier
+    time::nanoseconds initialRto = 1_s; ///< RTO of a name server without measurements
+    time::nanoseconds minRto = 200_ms;
+    time::nanoseconds maxRto = 60_s;
+    size_t maxEntries = 1000; ///< number of entries kept in the table
+    time::nanoseconds failureMemory = 60_s; ///< failures older than this are forgotten
+  };
+
+  explicit
+  RttTable(const Options& options = Options());
+
+  /**
+   * @brief record an RTT sample of the name server reached through @p key
+   *
+   * Samples must not be taken from retransmitted Interests (Karn's algorithm).
+   */
+  void
+  addMeasurement(const Name& key, time::nanoseconds rtt);
+
+  /**
+   * @brief double the RTO of @p key after a loss, up to Options::maxRto
+   */
+  void
+  backoffRto(const Name& key);
+
+  /**
+   * @brief record that the name server reached through @p key did not answer
+   *
+   * Consecutive failures lower the rank of @p key until it answers again or
+   * Options::failureMemory elapses.
+   */
+  void
+  recordFailure(const Name& key);
+
+  /**
+   * @brief expected cost of using @p key, lower is better
+   *
+   * The cost is the smoothed RTT (Options::minRto for name servers without measurements),
+   * doubled for each recent consecutive failure.
+   */
+  time::nanoseconds
+  getScore(const Name& key) const;
+
+  /**
+   * @brief sort @p delegations by increasing score
+   *
+   * Delegations with equal scores keep their original order.
+   */
+  std::vector<Name>
+  rankDelegations(std::vector<Name> delegations) const;
+
+  /**
+   * @return the current RTO of @p key, Options::initialRto if there is no entry
+   */
+  time::nanoseconds
+  getRto(const Name& key) const;
+
+  /**
+   * @return the smoothed RTT of @p key, or a negative value if @p key has no measurements
+   */
+  time::nanoseconds
+  getSmoothedRtt(const Name& key) const;
+
+  size_t
+  size() const
+  {
+    return m_entries.size();
+  }
+
+private:
+  struct Entry
+  {
+    time::nanoseconds srtt = -1_ns;
+    time::nanoseconds rttVar = 0_ns;
+    time::nanoseconds rto;
+    time::steady_clock::time_point lastUsed;
+    size_t nFailures = 0;
+    time::steady_clock::time_point lastFailure;
+  };
+
+  Entry&
+  findOrInsert(const Name& key);
+
+  time::nanoseconds
+  clampRto(time::nanoseconds rto) const;
+
+private:
+  const Options m_options;
+  std::map<Name, Entry> m_entries;
+};
+
+} // namespace ndns
+} // namespace ndn
+
+#endif // NDNS_CLIENTS_RTT_TABLE_HPP
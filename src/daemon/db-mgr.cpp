@@ -19,6 +19,7 @@
 
 #include "db-mgr.hpp"
 #include "logger.hpp"
+#include "tracepoints.hpp"
 #include "clients/response.hpp"
 #include "util/util.hpp"
 
@@ -27,6 +28,34 @@ namespace ndns {
 
 NDNS_LOG_INIT(DbMgr);
 
+namespace {
+
+/**
+ * @brief sqlite3_step between the db_step_start and db_step_done tracepoints
+ */
+int
+step(sqlite3_stmt* stmt)
+{
+  NDNS_TRACE1(db_step_start, sqlite3_sql(stmt));
+  int rc = sqlite3_step(stmt);
+  NDNS_TRACE1(db_step_done, rc);
+  return rc;
+}
+
+/**
+ * @brief sqlite3_exec between the db_exec_start and db_exec_done tracepoints
+ */
+int
+exec(sqlite3* conn, const char* sql)
+{
+  NDNS_TRACE1(db_exec_start, sql);
+  int rc = sqlite3_exec(conn, sql, nullptr, nullptr, nullptr);
+  NDNS_TRACE1(db_exec_done, rc);
+  return rc;
+}
+
+} // namespace
+
 const std::string NDNS_SCHEMA = R"SQL(
 CREATE TABLE IF NOT EXISTS zones (
   id    INTEGER NOT NULL PRIMARY KEY,
@@ -53,6 +82,14 @@ CREATE TABLE IF NOT EXISTS rrsets (
   FOREIGN KEY(zone_id) REFERENCES zones(id) ON UPDATE CASCADE ON DELETE CASCADE
 );
 
+CREATE TABLE IF NOT EXISTS validator_cache (
+  type    INTEGER NOT NULL,
+  name    BLOB NOT NULL,
+  data    BLOB NOT NULL,
+  expires INTEGER NOT NULL,
+  PRIMARY KEY(type, name)
+);
+
 CREATE UNIQUE INDEX rrsets_zone_id_label_type_version
   ON rrsets(zone_id, label, type, version);
 )SQL";
@@ -92,7 +129,7 @@ DbMgr::open()
   }
 
   // ignore any errors from DB creation (command will fail for the existing database, which is ok)
-  sqlite3_exec(m_conn, NDNS_SCHEMA.data(), nullptr, nullptr, nullptr);
+  exec(m_conn, NDNS_SCHEMA.data());
 }
 
 void
@@ -114,10 +151,10 @@ DbMgr::close()
 void
 DbMgr::clearAllData()
 {
-  const char* sql = "DELETE FROM zones; DELETE FROM rrsets;";
+  const char* sql = "DELETE FROM zones; DELETE FROM rrsets; DELETE FROM validator_cache;";
 
   // sqlite3_step cannot execute multiple SQL statements
-  int rc = sqlite3_exec(m_conn, sql, nullptr, nullptr, nullptr);
+  int rc = exec(m_conn, sql);
   if (rc != SQLITE_OK) {
     NDN_THROW(ExecuteError(sql));
   }
@@ -125,6 +162,36 @@ DbMgr::clearAllData()
   NDNS_LOG_INFO("clear all the data in the database: " << m_dbFile);
 }
 
+void
+DbMgr::beginTransaction()
+{
+  const char* sql = "BEGIN TRANSACTION";
+  int rc = exec(m_conn, sql);
+  if (rc != SQLITE_OK) {
+    NDN_THROW(ExecuteError(sql));
+  }
+}
+
+void
+DbMgr::commitTransaction()
+{
+  const char* sql = "COMMIT TRANSACTION";
+  int rc = exec(m_conn, sql);
+  if (rc != SQLITE_OK) {
+    NDN_THROW(ExecuteError(sql));
+  }
+}
+
+void
+DbMgr::rollbackTransaction()
+{
+  const char* sql = "ROLLBACK TRANSACTION";
+  int rc = exec(m_conn, sql);
+  if (rc != SQLITE_OK) {
+    NDN_THROW(ExecuteError(sql));
+  }
+}
+
 void
 DbMgr::saveName(const Name& name, sqlite3_stmt* stmt, int iCol, bool isStatic)
 {
@@ -181,7 +248,7 @@ DbMgr::insert(Zone& zone)
   saveName(zone.getName(), stmt, 1);
   sqlite3_bind_int(stmt,  2, zone.getTtl().count());
 
-  rc = sqlite3_step(stmt);
+  rc = step(stmt);
   if (rc != SQLITE_DONE) {
     sqlite3_finalize(stmt);
     NDN_THROW(ExecuteError(sql));
@@ -215,7 +282,7 @@ DbMgr::setZoneInfo(Zone& zone,
   sqlite3_bind_text(stmt, 2, key.data(),   key.length(), SQLITE_STATIC);
   sqlite3_bind_blob(stmt, 3, value.data(), value.size(), SQLITE_STATIC);
 
-  rc = sqlite3_step(stmt);
+  rc = step(stmt);
   if (rc != SQLITE_DONE) {
     sqlite3_finalize(stmt);
     NDN_THROW(ExecuteError(sql));
@@ -247,7 +314,7 @@ DbMgr::getZoneInfo(Zone& zone)
 
   sqlite3_bind_int(stmt, 1, zone.getId());
 
-  while (sqlite3_step(stmt) == SQLITE_ROW) {
+  while (step(stmt) == SQLITE_ROW) {
     const char* key = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
     rtn[string(key)] = Block(span(static_cast<const uint8_t*>(sqlite3_column_blob(stmt, 1)),
                                   sqlite3_column_bytes(stmt, 1)));
@@ -269,7 +336,7 @@ DbMgr::find(Zone& zone)
 
   saveName(zone.getName(), stmt, 1);
 
-  if (sqlite3_step(stmt) == SQLITE_ROW) {
+  if (step(stmt) == SQLITE_ROW) {
     zone.setId(sqlite3_column_int64(stmt, 0));
     zone.setTtl(time::seconds(sqlite3_column_int(stmt, 1)));
   }
@@ -294,7 +361,7 @@ DbMgr::listZones()
 
   std::vector<Zone> vec;
 
-  while (sqlite3_step(stmt) == SQLITE_ROW) {
+  while (step(stmt) == SQLITE_ROW) {
     vec.emplace_back();
     Zone& zone = vec.back();
     zone.setId(sqlite3_column_int64(stmt, 0));
@@ -321,7 +388,7 @@ DbMgr::remove(Zone& zone)
 
   sqlite3_bind_int64(stmt, 1, zone.getId());
 
-  rc = sqlite3_step(stmt);
+  rc = step(stmt);
   if (rc != SQLITE_DONE) {
     sqlite3_finalize(stmt);
     NDN_THROW(ExecuteError(sql));
@@ -368,7 +435,7 @@ DbMgr::insert(Rrset& rrset)
   sqlite3_bind_int64(stmt, 5, rrset.getTtl().count());
   sqlite3_bind_blob(stmt,  6, rrset.getData().data(),    rrset.getData().size(),    SQLITE_STATIC);
 
-  rc = sqlite3_step(stmt);
+  rc = step(stmt);
   if (rc != SQLITE_DONE) {
     sqlite3_finalize(stmt);
     NDN_THROW(ExecuteError(sql));
@@ -406,7 +473,7 @@ DbMgr::find(Rrset& rrset)
   saveName(rrset.getLabel(), stmt, 2);
   sqlite3_bind_blob(stmt, 3, rrset.getType().data(), rrset.getType().size(), SQLITE_STATIC);
 
-  if (sqlite3_step(stmt) == SQLITE_ROW) {
+  if (step(stmt) == SQLITE_ROW) {
     rrset.setId(sqlite3_column_int64(stmt, 0));
     rrset.setTtl(time::seconds(sqlite3_column_int64(stmt, 1)));
     rrset.setVersion(name::Component(Block(span(static_cast<const uint8_t*>(sqlite3_column_blob(stmt, 2)),
@@ -450,7 +517,7 @@ DbMgr::findLowerBound(Rrset& rrset)
   saveName(rrset.getLabel(), stmt, 2);
   sqlite3_bind_blob(stmt, 3, rrset.getType().data(), rrset.getType().size(), SQLITE_STATIC);
 
-  if (sqlite3_step(stmt) == SQLITE_ROW) {
+  if (step(stmt) == SQLITE_ROW) {
     rrset.setId(sqlite3_column_int64(stmt, 0));
     rrset.setTtl(time::seconds(sqlite3_column_int64(stmt, 1)));
     rrset.setVersion(name::Component(Block(span(static_cast<const uint8_t*>(sqlite3_column_blob(stmt, 2)),
@@ -486,7 +553,7 @@ DbMgr::findRrsets(Zone& zone)
   }
   sqlite3_bind_int64(stmt, 1, zone.getId());
 
-  while (sqlite3_step(stmt) == SQLITE_ROW) {
+  while (step(stmt) == SQLITE_ROW) {
     vec.emplace_back(&zone);
     Rrset& rrset = vec.back();
 
@@ -524,7 +591,7 @@ DbMgr::removeRrsetsOfZoneByType(Zone& zone, const name::Component& type)
   sqlite3_bind_int64(stmt, 1, zone.getId());
   sqlite3_bind_blob(stmt,  2, type.data(), type.size(), SQLITE_STATIC);
 
-  rc = sqlite3_step(stmt);
+  rc = step(stmt);
   if (rc != SQLITE_DONE) {
     sqlite3_finalize(stmt);
     NDN_THROW(ExecuteError(sql));
@@ -547,7 +614,7 @@ DbMgr::remove(Rrset& rrset)
 
   sqlite3_bind_int64(stmt, 1, rrset.getId());
 
-  rc = sqlite3_step(stmt);
+  rc = step(stmt);
   if (rc != SQLITE_DONE) {
     sqlite3_finalize(stmt);
     NDN_THROW(ExecuteError(sql));
@@ -581,9 +648,88 @@ DbMgr::update(Rrset& rrset)
   sqlite3_bind_blob(stmt,  3, rrset.getData().data(),    rrset.getData().size(),    SQLITE_STATIC);
   sqlite3_bind_int64(stmt, 4, rrset.getId());
 
-  sqlite3_step(stmt);
+  step(stmt);
   sqlite3_finalize(stmt);
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Validator cache
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+void
+DbMgr::insert(ValidatorCacheType type, const Data& data, time::system_clock::time_point expiry)
+{
+  sqlite3_stmt* stmt;
+  const char* sql = "INSERT OR REPLACE INTO validator_cache (type, name, data, expires) "
+                    "VALUES (?, ?, ?, ?)";
+  int rc = sqlite3_prepare_v2(m_conn, sql, -1, &stmt, nullptr);
+  if (rc != SQLITE_OK) {
+    NDN_THROW(PrepareError(sql));
+  }
+
+  const Block& wire = data.wireEncode();
+  sqlite3_bind_int(stmt,   1, static_cast<int>(type));
+  saveName(data.getName(), stmt, 2);
+  sqlite3_bind_blob(stmt,  3, wire.data(), wire.size(), SQLITE_STATIC);
+  sqlite3_bind_int64(stmt, 4, time::toUnixTimestamp(expiry).count());
+
+  rc = step(stmt);
+  if (rc != SQLITE_DONE) {
+    sqlite3_finalize(stmt);
+    NDN_THROW(ExecuteError(sql));
+  }
+
+  sqlite3_finalize(stmt);
+}
+
+std::vector<std::pair<Data, time::system_clock::time_point>>
+DbMgr::find(ValidatorCacheType type)
+{
+  sqlite3_stmt* stmt;
+  const char* sql = "SELECT data, expires FROM validator_cache WHERE type=? AND expires>?";
+  int rc = sqlite3_prepare_v2(m_conn, sql, -1, &stmt, nullptr);
+  if (rc != SQLITE_OK) {
+    NDN_THROW(PrepareError(sql));
+  }
+
+  sqlite3_bind_int(stmt,   1, static_cast<int>(type));
+  sqlite3_bind_int64(stmt, 2, time::toUnixTimestamp(time::system_clock::now()).count());
+
+  std::vector<std::pair<Data, time::system_clock::time_point>> entries;
+  while (step(stmt) == SQLITE_ROW) {
+    try {
+      Data data(Block(span(static_cast<const uint8_t*>(sqlite3_column_blob(stmt, 0)),
+                           sqlite3_column_bytes(stmt, 0))));
+      auto expiry = time::fromUnixTimestamp(time::milliseconds(sqlite3_column_int64(stmt, 1)));
+      entries.emplace_back(std::move(data), expiry);
+    }
+    catch (const ndn::tlv::Error& e) {
+      NDNS_LOG_WARN("skip malformed validator cache entry: " << e.what());
+    }
+  }
+
+  sqlite3_finalize(stmt);
+  return entries;
+}
+
+void
+DbMgr::removeExpiredValidatorCacheEntries()
+{
+  sqlite3_stmt* stmt;
+  const char* sql = "DELETE FROM validator_cache WHERE expires<=?";
+  int rc = sqlite3_prepare_v2(m_conn, sql, -1, &stmt, nullptr);
+  if (rc != SQLITE_OK) {
+    NDN_THROW(PrepareError(sql));
+  }
+
+  sqlite3_bind_int64(stmt, 1, time::toUnixTimestamp(time::system_clock::now()).count());
+
+  rc = step(stmt);
+  sqlite3_finalize(stmt);
+  if (rc != SQLITE_DONE) {
+    NDN_THROW(ExecuteError(sql));
+  }
+}
+
 } // namespace ndns
 } // namespace ndn
@@ -88,6 +88,24 @@ public:
   void
   clearAllData();
 
+  /**
+   * @brief start a transaction, which groups the following writes until commitTransaction()
+   *
+   * Writes inside a transaction are flushed to the database file once, at commit time, which
+   * makes bulk inserts much faster. Transactions cannot be nested.
+   */
+  void
+  beginTransaction();
+
+  void
+  commitTransaction();
+
+  /**
+   * @brief discard the writes made since beginTransaction()
+   */
+  void
+  rollbackTransaction();
+
 public: // Zone manipulation
   DEFINE_ERROR(ZoneError, Error);
 
@@ -205,6 +223,33 @@ public: // Rrset manipulation
   void
   update(Rrset& rrset);
 
+public: // Validator cache
+  /**
+   * @brief kinds of packets the validator of the name server keeps across restarts
+   */
+  enum class ValidatorCacheType {
+    CERTIFICATE = 1, ///< certificate that passed validation
+    NS_LINK = 2, ///< NS response used to fetch certificates
+  };
+
+  /**
+   * @brief add or replace a packet of the validator cache, valid until @p expiry
+   */
+  void
+  insert(ValidatorCacheType type, const Data& data, time::system_clock::time_point expiry);
+
+  /**
+   * @brief get the unexpired packets of the validator cache with their expiry
+   */
+  std::vector<std::pair<Data, time::system_clock::time_point>>
+  find(ValidatorCacheType type);
+
+  /**
+   * @brief remove the expired packets of the validator cache
+   */
+  void
+  removeExpiredValidatorCacheEntries();
+
 public:
   const std::string&
   getDbFile() const
@@ -19,10 +19,16 @@
 
 #include "name-server.hpp"
 #include "logger.hpp"
+#include "tracepoints.hpp"
+#include "util/cert-helper.hpp"
+#include "validator/certificate-fetcher-local-db.hpp"
 
 #include <ndn-cxx/encoding/encoding-buffer.hpp>
 #include <ndn-cxx/security/signing-helpers.hpp>
 
+#include <algorithm>
+#include <set>
+
 namespace ndn {
 namespace ndns {
 
@@ -30,6 +36,16 @@ NDNS_LOG_INIT(NameServer);
 
 constexpr time::milliseconds NAME_SERVER_DEFAULT_CONTENT_FRESHNESS{4000};
 
+/**
+ * @brief maximum number of segments kept in memory, e.g., 8 MB with the default segment size
+ */
+constexpr size_t SEGMENT_CACHE_LIMIT = 1024;
+
+/**
+ * @brief maximum number of signed answers to multi-type queries kept in memory
+ */
+constexpr size_t MULTI_ANSWER_CACHE_LIMIT = 256;
+
 NameServer::NameServer(const Name& zoneName, const Name& certName, Face& face, DbMgr& dbMgr,
                        KeyChain& keyChain, security::Validator& validator)
   : m_zone(zoneName)
@@ -40,6 +56,8 @@ NameServer::NameServer(const Name& zoneName, const Name& certName, Face& face, D
   , m_face(face)
   , m_keyChain(keyChain)
   , m_validator(validator)
+  , m_segments(SEGMENT_CACHE_LIMIT)
+  , m_multiAnswers(MULTI_ANSWER_CACHE_LIMIT)
 {
   m_dbMgr.find(m_zone);
 
@@ -65,18 +83,86 @@ void
 NameServer::onInterest(const Name& prefix, const Interest& interest)
 {
   label::MatchResult re;
-  if (!label::matchName(interest, m_zone.getName(), re))
+  bool isMatched = false;
+  {
+    ScopedStageTimer timer(getStageHistogram(StageHistograms::MATCH));
+    isMatched = label::matchName(interest, m_zone.getName(), re);
+  }
+  if (!isMatched)
     return;
 
   if (re.rrType == ndns::label::NDNS_UPDATE_LABEL) {
+    NDNS_TRACE2(update_start, interest.getName().wireEncode().data(),
+                interest.getName().wireEncode().size());
     this->handleUpdate(prefix, interest, re); // NDNS Update
+    NDNS_TRACE(update_done);
   }
   else {
-    this->handleQuery(prefix, interest, re);  // NDNS Iterative query
+    auto receiveTime = m_queryLog != nullptr ? time::steady_clock::now() :
+                                               time::steady_clock::time_point();
+    NDNS_TRACE2(query_start, interest.getName().wireEncode().data(),
+                interest.getName().wireEncode().size());
+    auto outcome = this->handleQuery(prefix, interest, re);  // NDNS Iterative query
+    NDNS_TRACE1(query_done, static_cast<int>(outcome));
+    ++m_counters.nQueries;
+    switch (outcome) {
+      case QueryLogEntry::ANSWER:
+      case QueryLogEntry::BUNDLE:
+        ++m_counters.nAnswers;
+        break;
+      case QueryLogEntry::NACK:
+        ++m_counters.nNacks;
+        break;
+      default:
+        ++m_counters.nUnanswered;
+        break;
+    }
+    logQuery(QueryLogEntry::QUERY, outcome, re.rrLabel, re.rrType, receiveTime);
+  }
+}
+
+void
+NameServer::put(const Data& data)
+{
+  ScopedStageTimer timer(getStageHistogram(StageHistograms::PUT));
+  m_face.put(data);
+}
+
+void
+NameServer::addStageTime(StageHistograms::Stage stage, time::steady_clock::time_point start)
+{
+  LatencyHistogram* histogram = getStageHistogram(stage);
+  if (histogram != nullptr && start != time::steady_clock::time_point()) {
+    histogram->add(time::steady_clock::now() - start);
   }
 }
 
+bool
+NameServer::findRrset(Rrset& rrset)
+{
+  ScopedCounterTimer timer(m_counters.nDbOperations, m_counters.dbTime,
+                           getStageHistogram(StageHistograms::DATABASE));
+  return m_dbMgr.find(rrset);
+}
+
 void
+NameServer::logQuery(QueryLogEntry::Kind kind, QueryLogEntry::Outcome outcome, const Name& label,
+                     const name::Component& rrType, time::steady_clock::time_point receiveTime)
+{
+  if (m_queryLog == nullptr) {
+    return;
+  }
+
+  QueryLogEntry entry{};
+  entry.setTimestamp(time::system_clock::now());
+  entry.setLatency(time::steady_clock::now() - receiveTime);
+  entry.kind = kind;
+  entry.outcome = outcome;
+  entry.setNames(m_zone.getName(), label, rrType);
+  m_queryLog->add(entry);
+}
+
+QueryLogEntry::Outcome
 NameServer::handleQuery(const Name& prefix, const Interest& interest, const label::MatchResult& re)
 {
   Rrset rrset(&m_zone);
@@ -85,40 +171,155 @@ NameServer::handleQuery(const Name& prefix, const Interest& interest, const labe
 
   NDNS_LOG_TRACE("query record: " << interest.getName());
 
-  if (m_dbMgr.find(rrset) &&
+  if (!re.segment.empty()) {
+    auto segment = m_segments.find(interest.getName());
+    if (segment != nullptr) {
+      NDNS_LOG_TRACE("answer query with cached segment: " << segment->getName());
+      ++m_counters.nSegmentCacheHits;
+      put(*segment);
+      return QueryLogEntry::ANSWER;
+    }
+  }
+
+  if (m_isBundleEnabled && re.rrLabel.empty() && re.rrType == label::BUNDLE_RR_TYPE) {
+    return handleBundleQuery(interest, re) ? QueryLogEntry::BUNDLE : QueryLogEntry::NO_ANSWER;
+  }
+
+  auto rrTypes = label::parseMultiRrType(re.rrType);
+  if (!rrTypes.empty()) {
+    return handleMultiQuery(interest, re, rrTypes);
+  }
+
+  if (findRrset(rrset) &&
       (re.version.empty() || re.version == rrset.getVersion())) {
     // find the record: NDNS-RESP, NDNS-AUTH, NDNS-RAW, or NDNS-NACK
-    shared_ptr<Data> answer = make_shared<Data>(rrset.getData());
-    NDNS_LOG_TRACE("answer query with existing Data: " << answer->getName());
-    m_face.put(*answer);
+    Name name(m_ndnsPrefix);
+    name.append(re.rrLabel).append(re.rrType).append(rrset.getVersion());
+    return putRecord(rrset.getData(), name, re.segment) ? QueryLogEntry::ANSWER :
+                                                          QueryLogEntry::NO_ANSWER;
   }
   else {
+    return putNack(interest, re);
+  }
+}
+
+QueryLogEntry::Outcome
+NameServer::putNack(const Interest& interest, const label::MatchResult& re)
+{
+  Block doe = findDoe(re.rrLabel, re.rrType).getData();
+  shared_ptr<Data> answer;
+  {
+    ScopedStageTimer timer(getStageHistogram(StageHistograms::ENCODE));
     Name name = interest.getName();
     name.appendVersion();
-    shared_ptr<Data> answer = make_shared<Data>(name);
-    Rrset doe(&m_zone);
-    // currently, there is only one DoE record contains everything
-    doe.setLabel(Name(re.rrLabel).append(re.rrType));
-    doe.setType(label::DOE_RR_TYPE);
-    if (!m_dbMgr.findLowerBound(doe)) {
-        NDNS_LOG_FATAL("fail to find DoE record of zone:" + m_zone.getName().toUri());
-        NDN_THROW(std::runtime_error("fail to find DoE record of zone:" + m_zone.getName().toUri()));
-    }
-
-    answer->setContent(doe.getData());
+    answer = make_shared<Data>(name);
+    answer->setContent(doe);
     answer->setFreshnessPeriod(this->getContentFreshness());
     answer->setContentType(NDNS_NACK);
+  }
+  {
     // give this NACk a random signature
+    ScopedCounterTimer timer(m_counters.nSignings, m_counters.signingTime,
+                             getStageHistogram(StageHistograms::SIGN));
     m_keyChain.sign(*answer);
+  }
+
+  NDNS_LOG_TRACE("answer query with NDNS-NACK: " << answer->getName());
+  put(*answer);
+  return QueryLogEntry::NACK;
+}
 
-    NDNS_LOG_TRACE("answer query with NDNS-NACK: " << answer->getName());
-    m_face.put(*answer);
+Rrset
+NameServer::findDoe(const Name& label, const name::Component& rrType)
+{
+  ScopedCounterTimer timer(m_counters.nDbOperations, m_counters.dbTime,
+                           getStageHistogram(StageHistograms::DATABASE));
+  Rrset doe(&m_zone);
+  // currently, there is only one DoE record contains everything
+  doe.setLabel(Name(label).append(rrType));
+  doe.setType(label::DOE_RR_TYPE);
+  if (!m_dbMgr.findLowerBound(doe)) {
+    NDNS_LOG_FATAL("fail to find DoE record of zone:" + m_zone.getName().toUri());
+    NDN_THROW(std::runtime_error("fail to find DoE record of zone:" + m_zone.getName().toUri()));
   }
+  return doe;
+}
+
+QueryLogEntry::Outcome
+NameServer::handleMultiQuery(const Interest& interest, const label::MatchResult& re,
+                             const std::vector<name::Component>& rrTypes)
+{
+  Block content(ndn::tlv::Content);
+  uint64_t version = 0;
+  for (const auto& rrType : rrTypes) {
+    Rrset rrset(&m_zone);
+    rrset.setLabel(re.rrLabel);
+    rrset.setType(rrType);
+    if (!findRrset(rrset)) {
+      // the DoE record is signed by the zone, so the absence can be verified on its own
+      rrset = findDoe(re.rrLabel, rrType);
+    }
+    content.push_back(rrset.getData());
+    if (rrset.getVersion().isVersion()) {
+      version = std::max(version, rrset.getVersion().toVersion());
+    }
+  }
+
+  // the version is chosen here, a version requested by the client only selects the answer
+  Name prefix(m_ndnsPrefix);
+  prefix.append(re.rrLabel).append(re.rrType);
+  Name name(prefix);
+  name.appendVersion(version);
+  if (!re.version.empty() && re.version != name.get(-1)) {
+    return putNack(interest, re);
+  }
+
+  shared_ptr<const Data> answer;
+  {
+    ScopedStageTimer timer(getStageHistogram(StageHistograms::ENCODE));
+    content.encode();
+    // the signed answer is reused as long as the records it carries are unchanged
+    answer = m_multiAnswers.find(name);
+    if (answer != nullptr && answer->getContent() != content) {
+      answer = nullptr;
+    }
+  }
+
+  if (answer != nullptr) {
+    ++m_counters.nMultiCacheHits;
+  }
+  else {
+    ++m_counters.nMultiCacheMisses;
+    shared_ptr<Data> data;
+    {
+      ScopedStageTimer timer(getStageHistogram(StageHistograms::ENCODE));
+      data = make_shared<Data>(name);
+      data->setContent(content);
+      data->setContentType(NDNS_MULTI);
+      data->setFreshnessPeriod(this->getContentFreshness());
+    }
+    {
+      ScopedCounterTimer timer(m_counters.nSignings, m_counters.signingTime,
+                               getStageHistogram(StageHistograms::SIGN));
+      m_keyChain.sign(*data, signingByCertificate(m_certName));
+    }
+    m_multiAnswers.erase(prefix, true);
+    m_multiAnswers.insert(*data);
+    answer = data;
+  }
+
+  NDNS_LOG_TRACE("answer multi-type query with " << rrTypes.size() << " records: "
+                 << answer->getName());
+  // the records may be large, up to MAX_MULTI_RR_TYPES of them do not fit in one packet
+  return putRecord(answer->wireEncode(), answer->getName(), re.segment) ?
+         QueryLogEntry::ANSWER : QueryLogEntry::NO_ANSWER;
 }
 
 void
 NameServer::handleUpdate(const Name& prefix, const Interest& interest, const label::MatchResult& re)
 {
+  auto receiveTime = m_queryLog != nullptr ? time::steady_clock::now() :
+                                             time::steady_clock::time_point();
   if (re.rrLabel.size() == 1) {
     // for current, we only allow Update message contains one Data, and ignore others
     auto it = re.rrLabel.begin();
@@ -130,15 +331,153 @@ NameServer::handleUpdate(const Name& prefix, const Interest& interest, const lab
     }
     catch (const std::exception& e) {
       NDNS_LOG_WARN("exception when getting update info: " << e.what());
+      ++m_counters.nUpdatesRejected;
+      logQuery(QueryLogEntry::UPDATE, QueryLogEntry::UPDATE_INVALID, Name(), re.rrType,
+               receiveTime);
       return;
     }
-    m_validator.validate(*data,
-                         bind(&NameServer::doUpdate, this, interest.shared_from_this(), data),
-                         [] (const Data&, const security::ValidationError&) {
-                           NDNS_LOG_WARN("Ignoring update that did not pass the verification. "
-                                         "Check the root certificate");
-                         });
+    auto validationStart = m_stageHistograms != nullptr ? time::steady_clock::now() :
+                                                          time::steady_clock::time_point();
+    auto onValidated = [this, interest = interest.shared_from_this(), data, receiveTime,
+                        validationStart] (const Data&) {
+      addStageTime(StageHistograms::VALIDATE, validationStart);
+      doUpdate(interest, data, receiveTime);
+    };
+    auto onFailed = [this, receiveTime, validationStart] (const Data&,
+                                                          const security::ValidationError&) {
+      addStageTime(StageHistograms::VALIDATE, validationStart);
+      NDNS_LOG_WARN("Ignoring update that did not pass the verification. "
+                    "Check the root certificate");
+      ++m_counters.nValidationFailures;
+      logQuery(QueryLogEntry::UPDATE, QueryLogEntry::UPDATE_INVALID, Name(),
+               label::NDNS_UPDATE_LABEL, receiveTime);
+    };
+
+    if (m_updateVerifier != nullptr) {
+      m_updateVerifier->verify(data, onValidated, onFailed);
+    }
+    else if (m_validationCache != nullptr) {
+      m_validationCache->validate(m_validator, *data, onValidated, onFailed);
+    }
+    else {
+      m_validator.validate(*data, onValidated, onFailed);
+    }
+  }
+}
+
+bool
+NameServer::putRecord(const Block& record, const Name& versionedName,
+                      const name::Component& segment)
+{
+  if (record.size() <= m_segmentSize && segment.empty()) {
+    NDNS_LOG_TRACE("answer query with existing Data: " << versionedName);
+    Data answer;
+    {
+      ScopedStageTimer timer(getStageHistogram(StageHistograms::ENCODE));
+      answer.wireDecode(record);
+    }
+    put(answer);
+    return true;
+  }
+
+  uint64_t segmentNo = segment.empty() ? 0 : segment.toSegment();
+  auto cached = m_segments.find(Name(versionedName).appendSegment(segmentNo));
+  if (cached != nullptr) {
+    NDNS_LOG_TRACE("answer query with cached segment: " << cached->getName());
+    ++m_counters.nSegmentCacheHits;
+    put(*cached);
+    return true;
+  }
+
+  // all segments are made at once, the requester is about to ask for the following ones
+  ++m_counters.nSegmentCacheMisses;
+  std::vector<shared_ptr<Data>> segments;
+  {
+    ScopedCounterTimer timer(m_counters.nSignings, m_counters.signingTime,
+                             getStageHistogram(StageHistograms::SIGN));
+    segments = makeRecordSegments(record, versionedName, m_segmentSize,
+                                  this->getContentFreshness(), m_keyChain);
+  }
+  for (const auto& data : segments) {
+    m_segments.insert(*data);
   }
+  if (segmentNo >= segments.size()) {
+    NDNS_LOG_DEBUG(versionedName << " has no segment " << segmentNo);
+    return false;
+  }
+
+  NDNS_LOG_TRACE("answer query with segment " << segmentNo << "/" << segments.size()
+                 << " of " << versionedName);
+  put(*segments[segmentNo]);
+  return true;
+}
+
+bool
+NameServer::handleBundleQuery(const Interest& interest, const label::MatchResult& re)
+{
+  auto now = time::steady_clock::now();
+  if (m_bundle == nullptr || now >= m_bundleExpiry) {
+    // the chain is rebuilt periodically, to pick up new certificates of the zone
+    ++m_counters.nBundleCacheMisses;
+    CertificateBundle bundle = makeCertificateBundle();
+    {
+      ScopedStageTimer timer(getStageHistogram(StageHistograms::ENCODE));
+      Name name(m_ndnsPrefix);
+      name.append(label::BUNDLE_RR_TYPE).appendVersion();
+      m_bundle = bundle.toData(name);
+      m_bundle->setFreshnessPeriod(this->getContentFreshness());
+    }
+    {
+      ScopedCounterTimer timer(m_counters.nSignings, m_counters.signingTime,
+                               getStageHistogram(StageHistograms::SIGN));
+      m_keyChain.sign(*m_bundle, signingByCertificate(m_certName));
+    }
+    m_bundleExpiry = now + this->getContentFreshness();
+    NDNS_LOG_DEBUG("certificate bundle " << m_bundle->getName() << " has "
+                   << bundle.getCertificates().size() << " certificates");
+  }
+  else {
+    ++m_counters.nBundleCacheHits;
+  }
+
+  if (!re.version.empty() && re.version != m_bundle->getName().get(-1)) {
+    // segments of a previous bundle, which has been evicted
+    NDNS_LOG_DEBUG("certificate bundle " << interest.getName() << " is outdated");
+    return false;
+  }
+  NDNS_LOG_TRACE("answer query with certificate bundle: " << m_bundle->getName());
+  return putRecord(m_bundle->wireEncode(), m_bundle->getName(), re.segment);
+}
+
+CertificateBundle
+NameServer::makeCertificateBundle() const
+{
+  constexpr size_t MAX_BUNDLE_SIZE = 16;
+
+  CertificateBundle bundle;
+  std::optional<security::Certificate> cert;
+  try {
+    cert = CertHelper::getCertificate(m_keyChain, m_certName);
+  }
+  catch (const std::exception& e) {
+    NDNS_LOG_WARN("cannot find certificate " << m_certName << " of the zone: " << e.what());
+    return bundle;
+  }
+
+  std::set<Name> seen;
+  while (cert && bundle.getCertificates().size() < MAX_BUNDLE_SIZE &&
+         seen.insert(cert->getName()).second) {
+    bundle.addCertificate(*cert);
+
+    auto keyLocator = cert->getKeyLocator();
+    if (!keyLocator || keyLocator->getType() != ndn::tlv::Name ||
+        keyLocator->getName().isPrefixOf(cert->getName())) {
+      // self-signed
+      break;
+    }
+    cert = CertificateFetcherLocalDb::findLocalCertificate(m_dbMgr, keyLocator->getName());
+  }
+  return bundle;
 }
 
 void
@@ -151,12 +490,22 @@ NameServer::onRegisterFailed(const ndn::Name& prefix, const std::string& reason)
 
 void
 NameServer::doUpdate(const shared_ptr<const Interest>& interest,
-                     const shared_ptr<const Data>& data)
+                     const shared_ptr<const Data>& data,
+                     time::steady_clock::time_point receiveTime)
 {
+  NDNS_TRACE2(do_update_start, data->getName().wireEncode().data(),
+              data->getName().wireEncode().size());
+
   label::MatchResult re;
   try {
-    if (!label::matchName(*data, m_zone.getName(), re))
+    ScopedStageTimer timer(getStageHistogram(StageHistograms::MATCH));
+    if (!label::matchName(*data, m_zone.getName(), re)) {
+      ++m_counters.nUpdatesRejected;
+      logQuery(QueryLogEntry::UPDATE, QueryLogEntry::UPDATE_INVALID, Name(),
+               label::NDNS_UPDATE_LABEL, receiveTime);
+      NDNS_TRACE1(do_update_done, static_cast<int>(QueryLogEntry::UPDATE_INVALID));
       return;
+    }
   }
   catch (const std::exception& e) {
     NDNS_LOG_INFO("Error while name/certificate matching: " << e.what());
@@ -166,24 +515,34 @@ NameServer::doUpdate(const shared_ptr<const Interest>& interest,
   rrset.setLabel(re.rrLabel);
   rrset.setType(re.rrType);
 
-  Name name = interest->getName();
-  name.appendVersion();
-  shared_ptr<Data> answer = make_shared<Data>(name);
-  answer->setFreshnessPeriod(this->getContentFreshness());
-  answer->setContentType(NDNS_RESP);
+  shared_ptr<Data> answer;
+  {
+    ScopedStageTimer timer(getStageHistogram(StageHistograms::ENCODE));
+    Name name = interest->getName();
+    name.appendVersion();
+    answer = make_shared<Data>(name);
+    answer->setFreshnessPeriod(this->getContentFreshness());
+    answer->setContentType(NDNS_RESP);
+  }
 
   Block blk(ndn::ndns::tlv::RrData);
+  auto outcome = QueryLogEntry::UPDATE_FAILURE;
   try {
-    if (m_dbMgr.find(rrset)) {
+    if (findRrset(rrset)) {
       const name::Component& newVersion = re.version;
       if (newVersion > rrset.getVersion()) {
         // update existing record
         rrset.setVersion(newVersion);
         rrset.setData(data->wireEncode());
-        m_dbMgr.update(rrset);
+        {
+          ScopedCounterTimer timer(m_counters.nDbOperations, m_counters.dbTime,
+                                   getStageHistogram(StageHistograms::DATABASE));
+          m_dbMgr.update(rrset);
+        }
         blk.push_back(makeNonNegativeIntegerBlock(ndn::ndns::tlv::UpdateReturnCode, UPDATE_OK));
         blk.encode(); // must
         answer->setContent(blk);
+        outcome = QueryLogEntry::UPDATE_OK;
         NDNS_LOG_TRACE("replace old record and answer update with UPDATE_OK");
       }
       else {
@@ -198,10 +557,15 @@ NameServer::doUpdate(const shared_ptr<const Interest>& interest,
       rrset.setVersion(re.version);
       rrset.setData(data->wireEncode());
       rrset.setTtl(m_zone.getTtl());
-      m_dbMgr.insert(rrset);
+      {
+        ScopedCounterTimer timer(m_counters.nDbOperations, m_counters.dbTime,
+                                 getStageHistogram(StageHistograms::DATABASE));
+        m_dbMgr.insert(rrset);
+      }
       blk.push_back(makeNonNegativeIntegerBlock(ndn::ndns::tlv::UpdateReturnCode, UPDATE_OK));
       blk.encode();
       answer->setContent(blk);
+      outcome = QueryLogEntry::UPDATE_OK;
       NDNS_LOG_TRACE("insert new record and answer update with UPDATE_OK");
     }
   }
@@ -213,8 +577,20 @@ NameServer::doUpdate(const shared_ptr<const Interest>& interest,
                   << ". Update may need sudo privilege to write DbFile");
     NDNS_LOG_TRACE("exception happens and answer update with UPDATE_FAILURE");
   }
-  m_keyChain.sign(*answer, signingByCertificate(m_certName));
-  m_face.put(*answer);
+  {
+    ScopedCounterTimer timer(m_counters.nSignings, m_counters.signingTime,
+                             getStageHistogram(StageHistograms::SIGN));
+    m_keyChain.sign(*answer, signingByCertificate(m_certName));
+  }
+  put(*answer);
+  if (outcome == QueryLogEntry::UPDATE_OK) {
+    ++m_counters.nUpdatesAccepted;
+  }
+  else {
+    ++m_counters.nUpdatesRejected;
+  }
+  logQuery(QueryLogEntry::UPDATE, outcome, re.rrLabel, re.rrType, receiveTime);
+  NDNS_TRACE1(do_update_done, static_cast<int>(outcome));
 }
 
 } // namespace ndns
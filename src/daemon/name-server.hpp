@@ -23,12 +23,20 @@
 #include "zone.hpp"
 #include "rrset.hpp"
 #include "db-mgr.hpp"
+#include "query-log.hpp"
+#include "stage-histograms.hpp"
+#include "zone-status.hpp"
 #include "ndns-label.hpp"
 #include "ndns-tlv.hpp"
+#include "validator/certificate-bundle.hpp"
+#include "validator/update-verifier.hpp"
+#include "validator/validation-cache.hpp"
 #include "validator/validator.hpp"
+#include "util/segmented-record.hpp"
 
 #include <ndn-cxx/security/key-chain.hpp>
 #include <ndn-cxx/face.hpp>
+#include <ndn-cxx/ims/in-memory-storage-lru.hpp>
 
 #include <sstream>
 #include <stdexcept>
@@ -56,8 +64,9 @@ NDNS_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
 
   /**
    * @brief handle NDNS query message
+   * @return how the query was answered
    */
-  void
+  QueryLogEntry::Outcome
   handleQuery(const Name& prefix, const Interest& interest, const label::MatchResult& re);
 
   /**
@@ -70,7 +79,96 @@ NDNS_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
   onRegisterFailed(const ndn::Name& prefix, const std::string& reason);
 
   void
-  doUpdate(const shared_ptr<const Interest>& interest, const shared_ptr<const Data>& data);
+  doUpdate(const shared_ptr<const Interest>& interest, const shared_ptr<const Data>& data,
+           time::steady_clock::time_point receiveTime);
+
+  /**
+   * @brief send @p data on the face, timing the PUT stage
+   */
+  void
+  put(const Data& data);
+
+  /**
+   * @return the histogram of @p stage, or nullptr if stage histograms are disabled
+   */
+  LatencyHistogram*
+  getStageHistogram(StageHistograms::Stage stage)
+  {
+    return m_stageHistograms != nullptr ? &m_stageHistograms->get(stage) : nullptr;
+  }
+
+  /**
+   * @brief add the time elapsed since @p start to the histogram of @p stage, if enabled
+   */
+  void
+  addStageTime(StageHistograms::Stage stage, time::steady_clock::time_point start);
+
+  /**
+   * @brief find @p rrset in the database, counting the time spent
+   */
+  bool
+  findRrset(Rrset& rrset);
+
+  /**
+   * @brief add an entry to the query log, if one is set
+   */
+  void
+  logQuery(QueryLogEntry::Kind kind, QueryLogEntry::Outcome outcome, const Name& label,
+           const name::Component& rrType, time::steady_clock::time_point receiveTime);
+
+  /**
+   * @brief answer a query for several RR types of a label with one NDNS_MULTI record
+   *
+   * The version of the answer is the newest version of the records it carries, and the signed
+   * answer is reused by later queries as long as these records are unchanged, so that repeated
+   * queries do not cost one signing each. A query for another version is answered with a NACK.
+   * Answers larger than the segment size are segmented like records.
+   *
+   * @return how the query was answered
+   */
+  QueryLogEntry::Outcome
+  handleMultiQuery(const Interest& interest, const label::MatchResult& re,
+                   const std::vector<name::Component>& rrTypes);
+
+  /**
+   * @brief answer @p interest with an NDNS NACK carrying the DoE record of the queried name
+   */
+  QueryLogEntry::Outcome
+  putNack(const Interest& interest, const label::MatchResult& re);
+
+  /**
+   * @return the DoE record proving the absence of (@p label, @p rrType)
+   * @throw std::runtime_error the zone has no DoE record
+   */
+  Rrset
+  findDoe(const Name& label, const name::Component& rrType);
+
+  /**
+   * @brief answer a query for the certificate bundle of the zone
+   * @return false if the query is not answered
+   */
+  bool
+  handleBundleQuery(const Interest& interest, const label::MatchResult& re);
+
+  /**
+   * @brief answer a query with @p record, segmented if it is larger than the segment size
+   *
+   * @param record wire encoding of the record
+   * @param versionedName name of the record, which ends with its version
+   * @param segment the requested segment, or empty if the query does not ask for a segment
+   * @return false if the requested segment does not exist
+   */
+  bool
+  putRecord(const Block& record, const Name& versionedName, const name::Component& segment);
+
+  /**
+   * @brief collect the certificate chain of the zone from the KeyChain and the database
+   *
+   * The chain starts with the certificate signing the zone's records and follows KeyLocators
+   * as long as the signer certificate is hosted in the database.
+   */
+  CertificateBundle
+  makeCertificateBundle() const;
 
 public:
   const Name&
@@ -85,6 +183,41 @@ public:
     return m_zone;
   }
 
+  /**
+   * @brief enable or disable the latency histograms of the stages of query and update handling
+   *
+   * Disabling the histograms discards them. When disabled, the instrumentation costs a branch
+   * per stage.
+   */
+  void
+  setStageHistogramsEnabled(bool isEnabled)
+  {
+    if (!isEnabled) {
+      m_stageHistograms.reset();
+    }
+    else if (m_stageHistograms == nullptr) {
+      m_stageHistograms = make_unique<StageHistograms>();
+    }
+  }
+
+  /**
+   * @return the stage histograms, or nullptr if they are disabled
+   */
+  const StageHistograms*
+  getStageHistograms() const
+  {
+    return m_stageHistograms.get();
+  }
+
+  /**
+   * @brief counters of the queries and updates handled so far, readable from any thread
+   */
+  const ZoneCounters&
+  getCounters() const
+  {
+    return m_counters;
+  }
+
   const time::milliseconds&
   getContentFreshness() const
   {
@@ -101,6 +234,73 @@ public:
     m_contentFreshness = contentFreshness;
   }
 
+  /**
+   * @brief set the cache of validation results consulted before validating each update
+   *
+   * @p cache can be shared by name servers that use the same validator.
+   */
+  void
+  setValidationCache(ValidationCache* cache)
+  {
+    m_validationCache = cache;
+  }
+
+  /**
+   * @brief enable or disable answering queries for <zone>/NDNS/BUNDLE
+   *
+   * When enabled, the certificate chain of the zone can be retrieved with a single query
+   * (see CertificateBundle), which saves resolvers one lookup per certificate of the chain.
+   */
+  void
+  setCertificateBundleEnabled(bool isEnabled)
+  {
+    m_isBundleEnabled = isEnabled;
+    m_bundle.reset();
+  }
+
+  size_t
+  getSegmentSize() const
+  {
+    return m_segmentSize;
+  }
+
+  /**
+   * @brief set the maximum size of a record served in one packet
+   *
+   * Larger records are served as segmented objects (see makeRecordSegments), with segments of
+   * at most @p segmentSize octets of content.
+   */
+  void
+  setSegmentSize(size_t segmentSize)
+  {
+    BOOST_ASSERT(segmentSize > 0);
+    m_segmentSize = segmentSize;
+    m_segments.erase("/", true);
+  }
+
+  /**
+   * @brief set the verifier of updates, which offloads signature verification to worker threads
+   *
+   * When set, updates are verified by @p verifier instead of the validator, and the validation
+   * cache set by setValidationCache() is not consulted by the name server itself.
+   */
+  void
+  setUpdateVerifier(UpdateVerifier* verifier)
+  {
+    m_updateVerifier = verifier;
+  }
+
+  /**
+   * @brief record every query and update handled by the name server in @p queryLog
+   *
+   * @p queryLog can be shared by name servers that run on the same thread.
+   */
+  void
+  setQueryLog(QueryLog* queryLog)
+  {
+    m_queryLog = queryLog;
+  }
+
 private:
   Zone m_zone;
   DbMgr& m_dbMgr;
@@ -113,6 +313,20 @@ private:
   Face& m_face;
   KeyChain& m_keyChain;
   security::Validator& m_validator;
+  ValidationCache* m_validationCache = nullptr;
+  UpdateVerifier* m_updateVerifier = nullptr;
+  QueryLog* m_queryLog = nullptr;
+
+  size_t m_segmentSize = DEFAULT_SEGMENT_SIZE;
+  InMemoryStorageLru m_segments; ///< segments of the large records recently served
+  InMemoryStorageLru m_multiAnswers; ///< signed answers to multi-type queries, one per query
+
+  bool m_isBundleEnabled = false;
+  shared_ptr<Data> m_bundle;
+  time::steady_clock::time_point m_bundleExpiry;
+
+  ZoneCounters m_counters;
+  unique_ptr<StageHistograms> m_stageHistograms;
 };
 
 } // namespace ndns
@@ -0,0 +1,346 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "query-log.hpp"
+#include "logger.hpp"
+
+#include <boost/filesystem/operations.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+
+namespace ndn {
+namespace ndns {
+
+NDNS_LOG_INIT(QueryLog);
+
+namespace {
+
+struct FileHeader
+{
+  char magic[8];
+  uint32_t entrySize;
+  uint32_t byteOrderMark;
+};
+
+const char MAGIC[8] = {'N', 'D', 'N', 'S', 'Q', 'L', 'O', 'G'};
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+Name
+decodeName(const uint8_t* begin, size_t size)
+{
+  Name name;
+  size_t offset = 0;
+  while (offset < size) {
+    auto [isOk, block] = Block::fromBuffer({begin + offset, size - offset});
+    if (!isOk) {
+      break;
+    }
+    name.append(name::Component(block));
+    offset += block.size();
+  }
+  return name;
+}
+
+size_t
+roundUpToPowerOfTwo(size_t n)
+{
+  size_t result = 1;
+  while (result < n) {
+    result <<= 1;
+  }
+  return result;
+}
+
+} // namespace
+
+void
+QueryLogEntry::setNames(const Name& zone, const Name& label, const name::Component& rrType)
+{
+  size_t offset = 0;
+  auto append = [this, &offset] (const Block& component) -> uint16_t {
+    if ((flags & TRUNCATED) != 0 || !component.hasWire() ||
+        offset + component.size() > NAME_CAPACITY) {
+      flags |= TRUNCATED;
+      return 0;
+    }
+    std::copy(component.begin(), component.end(), names + offset);
+    offset += component.size();
+    return static_cast<uint16_t>(component.size());
+  };
+
+  flags &= ~TRUNCATED;
+  zoneSize = 0;
+  for (const auto& component : zone) {
+    zoneSize += append(component);
+  }
+  labelSize = 0;
+  for (const auto& component : label) {
+    labelSize += append(component);
+  }
+  rrTypeSize = append(rrType);
+}
+
+Name
+QueryLogEntry::getZone() const
+{
+  return decodeName(names, zoneSize);
+}
+
+Name
+QueryLogEntry::getLabel() const
+{
+  return decodeName(names + zoneSize, labelSize);
+}
+
+name::Component
+QueryLogEntry::getRrType() const
+{
+  Name rrType = decodeName(names + zoneSize + labelSize, rrTypeSize);
+  return rrType.empty() ? name::Component() : rrType[0];
+}
+
+void
+QueryLogEntry::setTimestamp(time::system_clock::time_point tp)
+{
+  timestamp = static_cast<uint64_t>(
+    time::duration_cast<time::nanoseconds>(tp.time_since_epoch()).count());
+}
+
+void
+QueryLogEntry::setLatency(time::nanoseconds value)
+{
+  latency = static_cast<uint32_t>(std::clamp<time::nanoseconds::rep>(
+    value.count(), 0, std::numeric_limits<uint32_t>::max()));
+}
+
+const char*
+toString(QueryLogEntry::Kind kind)
+{
+  switch (kind) {
+    case QueryLogEntry::QUERY:
+      return "QUERY";
+    case QueryLogEntry::UPDATE:
+      return "UPDATE";
+  }
+  return "UNKNOWN";
+}
+
+const char*
+toString(QueryLogEntry::Outcome outcome)
+{
+  switch (outcome) {
+    case QueryLogEntry::ANSWER:
+      return "ANSWER";
+    case QueryLogEntry::NACK:
+      return "NACK";
+    case QueryLogEntry::BUNDLE:
+      return "BUNDLE";
+    case QueryLogEntry::NO_ANSWER:
+      return "NO_ANSWER";
+    case QueryLogEntry::UPDATE_OK:
+      return "UPDATE_OK";
+    case QueryLogEntry::UPDATE_FAILURE:
+      return "UPDATE_FAILURE";
+    case QueryLogEntry::UPDATE_INVALID:
+      return "UPDATE_INVALID";
+  }
+  return "UNKNOWN";
+}
+
+QueryLog::QueryLog(const Options& options)
+  : m_options(options)
+  , m_entries(roundUpToPowerOfTwo(std::max<size_t>(options.capacity, 1)))
+  , m_mask(m_entries.size() - 1)
+{
+  // a previous log, e.g., from before a restart, is kept as the first rotated file
+  if (boost::filesystem::exists(m_options.path)) {
+    rotate();
+  }
+  else {
+    openFile();
+  }
+  if (m_hasWriteError) {
+    NDN_THROW(Error("cannot open query log " + m_options.path));
+  }
+  NDNS_LOG_INFO("logging queries to " << m_options.path);
+
+  m_writer = std::thread([this] { run(); });
+}
+
+QueryLog::~QueryLog()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_shouldStop = true;
+  }
+  m_cv.notify_all();
+  m_writer.join();
+
+  NDNS_LOG_INFO("query log wrote " << getNWritten() << " entries, dropped " << getNDropped());
+}
+
+void
+QueryLog::flush()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  uint64_t request = ++m_nFlushRequests;
+  m_cv.notify_all();
+  m_cv.wait(lock, [this, request] { return m_nFlushes >= request; });
+}
+
+void
+QueryLog::run()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_cv.wait_for(lock, std::chrono::milliseconds(m_options.flushInterval.count()),
+                  [this] { return m_shouldStop || m_nFlushRequests > m_nFlushes; });
+    bool shouldStop = m_shouldStop;
+    uint64_t nFlushRequests = m_nFlushRequests;
+
+    lock.unlock();
+    drain();
+    lock.lock();
+
+    if (nFlushRequests > m_nFlushes) {
+      m_nFlushes = nFlushRequests;
+      m_cv.notify_all();
+    }
+    if (shouldStop) {
+      return;
+    }
+  }
+}
+
+void
+QueryLog::drain()
+{
+  size_t tail = m_tail.load(std::memory_order_relaxed);
+  size_t head = m_head.load(std::memory_order_acquire);
+  if (tail == head) {
+    return;
+  }
+
+  while (tail != head) {
+    if (m_fileSize + sizeof(QueryLogEntry) > m_options.maxFileSize &&
+        m_fileSize > sizeof(FileHeader)) {
+      rotate();
+    }
+
+    // entries contiguous in the ring buffer and fitting in the current file
+    size_t index = tail & m_mask;
+    size_t room = m_fileSize < m_options.maxFileSize ?
+                  (m_options.maxFileSize - m_fileSize) / sizeof(QueryLogEntry) : 0;
+    size_t n = std::min({head - tail, m_entries.size() - index, std::max<size_t>(room, 1)});
+
+    if (!m_hasWriteError) {
+      m_file.write(reinterpret_cast<const char*>(&m_entries[index]), n * sizeof(QueryLogEntry));
+      m_fileSize += n * sizeof(QueryLogEntry);
+      if (!m_file) {
+        NDNS_LOG_ERROR("cannot write query log " << m_options.path);
+        m_hasWriteError = true;
+      }
+    }
+    tail += n;
+    m_tail.store(tail, std::memory_order_release);
+  }
+  m_file.flush();
+}
+
+void
+QueryLog::openFile()
+{
+  m_file.close();
+  m_file.clear();
+  m_file.open(m_options.path, std::ios::binary | std::ios::trunc);
+
+  FileHeader header;
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.entrySize = sizeof(QueryLogEntry);
+  header.byteOrderMark = BYTE_ORDER_MARK;
+  m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  m_fileSize = sizeof(header);
+
+  m_hasWriteError = !m_file;
+  if (m_hasWriteError) {
+    NDNS_LOG_ERROR("cannot open query log " << m_options.path);
+  }
+}
+
+void
+QueryLog::rotate()
+{
+  namespace fs = boost::filesystem;
+
+  m_file.close();
+  const std::string& path = m_options.path;
+  boost::system::error_code ec; // missing files are not an error
+  if (m_options.maxFiles == 0) {
+    fs::remove(path, ec);
+  }
+  else {
+    fs::remove(path + "." + to_string(m_options.maxFiles), ec);
+    for (size_t i = m_options.maxFiles; i > 1; --i) {
+      fs::rename(path + "." + to_string(i - 1), path + "." + to_string(i), ec);
+    }
+    fs::rename(path, path + ".1", ec);
+  }
+  NDNS_LOG_DEBUG("rotated query log " << path);
+  openFile();
+}
+
+void
+QueryLog::readFile(const std::string& path,
+                   const std::function<void(const QueryLogEntry&)>& onEntry)
+{
+  std::ifstream is(path, std::ios::binary);
+  if (!is) {
+    NDN_THROW(Error("cannot open " + path));
+  }
+
+  FileHeader header;
+  is.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (!is || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+    NDN_THROW(Error(path + " is not a query log"));
+  }
+  if (header.byteOrderMark != BYTE_ORDER_MARK || header.entrySize != sizeof(QueryLogEntry)) {
+    NDN_THROW(Error(path + " was written by a host of another byte order or by another version"));
+  }
+
+  // a partial entry at the end, e.g., after a crash, is ignored
+  QueryLogEntry entry;
+  while (is.read(reinterpret_cast<char*>(&entry), sizeof(entry))) {
+    onEntry(entry);
+  }
+}
+
+bool
+QueryLog::isQueryLog(const std::string& path)
+{
+  std::ifstream is(path, std::ios::binary);
+  char magic[sizeof(MAGIC)];
+  return is.read(magic, sizeof(magic)) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+} // namespace ndns
+} // namespace ndn
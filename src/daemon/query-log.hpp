@@ -0,0 +1,263 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef NDNS_DAEMON_QUERY_LOG_HPP
+#define NDNS_DAEMON_QUERY_LOG_HPP
+
+#include "common.hpp"
+
+#include <ndn-cxx/util/time.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace ndn {
+namespace ndns {
+
+/**
+ * @brief fixed-layout record of one query or update handled by a name server
+ *
+ * Names are stored as the TLV encodings of their components, back to back, and are truncated
+ * when they do not fit in NAME_CAPACITY octets. Entries are written to query log files as is,
+ * in the byte order of the host.
+ */
+struct QueryLogEntry
+{
+  enum Kind : uint8_t {
+    QUERY = 0,
+    UPDATE = 1,
+  };
+
+  enum Outcome : uint8_t {
+    ANSWER = 0, ///< the record, a segment of it, or a multi-type answer
+    NACK = 1, ///< NDNS NACK proving the absence of the record
+    BUNDLE = 2, ///< the certificate bundle of the zone
+    NO_ANSWER = 3, ///< the query was dropped, e.g., it asks for a segment that does not exist
+    UPDATE_OK = 4,
+    UPDATE_FAILURE = 5, ///< the update was not applied, e.g., its version is not newer
+    UPDATE_INVALID = 6, ///< the update is malformed or failed validation
+  };
+
+  enum Flags : uint8_t {
+    TRUNCATED = 1, ///< some name components did not fit in the entry
+  };
+
+  static constexpr size_t NAME_CAPACITY = 176;
+
+  /**
+   * @brief store @p zone, @p label, and @p rrType, without allocating memory
+   */
+  void
+  setNames(const Name& zone, const Name& label, const name::Component& rrType);
+
+  Name
+  getZone() const;
+
+  Name
+  getLabel() const;
+
+  name::Component
+  getRrType() const;
+
+  time::system_clock::time_point
+  getTimestamp() const
+  {
+    return time::system_clock::time_point(time::nanoseconds(timestamp));
+  }
+
+  void
+  setTimestamp(time::system_clock::time_point tp);
+
+  /**
+   * @brief set the latency, saturated at about 4.3 seconds
+   */
+  void
+  setLatency(time::nanoseconds latency);
+
+  uint64_t timestamp; ///< nanoseconds since the Unix epoch
+  uint32_t latency; ///< nanoseconds between the reception of the Interest and the answer
+  uint8_t kind;
+  uint8_t outcome;
+  uint8_t flags;
+  uint8_t reserved;
+  uint16_t zoneSize; ///< octets of names holding the zone
+  uint16_t labelSize; ///< octets of names holding the label, after the zone
+  uint16_t rrTypeSize; ///< octets of names holding the RR type, after the label
+  uint16_t reserved2;
+  uint8_t names[NAME_CAPACITY];
+};
+
+static_assert(std::is_trivially_copyable<QueryLogEntry>::value, "");
+static_assert(sizeof(QueryLogEntry) == 200, "the layout of QueryLogEntry must not change");
+
+const char*
+toString(QueryLogEntry::Kind kind);
+
+const char*
+toString(QueryLogEntry::Outcome outcome);
+
+/**
+ * @brief binary log of the queries and updates handled by name servers
+ *
+ * Entries are added to a lock-free ring buffer by the thread running the name servers, without
+ * allocating memory, and written to disk by a background thread. When the ring buffer is full,
+ * new entries are dropped and counted. The log is written to Options::path, which is rotated to
+ * `path.1`, `path.2`, ... when it exceeds Options::maxFileSize.
+ *
+ * Each file starts with a header identifying the format and the size of the entries, followed
+ * by QueryLogEntry records; see readFile().
+ */
+class QueryLog : boost::noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    using std::runtime_error::runtime_error;
+  };
+
+  struct Options
+  {
+    std::string path; ///< path of the current log file
+    size_t capacity = 65536; ///< entries of the ring buffer, rounded up to a power of two
+    size_t maxFileSize = 64 * 1024 * 1024; ///< octets of a file before it is rotated
+    size_t maxFiles = 10; ///< number of rotated files kept besides the current one
+    time::milliseconds flushInterval = 100_ms; ///< how often the buffer is written to disk
+  };
+
+  /**
+   * @brief open the log file and start the writer thread
+   * @throw Error the log file cannot be opened
+   */
+  explicit
+  QueryLog(const Options& options);
+
+  /**
+   * @brief write the remaining entries and stop the writer thread
+   */
+  ~QueryLog();
+
+  /**
+   * @brief add @p entry to the ring buffer, never blocks nor allocates
+   * @return false if the ring buffer is full and @p entry is dropped
+   * @note entries must be added by a single thread
+   */
+  bool
+  add(const QueryLogEntry& entry)
+  {
+    size_t head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) >= m_entries.size()) {
+      m_nDropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    m_entries[head & m_mask] = entry;
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief wait until the entries added so far are written to the file
+   */
+  void
+  flush();
+
+  size_t
+  getCapacity() const
+  {
+    return m_entries.size();
+  }
+
+  /**
+   * @return number of entries dropped because the ring buffer was full
+   */
+  uint64_t
+  getNDropped() const
+  {
+    return m_nDropped.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @return number of entries taken from the ring buffer by the writer thread
+   */
+  uint64_t
+  getNWritten() const
+  {
+    return m_tail.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief invoke @p onEntry for each entry of a query log file
+   * @throw Error the file cannot be read or is not a query log
+   */
+  static void
+  readFile(const std::string& path, const std::function<void(const QueryLogEntry&)>& onEntry);
+
+  /**
+   * @return whether @p path starts like a query log file
+   */
+  static bool
+  isQueryLog(const std::string& path);
+
+private:
+  void
+  run();
+
+  /**
+   * @brief write the entries of the ring buffer to the file, on the writer thread
+   */
+  void
+  drain();
+
+  void
+  openFile();
+
+  void
+  rotate();
+
+private:
+  const Options m_options;
+  std::vector<QueryLogEntry> m_entries;
+  size_t m_mask;
+  std::atomic<size_t> m_head{0}; ///< number of entries added, written by the adding thread
+  std::atomic<size_t> m_tail{0}; ///< number of entries written, written by the writer thread
+  std::atomic<uint64_t> m_nDropped{0};
+
+  std::ofstream m_file;
+  size_t m_fileSize = 0;
+  bool m_hasWriteError = false;
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_shouldStop = false;
+  uint64_t m_nFlushRequests = 0;
+  uint64_t m_nFlushes = 0;
+  std::thread m_writer;
+};
+
+} // namespace ndns
+} // namespace ndn
+
+#endif // NDNS_DAEMON_QUERY_LOG_HPP
@@ -18,6 +18,7 @@
  */
 
 #include "rrset-factory.hpp"
+#include "tracepoints.hpp"
 #include "mgmt/management-tool.hpp"
 #include "util/cert-helper.hpp"
 
@@ -246,7 +247,9 @@ RrsetFactory::generateDoeRrset(const Name& label,
 void
 RrsetFactory::sign(Data& data)
 {
+  NDNS_TRACE2(sign_start, data.getName().wireEncode().data(), data.getName().wireEncode().size());
   m_keyChain.sign(data, signingByCertificate(m_dskCertName));
+  NDNS_TRACE1(sign_done, data.wireEncode().size());
 }
 
 void
@@ -0,0 +1,178 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "stage-histograms.hpp"
+#include "ndns-tlv.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+
+#include <iomanip>
+#include <ostream>
+
+namespace ndn {
+namespace ndns {
+
+namespace {
+
+using Latency = ZoneStageStatus::Latency;
+
+struct Field
+{
+  uint32_t type;
+  uint64_t Latency::* value;
+};
+
+const Field FIELDS[] = {
+  {tlv::LatencyCount, &Latency::count},
+  {tlv::LatencyMean, &Latency::mean},
+  {tlv::LatencyP50, &Latency::p50},
+  {tlv::LatencyP90, &Latency::p90},
+  {tlv::LatencyP99, &Latency::p99},
+  {tlv::LatencyP999, &Latency::p999},
+  {tlv::LatencyMax, &Latency::max},
+};
+
+} // namespace
+
+StageHistograms::StageHistograms()
+{
+  for (auto& histogram : m_histograms) {
+    histogram.reserve(10_s);
+  }
+}
+
+const char*
+toString(StageHistograms::Stage stage)
+{
+  switch (stage) {
+    case StageHistograms::MATCH:
+      return "match";
+    case StageHistograms::DATABASE:
+      return "database";
+    case StageHistograms::ENCODE:
+      return "encode";
+    case StageHistograms::SIGN:
+      return "sign";
+    case StageHistograms::VALIDATE:
+      return "validate";
+    case StageHistograms::PUT:
+      return "put";
+    case StageHistograms::N_STAGES:
+      break;
+  }
+  return "unknown";
+}
+
+ZoneStageStatus::ZoneStageStatus(const Name& zoneName, const StageHistograms& histograms)
+  : zone(zoneName)
+{
+  for (size_t i = 0; i < stages.size(); ++i) {
+    const auto& histogram = histograms.get(static_cast<StageHistograms::Stage>(i));
+    auto& latency = stages[i];
+    latency.count = histogram.getCount();
+    latency.mean = static_cast<uint64_t>(histogram.getMean().count());
+    latency.p50 = static_cast<uint64_t>(histogram.getPercentile(50).count());
+    latency.p90 = static_cast<uint64_t>(histogram.getPercentile(90).count());
+    latency.p99 = static_cast<uint64_t>(histogram.getPercentile(99).count());
+    latency.p999 = static_cast<uint64_t>(histogram.getPercentile(99.9).count());
+    latency.max = static_cast<uint64_t>(histogram.getMax().count());
+  }
+}
+
+Block
+ZoneStageStatus::wireEncode() const
+{
+  Block wire(tlv::ZoneStageStatus);
+  wire.push_back(zone.wireEncode());
+  for (size_t i = 0; i < stages.size(); ++i) {
+    Block stage(tlv::StageLatency);
+    stage.push_back(makeNonNegativeIntegerBlock(tlv::StageId, i));
+    for (const auto& field : FIELDS) {
+      stage.push_back(makeNonNegativeIntegerBlock(field.type, stages[i].*field.value));
+    }
+    stage.encode();
+    wire.push_back(stage);
+  }
+  wire.encode();
+  return wire;
+}
+
+void
+ZoneStageStatus::wireDecode(const Block& wire)
+{
+  if (wire.type() != tlv::ZoneStageStatus) {
+    NDN_THROW(Error("Expecting ZoneStageStatus, but TLV-TYPE is " + to_string(wire.type())));
+  }
+
+  *this = ZoneStageStatus();
+  wire.parse();
+  auto element = wire.elements_begin();
+  if (element == wire.elements_end() || element->type() != ndn::tlv::Name) {
+    NDN_THROW(Error("ZoneStageStatus does not start with a Name"));
+  }
+  zone.wireDecode(*element);
+
+  for (++element; element != wire.elements_end(); ++element) {
+    if (element->type() != tlv::StageLatency) {
+      continue;
+    }
+    element->parse();
+    auto id = element->find(tlv::StageId);
+    if (id == element->elements_end()) {
+      NDN_THROW(Error("StageLatency does not have a StageId"));
+    }
+    uint64_t stage = readNonNegativeInteger(*id);
+    if (stage >= stages.size()) {
+      continue;
+    }
+    for (const auto& field : FIELDS) {
+      auto value = element->find(field.type);
+      if (value != element->elements_end()) {
+        stages[stage].*field.value = readNonNegativeInteger(*value);
+      }
+    }
+  }
+}
+
+std::ostream&
+operator<<(std::ostream& os, const ZoneStageStatus& status)
+{
+  os << status.zone << " (us)\n"
+     << "  " << std::left << std::setw(10) << "stage" << std::right;
+  for (const char* column : {"count", "mean", "p50", "p90", "p99", "p99.9", "max"}) {
+    os << std::setw(11) << column;
+  }
+  os << "\n";
+
+  for (size_t i = 0; i < status.stages.size(); ++i) {
+    const auto& latency = status.stages[i];
+    os << "  " << std::left << std::setw(10) << toString(static_cast<StageHistograms::Stage>(i))
+       << std::right << std::setw(11) << latency.count;
+    for (uint64_t ns : {latency.mean, latency.p50, latency.p90, latency.p99, latency.p999,
+                        latency.max}) {
+      os << std::setw(11) << ns / 1000;
+    }
+    os << "\n";
+  }
+  return os;
+}
+
+} // namespace ndns
+} // namespace ndn
@@ -0,0 +1,170 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef NDNS_DAEMON_STAGE_HISTOGRAMS_HPP
+#define NDNS_DAEMON_STAGE_HISTOGRAMS_HPP
+
+#include "common.hpp"
+#include "util/latency-histogram.hpp"
+
+#include <array>
+#include <iosfwd>
+
+namespace ndn {
+namespace ndns {
+
+/**
+ * @brief latency histograms of the stages of query and update handling in a name server
+ */
+class StageHistograms : boost::noncopyable
+{
+public:
+  enum Stage {
+    MATCH, ///< matching the Interest name against the zone, label::matchName
+    DATABASE, ///< lookups and writes of the database
+    ENCODE, ///< construction of the Data packets of answers, signing excluded
+    SIGN, ///< signing answers and segments
+    VALIDATE, ///< validation of updates, from submission to result
+    PUT, ///< Face::put of answers
+    N_STAGES
+  };
+
+  /**
+   * @brief preallocate the buckets of the histograms, so that adding latencies below ten
+   *        seconds does not allocate memory
+   */
+  StageHistograms();
+
+  LatencyHistogram&
+  get(Stage stage)
+  {
+    return m_histograms[stage];
+  }
+
+  const LatencyHistogram&
+  get(Stage stage) const
+  {
+    return m_histograms[stage];
+  }
+
+private:
+  std::array<LatencyHistogram, N_STAGES> m_histograms;
+};
+
+const char*
+toString(StageHistograms::Stage stage);
+
+/**
+ * @brief adds the time elapsed during its lifetime to a histogram, if one is given
+ *
+ * When the histogram is nullptr, the clock is not read, so that disabled instrumentation
+ * costs a branch.
+ */
+class ScopedStageTimer : boost::noncopyable
+{
+public:
+  explicit
+  ScopedStageTimer(LatencyHistogram* histogram)
+    : m_histogram(histogram)
+  {
+    if (m_histogram != nullptr) {
+      m_start = time::steady_clock::now();
+    }
+  }
+
+  ~ScopedStageTimer()
+  {
+    if (m_histogram != nullptr) {
+      m_histogram->add(time::steady_clock::now() - m_start);
+    }
+  }
+
+private:
+  LatencyHistogram* m_histogram;
+  time::steady_clock::time_point m_start;
+};
+
+/**
+ * @brief summary of the stage histograms of a zone, as published in the status dataset of
+ *        ndns-daemon
+ *
+ * ZoneStageStatus := ZONE-STAGE-STATUS-TYPE TLV-LENGTH
+ *                      Name
+ *                      StageLatency*
+ *
+ * StageLatency := STAGE-LATENCY-TYPE TLV-LENGTH
+ *                   StageId Count Mean P50 P90 P99 P999 Max
+ *
+ * Latencies are in nanoseconds. StageLatency elements of unknown stages are ignored.
+ */
+class ZoneStageStatus
+{
+public:
+  class Error : public ndn::tlv::Error
+  {
+  public:
+    using ndn::tlv::Error::Error;
+  };
+
+  struct Latency
+  {
+    uint64_t count = 0;
+    uint64_t mean = 0;
+    uint64_t p50 = 0;
+    uint64_t p90 = 0;
+    uint64_t p99 = 0;
+    uint64_t p999 = 0;
+    uint64_t max = 0;
+  };
+
+  ZoneStageStatus() = default;
+
+  ZoneStageStatus(const Name& zone, const StageHistograms& histograms);
+
+  /**
+   * @throw Error @p wire is not a valid ZoneStageStatus
+   */
+  explicit
+  ZoneStageStatus(const Block& wire)
+  {
+    wireDecode(wire);
+  }
+
+  Block
+  wireEncode() const;
+
+  void
+  wireDecode(const Block& wire);
+
+public:
+  Name zone;
+  std::array<Latency, StageHistograms::N_STAGES> stages;
+};
+
+/**
+ * @brief print one line per stage, with latencies in microseconds
+ */
+std::ostream&
+operator<<(std::ostream& os, const ZoneStageStatus& status);
+
+} // namespace ndns
+} // namespace ndn
+
+#endif // NDNS_DAEMON_STAGE_HISTOGRAMS_HPP
@@ -0,0 +1,102 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "status-server.hpp"
+#include "logger.hpp"
+
+#include <ndn-cxx/security/signing-helpers.hpp>
+
+namespace ndn {
+namespace ndns {
+
+NDNS_LOG_INIT(StatusServer);
+
+const Name StatusServer::DEFAULT_PREFIX("/localhost/ndns");
+
+StatusServer::StatusServer(Face& face, KeyChain& keyChain, const Name& prefix)
+  : m_dispatcher(face, keyChain, security::signingWithSha256())
+{
+  m_dispatcher.addStatusDataset("zones/list", mgmt::makeAcceptAllAuthorization(),
+                                [this] (const Name& topPrefix, const Interest& interest,
+                                        mgmt::StatusDatasetContext& context) {
+                                  listZones(topPrefix, interest, context);
+                                });
+  m_dispatcher.addStatusDataset("zones/stages", mgmt::makeAcceptAllAuthorization(),
+                                [this] (const Name& topPrefix, const Interest& interest,
+                                        mgmt::StatusDatasetContext& context) {
+                                  listStages(topPrefix, interest, context);
+                                });
+  m_dispatcher.addStatusDataset("validator", mgmt::makeAcceptAllAuthorization(),
+                                [this] (const Name& topPrefix, const Interest& interest,
+                                        mgmt::StatusDatasetContext& context) {
+                                  showValidator(topPrefix, interest, context);
+                                });
+  m_dispatcher.addTopPrefix(prefix);
+  NDNS_LOG_INFO("publish the status of zones under " << prefix);
+}
+
+void
+StatusServer::listZones(const Name&, const Interest&, mgmt::StatusDatasetContext& context) const
+{
+  for (const auto* server : m_servers) {
+    context.append(ZoneStatus(server->getZone().getName(), server->getCounters()).wireEncode());
+  }
+  context.end();
+}
+
+void
+StatusServer::listStages(const Name&, const Interest&, mgmt::StatusDatasetContext& context) const
+{
+  for (const auto* server : m_servers) {
+    const StageHistograms* histograms = server->getStageHistograms();
+    if (histograms != nullptr) {
+      context.append(ZoneStageStatus(server->getZone().getName(), *histograms).wireEncode());
+    }
+  }
+  context.end();
+}
+
+void
+StatusServer::showValidator(const Name&, const Interest&,
+                            mgmt::StatusDatasetContext& context) const
+{
+  ValidatorStatus status;
+  if (m_updateVerifier != nullptr) {
+    status.verifierQueueDepth = m_updateVerifier->getQueueDepth();
+    status.verifierMaxQueueDepth = m_updateVerifier->getMaxQueueDepth();
+    status.nVerifierOffloaded = m_updateVerifier->getNOffloaded();
+    status.nVerifierFallbacks = m_updateVerifier->getNFallbacks();
+    status.verifierMeanLatency = m_updateVerifier->getMeanLatency().count();
+    status.verifierMaxLatency = m_updateVerifier->getMaxLatency().count();
+  }
+  if (m_validationCache != nullptr) {
+    status.nValidationCacheHits = m_validationCache->getNHits();
+    status.nValidationCacheMisses = m_validationCache->getNMisses();
+  }
+  if (m_nsCache != nullptr) {
+    status.nNsCacheHits = m_nsCache->getNHits();
+    status.nNsCacheMisses = m_nsCache->getNMisses();
+  }
+  context.append(status.wireEncode());
+  context.end();
+}
+
+} // namespace ndns
+} // namespace ndn
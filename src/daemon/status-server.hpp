@@ -0,0 +1,113 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef NDNS_DAEMON_STATUS_SERVER_HPP
+#define NDNS_DAEMON_STATUS_SERVER_HPP
+
+#include "name-server.hpp"
+#include "clients/ns-cache.hpp"
+#include "validator/update-verifier.hpp"
+
+#include <ndn-cxx/mgmt/dispatcher.hpp>
+
+#include <vector>
+
+namespace ndn {
+namespace ndns {
+
+/**
+ * @brief publishes the runtime counters of name servers as status datasets
+ *
+ * The dataset <prefix>/zones/list is the sequence of the ZoneStatus of each name server, and
+ * <prefix>/zones/stages the sequence of the ZoneStageStatus of each name server whose stage
+ * histograms are enabled. The dataset <prefix>/validator is a single ValidatorStatus, with the
+ * counters shared by all name servers. Datasets are segmented and versioned as in NFD
+ * management, so they can be retrieved with a SegmentFetcher, e.g., by ndns-status. The default
+ * prefix is only reachable by local applications, hence datasets are signed with a digest.
+ */
+class StatusServer : boost::noncopyable
+{
+public:
+  static const Name DEFAULT_PREFIX;
+
+  StatusServer(Face& face, KeyChain& keyChain, const Name& prefix = DEFAULT_PREFIX);
+
+  /**
+   * @brief include the counters of @p server in the dataset
+   */
+  void
+  addNameServer(const NameServer& server)
+  {
+    m_servers.push_back(&server);
+  }
+
+  /**
+   * @brief include the metrics of @p verifier in the validator dataset
+   */
+  void
+  setUpdateVerifier(const UpdateVerifier* verifier)
+  {
+    m_updateVerifier = verifier;
+  }
+
+  /**
+   * @brief include the counters of @p cache in the validator dataset
+   */
+  void
+  setValidationCache(const ValidationCache* cache)
+  {
+    m_validationCache = cache;
+  }
+
+  /**
+   * @brief include the counters of @p cache, the NS cache of the validator, in the validator
+   *        dataset
+   */
+  void
+  setNsCache(const NsCache* cache)
+  {
+    m_nsCache = cache;
+  }
+
+private:
+  void
+  listZones(const Name& topPrefix, const Interest& interest,
+            mgmt::StatusDatasetContext& context) const;
+
+  void
+  listStages(const Name& topPrefix, const Interest& interest,
+             mgmt::StatusDatasetContext& context) const;
+
+  void
+  showValidator(const Name& topPrefix, const Interest& interest,
+                mgmt::StatusDatasetContext& context) const;
+
+private:
+  mgmt::Dispatcher m_dispatcher;
+  std::vector<const NameServer*> m_servers;
+  const UpdateVerifier* m_updateVerifier = nullptr;
+  const ValidationCache* m_validationCache = nullptr;
+  const NsCache* m_nsCache = nullptr;
+};
+
+} // namespace ndns
+} // namespace ndn
+
+#endif // NDNS_DAEMON_STATUS_SERVER_HPP
@@ -0,0 +1,224 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "zone-status.hpp"
+#include "ndns-tlv.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+
+#include <ostream>
+
+namespace ndn {
+namespace ndns {
+
+namespace {
+
+template<typename Status>
+struct Field
+{
+  uint32_t type;
+  uint64_t Status::* value;
+};
+
+const Field<ZoneStatus> FIELDS[] = {
+  {tlv::NQueries, &ZoneStatus::nQueries},
+  {tlv::NAnswers, &ZoneStatus::nAnswers},
+  {tlv::NNacks, &ZoneStatus::nNacks},
+  {tlv::NUnanswered, &ZoneStatus::nUnanswered},
+  {tlv::NUpdatesAccepted, &ZoneStatus::nUpdatesAccepted},
+  {tlv::NUpdatesRejected, &ZoneStatus::nUpdatesRejected},
+  {tlv::NValidationFailures, &ZoneStatus::nValidationFailures},
+  {tlv::NSegmentCacheHits, &ZoneStatus::nSegmentCacheHits},
+  {tlv::NSegmentCacheMisses, &ZoneStatus::nSegmentCacheMisses},
+  {tlv::NBundleCacheHits, &ZoneStatus::nBundleCacheHits},
+  {tlv::NBundleCacheMisses, &ZoneStatus::nBundleCacheMisses},
+  {tlv::NMultiCacheHits, &ZoneStatus::nMultiCacheHits},
+  {tlv::NMultiCacheMisses, &ZoneStatus::nMultiCacheMisses},
+  {tlv::NDbOperations, &ZoneStatus::nDbOperations},
+  {tlv::DbTime, &ZoneStatus::dbTime},
+  {tlv::NSignings, &ZoneStatus::nSignings},
+  {tlv::SigningTime, &ZoneStatus::signingTime},
+};
+
+const Field<ValidatorStatus> VALIDATOR_FIELDS[] = {
+  {tlv::VerifierQueueDepth, &ValidatorStatus::verifierQueueDepth},
+  {tlv::VerifierMaxQueueDepth, &ValidatorStatus::verifierMaxQueueDepth},
+  {tlv::NVerifierOffloaded, &ValidatorStatus::nVerifierOffloaded},
+  {tlv::NVerifierFallbacks, &ValidatorStatus::nVerifierFallbacks},
+  {tlv::VerifierMeanLatency, &ValidatorStatus::verifierMeanLatency},
+  {tlv::VerifierMaxLatency, &ValidatorStatus::verifierMaxLatency},
+  {tlv::NValidationCacheHits, &ValidatorStatus::nValidationCacheHits},
+  {tlv::NValidationCacheMisses, &ValidatorStatus::nValidationCacheMisses},
+  {tlv::NNsCacheHits, &ValidatorStatus::nNsCacheHits},
+  {tlv::NNsCacheMisses, &ValidatorStatus::nNsCacheMisses},
+};
+
+void
+printRate(std::ostream& os, uint64_t nHits, uint64_t nMisses)
+{
+  os << "hits=" << nHits << " misses=" << nMisses;
+  if (nHits + nMisses > 0) {
+    os << " (" << 100.0 * nHits / (nHits + nMisses) << "% hits)";
+  }
+}
+
+void
+printTime(std::ostream& os, uint64_t nOperations, uint64_t totalTime)
+{
+  os << nOperations << " in " << totalTime / 1000000 << " ms";
+  if (nOperations > 0) {
+    os << " (mean " << totalTime / nOperations / 1000 << " us)";
+  }
+}
+
+} // namespace
+
+ZoneStatus::ZoneStatus(const Name& zoneName, const ZoneCounters& counters)
+  : zone(zoneName)
+  , nQueries(counters.nQueries)
+  , nAnswers(counters.nAnswers)
+  , nNacks(counters.nNacks)
+  , nUnanswered(counters.nUnanswered)
+  , nUpdatesAccepted(counters.nUpdatesAccepted)
+  , nUpdatesRejected(counters.nUpdatesRejected)
+  , nValidationFailures(counters.nValidationFailures)
+  , nSegmentCacheHits(counters.nSegmentCacheHits)
+  , nSegmentCacheMisses(counters.nSegmentCacheMisses)
+  , nBundleCacheHits(counters.nBundleCacheHits)
+  , nBundleCacheMisses(counters.nBundleCacheMisses)
+  , nMultiCacheHits(counters.nMultiCacheHits)
+  , nMultiCacheMisses(counters.nMultiCacheMisses)
+  , nDbOperations(counters.nDbOperations)
+  , dbTime(counters.dbTime)
+  , nSignings(counters.nSignings)
+  , signingTime(counters.signingTime)
+{
+}
+
+Block
+ZoneStatus::wireEncode() const
+{
+  Block wire(tlv::ZoneStatus);
+  wire.push_back(zone.wireEncode());
+  for (const auto& field : FIELDS) {
+    wire.push_back(makeNonNegativeIntegerBlock(field.type, this->*field.value));
+  }
+  wire.encode();
+  return wire;
+}
+
+void
+ZoneStatus::wireDecode(const Block& wire)
+{
+  if (wire.type() != tlv::ZoneStatus) {
+    NDN_THROW(Error("Expecting ZoneStatus, but TLV-TYPE is " + to_string(wire.type())));
+  }
+
+  *this = ZoneStatus();
+  wire.parse();
+  auto element = wire.elements_begin();
+  if (element == wire.elements_end() || element->type() != ndn::tlv::Name) {
+    NDN_THROW(Error("ZoneStatus does not start with a Name"));
+  }
+  zone.wireDecode(*element);
+
+  for (++element; element != wire.elements_end(); ++element) {
+    for (const auto& field : FIELDS) {
+      if (element->type() == field.type) {
+        this->*field.value = readNonNegativeInteger(*element);
+        break;
+      }
+    }
+  }
+}
+
+std::ostream&
+operator<<(std::ostream& os, const ZoneStatus& status)
+{
+  os << status.zone << "\n"
+     << "  queries=" << status.nQueries
+     << " answers=" << status.nAnswers
+     << " nacks=" << status.nNacks
+     << " unanswered=" << status.nUnanswered << "\n"
+     << "  updates: accepted=" << status.nUpdatesAccepted
+     << " rejected=" << status.nUpdatesRejected
+     << " validationFailures=" << status.nValidationFailures << "\n"
+     << "  segment cache: ";
+  printRate(os, status.nSegmentCacheHits, status.nSegmentCacheMisses);
+  os << "\n  bundle cache: ";
+  printRate(os, status.nBundleCacheHits, status.nBundleCacheMisses);
+  os << "\n  multi-type answer cache: ";
+  printRate(os, status.nMultiCacheHits, status.nMultiCacheMisses);
+  os << "\n  database operations: ";
+  printTime(os, status.nDbOperations, status.dbTime);
+  os << "\n  signings: ";
+  printTime(os, status.nSignings, status.signingTime);
+  return os << "\n";
+}
+
+Block
+ValidatorStatus::wireEncode() const
+{
+  Block wire(tlv::ValidatorStatus);
+  for (const auto& field : VALIDATOR_FIELDS) {
+    wire.push_back(makeNonNegativeIntegerBlock(field.type, this->*field.value));
+  }
+  wire.encode();
+  return wire;
+}
+
+void
+ValidatorStatus::wireDecode(const Block& wire)
+{
+  if (wire.type() != tlv::ValidatorStatus) {
+    NDN_THROW(Error("Expecting ValidatorStatus, but TLV-TYPE is " + to_string(wire.type())));
+  }
+
+  *this = ValidatorStatus();
+  wire.parse();
+  for (const auto& element : wire.elements()) {
+    for (const auto& field : VALIDATOR_FIELDS) {
+      if (element.type() == field.type) {
+        this->*field.value = readNonNegativeInteger(element);
+        break;
+      }
+    }
+  }
+}
+
+std::ostream&
+operator<<(std::ostream& os, const ValidatorStatus& status)
+{
+  os << "validator\n"
+     << "  update verifier: queue=" << status.verifierQueueDepth
+     << " maxQueue=" << status.verifierMaxQueueDepth
+     << " offloaded=" << status.nVerifierOffloaded
+     << " fallbacks=" << status.nVerifierFallbacks
+     << " latency: mean " << status.verifierMeanLatency / 1000 << " us,"
+     << " max " << status.verifierMaxLatency / 1000 << " us\n"
+     << "  validation cache: ";
+  printRate(os, status.nValidationCacheHits, status.nValidationCacheMisses);
+  os << "\n  NS cache: ";
+  printRate(os, status.nNsCacheHits, status.nNsCacheMisses);
+  return os << "\n";
+}
+
+} // namespace ndns
+} // namespace ndn
@@ -0,0 +1,241 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef NDNS_DAEMON_ZONE_STATUS_HPP
+#define NDNS_DAEMON_ZONE_STATUS_HPP
+
+#include "common.hpp"
+#include "util/latency-histogram.hpp"
+
+#include <ndn-cxx/util/time.hpp>
+
+#include <atomic>
+#include <iosfwd>
+
+namespace ndn {
+namespace ndns {
+
+/**
+ * @brief counter incremented by a single thread and read by any thread, without locks
+ *
+ * Increments are a relaxed load and store rather than an atomic read-modify-write, which is
+ * correct as long as only one thread increments the counter.
+ */
+class Counter : boost::noncopyable
+{
+public:
+  Counter&
+  operator++()
+  {
+    return *this += 1;
+  }
+
+  Counter&
+  operator+=(uint64_t n)
+  {
+    m_value.store(m_value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    return *this;
+  }
+
+  operator uint64_t() const
+  {
+    return m_value.load(std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<uint64_t> m_value{0};
+};
+
+/**
+ * @brief runtime counters of a zone, updated by its name server
+ */
+struct ZoneCounters
+{
+  Counter nQueries;
+  Counter nAnswers; ///< queries answered with a record, a segment, or the certificate bundle
+  Counter nNacks; ///< queries answered with an NDNS NACK
+  Counter nUnanswered; ///< queries dropped, e.g., for a segment that does not exist
+  Counter nUpdatesAccepted;
+  Counter nUpdatesRejected; ///< malformed updates, or updates not newer than the record
+  Counter nValidationFailures; ///< updates that failed validation
+  Counter nSegmentCacheHits;
+  Counter nSegmentCacheMisses; ///< records segmented to answer a query
+  Counter nBundleCacheHits;
+  Counter nBundleCacheMisses; ///< certificate bundles built to answer a query
+  Counter nMultiCacheHits;
+  Counter nMultiCacheMisses; ///< answers to multi-type queries built and signed
+  Counter nDbOperations;
+  Counter dbTime; ///< nanoseconds spent in database operations
+  Counter nSignings; ///< answers signed, a record segmented at once counting as one
+  Counter signingTime; ///< nanoseconds spent signing answers
+};
+
+/**
+ * @brief adds one operation and the time elapsed during its lifetime to a pair of counters,
+ *        and to @p histogram if it is not nullptr
+ */
+class ScopedCounterTimer : boost::noncopyable
+{
+public:
+  ScopedCounterTimer(Counter& nOperations, Counter& totalTime,
+                     LatencyHistogram* histogram = nullptr)
+    : m_nOperations(nOperations)
+    , m_totalTime(totalTime)
+    , m_histogram(histogram)
+    , m_start(time::steady_clock::now())
+  {
+  }
+
+  ~ScopedCounterTimer()
+  {
+    time::nanoseconds elapsed = time::steady_clock::now() - m_start;
+    ++m_nOperations;
+    m_totalTime += elapsed.count();
+    if (m_histogram != nullptr) {
+      m_histogram->add(elapsed);
+    }
+  }
+
+private:
+  Counter& m_nOperations;
+  Counter& m_totalTime;
+  LatencyHistogram* m_histogram;
+  time::steady_clock::time_point m_start;
+};
+
+/**
+ * @brief snapshot of the counters of a zone, as published in the status dataset of ndns-daemon
+ *
+ * ZoneStatus := ZONE-STATUS-TYPE TLV-LENGTH
+ *                 Name
+ *                 NonNegativeInteger counters, each with its own TLV-TYPE
+ *
+ * Counters with unknown TLV-TYPEs are ignored when decoding, so that counters can be added.
+ */
+class ZoneStatus
+{
+public:
+  class Error : public ndn::tlv::Error
+  {
+  public:
+    using ndn::tlv::Error::Error;
+  };
+
+  ZoneStatus() = default;
+
+  ZoneStatus(const Name& zone, const ZoneCounters& counters);
+
+  /**
+   * @throw Error @p wire is not a valid ZoneStatus
+   */
+  explicit
+  ZoneStatus(const Block& wire)
+  {
+    wireDecode(wire);
+  }
+
+  Block
+  wireEncode() const;
+
+  void
+  wireDecode(const Block& wire);
+
+public:
+  Name zone;
+  uint64_t nQueries = 0;
+  uint64_t nAnswers = 0;
+  uint64_t nNacks = 0;
+  uint64_t nUnanswered = 0;
+  uint64_t nUpdatesAccepted = 0;
+  uint64_t nUpdatesRejected = 0;
+  uint64_t nValidationFailures = 0;
+  uint64_t nSegmentCacheHits = 0;
+  uint64_t nSegmentCacheMisses = 0;
+  uint64_t nBundleCacheHits = 0;
+  uint64_t nBundleCacheMisses = 0;
+  uint64_t nMultiCacheHits = 0;
+  uint64_t nMultiCacheMisses = 0;
+  uint64_t nDbOperations = 0;
+  uint64_t dbTime = 0;
+  uint64_t nSignings = 0;
+  uint64_t signingTime = 0;
+};
+
+/**
+ * @brief print the counters of @p status on several lines, with cache hit rates and mean times
+ */
+std::ostream&
+operator<<(std::ostream& os, const ZoneStatus& status);
+
+/**
+ * @brief snapshot of the counters shared by all zones of ndns-daemon, which concern the
+ *        validation of updates and the caches of the validator
+ *
+ * ValidatorStatus := VALIDATOR-STATUS-TYPE TLV-LENGTH
+ *                      NonNegativeInteger counters, each with its own TLV-TYPE
+ *
+ * As in ZoneStatus, counters with unknown TLV-TYPEs are ignored when decoding.
+ */
+class ValidatorStatus
+{
+public:
+  class Error : public ndn::tlv::Error
+  {
+  public:
+    using ndn::tlv::Error::Error;
+  };
+
+  ValidatorStatus() = default;
+
+  /**
+   * @throw Error @p wire is not a valid ValidatorStatus
+   */
+  explicit
+  ValidatorStatus(const Block& wire)
+  {
+    wireDecode(wire);
+  }
+
+  Block
+  wireEncode() const;
+
+  void
+  wireDecode(const Block& wire);
+
+public:
+  uint64_t verifierQueueDepth = 0; ///< updates being verified by the update verifier
+  uint64_t verifierMaxQueueDepth = 0;
+  uint64_t nVerifierOffloaded = 0; ///< signatures verified on worker threads
+  uint64_t nVerifierFallbacks = 0; ///< updates handed to the validator on the Face thread
+  uint64_t verifierMeanLatency = 0; ///< nanoseconds
+  uint64_t verifierMaxLatency = 0; ///< nanoseconds
+  uint64_t nValidationCacheHits = 0;
+  uint64_t nValidationCacheMisses = 0;
+  uint64_t nNsCacheHits = 0; ///< lookups answered by the NS cache of the certificate fetcher
+  uint64_t nNsCacheMisses = 0;
+};
+
+std::ostream&
+operator<<(std::ostream& os, const ValidatorStatus& status);
+
+} // namespace ndns
+} // namespace ndn
+
+#endif // NDNS_DAEMON_ZONE_STATUS_HPP
@@ -657,6 +657,25 @@ ManagementTool::generateDoe(Zone& zone)
     NDN_THROW(Error(zone.getName().toUri() + " is not present in the NDNS db"));
   }
 
+  RrsetFactory factory(m_dbMgr.getDbFile(), zone.getName(), m_keyChain, DEFAULT_CERT);
+  factory.checkZoneKey();
+
+  // write all the DoE records at once, so that the zone never has an incomplete DoE chain
+  m_dbMgr.beginTransaction();
+  try {
+    generateDoeRecords(zone, factory);
+    m_dbMgr.commitTransaction();
+  }
+  catch (const std::exception&) {
+    m_dbMgr.rollbackTransaction();
+    throw;
+  }
+  NDNS_LOG_INFO("DoE record updated");
+}
+
+void
+ManagementTool::generateDoeRecords(Zone& zone, RrsetFactory& factory)
+{
   // remove all the Doe records
   m_dbMgr.removeRrsetsOfZoneByType(zone, label::DOE_RR_TYPE);
 
@@ -666,9 +685,6 @@ ManagementTool::generateDoe(Zone& zone)
   // sort them by DoE label name (same as in the database)
   std::sort(allRecords.begin(), allRecords.end());
 
-  RrsetFactory factory(m_dbMgr.getDbFile(), zone.getName(), m_keyChain, DEFAULT_CERT);
-  factory.checkZoneKey();
-
   for (size_t i = 0; i < allRecords.size() - 1; i++) {
     Name lowerLabel = Name(allRecords[i].getLabel()).append(allRecords[i].getType());
     Name upperLabel = Name(allRecords[i + 1].getLabel()).append(allRecords[i + 1].getType());
@@ -692,7 +708,6 @@ ManagementTool::generateDoe(Zone& zone)
                                               VERSION_USE_UNIX_TIMESTAMP,
                                               DEFAULT_CACHE_TTL, lastLabel, firstLabel);
   m_dbMgr.insert(guardRange);
-  NDNS_LOG_INFO("DoE record updated");
 }
 
 } // namespace ndns
@@ -220,6 +220,16 @@ public:
   void
   listAllZones(std::ostream& os);
 
+  /** @brief regenerate all DoE records of the zone, signed by the default DSK of the zone
+   *
+   *  This is done automatically when rrsets are added through this tool. The records are
+   *  replaced in a single database transaction.
+   *
+   *  @throw Error if zone does not exist in the database
+   */
+  void
+  generateDoe(Zone& zone);
+
 private:
   /** @brief add CERT to the NDNS local database
    */
@@ -248,10 +258,10 @@ private:
   void
   checkRrsetVersion(const Rrset& rrset);
 
-  /**
-     @brief generate all Doe records
+  /** @brief replace the DoE records of the zone, within the transaction of generateDoe()
    */
-  void generateDoe(Zone& zone);
+  void
+  generateDoeRecords(Zone& zone, RrsetFactory& factory);
 
 private:
   KeyChain& m_keyChain;
@@ -0,0 +1,231 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "zone-generator.hpp"
+#include "logger.hpp"
+#include "util/cert-helper.hpp"
+
+#include <ndn-cxx/security/signing-helpers.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+
+namespace ndn {
+namespace ndns {
+
+NDNS_LOG_INIT(ZoneGenerator);
+
+static std::vector<double>
+makeBranchWeights(const ZoneGenerator::Options& options)
+{
+  std::vector<double> weights(options.fanout, 1.0);
+  if (options.labelDistribution == ZoneGenerator::LabelDistribution::ZIPF) {
+    for (size_t i = 0; i < weights.size(); ++i) {
+      weights[i] = 1.0 / std::pow(i + 1, options.zipfExponent);
+    }
+  }
+  return weights;
+}
+
+static std::vector<double>
+makeTypeWeights(const ZoneGenerator::Options& options)
+{
+  std::vector<double> weights;
+  for (const auto& [type, weight] : options.typeMix) {
+    weights.push_back(weight);
+  }
+  return weights;
+}
+
+ZoneGenerator::ZoneGenerator(const std::string& dbFile, KeyChain& keyChain, const Options& options)
+  : m_keyChain(keyChain)
+  , m_options(options)
+  , m_tool(dbFile, keyChain)
+  , m_dbMgr(dbFile)
+  , m_rng(options.seed)
+{
+  if (m_options.maxDepth == 0 || m_options.fanout == 0 || m_options.batchSize == 0) {
+    NDN_THROW(Error("maxDepth, fanout, and batchSize must be positive"));
+  }
+  if (m_options.minRecordSize > m_options.maxRecordSize) {
+    NDN_THROW(Error("minRecordSize must not exceed maxRecordSize"));
+  }
+  if (m_options.zoneLevels == 0) {
+    NDN_THROW(Error("zoneLevels must be positive"));
+  }
+
+  double totalWeight = 0;
+  for (const auto& [type, weight] : m_options.typeMix) {
+    if (type != label::TXT_RR_TYPE && type != label::NS_RR_TYPE) {
+      NDN_THROW(Error("unsupported record type " + type.toUri()));
+    }
+    if (weight < 0) {
+      NDN_THROW(Error("weight of " + type.toUri() + " must not be negative"));
+    }
+    totalWeight += weight;
+  }
+  if (totalWeight <= 0) {
+    NDN_THROW(Error("typeMix must have a positive weight"));
+  }
+
+  auto branchWeights = makeBranchWeights(m_options);
+  m_branchDist = std::discrete_distribution<size_t>(branchWeights.begin(), branchWeights.end());
+  auto typeWeights = makeTypeWeights(m_options);
+  m_typeDist = std::discrete_distribution<size_t>(typeWeights.begin(), typeWeights.end());
+}
+
+ZoneGenerator::Summary
+ZoneGenerator::generate(const Name& zoneName, const Name& parentZoneName)
+{
+  Summary summary;
+  generateZone(zoneName, parentZoneName, 1, m_options.nRecords, summary);
+  return summary;
+}
+
+Name
+ZoneGenerator::makeLabel(size_t index)
+{
+  std::uniform_int_distribution<size_t> depthDist(1, m_options.maxDepth);
+  size_t depth = depthDist(m_rng);
+
+  Name label;
+  for (size_t i = 1; i < depth; ++i) {
+    label.append("d" + to_string(m_branchDist(m_rng)));
+  }
+  return label.append("r" + to_string(index));
+}
+
+void
+ZoneGenerator::generateZone(const Name& zoneName, const Name& parentZoneName, size_t level,
+                            size_t nRecords, Summary& summary)
+{
+  NDNS_LOG_INFO("generating zone " << zoneName << " with " << nRecords << " records");
+  Zone zone = m_tool.createZone(zoneName, parentZoneName, m_options.ttl, m_options.certValidity);
+  ++summary.nZones;
+
+  RrsetFactory factory(m_dbMgr.getDbFile(), zoneName, m_keyChain, DEFAULT_CERT);
+  factory.checkZoneKey();
+
+  std::uniform_int_distribution<size_t> sizeDist(m_options.minRecordSize, m_options.maxRecordSize);
+  std::uniform_int_distribution<int> charDist('a', 'z');
+  std::set<Name> authLabels;
+  std::vector<Rrset> batch;
+  batch.reserve(std::min(m_options.batchSize, nRecords));
+
+  for (size_t i = 0; i < nRecords; ++i) {
+    Name label = makeLabel(i);
+    for (size_t j = 1; j < label.size(); ++j) {
+      Name prefix = label.getPrefix(j);
+      if (authLabels.insert(prefix).second) {
+        batch.push_back(factory.generateAuthRrset(prefix, VERSION_USE_UNIX_TIMESTAMP,
+                                                  m_options.ttl));
+        ++summary.nAuthRecords;
+      }
+    }
+
+    const name::Component& type = m_options.typeMix[m_typeDist(m_rng)].first;
+    if (type == label::NS_RR_TYPE) {
+      batch.push_back(factory.generateNsRrset(label, VERSION_USE_UNIX_TIMESTAMP, m_options.ttl,
+                                              {Name("/ndns-gen/ns1"), Name("/ndns-gen/ns2")}));
+    }
+    else {
+      std::string text(sizeDist(m_rng), 'a');
+      std::generate(text.begin(), text.end(), [&] { return static_cast<char>(charDist(m_rng)); });
+      batch.push_back(factory.generateTxtRrset(label, VERSION_USE_UNIX_TIMESTAMP, m_options.ttl,
+                                               {text}));
+    }
+    ++summary.nRecords;
+
+    if (batch.size() >= m_options.batchSize) {
+      insertBatch(batch);
+    }
+  }
+  insertBatch(batch);
+
+  if (level < m_options.zoneLevels) {
+    for (size_t i = 0; i < m_options.nChildZones; ++i) {
+      Name childLabel("c" + to_string(i));
+      Name childName = Name(zoneName).append(childLabel);
+      generateZone(childName, zoneName, level + 1, m_options.nChildRecords, summary);
+
+      Zone child(childName);
+      m_dbMgr.find(child);
+      batch.push_back(makeDkeyRrset(zone, child));
+      batch.push_back(factory.generateNsRrset(childLabel, VERSION_USE_UNIX_TIMESTAMP,
+                                              m_options.ttl, {childName}));
+      ++summary.nRecords;
+    }
+    insertBatch(batch);
+  }
+
+  NDNS_LOG_INFO("generating DoE records of zone " << zoneName);
+  m_tool.generateDoe(zone);
+}
+
+Rrset
+ZoneGenerator::makeDkeyRrset(Zone& zone, Zone& child)
+{
+  Name identityName = Name(zone.getName()).append(label::NDNS_ITERATIVE_QUERY);
+  Name dskCertName = CertHelper::getDefaultCertificateNameOfIdentity(m_keyChain, identityName);
+
+  // the same as ManagementTool::addRrsetFromFile with needResign
+  security::Certificate dkeyCert = m_tool.getZoneDkey(child);
+  SignatureInfo info;
+  info.setValidityPeriod(security::ValidityPeriod(time::system_clock::now(),
+                                                  time::system_clock::now() +
+                                                  m_options.certValidity));
+  m_keyChain.sign(dkeyCert, signingByCertificate(dskCertName).setSignatureInfo(info));
+
+  Response re;
+  re.fromData(zone.getName(), dkeyCert);
+  Rrset rrset(&zone);
+  rrset.setLabel(re.getRrLabel());
+  rrset.setType(re.getRrType());
+  rrset.setTtl(m_options.ttl);
+  rrset.setVersion(re.getVersion());
+  rrset.setData(dkeyCert.wireEncode());
+  return rrset;
+}
+
+void
+ZoneGenerator::insertBatch(std::vector<Rrset>& batch)
+{
+  if (batch.empty()) {
+    return;
+  }
+
+  m_dbMgr.beginTransaction();
+  try {
+    for (auto& rrset : batch) {
+      m_dbMgr.insert(rrset);
+    }
+    m_dbMgr.commitTransaction();
+  }
+  catch (const std::exception&) {
+    m_dbMgr.rollbackTransaction();
+    throw;
+  }
+  NDNS_LOG_DEBUG("inserted " << batch.size() << " records");
+  batch.clear();
+}
+
+} // namespace ndns
+} // namespace ndn
@@ -0,0 +1,132 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef NDNS_MGMT_ZONE_GENERATOR_HPP
+#define NDNS_MGMT_ZONE_GENERATOR_HPP
+
+#include "mgmt/management-tool.hpp"
+
+#include <random>
+
+namespace ndn {
+namespace ndns {
+
+/**
+ * @brief creates synthetic zone hierarchies in an NDNS database
+ *
+ * Zones and their keys are created with ManagementTool::createZone. Records are signed by the
+ * DSK of their zone and inserted in batches, each batch in one database transaction; AUTH
+ * records are added for the intermediate labels of multi-level labels, as
+ * ManagementTool::addMultiLevelLabelRrset does, and the DoE records of each zone are generated
+ * once after all its records have been inserted.
+ *
+ * Labels have between one and Options::maxDepth components. The intermediate components are
+ * drawn among Options::fanout values, either uniformly or following a Zipf distribution, and
+ * the last component is unique, so that every record has a distinct label.
+ */
+class ZoneGenerator : boost::noncopyable
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    using std::runtime_error::runtime_error;
+  };
+
+  enum class LabelDistribution {
+    UNIFORM,
+    ZIPF,
+  };
+
+  struct Options
+  {
+    size_t nRecords = 1000; ///< records of the top zone, AUTH and DoE records excluded
+    size_t maxDepth = 3; ///< maximum number of components of a label
+    size_t fanout = 10; ///< number of values of each intermediate label component
+    LabelDistribution labelDistribution = LabelDistribution::UNIFORM;
+    double zipfExponent = 1.0;
+    size_t minRecordSize = 32; ///< minimum size of the payload of a TXT record, in octets
+    size_t maxRecordSize = 256; ///< maximum size of the payload of a TXT record, in octets
+    /// relative weights of the record types, only TXT and NS are supported
+    std::vector<std::pair<name::Component, double>> typeMix{{label::TXT_RR_TYPE, 1.0}};
+    size_t nChildZones = 0; ///< number of child zones delegated by each zone above zoneLevels
+    size_t zoneLevels = 1; ///< number of levels of the hierarchy, 1 for the top zone only
+    size_t nChildRecords = 100; ///< records of each child zone
+    time::seconds ttl = DEFAULT_CACHE_TTL;
+    time::seconds certValidity = DEFAULT_CERT_TTL;
+    size_t batchSize = 10000; ///< records inserted in one transaction
+    uint32_t seed = 1;
+  };
+
+  struct Summary
+  {
+    size_t nZones = 0;
+    size_t nRecords = 0; ///< generated records, including delegations to child zones
+    size_t nAuthRecords = 0;
+  };
+
+  /**
+   * @throw Error @p options are invalid
+   */
+  ZoneGenerator(const std::string& dbFile, KeyChain& keyChain, const Options& options);
+
+  /**
+   * @brief create @p zoneName and its child zones, and fill them with synthetic records
+   * @throw ManagementTool::Error a zone cannot be created, e.g., it already exists
+   */
+  Summary
+  generate(const Name& zoneName, const Name& parentZoneName);
+
+NDNS_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  /**
+   * @brief make the label of the @p index-th record of a zone
+   */
+  Name
+  makeLabel(size_t index);
+
+private:
+  void
+  generateZone(const Name& zoneName, const Name& parentZoneName, size_t level, size_t nRecords,
+               Summary& summary);
+
+  /**
+   * @return the DKEY certificate of @p child signed by the DSK of @p zone, as a CERT rrset of
+   *         @p zone
+   */
+  Rrset
+  makeDkeyRrset(Zone& zone, Zone& child);
+
+  void
+  insertBatch(std::vector<Rrset>& batch);
+
+private:
+  KeyChain& m_keyChain;
+  const Options m_options;
+  ManagementTool m_tool;
+  DbMgr m_dbMgr;
+  std::mt19937 m_rng;
+  std::discrete_distribution<size_t> m_branchDist;
+  std::discrete_distribution<size_t> m_typeDist;
+};
+
+} // namespace ndns
+} // namespace ndn
+
+#endif // NDNS_MGMT_ZONE_GENERATOR_HPP
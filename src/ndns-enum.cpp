@@ -47,6 +47,15 @@ operator<<(std::ostream& os, NdnsContentType ndnsType)
   case NDNS_RESP:
     os << "NDNS-Resp";
     break;
+  case NDNS_BUNDLE:
+    os << "NDNS-Bundle";
+    break;
+  case NDNS_MULTI:
+    os << "NDNS-Multi";
+    break;
+  case NDNS_SEGMENT:
+    os << "NDNS-Segment";
+    break;
   default:
     os << "UNKNOWN";
     break;
@@ -38,6 +38,9 @@ enum NdnsContentType {
   NDNS_AUTH = 1086, ///< only has RR for detailed (longer) label
   NDNS_RESP = 1087, ///< response type means there are requested RR
   NDNS_UNKNOWN = 1088,  ///< this is not a real type, just mean that contentType is unknown
+  NDNS_BUNDLE = 1089, ///< certificate chain of the zone, see CertificateBundle
+  NDNS_MULTI = 1090, ///< records of several RR types of a label, see MultiResponse
+  NDNS_SEGMENT = 1091, ///< segment of a record too large for one packet, see makeRecordSegments
 };
 
 std::ostream&
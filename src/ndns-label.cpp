@@ -21,6 +21,9 @@
 
 #include <ndn-cxx/data.hpp>
 #include <ndn-cxx/interest.hpp>
+#include <ndn-cxx/util/exception.hpp>
+
+#include <algorithm>
 
 namespace ndn {
 namespace ndns {
@@ -47,7 +50,7 @@ matchName(const Interest& interest,
           const Name& zone,
           MatchResult& result)
 {
-  //  zoneName / <Update>|rrLabel / UPDATE|rrType / [VERSION]
+  //  zoneName / <Update>|rrLabel / UPDATE|rrType / [VERSION / [SEGMENT]]
 
   const Name& name = interest.getName();
   size_t skip = calculateSkip(name, zone);
@@ -56,6 +59,14 @@ matchName(const Interest& interest,
     return false;
 
   size_t offset = 1;
+  if (name.size() - skip >= 3 && name.get(-1).isSegment() && name.get(-2).isVersion()) {
+    result.segment = name.get(-offset);
+    ++offset;
+  }
+  else {
+    result.segment = name::Component();
+  }
+
   if (name.get(-offset).isVersion()) {
     result.version = name.get(-offset);
     ++offset;
@@ -90,6 +101,63 @@ matchName(const Data& data,
   return true;
 }
 
+static const std::string MULTI_RR_TYPE_PREFIX("MULTI");
+
+name::Component
+makeMultiRrType(const std::vector<name::Component>& rrTypes)
+{
+  if (rrTypes.empty() || rrTypes.size() > MAX_MULTI_RR_TYPES) {
+    NDN_THROW(std::invalid_argument("A multi-type query must have between 1 and " +
+                                    to_string(MAX_MULTI_RR_TYPES) + " RR types"));
+  }
+
+  std::string value = MULTI_RR_TYPE_PREFIX;
+  for (const auto& rrType : rrTypes) {
+    std::string type(reinterpret_cast<const char*>(rrType.value()), rrType.value_size());
+    if (type.empty() || type.find('.') != std::string::npos) {
+      NDN_THROW(std::invalid_argument("Invalid RR type `" + rrType.toUri() +
+                                      "` in multi-type query"));
+    }
+    if (std::count(rrTypes.begin(), rrTypes.end(), rrType) > 1) {
+      NDN_THROW(std::invalid_argument("Duplicate RR type `" + rrType.toUri() +
+                                      "` in multi-type query"));
+    }
+    value += '.' + type;
+  }
+  return name::Component(value);
+}
+
+std::vector<name::Component>
+parseMultiRrType(const name::Component& rrType)
+{
+  if (!rrType.isGeneric()) {
+    return {};
+  }
+
+  std::string value(reinterpret_cast<const char*>(rrType.value()), rrType.value_size());
+  if (value.compare(0, MULTI_RR_TYPE_PREFIX.size() + 1, MULTI_RR_TYPE_PREFIX + ".") != 0) {
+    return {};
+  }
+
+  std::vector<name::Component> rrTypes;
+  size_t start = MULTI_RR_TYPE_PREFIX.size() + 1;
+  while (start <= value.size()) {
+    size_t end = std::min(value.find('.', start), value.size());
+    if (end == start || rrTypes.size() == MAX_MULTI_RR_TYPES) {
+      // empty type, or too many types
+      return {};
+    }
+    name::Component type(value.substr(start, end - start));
+    if (std::find(rrTypes.begin(), rrTypes.end(), type) != rrTypes.end()) {
+      // each type is answered once
+      return {};
+    }
+    rrTypes.push_back(type);
+    start = end + 1;
+  }
+  return rrTypes;
+}
+
 } // namespace label
 } // namespace ndns
 } // namespace ndn
@@ -25,6 +25,8 @@
 #include <ndn-cxx/name.hpp>
 #include <ndn-cxx/interest.hpp>
 
+#include <vector>
+
 namespace ndn::ndns::label {
 
 /**
@@ -68,16 +70,27 @@ inline const name::Component TXT_RR_TYPE{"TXT"};
  */
 inline const name::Component DOE_RR_TYPE{"DOE"};
 
+/**
+ * @brief certificate bundle record type, served with an empty label
+ */
+inline const name::Component BUNDLE_RR_TYPE{"BUNDLE"};
+
+/**
+ * @brief maximum number of RR types in a multi-type query
+ */
+constexpr size_t MAX_MULTI_RR_TYPES = 8;
+
 //////////////////////////////////////////
 
 /**
- * @brief result of Matching. version only works when matching a Interest Name
+ * @brief result of Matching. version and segment only work when matching a Interest Name
  */
 struct MatchResult
 {
   Name rrLabel;
   name::Component rrType;
   name::Component version;
+  name::Component segment; ///< requested segment of a segmented record, or empty
 };
 
 /**
@@ -108,6 +121,25 @@ matchName(const Data& data,
           const Name& zone,
           MatchResult& result);
 
+/**
+ * @brief make the type component of a query for several RR types of the same label
+ *
+ * The component is `MULTI.<type1>.<type2>...`, e.g., `MULTI.TXT.APPCERT`.
+ * The response is an NDNS_MULTI record carrying one record per requested type.
+ *
+ * @throw std::invalid_argument @p rrTypes is empty, has more than MAX_MULTI_RR_TYPES types,
+ *                              has a type twice, or a type contains a dot
+ */
+name::Component
+makeMultiRrType(const std::vector<name::Component>& rrTypes);
+
+/**
+ * @return the RR types requested by a multi-type query, or an empty vector if @p rrType is
+ *         not a valid multi-type component, e.g., it repeats a type
+ */
+std::vector<name::Component>
+parseMultiRrType(const name::Component& rrType);
+
 } // namespace ndn::ndns::label
 
 #endif // NDNS_NDNS_LABEL_HPP
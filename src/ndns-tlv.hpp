@@ -34,7 +34,48 @@ enum {
   RrData = 191,
 
   UpdateReturnCode = 160,
-  UpdateReturnMsg = 161
+  UpdateReturnMsg = 161,
+
+  // status dataset of ndns-daemon
+  ZoneStatus = 200,
+  NQueries = 201,
+  NAnswers = 202,
+  NNacks = 203,
+  NUnanswered = 204,
+  NUpdatesAccepted = 205,
+  NUpdatesRejected = 206,
+  NValidationFailures = 207,
+  NSegmentCacheHits = 208,
+  NSegmentCacheMisses = 209,
+  NBundleCacheHits = 210,
+  NBundleCacheMisses = 211,
+  NDbOperations = 212,
+  DbTime = 213,
+  NSignings = 214,
+  SigningTime = 215,
+  NMultiCacheHits = 216,
+  NMultiCacheMisses = 217,
+  ZoneStageStatus = 220,
+  StageLatency = 221,
+  StageId = 222,
+  LatencyCount = 223,
+  LatencyMean = 224,
+  LatencyP50 = 225,
+  LatencyP90 = 226,
+  LatencyP99 = 227,
+  LatencyP999 = 228,
+  LatencyMax = 229,
+  ValidatorStatus = 230,
+  VerifierQueueDepth = 231,
+  VerifierMaxQueueDepth = 232,
+  NVerifierOffloaded = 233,
+  NVerifierFallbacks = 234,
+  VerifierMeanLatency = 235,
+  VerifierMaxLatency = 236,
+  NValidationCacheHits = 237,
+  NValidationCacheMisses = 238,
+  NNsCacheHits = 239,
+  NNsCacheMisses = 240,
 };
 
 } // namespace tlv
@@ -0,0 +1,31 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "tracepoints.hpp"
+
+#ifdef NDNS_HAVE_SYS_SDT_H
+
+// the .probes section is where tracers look for the semaphores to increment
+#define NDNS_DEFINE_TRACE_SEMAPHORE(probe) \
+  extern "C" volatile unsigned short NDNS_TRACE_SEMAPHORE(probe) \
+    __attribute__((section(".probes"))) = 0;
+NDNS_FOR_EACH_PROBE(NDNS_DEFINE_TRACE_SEMAPHORE)
+
+#endif // NDNS_HAVE_SYS_SDT_H
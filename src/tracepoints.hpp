@@ -0,0 +1,85 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef NDNS_TRACEPOINTS_HPP
+#define NDNS_TRACEPOINTS_HPP
+
+#include "config.hpp"
+
+/**
+ * @file
+ * @brief statically defined tracepoints (USDT probes) of provider "ndns"
+ *
+ * When <sys/sdt.h> is found at configure time, each NDNS_TRACE macro places a probe guarded by
+ * a semaphore, which tracers such as perf or bpftrace increment while they are attached. Until
+ * then, a probe costs a load of its semaphore and a branch, and its arguments are not
+ * evaluated. The probes are listed in docs/INSTALL.rst; a new probe must also be added to
+ * NDNS_FOR_EACH_PROBE, which defines its semaphore. Without <sys/sdt.h>, or when configured
+ * with --without-tracepoints, the macros are no-ops and their arguments are not evaluated.
+ */
+
+#define NDNS_FOR_EACH_PROBE(X) \
+  X(query_start) X(query_done) \
+  X(update_start) X(update_done) \
+  X(do_update_start) X(do_update_done) \
+  X(db_step_start) X(db_step_done) \
+  X(db_exec_start) X(db_exec_done) \
+  X(sign_start) X(sign_done) \
+  X(resolver_step_start) X(resolver_step_done) X(resolver_abort)
+
+#ifdef NDNS_HAVE_SYS_SDT_H
+
+// probes reference the semaphore ndns_<probe>_semaphore, defined in tracepoints.cpp
+#define _SDT_HAS_SEMAPHORES 1
+#include <sys/sdt.h>
+
+#define NDNS_TRACE_SEMAPHORE(probe) ndns_##probe##_semaphore
+#define NDNS_DECLARE_TRACE_SEMAPHORE(probe) \
+  extern "C" volatile unsigned short NDNS_TRACE_SEMAPHORE(probe);
+NDNS_FOR_EACH_PROBE(NDNS_DECLARE_TRACE_SEMAPHORE)
+
+/**
+ * @brief whether a tracer is attached to @p probe
+ */
+#define NDNS_TRACE_ENABLED(probe) __builtin_expect(NDNS_TRACE_SEMAPHORE(probe) != 0, 0)
+
+#define NDNS_TRACE(probe) \
+  do { if (NDNS_TRACE_ENABLED(probe)) DTRACE_PROBE(ndns, probe); } while (false)
+#define NDNS_TRACE1(probe, a1) \
+  do { if (NDNS_TRACE_ENABLED(probe)) DTRACE_PROBE1(ndns, probe, a1); } while (false)
+#define NDNS_TRACE2(probe, a1, a2) \
+  do { if (NDNS_TRACE_ENABLED(probe)) DTRACE_PROBE2(ndns, probe, a1, a2); } while (false)
+#define NDNS_TRACE3(probe, a1, a2, a3) \
+  do { if (NDNS_TRACE_ENABLED(probe)) DTRACE_PROBE3(ndns, probe, a1, a2, a3); } while (false)
+
+#else
+
+#define NDNS_TRACE_ENABLED(probe) false
+
+// sizeof keeps the arguments unevaluated, but still counts them as uses
+#define NDNS_TRACE(probe) do {} while (false)
+#define NDNS_TRACE1(probe, a1) do { (void)sizeof(a1); } while (false)
+#define NDNS_TRACE2(probe, a1, a2) do { (void)sizeof(a1); (void)sizeof(a2); } while (false)
+#define NDNS_TRACE3(probe, a1, a2, a3) \
+  do { (void)sizeof(a1); (void)sizeof(a2); (void)sizeof(a3); } while (false)
+
+#endif // NDNS_HAVE_SYS_SDT_H
+
+#endif // NDNS_TRACEPOINTS_HPP
@@ -0,0 +1,222 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "latency-histogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+
+namespace ndn {
+namespace ndns {
+
+static_assert((LatencyHistogram::SUB_BUCKETS & (LatencyHistogram::SUB_BUCKETS - 1)) == 0,
+              "SUB_BUCKETS must be a power of two");
+
+static size_t
+log2Floor(uint64_t value)
+{
+  size_t result = 0;
+  while (value >>= 1) {
+    ++result;
+  }
+  return result;
+}
+
+size_t
+LatencyHistogram::getBucketIndex(uint64_t ns)
+{
+  // below 2 * SUB_BUCKETS, each bucket holds a single value
+  if (ns < 2 * SUB_BUCKETS) {
+    return ns;
+  }
+  size_t shift = log2Floor(ns) - log2Floor(SUB_BUCKETS);
+  return SUB_BUCKETS * shift + (ns >> shift);
+}
+
+uint64_t
+LatencyHistogram::getBucketLowerBound(size_t index)
+{
+  if (index < 2 * SUB_BUCKETS) {
+    return index;
+  }
+  size_t shift = index / SUB_BUCKETS - 1;
+  return static_cast<uint64_t>(index - SUB_BUCKETS * shift) << shift;
+}
+
+void
+LatencyHistogram::add(time::nanoseconds latency)
+{
+  uint64_t ns = static_cast<uint64_t>(std::max<time::nanoseconds::rep>(latency.count(), 0));
+  size_t index = getBucketIndex(ns);
+  if (index >= m_buckets.size()) {
+    m_buckets.resize(index + 1);
+  }
+  ++m_buckets[index];
+
+  m_min = m_count == 0 ? ns : std::min(m_min, ns);
+  m_max = std::max(m_max, ns);
+  m_sum += ns;
+  ++m_count;
+}
+
+void
+LatencyHistogram::merge(const LatencyHistogram& other)
+{
+  if (other.m_count == 0) {
+    return;
+  }
+  if (other.m_buckets.size() > m_buckets.size()) {
+    m_buckets.resize(other.m_buckets.size());
+  }
+  for (size_t i = 0; i < other.m_buckets.size(); ++i) {
+    m_buckets[i] += other.m_buckets[i];
+  }
+  m_min = m_count == 0 ? other.m_min : std::min(m_min, other.m_min);
+  m_max = std::max(m_max, other.m_max);
+  m_sum += other.m_sum;
+  m_count += other.m_count;
+}
+
+void
+LatencyHistogram::reset()
+{
+  *this = LatencyHistogram();
+}
+
+void
+LatencyHistogram::reserve(time::nanoseconds maxLatency)
+{
+  size_t size = getBucketIndex(static_cast<uint64_t>(maxLatency.count())) + 1;
+  if (size > m_buckets.size()) {
+    m_buckets.resize(size);
+  }
+}
+
+time::nanoseconds
+LatencyHistogram::getMin() const
+{
+  return time::nanoseconds(m_min);
+}
+
+time::nanoseconds
+LatencyHistogram::getMax() const
+{
+  return time::nanoseconds(m_max);
+}
+
+time::nanoseconds
+LatencyHistogram::getMean() const
+{
+  return m_count == 0 ? 0_ns : time::nanoseconds(m_sum / m_count);
+}
+
+time::nanoseconds
+LatencyHistogram::getPercentile(double percentile) const
+{
+  if (m_count == 0) {
+    return 0_ns;
+  }
+
+  auto rank = static_cast<uint64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100 * m_count));
+  rank = std::max<uint64_t>(rank, 1);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < m_buckets.size(); ++i) {
+    seen += m_buckets[i];
+    if (seen >= rank) {
+      uint64_t upper = getBucketLowerBound(i + 1) - 1;
+      return time::nanoseconds(std::clamp(upper, m_min, m_max));
+    }
+  }
+  return time::nanoseconds(m_max);
+}
+
+static std::string
+formatLatency(uint64_t ns)
+{
+  std::ostringstream os;
+  if (ns < 1000) {
+    os << ns << "ns";
+  }
+  else if (ns < 1000000) {
+    os << ns / 1000 << "us";
+  }
+  else if (ns < 1000000000) {
+    os << ns / 1000000 << "ms";
+  }
+  else {
+    os << ns / 1000000000 << "s";
+  }
+  return os.str();
+}
+
+void
+LatencyHistogram::printBuckets(std::ostream& os) const
+{
+  const size_t barWidth = 50;
+
+  // aggregate the buckets of each power-of-two range
+  std::vector<std::pair<uint64_t, uint64_t>> ranges; // lower bound and count
+  for (size_t i = 0; i < m_buckets.size(); ++i) {
+    if (m_buckets[i] == 0) {
+      continue;
+    }
+    uint64_t lower = getBucketLowerBound(i);
+    uint64_t rangeLower = lower == 0 ? 0 : uint64_t(1) << log2Floor(lower);
+    if (ranges.empty() || ranges.back().first != rangeLower) {
+      ranges.emplace_back(rangeLower, 0);
+    }
+    ranges.back().second += m_buckets[i];
+  }
+
+  uint64_t largest = 0;
+  for (const auto& range : ranges) {
+    largest = std::max(largest, range.second);
+  }
+  for (const auto& [lower, count] : ranges) {
+    uint64_t upper = lower == 0 ? 1 : lower * 2;
+    os << std::setw(8) << formatLatency(lower) << " - " << std::setw(8) << formatLatency(upper)
+       << std::setw(10) << count
+       << std::setw(8) << std::fixed << std::setprecision(2) << 100.0 * count / m_count << "% "
+       << std::string(count * barWidth / largest, '#') << "\n";
+  }
+}
+
+std::ostream&
+operator<<(std::ostream& os, const LatencyHistogram& histogram)
+{
+  auto toMicroseconds = [] (time::nanoseconds ns) {
+    return time::duration_cast<time::microseconds>(ns).count();
+  };
+  return os << "count=" << histogram.getCount()
+            << " latency(min/mean/p50/p90/p99/p999/max)="
+            << toMicroseconds(histogram.getMin()) << "/"
+            << toMicroseconds(histogram.getMean()) << "/"
+            << toMicroseconds(histogram.getPercentile(50)) << "/"
+            << toMicroseconds(histogram.getPercentile(90)) << "/"
+            << toMicroseconds(histogram.getPercentile(99)) << "/"
+            << toMicroseconds(histogram.getPercentile(99.9)) << "/"
+            << toMicroseconds(histogram.getMax()) << " us";
+}
+
+} // namespace ndns
+} // namespace ndn
@@ -0,0 +1,121 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef NDNS_UTIL_LATENCY_HISTOGRAM_HPP
+#define NDNS_UTIL_LATENCY_HISTOGRAM_HPP
+
+#include "common.hpp"
+
+#include <ndn-cxx/util/time.hpp>
+
+#include <iosfwd>
+#include <vector>
+
+namespace ndn {
+namespace ndns {
+
+/**
+ * @brief histogram of latencies with log-linear buckets
+ *
+ * Each power-of-two range of nanoseconds is divided into SUB_BUCKETS equal buckets, so that
+ * percentiles are reported with a relative error below 1/SUB_BUCKETS while the memory used
+ * only grows with the logarithm of the largest latency. Adding a latency takes constant time.
+ */
+class LatencyHistogram
+{
+public:
+  static constexpr size_t SUB_BUCKETS = 16;
+
+  void
+  add(time::nanoseconds latency);
+
+  /**
+   * @brief add all latencies recorded by @p other
+   */
+  void
+  merge(const LatencyHistogram& other);
+
+  void
+  reset();
+
+  /**
+   * @brief allocate the buckets of latencies up to @p maxLatency, so that adding them does
+   *        not allocate memory
+   */
+  void
+  reserve(time::nanoseconds maxLatency);
+
+  uint64_t
+  getCount() const
+  {
+    return m_count;
+  }
+
+  time::nanoseconds
+  getMin() const;
+
+  time::nanoseconds
+  getMax() const;
+
+  time::nanoseconds
+  getMean() const;
+
+  /**
+   * @return upper bound of the bucket holding the @p percentile-th latency, clamped to the
+   *         largest recorded latency; zero if the histogram is empty
+   * @param percentile a value between 0 and 100, e.g., 99.9
+   */
+  time::nanoseconds
+  getPercentile(double percentile) const;
+
+  /**
+   * @brief print one line per non-empty power-of-two range, with its count and a bar
+   */
+  void
+  printBuckets(std::ostream& os) const;
+
+NDNS_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  static size_t
+  getBucketIndex(uint64_t ns);
+
+  /**
+   * @return smallest latency, in nanoseconds, of bucket @p index
+   */
+  static uint64_t
+  getBucketLowerBound(size_t index);
+
+private:
+  std::vector<uint64_t> m_buckets;
+  uint64_t m_count = 0;
+  uint64_t m_sum = 0;
+  uint64_t m_min = 0;
+  uint64_t m_max = 0;
+};
+
+/**
+ * @brief print count, min, mean, p50, p90, p99, p999 and max of @p histogram
+ */
+std::ostream&
+operator<<(std::ostream& os, const LatencyHistogram& histogram);
+
+} // namespace ndns
+} // namespace ndn
+
+#endif // NDNS_UTIL_LATENCY_HISTOGRAM_HPP
@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "query-trace.hpp"
+#include "ndns-label.hpp"
+#include "daemon/query-log.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+
+namespace ndn {
+namespace ndns {
+
+namespace {
+
+/**
+ * @return nanoseconds since the Unix epoch of a timestamp such as 1697040000.123456
+ */
+uint64_t
+parseTimestamp(const std::string& str)
+{
+  size_t dot = str.find('.');
+  std::string seconds = str.substr(0, dot);
+  std::string fraction = dot == std::string::npos ? "" : str.substr(dot + 1);
+  auto isDigit = [] (char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; };
+  if (seconds.empty() || seconds.size() > 10 || fraction.size() > 9 ||
+      !std::all_of(seconds.begin(), seconds.end(), isDigit) ||
+      !std::all_of(fraction.begin(), fraction.end(), isDigit)) {
+    NDN_THROW(std::invalid_argument("invalid timestamp " + str));
+  }
+  fraction.resize(9, '0');
+  return std::stoull(seconds) * 1000000000 + std::stoull(fraction);
+}
+
+} // namespace
+
+QueryTrace::QueryTrace(const Name& zone)
+  : m_zone(zone)
+{
+}
+
+void
+QueryTrace::addFile(const std::string& path)
+{
+  if (!QueryLog::isQueryLog(path)) {
+    std::ifstream is(path);
+    if (!is) {
+      NDN_THROW(Error("cannot open " + path));
+    }
+    addText(is, path);
+    return;
+  }
+
+  size_t nSorted = m_queries.size();
+  QueryLog::readFile(path, [this] (const QueryLogEntry& entry) {
+    if (entry.kind != QueryLogEntry::QUERY || (entry.flags & QueryLogEntry::TRUNCATED) != 0) {
+      ++m_nSkipped;
+      return;
+    }
+    add(entry.timestamp, entry.getZone(), entry.getLabel(), entry.getRrType());
+  });
+  sort(nSorted);
+}
+
+void
+QueryTrace::addText(std::istream& is, const std::string& source)
+{
+  size_t nSorted = m_queries.size();
+  size_t lineNo = 0;
+  for (std::string line; std::getline(is, line);) {
+    ++lineNo;
+    std::istringstream fields(line);
+    std::string timestampStr, nameStr, rrTypeStr;
+    if (!(fields >> timestampStr) || timestampStr[0] == ';' || timestampStr[0] == '#') {
+      continue;
+    }
+
+    uint64_t timestamp = 0;
+    Name name;
+    name::Component rrType;
+    try {
+      if (!(fields >> nameStr >> rrTypeStr)) {
+        NDN_THROW(std::invalid_argument("expecting a timestamp, a name, and an RR type"));
+      }
+      timestamp = parseTimestamp(timestampStr);
+      name = Name(nameStr);
+      rrType = name::Component::fromEscapedString(rrTypeStr);
+    }
+    catch (const std::exception& e) {
+      NDN_THROW(Error(source + ":" + to_string(lineNo) + ": " + e.what()));
+    }
+
+    auto ndns = std::find(name.begin(), name.end(), label::NDNS_ITERATIVE_QUERY);
+    if (ndns != name.end()) {
+      size_t zoneSize = static_cast<size_t>(ndns - name.begin());
+      add(timestamp, name.getPrefix(zoneSize), name.getSubName(zoneSize + 1), std::move(rrType));
+    }
+    else if (!m_zone.empty() && m_zone.isPrefixOf(name)) {
+      add(timestamp, m_zone, name.getSubName(m_zone.size()), std::move(rrType));
+    }
+    else {
+      ++m_nSkipped;
+    }
+  }
+  sort(nSorted);
+}
+
+void
+QueryTrace::add(uint64_t timestamp, Name zone, Name label, name::Component rrType)
+{
+  if (!m_zone.empty() && zone != m_zone) {
+    ++m_nSkipped;
+    return;
+  }
+  m_queries.push_back({timestamp, std::move(zone), std::move(label), std::move(rrType)});
+}
+
+void
+QueryTrace::sort(size_t nSorted)
+{
+  // files are almost sorted, e.g., query logs are written in the order of the answers
+  auto byTimestamp = [] (const TracedQuery& a, const TracedQuery& b) {
+    return a.timestamp < b.timestamp;
+  };
+  auto middle = m_queries.begin() + nSorted;
+  std::stable_sort(middle, m_queries.end(), byTimestamp);
+  std::inplace_merge(m_queries.begin(), middle, m_queries.end(), byTimestamp);
+}
+
+time::nanoseconds
+QueryTrace::getDuration() const
+{
+  if (m_queries.empty()) {
+    return 0_ns;
+  }
+  return time::nanoseconds(m_queries.back().timestamp - m_queries.front().timestamp);
+}
+
+} // namespace ndns
+} // namespace ndn
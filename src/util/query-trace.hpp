@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef NDNS_UTIL_QUERY_TRACE_HPP
+#define NDNS_UTIL_QUERY_TRACE_HPP
+
+#include "common.hpp"
+
+#include <ndn-cxx/util/time.hpp>
+
+#include <iosfwd>
+#include <vector>
+
+namespace ndn {
+namespace ndns {
+
+/**
+ * @brief one query of a QueryTrace
+ */
+struct TracedQuery
+{
+  uint64_t timestamp; ///< nanoseconds since the Unix epoch
+  Name zone;
+  Name label;
+  name::Component rrType;
+};
+
+/**
+ * @brief queries loaded from query logs or text traces, ordered by timestamp
+ *
+ * A text trace has one query per line: a timestamp in seconds since the Unix epoch, with an
+ * optional fraction, followed by a name and an RR type, e.g.,
+ *
+ *     1697040000.123456 /example/NDNS/www TXT
+ *
+ * The name is either an NDNS query name, in which the zone and the label are separated by the
+ * NDNS component, or the zone of the trace followed by the label. Empty lines and lines starting
+ * with ';' or '#' are ignored.
+ *
+ * Updates recorded in query logs, and queries for zones other than the zone of the trace, are
+ * skipped and counted.
+ */
+class QueryTrace
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    using std::runtime_error::runtime_error;
+  };
+
+  /**
+   * @param zone if not empty, only queries for this zone are kept
+   */
+  explicit
+  QueryTrace(const Name& zone = Name());
+
+  /**
+   * @brief add the queries of a query log written by ndns-daemon or of a text trace
+   * @throw Error the file cannot be read, or a line of the text trace is malformed
+   */
+  void
+  addFile(const std::string& path);
+
+  /**
+   * @brief add the queries of a text trace
+   * @param source name of the trace in error messages
+   * @throw Error a line is malformed
+   */
+  void
+  addText(std::istream& is, const std::string& source);
+
+  const std::vector<TracedQuery>&
+  getQueries() const
+  {
+    return m_queries;
+  }
+
+  /**
+   * @return time between the first and the last query
+   */
+  time::nanoseconds
+  getDuration() const;
+
+  /**
+   * @return number of entries that were not added
+   */
+  size_t
+  getNSkipped() const
+  {
+    return m_nSkipped;
+  }
+
+private:
+  void
+  add(uint64_t timestamp, Name zone, Name label, name::Component rrType);
+
+  void
+  sort(size_t nSorted);
+
+private:
+  const Name m_zone;
+  std::vector<TracedQuery> m_queries;
+  size_t m_nSkipped = 0;
+};
+
+} // namespace ndns
+} // namespace ndn
+
+#endif // NDNS_UTIL_QUERY_TRACE_HPP
@@ -0,0 +1,98 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "segmented-record.hpp"
+#include "ndns-enum.hpp"
+#include "logger.hpp"
+
+#include <ndn-cxx/security/signing-helpers.hpp>
+#include <ndn-cxx/security/validator-null.hpp>
+
+#include <algorithm>
+
+namespace ndn {
+namespace ndns {
+
+NDNS_LOG_INIT(SegmentedRecord);
+
+std::vector<shared_ptr<Data>>
+makeRecordSegments(const Block& record, const Name& versionedName, size_t segmentSize,
+                   time::milliseconds freshnessPeriod, KeyChain& keyChain)
+{
+  BOOST_ASSERT(segmentSize > 0);
+
+  const uint8_t* begin = record.data();
+  size_t size = record.size();
+  uint64_t nSegments = std::max<uint64_t>((size + segmentSize - 1) / segmentSize, 1);
+  auto finalBlockId = name::Component::fromSegment(nSegments - 1);
+
+  std::vector<shared_ptr<Data>> segments;
+  segments.reserve(nSegments);
+  for (uint64_t i = 0; i < nSegments; ++i) {
+    size_t offset = i * segmentSize;
+    auto segment = make_shared<Data>(Name(versionedName).appendSegment(i));
+    segment->setContentType(NDNS_SEGMENT);
+    segment->setContent(make_span(begin + offset, std::min(segmentSize, size - offset)));
+    segment->setFreshnessPeriod(freshnessPeriod);
+    segment->setFinalBlock(finalBlockId);
+    keyChain.sign(*segment, signingWithSha256());
+    segments.push_back(std::move(segment));
+  }
+
+  NDNS_LOG_TRACE("split " << versionedName << " (" << size << " octets) into "
+                 << nSegments << " segments");
+  return segments;
+}
+
+shared_ptr<SegmentFetcher>
+fetchRecordSegments(Face& face, const Interest& interest, const Name& versionedName,
+                    std::function<void(const Data& record)> onRecord,
+                    std::function<void(const std::string& reason)> onError)
+{
+  Interest baseInterest(interest);
+  baseInterest.setName(versionedName);
+
+  SegmentFetcher::Options options;
+  options.interestLifetime = interest.getInterestLifetime();
+
+  // segments are only protected by a digest, the reassembled record is validated by the caller
+  auto fetcher = SegmentFetcher::start(face, baseInterest, security::getAcceptAllValidator(),
+                                       options);
+  fetcher->onComplete.connect([=] (const ConstBufferPtr& content) {
+    Data record;
+    try {
+      record.wireDecode(Block(content));
+    }
+    catch (const ndn::tlv::Error& e) {
+      onError("malformed segmented record " + versionedName.toUri() + " (" + e.what() + ")");
+      return;
+    }
+    NDNS_LOG_TRACE("reassembled " << record.getName() << " from " << content->size()
+                   << " octets");
+    onRecord(record);
+  });
+  fetcher->onError.connect([=] (uint32_t code, const std::string& msg) {
+    onError("cannot fetch segments of " + versionedName.toUri() + " (" + msg + ")");
+  });
+  return fetcher;
+}
+
+} // namespace ndns
+} // namespace ndn
@@ -0,0 +1,70 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef NDNS_UTIL_SEGMENTED_RECORD_HPP
+#define NDNS_UTIL_SEGMENTED_RECORD_HPP
+
+#include "common.hpp"
+
+#include <ndn-cxx/face.hpp>
+#include <ndn-cxx/security/key-chain.hpp>
+#include <ndn-cxx/util/segment-fetcher.hpp>
+
+#include <vector>
+
+namespace ndn {
+namespace ndns {
+
+/**
+ * @brief default maximum size of a record served in one packet, and of each segment of
+ *        larger records
+ */
+constexpr size_t DEFAULT_SEGMENT_SIZE = 8000;
+
+/**
+ * @brief split a record that is too large for one packet into segments
+ *
+ * The segments are named `<versionedName>/<segment>` and carry consecutive pieces of the wire
+ * encoding of @p record, at most @p segmentSize octets each. They have content type
+ * NDNS_SEGMENT and are signed with a digest only: the reassembled record keeps the signature
+ * of the zone and is validated as a whole.
+ */
+std::vector<shared_ptr<Data>>
+makeRecordSegments(const Block& record, const Name& versionedName, size_t segmentSize,
+                   time::milliseconds freshnessPeriod, KeyChain& keyChain);
+
+/**
+ * @brief fetch all segments of the record named @p versionedName and reassemble it
+ *
+ * Segments are fetched with a pipelined window. @p interest is the query that was answered
+ * with a segment; its forwarding hint and lifetime are used for the segment Interests.
+ * The record passed to @p onRecord is not validated.
+ *
+ * @return the running fetcher, which can be stopped to cancel the fetch
+ */
+shared_ptr<SegmentFetcher>
+fetchRecordSegments(Face& face, const Interest& interest, const Name& versionedName,
+                    std::function<void(const Data& record)> onRecord,
+                    std::function<void(const std::string& reason)> onError);
+
+} // namespace ndns
+} // namespace ndn
+
+#endif // NDNS_UTIL_SEGMENTED_RECORD_HPP
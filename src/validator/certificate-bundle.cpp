@@ -0,0 +1,76 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "certificate-bundle.hpp"
+#include "ndns-enum.hpp"
+
+namespace ndn {
+namespace ndns {
+
+CertificateBundle::CertificateBundle(const Data& data)
+{
+  if (data.getContentType() != NDNS_BUNDLE) {
+    NDN_THROW(Error("Data " + data.getName().toUri() + " is not a certificate bundle"));
+  }
+
+  const Block& content = data.getContent();
+  content.parse();
+  for (const auto& element : content.elements()) {
+    if (element.type() != ndn::tlv::Data) {
+      NDN_THROW(Error("Unexpected TLV-TYPE " + to_string(element.type()) +
+                      " in certificate bundle"));
+    }
+    try {
+      m_certs.emplace_back(element);
+    }
+    catch (const ndn::tlv::Error& e) {
+      NDN_THROW_NESTED(Error("Malformed certificate in bundle " + data.getName().toUri() +
+                             " (" + e.what() + ")"));
+    }
+  }
+}
+
+const security::Certificate*
+CertificateBundle::find(const Name& keyName) const
+{
+  for (const auto& cert : m_certs) {
+    if (keyName.isPrefixOf(cert.getName())) {
+      return &cert;
+    }
+  }
+  return nullptr;
+}
+
+shared_ptr<Data>
+CertificateBundle::toData(const Name& name) const
+{
+  Block content(ndn::tlv::Content);
+  for (const auto& cert : m_certs) {
+    content.push_back(cert.wireEncode());
+  }
+  content.encode();
+
+  auto data = make_shared<Data>(name);
+  data->setContentType(NDNS_BUNDLE);
+  data->setContent(content);
+  return data;
+}
+
+} // namespace ndns
+} // namespace ndn
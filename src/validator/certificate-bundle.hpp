@@ -0,0 +1,91 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDNS_VALIDATOR_CERTIFICATE_BUNDLE_HPP
+#define NDNS_VALIDATOR_CERTIFICATE_BUNDLE_HPP
+
+#include "common.hpp"
+
+#include <ndn-cxx/security/certificate.hpp>
+
+#include <vector>
+
+namespace ndn {
+namespace ndns {
+
+/**
+ * @brief certificate chain of a zone, carried by a single NDNS_BUNDLE record
+ *
+ * The record is named <zone>/NDNS/BUNDLE/<version>. Its content is the sequence of the
+ * certificates of the chain, starting with the certificate that signs the zone's records.
+ * Certificates taken from a bundle are not trusted by themselves: the validator verifies
+ * them exactly as if they had been fetched one by one.
+ */
+class CertificateBundle
+{
+public:
+  class Error : public ndn::tlv::Error
+  {
+  public:
+    using ndn::tlv::Error::Error;
+  };
+
+  CertificateBundle() = default;
+
+  /**
+   * @brief decode the bundle carried by @p data
+   * @throw Error @p data is not an NDNS_BUNDLE record or a certificate is malformed
+   */
+  explicit
+  CertificateBundle(const Data& data);
+
+  void
+  addCertificate(const security::Certificate& cert)
+  {
+    m_certs.push_back(cert);
+  }
+
+  const std::vector<security::Certificate>&
+  getCertificates() const
+  {
+    return m_certs;
+  }
+
+  /**
+   * @return the first certificate of the bundle that matches @p keyName, or nullptr
+   *
+   * @p keyName can be a key name or a certificate name, as in a KeyLocator.
+   */
+  const security::Certificate*
+  find(const Name& keyName) const;
+
+  /**
+   * @brief create an unsigned NDNS_BUNDLE record named @p name carrying the bundle
+   */
+  shared_ptr<Data>
+  toData(const Name& name) const;
+
+private:
+  std::vector<security::Certificate> m_certs;
+};
+
+} // namespace ndns
+} // namespace ndn
+
+#endif // NDNS_VALIDATOR_CERTIFICATE_BUNDLE_HPP
@@ -0,0 +1,287 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "certificate-fetcher-local-db.hpp"
+#include "ndns-label.hpp"
+#include "logger.hpp"
+
+#include <ndn-cxx/security/certificate-storage.hpp>
+#include <ndn-cxx/security/verification-helpers.hpp>
+
+namespace ndn {
+namespace ndns {
+
+NDNS_LOG_INIT(CertificateFetcherLocalDb);
+
+/**
+ * @brief delay between the retrieval of a certificate and the save of the verified certificates
+ */
+constexpr time::seconds PERSIST_DELAY{1};
+
+/**
+ * @brief fetched certificates that are not verified within this time are not saved
+ */
+constexpr time::seconds VERIFICATION_TIMEOUT{60};
+
+/**
+ * @brief lifetime of saved certificates, same as the verified certificate cache of ndn-cxx
+ */
+constexpr time::hours VERIFIED_CERT_LIFETIME{1};
+
+/**
+ * @brief maximum number of certificates between a saved certificate and its trust anchor
+ */
+constexpr size_t MAX_SAVED_CHAIN_LENGTH{10};
+
+CertificateFetcherLocalDb::CertificateFetcherLocalDb(DbMgr& dbMgr, Face& face,
+                                                     size_t nsCacheSize,
+                                                     size_t startComponentIndex,
+                                                     ResolverCache* resolverCache)
+  : CertificateFetcherNdnsCert(face, nsCacheSize, startComponentIndex, resolverCache)
+  , m_dbMgr(dbMgr)
+  , m_scheduler(face.getIoContext())
+{
+}
+
+void
+CertificateFetcherLocalDb::doFetch(const shared_ptr<security::CertificateRequest>& certRequest,
+                                   const shared_ptr<security::ValidationState>& state,
+                                   const ValidationContinuation& continueValidation)
+{
+  auto cert = findLocalCertificate(certRequest->interest.getName());
+  if (cert) {
+    NDNS_LOG_DEBUG("Fetched certificate from local database " << cert->getName());
+    continueValidation(*cert, state);
+    return;
+  }
+
+  NDNS_LOG_TRACE("Certificate " << certRequest->interest.getName()
+                 << " is not in local database, fetching from network");
+  CertificateFetcherNdnsCert::doFetch(certRequest, state, continueValidation);
+}
+
+void
+CertificateFetcherLocalDb::loadPersistentCache()
+{
+  BOOST_ASSERT(m_certStorage != nullptr);
+
+  std::vector<std::pair<Data, time::system_clock::time_point>> certs;
+  std::vector<std::pair<Data, time::system_clock::time_point>> links;
+  try {
+    m_dbMgr.removeExpiredValidatorCacheEntries();
+    certs = m_dbMgr.find(DbMgr::ValidatorCacheType::CERTIFICATE);
+    links = m_dbMgr.find(DbMgr::ValidatorCacheType::NS_LINK);
+  }
+  catch (const DbMgr::Error& e) {
+    // e.g., the database is read-only
+    NDNS_LOG_WARN("validator cache is disabled, cannot use " << m_dbMgr.getDbFile() << ": "
+                  << e.what());
+    m_isPersistentCacheEnabled = false;
+    return;
+  }
+  auto now = time::system_clock::now();
+
+  SavedCertificates savedCerts;
+  for (auto& [data, expiry] : certs) {
+    try {
+      savedCerts.emplace_back(security::Certificate(std::move(data)), expiry);
+    }
+    catch (const ndn::tlv::Error& e) {
+      NDNS_LOG_WARN("skip malformed certificate in validator cache: " << e.what());
+    }
+  }
+
+  size_t nCerts = 0;
+  for (const auto& [cert, expiry] : savedCerts) {
+    // the trust anchors may have changed since the certificate was verified
+    if (!isChainedToAnchor(cert, savedCerts)) {
+      NDNS_LOG_DEBUG("skip certificate not chained to a current trust anchor " << cert.getName());
+      continue;
+    }
+    m_certStorage->cacheVerifiedCertificate(security::Certificate(cert), expiry - now);
+    ++nCerts;
+  }
+
+  size_t nLinks = 0;
+  for (const auto& [data, expiry] : links) {
+    if (expiry <= now) {
+      continue;
+    }
+    // the link expires when it would have expired in the previous run
+    m_nsCache->insert(data, expiry - now);
+    m_persistedLinks.insert(data.getName());
+    ++nLinks;
+  }
+
+  NDNS_LOG_INFO("loaded " << nCerts << " certificates and " << nLinks
+                << " NS links from the validator cache");
+}
+
+bool
+CertificateFetcherLocalDb::isChainedToAnchor(const security::Certificate& cert,
+                                             const SavedCertificates& savedCerts)
+{
+  security::Certificate current = cert;
+  for (size_t i = 0; i < MAX_SAVED_CHAIN_LENGTH; ++i) {
+    const auto& info = current.getSignatureInfo();
+    if (!info.hasKeyLocator() || info.getKeyLocator().getType() != ndn::tlv::Name) {
+      return false;
+    }
+    Name issuerName = info.getKeyLocator().getName();
+
+    Interest issuerInterest(issuerName);
+    issuerInterest.setCanBePrefix(true);
+    const auto* anchor = m_certStorage->getTrustAnchors().find(issuerInterest);
+    if (anchor != nullptr) {
+      return security::verifySignature(current, anchor->getPublicKey());
+    }
+
+    // the issuer is another saved certificate, or a certificate of a local zone
+    std::optional<security::Certificate> issuer;
+    for (const auto& saved : savedCerts) {
+      if (issuerName.isPrefixOf(saved.first.getName())) {
+        issuer = saved.first;
+        break;
+      }
+    }
+    if (!issuer) {
+      issuer = findLocalCertificate(issuerName);
+    }
+    if (!issuer || !security::verifySignature(current, issuer->getPublicKey())) {
+      return false;
+    }
+    current = std::move(*issuer);
+  }
+  return false;
+}
+
+void
+CertificateFetcherLocalDb::onCertificateFetched(const Data& data)
+{
+  if (!m_isPersistentCacheEnabled) {
+    return;
+  }
+
+  m_unverifiedCerts.emplace(data.getName(), time::steady_clock::now());
+  if (!m_persistEvent) {
+    m_persistEvent = m_scheduler.schedule(PERSIST_DELAY, [this] { persistCache(); });
+  }
+}
+
+void
+CertificateFetcherLocalDb::persistCache()
+{
+  BOOST_ASSERT(m_certStorage != nullptr);
+  m_persistEvent.cancel();
+
+  auto now = time::system_clock::now();
+  const auto& verifiedCerts = m_certStorage->getVerifiedCertificateCache();
+  for (auto it = m_unverifiedCerts.begin(); it != m_unverifiedCerts.end();) {
+    const auto* cert = verifiedCerts.find(it->first);
+    if (cert != nullptr) {
+      auto expiry = std::min(cert->getValidityPeriod().getPeriod().second,
+                             now + VERIFIED_CERT_LIFETIME);
+      NDNS_LOG_DEBUG("save verified certificate " << cert->getName());
+      try {
+        m_dbMgr.insert(DbMgr::ValidatorCacheType::CERTIFICATE, *cert, expiry);
+      }
+      catch (const DbMgr::Error& e) {
+        // e.g., the database is busy or the disk is full, the certificate is not saved
+        NDNS_LOG_WARN("cannot save verified certificate " << cert->getName() << ": " << e.what());
+      }
+      it = m_unverifiedCerts.erase(it);
+    }
+    else if (time::steady_clock::now() - it->second > VERIFICATION_TIMEOUT) {
+      it = m_unverifiedCerts.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+
+  // only the links still in the NS cache are remembered, so the set is bounded by its capacity
+  std::set<Name> persistedLinks;
+  for (const auto& link : *m_nsCache) {
+    if (m_persistedLinks.count(link.getName()) > 0) {
+      persistedLinks.insert(link.getName());
+    }
+    else if (link.getFreshnessPeriod() > 0_ms) {
+      NDNS_LOG_DEBUG("save NS link " << link.getName());
+      try {
+        m_dbMgr.insert(DbMgr::ValidatorCacheType::NS_LINK, link, now + link.getFreshnessPeriod());
+        persistedLinks.insert(link.getName());
+      }
+      catch (const DbMgr::Error& e) {
+        // tried again at the next save
+        NDNS_LOG_WARN("cannot save NS link " << link.getName() << ": " << e.what());
+      }
+    }
+  }
+  m_persistedLinks = std::move(persistedLinks);
+
+  if (!m_unverifiedCerts.empty()) {
+    m_persistEvent = m_scheduler.schedule(PERSIST_DELAY, [this] { persistCache(); });
+  }
+}
+
+std::optional<security::Certificate>
+CertificateFetcherLocalDb::findLocalCertificate(DbMgr& dbMgr, const Name& keyName)
+{
+  Name domain;
+  try {
+    domain = calculateDomain(keyName);
+  }
+  catch (const std::runtime_error&) {
+    return std::nullopt;
+  }
+
+  // <zone>/NDNS/KEY/<key-id>[/<issuer-id>/<version>]
+  if (keyName.size() < domain.size() + 3) {
+    return std::nullopt;
+  }
+
+  Zone zone(domain);
+  if (!dbMgr.find(zone)) {
+    return std::nullopt;
+  }
+
+  Rrset rrset(&zone);
+  rrset.setLabel(keyName.getSubName(domain.size() + 1, 2));
+  rrset.setType(label::CERT_RR_TYPE);
+  if (!dbMgr.find(rrset)) {
+    return std::nullopt;
+  }
+
+  try {
+    security::Certificate cert(rrset.getData());
+    if (!keyName.isPrefixOf(cert.getName())) {
+      // e.g., a request for another version of the certificate
+      return std::nullopt;
+    }
+    return cert;
+  }
+  catch (const std::exception& e) {
+    NDNS_LOG_WARN("Malformed certificate in local database for " << keyName << ": " << e.what());
+    return std::nullopt;
+  }
+}
+
+} // namespace ndns
+} // namespace ndn
@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef NDNS_VALIDATOR_CERTIFICATE_FETCHER_LOCAL_DB_HPP
+#define NDNS_VALIDATOR_CERTIFICATE_FETCHER_LOCAL_DB_HPP
+
+#include "certificate-fetcher-ndns-cert.hpp"
+#include "daemon/db-mgr.hpp"
+
+#include <ndn-cxx/util/scheduler.hpp>
+
+#include <map>
+#include <set>
+#include <optional>
+#include <vector>
+
+namespace ndn {
+namespace ndns {
+
+/**
+ * @brief Fetch NDNS-owned certificate from the local database, or by an iterative query
+ *        process if the certificate is not stored locally
+ *
+ * A certificate `<zone>/NDNS/KEY/<key-id>/...` is looked up as the CERT rrset with label
+ * `KEY/<key-id>` of `<zone>`, if `<zone>` is hosted in the database.
+ *
+ * Certificates fetched from the network that pass verification, and the NS links used to
+ * fetch them, are saved in the validator cache of the database, so that they survive
+ * restarts (see loadPersistentCache()).
+ */
+class CertificateFetcherLocalDb : public CertificateFetcherNdnsCert
+{
+public:
+  CertificateFetcherLocalDb(DbMgr& dbMgr, Face& face,
+                            size_t nsCacheSize = 100,
+                            size_t startComponentIndex = 0,
+                            ResolverCache* resolverCache = nullptr);
+
+  /**
+   * @brief load the certificates and NS links saved by a previous run
+   *
+   * Certificates are added to the verified certificate cache of the validator, so the fetcher
+   * must be attached to a validator whose trust anchors are loaded. A certificate is skipped
+   * unless its chain, through saved or local certificates, still ends at a current trust anchor.
+   * If the database cannot be used, e.g., because it is read-only, the error is logged and
+   * verified certificates are no longer saved.
+   */
+  void
+  loadPersistentCache();
+
+  /**
+   * @brief find the certificate matching @p keyName in @p dbMgr
+   * @return the certificate, or nullopt if it is not stored in @p dbMgr
+   */
+  static std::optional<security::Certificate>
+  findLocalCertificate(DbMgr& dbMgr, const Name& keyName);
+
+protected:
+  void
+  doFetch(const shared_ptr<security::CertificateRequest>& certRequest,
+          const shared_ptr<security::ValidationState>& state,
+          const ValidationContinuation& continueValidation) override;
+
+NDNS_PUBLIC_WITH_TESTS_ELSE_PROTECTED:
+  void
+  onCertificateFetched(const Data& data) override;
+
+NDNS_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  /**
+   * @brief save the fetched certificates that have been verified since the last call,
+   *        and the NS links that have not been saved yet
+   */
+  void
+  persistCache();
+
+  /**
+   * @brief find the certificate matching @p keyName in the local database
+   * @return the certificate, or nullopt if it is not stored locally
+   */
+  std::optional<security::Certificate>
+  findLocalCertificate(const Name& keyName)
+  {
+    return findLocalCertificate(m_dbMgr, keyName);
+  }
+
+private:
+  /// certificates read from the validator cache, with their expiration time
+  using SavedCertificates = std::vector<std::pair<security::Certificate,
+                                                  time::system_clock::time_point>>;
+
+  /**
+   * @return whether the signatures from @p cert up to a current trust anchor are valid,
+   *         issuers being looked up in @p savedCerts and in the local database
+   */
+  bool
+  isChainedToAnchor(const security::Certificate& cert, const SavedCertificates& savedCerts);
+
+private:
+  DbMgr& m_dbMgr;
+
+  Scheduler m_scheduler;
+  scheduler::ScopedEventId m_persistEvent;
+  std::map<Name, time::steady_clock::time_point> m_unverifiedCerts; ///< name => fetch time
+  std::set<Name> m_persistedLinks; ///< saved links that are still in the NS cache
+  bool m_isPersistentCacheEnabled = true;
+};
+
+} // namespace ndns
+} // namespace ndn
+
+#endif // NDNS_VALIDATOR_CERTIFICATE_FETCHER_LOCAL_DB_HPP
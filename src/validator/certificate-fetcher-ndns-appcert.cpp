@@ -45,6 +45,10 @@ CertificateFetcherAppCert::doFetch(const shared_ptr<security::CertificateRequest
                                    const ValidationContinuation& continueValidation)
 {
   const Name& key = certRequest->interest.getName();
+  if (m_pendingFetches.add(key, {certRequest, state, continueValidation})) {
+    return;
+  }
+
   auto query = std::make_shared<IterativeQueryController>(key, label::APPCERT_RR_TYPE,
     certRequest->interest.getInterestLifetime(),
     [=] (const Data& data, const Response&) {
@@ -81,9 +85,10 @@ CertificateFetcherAppCert::onQueryFailCallback(const std::string& errMsg,
                                                const shared_ptr<security::ValidationState>& state,
                                                const ValidationContinuation& continueValidation)
 {
-  state->removeTag<IterativeQueryTag>();
-  state->fail({security::ValidationError::Code::CANNOT_RETRIEVE_CERT, "Cannot fetch certificate due to " +
-               errMsg + " `" + certRequest->interest.getName().toUri() + "`"});
+  const Name& key = certRequest->interest.getName();
+  failFetch(m_pendingFetches.take(key),
+            {security::ValidationError::Code::CANNOT_RETRIEVE_CERT,
+             "Cannot fetch certificate due to " + errMsg + " `" + key.toUri() + "`"});
 }
 
 void
@@ -92,12 +97,13 @@ CertificateFetcherAppCert::onValidationSuccessCallback(const Data& data,
                                                        const shared_ptr<security::ValidationState>& state,
                                                        const ValidationContinuation& continueValidation)
 {
-  state->removeTag<IterativeQueryTag>();
+  const Name& key = certRequest->interest.getName();
+  auto requesters = m_pendingFetches.take(key);
 
   if (data.getContentType() == NDNS_NACK) {
-    return state->fail({security::ValidationError::Code::CANNOT_RETRIEVE_CERT,
-                        "Cannot fetch certificate: got Nack for query `" +
-                        certRequest->interest.getName().toUri() + "`"});
+    return failFetch(requesters, {security::ValidationError::Code::CANNOT_RETRIEVE_CERT,
+                                  "Cannot fetch certificate: got Nack for query `" +
+                                  key.toUri() + "`"});
   }
 
   Certificate cert;
@@ -105,11 +111,12 @@ CertificateFetcherAppCert::onValidationSuccessCallback(const Data& data,
     cert = Certificate(data.getContent().blockFromValue());
   }
   catch (const ndn::tlv::Error& e) {
-    return state->fail({security::ValidationError::Code::MALFORMED_CERT, "Fetched a malformed "
-                        "certificate `" + data.getName().toUri() + "` (" + e.what() + ")"});
+    return failFetch(requesters, {security::ValidationError::Code::MALFORMED_CERT,
+                                  "Fetched a malformed certificate `" +
+                                  data.getName().toUri() + "` (" + e.what() + ")"});
   }
 
-  continueValidation(cert, state);
+  completeFetch(requesters, cert);
 }
 
 void
@@ -118,10 +125,11 @@ CertificateFetcherAppCert::onValidationFailCallback(const security::ValidationEr
                                                     const shared_ptr<security::ValidationState>& state,
                                                     const ValidationContinuation& continueValidation)
 {
-  state->removeTag<IterativeQueryTag>();
-  state->fail({security::ValidationError::Code::CANNOT_RETRIEVE_CERT,
-               "Cannot fetch certificate due to NDNS validation error: " +
-               err.getInfo() + " `" + certRequest->interest.getName().toUri() + "`"});
+  const Name& key = certRequest->interest.getName();
+  failFetch(m_pendingFetches.take(key),
+            {security::ValidationError::Code::CANNOT_RETRIEVE_CERT,
+             "Cannot fetch certificate due to NDNS validation error: " +
+             err.getInfo() + " `" + key.toUri() + "`"});
 }
 
 } // namespace ndns
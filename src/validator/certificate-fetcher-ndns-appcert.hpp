@@ -20,7 +20,9 @@
 #ifndef NDNS_VALIDATOR_CERTIFICATE_FETCHER_NDNS_APPCERT_HPP
 #define NDNS_VALIDATOR_CERTIFICATE_FETCHER_NDNS_APPCERT_HPP
 
-#include <ndn-cxx/ims/in-memory-storage.hpp>
+#include "pending-fetch-table.hpp"
+#include "clients/ns-cache.hpp"
+
 #include <ndn-cxx/security/validator.hpp>
 
 namespace ndn {
@@ -30,6 +32,7 @@ namespace ndns {
  * @brief Fetch NDNS-stored application certificate(APPCERT type record)
  * By an iterative-query process, it will retrieve the record, execute authentications,
  * and de-encapsulate record to get application's certificate.
+ * Concurrent requests of the same certificate share a single iterative query.
  */
 class CertificateFetcherAppCert : public security::CertificateFetcher
 {
@@ -93,8 +96,9 @@ private:
 private:
   Face& m_face;
   unique_ptr<security::Validator> m_validator;
-  InMemoryStorage* m_nsCache;
+  NsCache* m_nsCache;
   size_t m_startComponentIndex;
+  PendingFetchTable m_pendingFetches;
 };
 
 } // namespace ndns
@@ -18,12 +18,14 @@
  */
 
 #include "certificate-fetcher-ndns-cert.hpp"
+#include "certificate-bundle.hpp"
 #include "clients/iterative-query-controller.hpp"
+#include "clients/resolver-cache.hpp"
 #include "clients/response.hpp"
+#include "util/segmented-record.hpp"
 #include "logger.hpp"
 
 #include <ndn-cxx/encoding/tlv.hpp>
-#include <ndn-cxx/ims/in-memory-storage-fifo.hpp>
 
 namespace ndn {
 namespace ndns {
@@ -32,12 +34,25 @@ using security::Certificate;
 
 NDNS_LOG_INIT(CertificateFetcherNdnsCert);
 
+/**
+ * @brief maximum number of certificates kept from received bundles
+ */
+constexpr size_t MAX_BUNDLED_CERTS = 1000;
+
+/**
+ * @brief time during which certificates of a zone without bundle are fetched one by one
+ */
+constexpr time::minutes NO_BUNDLE_LIFETIME{5};
+
 CertificateFetcherNdnsCert::CertificateFetcherNdnsCert(Face& face,
                                                        size_t nsCacheSize,
-                                                       size_t startComponentIndex)
+                                                       size_t startComponentIndex,
+                                                       ResolverCache* resolverCache)
   : m_face(face)
-  , m_nsCache(make_unique<InMemoryStorageFifo>(nsCacheSize))
+  , m_nsCache(make_unique<NsCache>(face.getIoContext(), nsCacheSize))
+  , m_resolverCache(resolverCache)
   , m_startComponentIndex(startComponentIndex)
+  , m_scheduler(face.getIoContext())
 {
 }
 
@@ -47,6 +62,38 @@ CertificateFetcherNdnsCert::doFetch(const shared_ptr<security::CertificateReques
                                     const ValidationContinuation& continueValidation)
 {
   const Name& key = certRequest->interest.getName();
+
+  if (m_resolverCache != nullptr) {
+    // certificates are validated by the caller, an unvalidated cache entry is fine
+    auto cached = m_resolverCache->find(Name(key).append(label::CERT_RR_TYPE), false);
+    if (cached != nullptr) {
+      NDNS_LOG_DEBUG("Fetched certificate from resolver cache " << cached->getName());
+      continueWithCertificate(*cached, {{certRequest, state, continueValidation}});
+      return;
+    }
+  }
+
+  const auto* bundled = findBundledCertificate(key);
+  if (bundled != nullptr) {
+    NDNS_LOG_DEBUG("Fetched certificate from bundle " << bundled->getName());
+    Certificate cert = *bundled;
+    onCertificateFetched(cert);
+    continueWithCertificate(cert, {{certRequest, state, continueValidation}});
+    return;
+  }
+
+  if (m_pendingFetches.add(key, {certRequest, state, continueValidation})) {
+    return;
+  }
+  startFetch(certRequest, state, continueValidation);
+}
+
+void
+CertificateFetcherNdnsCert::startFetch(const shared_ptr<security::CertificateRequest>& certRequest,
+                                       const shared_ptr<security::ValidationState>& state,
+                                       const ValidationContinuation& continueValidation)
+{
+  const Name& key = certRequest->interest.getName();
   Name domain = calculateDomain(key);
   if (domain.size() == m_startComponentIndex) {
     // NS record does not exist, since the domain is actually globally routable
@@ -67,6 +114,7 @@ CertificateFetcherNdnsCert::doFetch(const shared_ptr<security::CertificateReques
     },
     m_face, nullptr, m_nsCache.get());
   query->setStartComponentIndex(m_startComponentIndex);
+  query->setResolverCache(m_resolverCache);
   query->start();
 
   state->setTag(std::make_shared<IterativeQueryTag>(query));
@@ -98,16 +146,7 @@ CertificateFetcherNdnsCert::nsSuccessCallback(const Data& data,
     NDNS_LOG_WARN("fail to get NS rrset of " << interestName << " , returned data type:" << data.getContentType());
   }
 
-  m_face.expressInterest(interest,
-                         [=] (const Interest&, const Data& data) {
-                           dataCallback(data, certRequest, state, continueValidation);
-                         },
-                         [=] (const Interest&, const lp::Nack& nack) {
-                           nackCallback(nack, certRequest, state, continueValidation);
-                         },
-                         [=] (const Interest&) {
-                           timeoutCallback(certRequest, state, continueValidation);
-                         });
+  requestCertificate(interest, certRequest, state, continueValidation);
 }
 
 void
@@ -123,6 +162,31 @@ CertificateFetcherNdnsCert::nsFailCallback(const std::string& errMsg,
   interestName.append(label::CERT_RR_TYPE);
   Interest interest(interestName);
   interest.setCanBePrefix(true);
+  requestCertificate(interest, certRequest, state, continueValidation);
+}
+
+void
+CertificateFetcherNdnsCert::requestCertificate(const Interest& interest,
+                                               const shared_ptr<security::CertificateRequest>& certRequest,
+                                               const shared_ptr<security::ValidationState>& state,
+                                               const ValidationContinuation& continueValidation)
+{
+  if (m_isBundleEnabled) {
+    Name domain = calculateDomain(certRequest->interest.getName());
+    if (m_zonesWithoutBundle.count(domain) == 0) {
+      fetchBundle(domain, interest, certRequest, state, continueValidation);
+      return;
+    }
+  }
+  expressCertificateInterest(interest, certRequest, state, continueValidation);
+}
+
+void
+CertificateFetcherNdnsCert::expressCertificateInterest(const Interest& interest,
+                                                       const shared_ptr<security::CertificateRequest>& certRequest,
+                                                       const shared_ptr<security::ValidationState>& state,
+                                                       const ValidationContinuation& continueValidation)
+{
   m_face.expressInterest(interest,
                          [=] (const Interest&, const Data& data) {
                            dataCallback(data, certRequest, state, continueValidation);
@@ -135,6 +199,114 @@ CertificateFetcherNdnsCert::nsFailCallback(const std::string& errMsg,
                          });
 }
 
+void
+CertificateFetcherNdnsCert::fetchBundle(const Name& domain, const Interest& certInterest,
+                                        const shared_ptr<security::CertificateRequest>& certRequest,
+                                        const shared_ptr<security::ValidationState>& state,
+                                        const ValidationContinuation& continueValidation)
+{
+  Name bundleName(domain);
+  bundleName.append(label::NDNS_ITERATIVE_QUERY).append(label::BUNDLE_RR_TYPE);
+  Interest interest(bundleName);
+  interest.setCanBePrefix(true);
+  interest.setForwardingHint(certInterest.getForwardingHint());
+  interest.setInterestLifetime(certInterest.getInterestLifetime());
+  NDNS_LOG_INFO(" [* -> *] sending interest for certificate bundle:" << bundleName);
+
+  auto fallback = [=] (const std::string& reason) {
+    NDNS_LOG_DEBUG("No certificate bundle for " << domain << " (" << reason << ")");
+    markZoneWithoutBundle(domain);
+    expressCertificateInterest(certInterest, certRequest, state, continueValidation);
+  };
+  auto onBundle = [=] (const Data& data) {
+    bundleCallback(data, domain, certInterest, certRequest, state, continueValidation);
+  };
+  m_face.expressInterest(interest,
+                         [=] (const Interest&, const Data& data) {
+                           if (data.getContentType() == NDNS_SEGMENT) {
+                             // a long chain is served as a segmented record
+                             fetchRecordSegments(m_face, interest, data.getName().getPrefix(-1),
+                                                 onBundle, fallback);
+                             return;
+                           }
+                           onBundle(data);
+                         },
+                         [=] (const Interest&, const lp::Nack&) {
+                           fallback("Nack");
+                         },
+                         [=] (const Interest&) {
+                           fallback("timeout");
+                         });
+}
+
+void
+CertificateFetcherNdnsCert::bundleCallback(const Data& data, const Name& domain,
+                                           const Interest& certInterest,
+                                           const shared_ptr<security::CertificateRequest>& certRequest,
+                                           const shared_ptr<security::ValidationState>& state,
+                                           const ValidationContinuation& continueValidation)
+{
+  try {
+    CertificateBundle bundle(data);
+    NDNS_LOG_DEBUG("Fetched certificate bundle " << data.getName() << " with "
+                   << bundle.getCertificates().size() << " certificates");
+    for (const auto& cert : bundle.getCertificates()) {
+      insertBundledCertificate(cert);
+    }
+  }
+  catch (const CertificateBundle::Error& e) {
+    NDNS_LOG_DEBUG("No certificate bundle for " << domain << " (" << e.what() << ")");
+    markZoneWithoutBundle(domain);
+  }
+
+  const auto* cert = findBundledCertificate(certRequest->interest.getName());
+  if (cert == nullptr) {
+    expressCertificateInterest(certInterest, certRequest, state, continueValidation);
+    return;
+  }
+  // the bundle may be modified while validation continues
+  Certificate bundled = *cert;
+  dataCallback(bundled, certRequest, state, continueValidation);
+}
+
+void
+CertificateFetcherNdnsCert::insertBundledCertificate(const Certificate& cert)
+{
+  auto it = m_bundledCertIndex.find(cert.getName());
+  if (it != m_bundledCertIndex.end()) {
+    *it->second = cert;
+    m_bundledCerts.splice(m_bundledCerts.begin(), m_bundledCerts, it->second);
+    return;
+  }
+
+  if (m_bundledCerts.size() >= MAX_BUNDLED_CERTS) {
+    m_bundledCertIndex.erase(m_bundledCerts.back().getName());
+    m_bundledCerts.pop_back();
+  }
+  m_bundledCerts.push_front(cert);
+  m_bundledCertIndex.emplace(cert.getName(), m_bundledCerts.begin());
+}
+
+const Certificate*
+CertificateFetcherNdnsCert::findBundledCertificate(const Name& keyName)
+{
+  auto it = m_bundledCertIndex.lower_bound(keyName);
+  if (it == m_bundledCertIndex.end() || !keyName.isPrefixOf(it->first)) {
+    return nullptr;
+  }
+  m_bundledCerts.splice(m_bundledCerts.begin(), m_bundledCerts, it->second);
+  return &*it->second;
+}
+
+void
+CertificateFetcherNdnsCert::markZoneWithoutBundle(const Name& domain)
+{
+  // the zone may start serving a bundle later, e.g., after its name server is upgraded
+  m_zonesWithoutBundle[domain] = m_scheduler.schedule(NO_BUNDLE_LIFETIME, [this, domain] {
+    m_zonesWithoutBundle.erase(domain);
+  });
+}
+
 Name
 CertificateFetcherNdnsCert::calculateDomain(const Name& key)
 {
@@ -154,18 +326,30 @@ CertificateFetcherNdnsCert::dataCallback(const Data& data,
 {
   NDNS_LOG_DEBUG("Fetched certificate from network " << data.getName());
 
-  state->removeTag<IterativeQueryTag>();
+  if (m_resolverCache != nullptr) {
+    m_resolverCache->insert(Name(certRequest->interest.getName()).append(label::CERT_RR_TYPE),
+                            data, false);
+  }
+
+  onCertificateFetched(data);
+  continueWithCertificate(data, m_pendingFetches.take(certRequest->interest.getName()));
+}
 
+void
+CertificateFetcherNdnsCert::continueWithCertificate(const Data& data,
+                                                    const std::vector<PendingFetchTable::Requester>& requesters)
+{
   Certificate cert;
   try {
     cert = Certificate(data);
   }
   catch (const ndn::tlv::Error& e) {
-    return state->fail({security::ValidationError::Code::MALFORMED_CERT, "Fetched a malformed "
-                        "certificate `" + data.getName().toUri() + "` (" + e.what() + ")"});
+    return failFetch(requesters, {security::ValidationError::Code::MALFORMED_CERT,
+                                  "Fetched a malformed certificate `" +
+                                  data.getName().toUri() + "` (" + e.what() + ")"});
   }
 
-  continueValidation(cert, state);
+  completeFetch(requesters, cert);
 }
 
 void
@@ -180,12 +364,13 @@ CertificateFetcherNdnsCert::nackCallback(const lp::Nack& nack,
   --certRequest->nRetriesLeft;
   if (certRequest->nRetriesLeft >= 0) {
     // TODO implement delay for the the next fetch
-    fetch(certRequest, state, continueValidation);
+    startFetch(certRequest, state, continueValidation);
   }
   else {
-    state->removeTag<IterativeQueryTag>();
-    state->fail({security::ValidationError::Code::CANNOT_RETRIEVE_CERT, "Cannot fetch certificate "
-                 "after all retries `" + certRequest->interest.getName().toUri() + "`"});
+    const Name& key = certRequest->interest.getName();
+    failFetch(m_pendingFetches.take(key),
+              {security::ValidationError::Code::CANNOT_RETRIEVE_CERT,
+               "Cannot fetch certificate after all retries `" + key.toUri() + "`"});
   }
 }
 
@@ -199,12 +384,13 @@ CertificateFetcherNdnsCert::timeoutCallback(const shared_ptr<security::Certifica
 
   --certRequest->nRetriesLeft;
   if (certRequest->nRetriesLeft >= 0) {
-    fetch(certRequest, state, continueValidation);
+    startFetch(certRequest, state, continueValidation);
   }
   else {
-    state->removeTag<IterativeQueryTag>();
-    state->fail({security::ValidationError::Code::CANNOT_RETRIEVE_CERT, "Cannot fetch certificate "
-                 "after all retries `" + certRequest->interest.getName().toUri() + "`"});
+    const Name& key = certRequest->interest.getName();
+    failFetch(m_pendingFetches.take(key),
+              {security::ValidationError::Code::CANNOT_RETRIEVE_CERT,
+               "Cannot fetch certificate after all retries `" + key.toUri() + "`"});
   }
 }
 
@@ -20,36 +20,89 @@
 #ifndef NDNS_VALIDATOR_CERTIFICATE_FETCHER_NDNS_CERT_HPP
 #define NDNS_VALIDATOR_CERTIFICATE_FETCHER_NDNS_CERT_HPP
 
+#include "pending-fetch-table.hpp"
+#include "clients/ns-cache.hpp"
+
 #include <ndn-cxx/face.hpp>
-#include <ndn-cxx/ims/in-memory-storage.hpp>
 #include <ndn-cxx/security/certificate-fetcher.hpp>
+#include <ndn-cxx/util/scheduler.hpp>
+
+#include <list>
+#include <map>
 
 namespace ndn {
 namespace ndns {
 
+class ResolverCache;
+
 /**
  * @brief Fetch NDNS-owned certificate by an iterative query process
+ *
+ * Concurrent requests of the same certificate share a single fetch.
  */
 class CertificateFetcherNdnsCert : public security::CertificateFetcher
 {
 public:
+  /**
+   * @param resolverCache if not nullptr, certificates and NS records are looked up in this
+   *                      persistent cache before going to the network
+   */
   explicit
   CertificateFetcherNdnsCert(Face& face,
                              size_t nsCacheSize = 100,
-                             size_t startComponentIndex = 0);
+                             size_t startComponentIndex = 0,
+                             ResolverCache* resolverCache = nullptr);
 
-  InMemoryStorage*
+  NsCache*
   getNsCache()
   {
     return m_nsCache.get();
   }
 
+  /**
+   * @brief enable or disable the retrieval of certificate bundles
+   *
+   * When enabled, the first certificate needed from a zone is requested as part of the zone's
+   * certificate bundle (see CertificateBundle), and the following certificates of the chain
+   * are taken from the bundle instead of being fetched one by one. Zones that do not serve
+   * a bundle are remembered and queried for each certificate as usual.
+   */
+  void
+  setCertificateBundleEnabled(bool isEnabled)
+  {
+    m_isBundleEnabled = isEnabled;
+  }
+
 protected:
   void
   doFetch(const shared_ptr<security::CertificateRequest>& certRequest,
           const shared_ptr<security::ValidationState>& state,
           const ValidationContinuation& continueValidation) override;
 
+  /**
+   * @brief start fetching the certificate of a request that no other fetch can satisfy
+   */
+  void
+  startFetch(const shared_ptr<security::CertificateRequest>& certRequest,
+             const shared_ptr<security::ValidationState>& state,
+             const ValidationContinuation& continueValidation);
+
+  /**
+   * @brief called when a certificate is retrieved from the network, before it is verified
+   */
+  virtual void
+  onCertificateFetched(const Data& data)
+  {
+  }
+
+  /**
+   * @brief get NDNS query's domainName and label name by parsing keylocator
+   *
+   * The return result is the name prefix before "/NDNS"
+   */
+  static Name
+  calculateDomain(const Name& key);
+
 private:
   /**
    * @brief Callback invoked when NS rrset of the domain is retrived, including nack rrset
@@ -71,13 +124,58 @@ private:
                  const shared_ptr<security::ValidationState>& state,
                  const ValidationContinuation& continueValidation);
 
+
   /**
-   * @brief get NDNS query's domainName and label name by parsing keylocator
-   *
-   * The return result is the name prefix before "/NDNS"
+   * @brief request a certificate through the zone's bundle if possible, @p interest otherwise
    */
-  Name
-  calculateDomain(const Name& key);
+  void
+  requestCertificate(const Interest& interest,
+                     const shared_ptr<security::CertificateRequest>& certRequest,
+                     const shared_ptr<security::ValidationState>& state,
+                     const ValidationContinuation& continueValidation);
+
+  /**
+   * @brief express the Interest for a single certificate
+   */
+  void
+  expressCertificateInterest(const Interest& interest,
+                             const shared_ptr<security::CertificateRequest>& certRequest,
+                             const shared_ptr<security::ValidationState>& state,
+                             const ValidationContinuation& continueValidation);
+
+  /**
+   * @brief fetch the certificate bundle of @p domain, falling back to @p certInterest if the
+   *        bundle cannot be retrieved or does not contain the requested certificate
+   */
+  void
+  fetchBundle(const Name& domain, const Interest& certInterest,
+              const shared_ptr<security::CertificateRequest>& certRequest,
+              const shared_ptr<security::ValidationState>& state,
+              const ValidationContinuation& continueValidation);
+
+  void
+  bundleCallback(const Data& data, const Name& domain, const Interest& certInterest,
+                 const shared_ptr<security::CertificateRequest>& certRequest,
+                 const shared_ptr<security::ValidationState>& state,
+                 const ValidationContinuation& continueValidation);
+
+  /**
+   * @brief keep @p cert received in a bundle, evicting the least recently used one if full
+   */
+  void
+  insertBundledCertificate(const security::Certificate& cert);
+
+  /**
+   * @return a certificate matching @p keyName received in a bundle, or nullptr
+   */
+  const security::Certificate*
+  findBundledCertificate(const Name& keyName);
+
+  /**
+   * @brief stop fetching the bundle of @p domain for a while
+   */
+  void
+  markZoneWithoutBundle(const Name& domain);
 
   /**
    * @brief Callback invoked when certificate is retrieved.
@@ -87,6 +185,15 @@ private:
                const shared_ptr<security::CertificateRequest>& certRequest,
                const shared_ptr<security::ValidationState>& state,
                const ValidationContinuation& continueValidation);
+
+  /**
+   * @brief continue validation of all @p requesters with a certificate retrieved from the
+   *        network or the cache
+   */
+  void
+  continueWithCertificate(const Data& data,
+                          const std::vector<PendingFetchTable::Requester>& requesters);
+
   /**
    * @brief Callback invoked when interest for fetching certificate gets NACKed.
    *
@@ -111,10 +218,21 @@ private:
                   const ValidationContinuation& continueValidation);
 protected:
   Face& m_face;
-  unique_ptr<InMemoryStorage> m_nsCache;
+  unique_ptr<NsCache> m_nsCache;
+  ResolverCache* m_resolverCache;
+  PendingFetchTable m_pendingFetches;
 
 private:
   size_t m_startComponentIndex;
+
+  bool m_isBundleEnabled = false;
+  using BundledCertList = std::list<security::Certificate>;
+  BundledCertList m_bundledCerts; ///< unverified, most recently used first
+  std::map<Name, BundledCertList::iterator> m_bundledCertIndex;
+
+  Scheduler m_scheduler;
+  /// zones whose bundle could not be retrieved => removal of the entry
+  std::map<Name, scheduler::ScopedEventId> m_zonesWithoutBundle;
 };
 
 } // namespace ndns
@@ -0,0 +1,78 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pending-fetch-table.hpp"
+#include "clients/iterative-query-controller.hpp"
+#include "logger.hpp"
+
+namespace ndn {
+namespace ndns {
+
+NDNS_LOG_INIT(PendingFetchTable);
+
+bool
+PendingFetchTable::add(const Name& name, Requester requester)
+{
+  auto& requesters = m_fetches[name];
+  requesters.push_back(std::move(requester));
+  if (requesters.size() == 1) {
+    return false;
+  }
+
+  NDNS_LOG_DEBUG("attach to in-flight fetch of " << name << " (" << requesters.size()
+                 << " requesters)");
+  ++m_nAttached;
+  return true;
+}
+
+std::vector<PendingFetchTable::Requester>
+PendingFetchTable::take(const Name& name)
+{
+  auto it = m_fetches.find(name);
+  if (it == m_fetches.end()) {
+    return {};
+  }
+
+  auto requesters = std::move(it->second);
+  m_fetches.erase(it);
+  return requesters;
+}
+
+void
+completeFetch(const std::vector<PendingFetchTable::Requester>& requesters,
+              const security::Certificate& cert)
+{
+  for (const auto& requester : requesters) {
+    requester.state->removeTag<IterativeQueryTag>();
+    requester.continueValidation(cert, requester.state);
+  }
+}
+
+void
+failFetch(const std::vector<PendingFetchTable::Requester>& requesters,
+          const security::ValidationError& error)
+{
+  for (const auto& requester : requesters) {
+    requester.state->removeTag<IterativeQueryTag>();
+    requester.state->fail(error);
+  }
+}
+
+} // namespace ndns
+} // namespace ndn
@@ -0,0 +1,100 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDNS_VALIDATOR_PENDING_FETCH_TABLE_HPP
+#define NDNS_VALIDATOR_PENDING_FETCH_TABLE_HPP
+
+#include "common.hpp"
+
+#include <ndn-cxx/security/certificate-fetcher.hpp>
+
+#include <map>
+
+namespace ndn {
+namespace ndns {
+
+/**
+ * @brief in-flight certificate fetches of a fetcher, keyed by the requested name
+ *
+ * The first request of a name starts the fetch, later requests of the same name are attached
+ * to it and complete with the same certificate or error.
+ */
+class PendingFetchTable : boost::noncopyable
+{
+public:
+  struct Requester
+  {
+    shared_ptr<security::CertificateRequest> certRequest;
+    shared_ptr<security::ValidationState> state;
+    security::CertificateFetcher::ValidationContinuation continueValidation;
+  };
+
+  /**
+   * @brief register @p requester for the certificate @p name
+   * @return true if a fetch of @p name is already in flight and @p requester was attached to
+   *         it, false if the caller must start the fetch
+   */
+  bool
+  add(const Name& name, Requester requester);
+
+  /**
+   * @brief complete the fetch of @p name
+   * @return the requesters of @p name, the one that started the fetch first
+   */
+  std::vector<Requester>
+  take(const Name& name);
+
+  size_t
+  size() const
+  {
+    return m_fetches.size();
+  }
+
+  /**
+   * @return number of requests that did not start a fetch of their own
+   */
+  size_t
+  getNAttached() const
+  {
+    return m_nAttached;
+  }
+
+private:
+  std::map<Name, std::vector<Requester>> m_fetches;
+  size_t m_nAttached = 0;
+};
+
+/**
+ * @brief complete all @p requesters with @p cert
+ */
+void
+completeFetch(const std::vector<PendingFetchTable::Requester>& requesters,
+              const security::Certificate& cert);
+
+/**
+ * @brief fail all @p requesters with @p error
+ */
+void
+failFetch(const std::vector<PendingFetchTable::Requester>& requesters,
+          const security::ValidationError& error);
+
+} // namespace ndns
+} // namespace ndn
+
+#endif // NDNS_VALIDATOR_PENDING_FETCH_TABLE_HPP
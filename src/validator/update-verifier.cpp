@@ -0,0 +1,227 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "update-verifier.hpp"
+#include "logger.hpp"
+
+#include <ndn-cxx/security/validation-policy.hpp>
+#include <ndn-cxx/security/verification-helpers.hpp>
+
+#include <boost/asio/post.hpp>
+
+namespace ndn {
+namespace ndns {
+
+NDNS_LOG_INIT(UpdateVerifier);
+
+namespace {
+
+/**
+ * @brief validation state that only records the outcome of the policy check
+ */
+class PolicyCheckState final : public security::ValidationState
+{
+public:
+  void
+  fail(const security::ValidationError& error) final
+  {
+    m_outcome = false;
+    m_error = error;
+  }
+
+  void
+  accept()
+  {
+    m_outcome = true;
+  }
+
+  const std::optional<security::ValidationError>&
+  getError() const
+  {
+    return m_error;
+  }
+
+private:
+  void
+  verifyOriginalPacket(const std::optional<security::Certificate>&) final
+  {
+    BOOST_ASSERT_MSG(false, "policy check never reaches signature verification");
+  }
+
+  void
+  bypassValidation() final
+  {
+    m_outcome = true;
+  }
+
+private:
+  std::optional<security::ValidationError> m_error;
+};
+
+} // namespace
+
+UpdateVerifier::UpdateVerifier(security::Validator& validator, boost::asio::io_service& io,
+                               size_t nThreads)
+  : m_validator(validator)
+  , m_io(io)
+  , m_pool(nThreads)
+{
+  BOOST_ASSERT(nThreads > 0);
+}
+
+UpdateVerifier::~UpdateVerifier()
+{
+  // results posted by the workers after this point are dropped
+  *m_isAlive = false;
+  m_pool.join();
+}
+
+void
+UpdateVerifier::verify(const shared_ptr<const Data>& data,
+                       const security::DataValidationSuccessCallback& successCb,
+                       const security::DataValidationFailureCallback& failureCb)
+{
+  auto job = make_shared<Job>();
+  job->data = data;
+  job->successCb = successCb;
+  job->failureCb = failureCb;
+  job->submitTime = time::steady_clock::now();
+  m_queue.push_back(job);
+  m_maxQueueDepth = std::max(m_maxQueueDepth, m_queue.size());
+
+  if (m_validationCache != nullptr && m_validationCache->contains(*data)) {
+    NDNS_LOG_TRACE("skip verification of already validated " << data->getName());
+    complete(job, std::nullopt);
+    return;
+  }
+
+  auto state = make_shared<PolicyCheckState>();
+  shared_ptr<security::CertificateRequest> certRequest;
+  m_validator.getPolicy().checkPolicy(*data, state,
+    [&] (const shared_ptr<security::CertificateRequest>& request,
+         const shared_ptr<security::ValidationState>&) {
+      certRequest = request;
+      state->accept();
+    });
+
+  if (state->getError()) {
+    complete(job, state->getError());
+    return;
+  }
+  if (certRequest == nullptr) {
+    // the policy does not require a signature
+    complete(job, std::nullopt);
+    return;
+  }
+
+  const auto* cert = m_validator.findTrustedCert(certRequest->interest);
+  if (cert != nullptr && cert->isValid()) {
+    offload(job, *cert);
+    return;
+  }
+
+  // the signer is not verified yet: let the validator fetch and verify the certificate chain,
+  // so that the following updates by the same signer can be offloaded
+  NDNS_LOG_TRACE("validate " << data->getName() << " on the Face thread");
+  ++m_nFallbacks;
+  m_validator.validate(*data,
+                       [this, job, isAlive = m_isAlive] (const Data&) {
+                         if (!*isAlive)
+                           return;
+                         if (m_validationCache != nullptr) {
+                           m_validationCache->insert(*job->data, m_validator);
+                         }
+                         complete(job, std::nullopt);
+                       },
+                       [this, job, isAlive = m_isAlive] (const Data&,
+                                                         const security::ValidationError& error) {
+                         if (!*isAlive)
+                           return;
+                         complete(job, error);
+                       });
+}
+
+void
+UpdateVerifier::offload(const shared_ptr<Job>& job, const security::Certificate& cert)
+{
+  ++m_nOffloaded;
+  // the wire encoding is created on this thread, the worker only reads it
+  job->data->wireEncode();
+
+  boost::asio::post(m_pool, [this, job, cert, isAlive = m_isAlive] {
+    bool isValid = security::verifySignature(*job->data, cert.getPublicKey());
+
+    boost::asio::post(m_io, [this, job, cert, isAlive, isValid] {
+      if (!*isAlive)
+        return;
+
+      if (!isValid) {
+        complete(job, security::ValidationError(security::ValidationError::INVALID_SIGNATURE,
+                                                "Invalid signature of " + job->data->getName().toUri()));
+        return;
+      }
+      if (m_validationCache != nullptr) {
+        m_validationCache->insert(*job->data, cert.getValidityPeriod().getPeriod().second);
+      }
+      complete(job, std::nullopt);
+    });
+  });
+}
+
+void
+UpdateVerifier::complete(const shared_ptr<Job>& job, std::optional<security::ValidationError> error)
+{
+  job->isDone = true;
+  job->error = std::move(error);
+
+  auto latency = time::steady_clock::now() - job->submitTime;
+  ++m_nCompleted;
+  m_totalLatency += latency;
+  m_maxLatency = std::max(m_maxLatency, time::duration_cast<time::nanoseconds>(latency));
+
+  deliver();
+}
+
+void
+UpdateVerifier::deliver()
+{
+  if (m_isDelivering) {
+    // a callback submitted or completed another update, the outer loop picks it up
+    return;
+  }
+
+  m_isDelivering = true;
+  while (!m_queue.empty() && m_queue.front()->isDone) {
+    auto job = std::move(m_queue.front());
+    m_queue.pop_front();
+
+    if (job->error) {
+      NDNS_LOG_DEBUG("update " << job->data->getName() << " failed verification: " << *job->error);
+      if (job->failureCb != nullptr)
+        job->failureCb(*job->data, *job->error);
+    }
+    else if (job->successCb != nullptr) {
+      job->successCb(*job->data);
+    }
+  }
+  m_isDelivering = false;
+}
+
+} // namespace ndns
+} // namespace ndn
@@ -0,0 +1,166 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDNS_VALIDATOR_UPDATE_VERIFIER_HPP
+#define NDNS_VALIDATOR_UPDATE_VERIFIER_HPP
+
+#include "validation-cache.hpp"
+
+#include <ndn-cxx/security/validator.hpp>
+
+#include <boost/asio/io_service.hpp>
+#include <boost/asio/thread_pool.hpp>
+
+#include <deque>
+#include <optional>
+
+namespace ndn {
+namespace ndns {
+
+/**
+ * @brief verifies the signatures of NDNS updates on a pool of worker threads
+ *
+ * The validation policy is checked and the signer certificate is looked up on the calling
+ * thread. When the signer certificate has already been verified by the validator, only the
+ * signature check remains, and it runs on a worker thread; otherwise the update goes through
+ * the validator as usual. Either way, callbacks are invoked on the thread running @p io in the
+ * order in which the updates were submitted.
+ */
+class UpdateVerifier : boost::noncopyable
+{
+public:
+  /**
+   * @param validator validator whose policy and verified certificates are used
+   * @param io the event loop of the Face, on which callbacks are invoked
+   * @param nThreads number of worker threads, must be positive
+   */
+  UpdateVerifier(security::Validator& validator, boost::asio::io_service& io, size_t nThreads);
+
+  ~UpdateVerifier();
+
+  /**
+   * @brief set the cache of validation results consulted before verifying each update
+   */
+  void
+  setValidationCache(ValidationCache* cache)
+  {
+    m_validationCache = cache;
+  }
+
+  /**
+   * @brief verify @p data, invoking exactly one of @p successCb and @p failureCb
+   *
+   * Callbacks may be invoked before this function returns, if no update is queued before
+   * @p data and the outcome is known immediately.
+   */
+  void
+  verify(const shared_ptr<const Data>& data,
+         const security::DataValidationSuccessCallback& successCb,
+         const security::DataValidationFailureCallback& failureCb);
+
+  /**
+   * @return number of updates whose callbacks have not been invoked yet
+   */
+  size_t
+  getQueueDepth() const
+  {
+    return m_queue.size();
+  }
+
+  size_t
+  getMaxQueueDepth() const
+  {
+    return m_maxQueueDepth;
+  }
+
+  /**
+   * @return number of signatures verified on worker threads
+   */
+  size_t
+  getNOffloaded() const
+  {
+    return m_nOffloaded;
+  }
+
+  /**
+   * @return number of updates handed to the validator, because their signer was not verified yet
+   */
+  size_t
+  getNFallbacks() const
+  {
+    return m_nFallbacks;
+  }
+
+  /**
+   * @return mean time between the submission of an update and the end of its verification
+   */
+  time::nanoseconds
+  getMeanLatency() const
+  {
+    return m_nCompleted == 0 ? 0_ns : m_totalLatency / m_nCompleted;
+  }
+
+  time::nanoseconds
+  getMaxLatency() const
+  {
+    return m_maxLatency;
+  }
+
+private:
+  struct Job
+  {
+    shared_ptr<const Data> data;
+    security::DataValidationSuccessCallback successCb;
+    security::DataValidationFailureCallback failureCb;
+    time::steady_clock::time_point submitTime;
+    bool isDone = false;
+    std::optional<security::ValidationError> error;
+  };
+
+  void
+  offload(const shared_ptr<Job>& job, const security::Certificate& cert);
+
+  void
+  complete(const shared_ptr<Job>& job, std::optional<security::ValidationError> error);
+
+  void
+  deliver();
+
+private:
+  security::Validator& m_validator;
+  boost::asio::io_service& m_io;
+  boost::asio::thread_pool m_pool;
+  ValidationCache* m_validationCache = nullptr;
+
+  std::deque<shared_ptr<Job>> m_queue; ///< in the order of submission
+  bool m_isDelivering = false;
+  shared_ptr<bool> m_isAlive = make_shared<bool>(true);
+
+  size_t m_maxQueueDepth = 0;
+  size_t m_nOffloaded = 0;
+  size_t m_nFallbacks = 0;
+  size_t m_nCompleted = 0;
+  time::nanoseconds m_totalLatency = 0_ns;
+  time::nanoseconds m_maxLatency = 0_ns;
+};
+
+} // namespace ndns
+} // namespace ndn
+
+#endif // NDNS_VALIDATOR_UPDATE_VERIFIER_HPP
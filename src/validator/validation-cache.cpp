@@ -0,0 +1,135 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "validation-cache.hpp"
+#include "logger.hpp"
+
+#include <ndn-cxx/security/certificate.hpp>
+
+namespace ndn {
+namespace ndns {
+
+NDNS_LOG_INIT(ValidationCache);
+
+ValidationCache::ValidationCache(size_t capacity, time::nanoseconds maxLifetime)
+  : m_capacity(capacity)
+  , m_maxLifetime(maxLifetime)
+{
+  BOOST_ASSERT(m_capacity > 0);
+}
+
+void
+ValidationCache::validate(security::Validator& validator, const Data& data,
+                          const security::DataValidationSuccessCallback& successCb,
+                          const security::DataValidationFailureCallback& failureCb)
+{
+  if (contains(data)) {
+    NDNS_LOG_TRACE("skip validation of already validated " << data.getName());
+    successCb(data);
+    return;
+  }
+
+  validator.validate(data,
+                     [this, &validator, successCb] (const Data& data) {
+                       insert(data, validator);
+                       successCb(data);
+                     },
+                     failureCb);
+}
+
+bool
+ValidationCache::contains(const Data& data)
+{
+  auto it = m_index.find(data.getFullName().get(-1));
+  if (it == m_index.end()) {
+    ++m_nMisses;
+    return false;
+  }
+
+  auto entry = it->second;
+  if (entry->epoch != m_epoch || entry->notAfter <= time::system_clock::now()) {
+    m_entries.erase(entry);
+    m_index.erase(it);
+    ++m_nMisses;
+    return false;
+  }
+
+  m_entries.splice(m_entries.begin(), m_entries, entry);
+  ++m_nHits;
+  return true;
+}
+
+void
+ValidationCache::insert(const Data& data, time::system_clock::time_point notAfter)
+{
+  notAfter = std::min(notAfter, time::system_clock::now() + m_maxLifetime);
+  const auto& digest = data.getFullName().get(-1);
+
+  auto it = m_index.find(digest);
+  if (it != m_index.end()) {
+    it->second->epoch = m_epoch;
+    it->second->notAfter = notAfter;
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return;
+  }
+
+  if (m_entries.size() >= m_capacity) {
+    m_index.erase(m_entries.back().digest);
+    m_entries.pop_back();
+  }
+  m_entries.push_front({digest, m_epoch, notAfter});
+  m_index.emplace(digest, m_entries.begin());
+}
+
+void
+ValidationCache::scheduleEpochBumps(Scheduler& scheduler, time::nanoseconds period)
+{
+  m_epochEvent.cancel();
+  if (period == time::nanoseconds::max()) {
+    return;
+  }
+
+  BOOST_ASSERT(period > 0_ns);
+  m_epochEvent = scheduler.schedule(period, [this, &scheduler, period] {
+    NDNS_LOG_DEBUG("trust anchors may have been refreshed, invalidate validation results");
+    bumpEpoch();
+    scheduleEpochBumps(scheduler, period);
+  });
+}
+
+void
+ValidationCache::insert(const Data& data, const security::Validator& validator)
+{
+  auto notAfter = time::system_clock::time_point::max();
+
+  const auto& sigInfo = data.getSignatureInfo();
+  if (sigInfo.hasKeyLocator() && sigInfo.getKeyLocator().getType() == ndn::tlv::Name) {
+    Interest certInterest(sigInfo.getKeyLocator().getName());
+    certInterest.setCanBePrefix(true);
+    const auto* cert = validator.findTrustedCert(certInterest);
+    if (cert != nullptr) {
+      notAfter = cert->getValidityPeriod().getPeriod().second;
+    }
+  }
+
+  insert(data, notAfter);
+}
+
+} // namespace ndns
+} // namespace ndn
@@ -0,0 +1,152 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDNS_VALIDATOR_VALIDATION_CACHE_HPP
+#define NDNS_VALIDATOR_VALIDATION_CACHE_HPP
+
+#include "common.hpp"
+
+#include <ndn-cxx/security/validator.hpp>
+#include <ndn-cxx/util/scheduler.hpp>
+#include <ndn-cxx/util/time.hpp>
+
+#include <list>
+#include <map>
+
+namespace ndn {
+namespace ndns {
+
+/**
+ * @brief bounded cache of Data packets that passed validation
+ *
+ * Entries are keyed by the implicit SHA-256 digest of the packet, so only the very same signed
+ * packet can hit, and tagged with the trust anchor epoch at insertion time. An entry expires at
+ * the end of the validity period of its signer certificate, or after the maximum lifetime if
+ * that happens first. The least recently used entry is evicted when the cache is full.
+ */
+class ValidationCache : boost::noncopyable
+{
+public:
+  explicit
+  ValidationCache(size_t capacity = 10000, time::nanoseconds maxLifetime = 1_h);
+
+  /**
+   * @brief validate @p data unless an identical packet already passed validation
+   *
+   * On a hit, @p successCb is invoked before this function returns. Otherwise @p data is
+   * validated by @p validator and inserted on success. The cache and @p validator must outlive
+   * the pending validation.
+   */
+  void
+  validate(security::Validator& validator, const Data& data,
+           const security::DataValidationSuccessCallback& successCb,
+           const security::DataValidationFailureCallback& failureCb);
+
+  /**
+   * @return whether @p data passed validation in the current epoch and its entry has not expired
+   */
+  bool
+  contains(const Data& data);
+
+  /**
+   * @brief record that @p data passed validation, the entry expires at @p notAfter
+   */
+  void
+  insert(const Data& data, time::system_clock::time_point notAfter);
+
+  /**
+   * @brief record that @p data passed validation by @p validator
+   *
+   * The expiry is taken from the signer certificate, if @p validator knows it.
+   */
+  void
+  insert(const Data& data, const security::Validator& validator);
+
+  /**
+   * @brief invalidate all entries, to be called whenever trust anchors are changed
+   */
+  void
+  bumpEpoch()
+  {
+    ++m_epoch;
+  }
+
+  /**
+   * @brief bump the epoch every @p period, for trust anchors that the validator reloads
+   *        periodically without notice
+   *
+   * Pending bumps are cancelled when @p period is time::nanoseconds::max(), or when the cache
+   * is destroyed. @p scheduler must outlive the cache.
+   * @sa ValidationPolicyNdns::getAnchorRefreshPeriod
+   */
+  void
+  scheduleEpochBumps(Scheduler& scheduler, time::nanoseconds period);
+
+  uint64_t
+  getEpoch() const
+  {
+    return m_epoch;
+  }
+
+  size_t
+  size() const
+  {
+    return m_entries.size();
+  }
+
+  size_t
+  getNHits() const
+  {
+    return m_nHits;
+  }
+
+  size_t
+  getNMisses() const
+  {
+    return m_nMisses;
+  }
+
+private:
+  struct Entry
+  {
+    name::Component digest;
+    uint64_t epoch;
+    time::system_clock::time_point notAfter;
+  };
+
+  using EntryList = std::list<Entry>;
+
+private:
+  const size_t m_capacity;
+  const time::nanoseconds m_maxLifetime;
+  uint64_t m_epoch = 0;
+
+  EntryList m_entries; ///< most recently used first
+  std::map<name::Component, EntryList::iterator> m_index;
+
+  size_t m_nHits = 0;
+  size_t m_nMisses = 0;
+
+  scheduler::ScopedEventId m_epochEvent;
+};
+
+} // namespace ndns
+} // namespace ndn
+
+#endif // NDNS_VALIDATOR_VALIDATION_CACHE_HPP
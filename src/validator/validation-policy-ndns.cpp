@@ -0,0 +1,257 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "validation-policy-ndns.hpp"
+#include "ndns-label.hpp"
+#include "logger.hpp"
+
+#include <ndn-cxx/security/certificate.hpp>
+#include <ndn-cxx/security/validation-state.hpp>
+#include <ndn-cxx/security/validator.hpp>
+#include <ndn-cxx/util/io.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/property_tree/info_parser.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace ndn {
+namespace ndns {
+
+NDNS_LOG_INIT(ValidationPolicyNdns);
+
+using security::ValidationError;
+
+/**
+ * @return index of the first NDNS component of @p name, or nullopt if there is none
+ */
+static std::optional<size_t>
+findNdnsComponent(const Name& name)
+{
+  for (size_t i = 0; i < name.size(); ++i) {
+    if (name[i] == label::NDNS_ITERATIVE_QUERY) {
+      return i;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<Name>
+ValidationPolicyNdns::getKeyZone(const Name& keyName, bool isSameZone)
+{
+  auto ndnsIdx = findNdnsComponent(keyName);
+  if (!ndnsIdx || keyName.size() < *ndnsIdx + 3 ||
+      keyName.get(-2) != security::Certificate::KEY_COMPONENT) {
+    return std::nullopt;
+  }
+  if (isSameZone && keyName.size() != *ndnsIdx + 3) {
+    return std::nullopt;
+  }
+
+  Name zone = keyName.getPrefix(*ndnsIdx);
+  zone.append(keyName.getSubName(*ndnsIdx + 1, keyName.size() - *ndnsIdx - 3));
+  return zone;
+}
+
+void
+ValidationPolicyNdns::checkPolicy(const Data& data,
+                                  const shared_ptr<security::ValidationState>& state,
+                                  const ValidationContinuation& continueValidation)
+{
+  if (m_shouldBypass) {
+    return continueValidation(nullptr, state);
+  }
+
+  Name klName = security::getKeyLocatorName(data, *state);
+  if (!state->getOutcome()) { // already failed
+    return;
+  }
+
+  const Name& name = data.getName();
+  auto ndnsIdx = findNdnsComponent(name);
+  if (!ndnsIdx || name.size() < *ndnsIdx + 3) {
+    return state->fail({ValidationError::Code::POLICY_ERROR,
+                        "No rule matched for data `" + name.toUri() + "`"});
+  }
+
+  if (data.getSignatureType() != ndn::tlv::SignatureSha256WithEcdsa) {
+    return state->fail({ValidationError::Code::POLICY_ERROR,
+                        "Signature type `" + std::to_string(data.getSignatureType()) +
+                        "` is not allowed for `" + name.toUri() + "`"});
+  }
+
+  // certificates of a zone are signed either by the parent zone or by the zone itself,
+  // any other Data only by the zone itself
+  bool isCertificate = name.size() == *ndnsIdx + 5 &&
+                       name[*ndnsIdx + 1] == security::Certificate::KEY_COMPONENT;
+  auto keyZone = getKeyZone(klName, !isCertificate);
+  if (!keyZone || *keyZone != name.getPrefix(*ndnsIdx)) {
+    return state->fail({ValidationError::Code::POLICY_ERROR,
+                        "KeyLocator `" + klName.toUri() + "` is not allowed to sign `" +
+                        name.toUri() + "`"});
+  }
+
+  continueValidation(make_shared<security::CertificateRequest>(klName), state);
+}
+
+void
+ValidationPolicyNdns::checkPolicy(const Interest& interest,
+                                  const shared_ptr<security::ValidationState>& state,
+                                  const ValidationContinuation& continueValidation)
+{
+  if (m_shouldBypass) {
+    return continueValidation(nullptr, state);
+  }
+
+  state->fail({ValidationError::Code::POLICY_ERROR,
+               "No rule matched for interest `" + interest.getName().toUri() + "`"});
+}
+
+void
+ValidationPolicyNdns::load(const std::string& filename)
+{
+  std::ifstream input(filename);
+  if (!input) {
+    NDN_THROW(Error("Failed to read configuration file: " + filename));
+  }
+  load(input, filename);
+}
+
+void
+ValidationPolicyNdns::load(std::istream& input, const std::string& filename)
+{
+  boost::property_tree::ptree config;
+  try {
+    boost::property_tree::read_info(input, config);
+  }
+  catch (const boost::property_tree::info_parser_error& e) {
+    NDN_THROW(Error("Failed to parse configuration file " + filename + ": " + e.message() +
+                    " on line " + std::to_string(e.line())));
+  }
+  load(config, filename);
+}
+
+void
+ValidationPolicyNdns::load(const boost::property_tree::ptree& config, const std::string& filename)
+{
+  BOOST_ASSERT(m_validator != nullptr);
+
+  m_shouldBypass = false;
+  m_anchorRefreshPeriod = time::nanoseconds::max();
+  m_validator->resetAnchors();
+
+  for (const auto& [key, section] : config) {
+    if (key == "rule") {
+      NDNS_LOG_TRACE("skip rule section of " << filename << ", NDNS rules are built in");
+    }
+    else if (key == "trust-anchor") {
+      processTrustAnchor(section, filename);
+    }
+    else {
+      NDN_THROW(Error("Error processing configuration file " + filename +
+                      ": unrecognized section " + key));
+    }
+  }
+}
+
+/**
+ * @return the refresh period of a file or dir trust anchor, as in ValidationPolicyConfig
+ */
+static time::nanoseconds
+getRefreshPeriod(const boost::property_tree::ptree& section)
+{
+  auto refresh = section.get_optional<std::string>("refresh");
+  if (!refresh) {
+    return time::nanoseconds::max();
+  }
+
+  uint64_t period = 0;
+  char unit = '\0';
+  try {
+    period = std::stoull(refresh->substr(0, refresh->size() - 1));
+    unit = refresh->back();
+  }
+  catch (const std::logic_error&) {
+    // reported below as a bad unit
+  }
+
+  time::nanoseconds refreshPeriod;
+  switch (unit) {
+    case 'h':
+      refreshPeriod = time::hours(period);
+      break;
+    case 'm':
+      refreshPeriod = time::minutes(period);
+      break;
+    case 's':
+      refreshPeriod = time::seconds(period);
+      break;
+    default:
+      NDN_THROW(ValidationPolicyNdns::Error("Bad refresh value `" + *refresh + "`"));
+  }
+  return refreshPeriod == 0_ns ? 1_h : refreshPeriod;
+}
+
+void
+ValidationPolicyNdns::processTrustAnchor(const boost::property_tree::ptree& section,
+                                         const std::string& filename)
+{
+  namespace fs = boost::filesystem;
+
+  auto type = section.get<std::string>("type", "");
+  if (type == "file") {
+    auto file = section.get_optional<std::string>("file-name");
+    if (!file) {
+      NDN_THROW(Error("Expecting <trust-anchor.file-name> in " + filename));
+    }
+    auto path = fs::absolute(*file, fs::path(filename).parent_path());
+    auto refreshPeriod = getRefreshPeriod(section);
+    m_anchorRefreshPeriod = std::min(m_anchorRefreshPeriod, refreshPeriod);
+    m_validator->loadAnchor(*file, path.string(), refreshPeriod, false);
+  }
+  else if (type == "base64") {
+    std::istringstream is(section.get<std::string>("base64-string", ""));
+    auto cert = io::load<security::Certificate>(is);
+    if (cert == nullptr) {
+      NDN_THROW(Error("Cannot decode <trust-anchor.base64-string> in " + filename));
+    }
+    m_validator->loadAnchor("", std::move(*cert));
+  }
+  else if (type == "dir") {
+    auto dir = section.get_optional<std::string>("dir");
+    if (!dir) {
+      NDN_THROW(Error("Expecting <trust-anchor.dir> in " + filename));
+    }
+    auto path = fs::absolute(*dir, fs::path(filename).parent_path());
+    auto refreshPeriod = getRefreshPeriod(section);
+    m_anchorRefreshPeriod = std::min(m_anchorRefreshPeriod, refreshPeriod);
+    m_validator->loadAnchor(*dir, path.string(), refreshPeriod, true);
+  }
+  else if (type == "any") {
+    m_shouldBypass = true;
+  }
+  else {
+    NDN_THROW(Error("Unrecognized <trust-anchor.type> `" + type + "` in " + filename));
+  }
+}
+
+} // namespace ndns
+} // namespace ndn
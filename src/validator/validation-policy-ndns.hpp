@@ -0,0 +1,114 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NDNS_VALIDATOR_VALIDATION_POLICY_NDNS_HPP
+#define NDNS_VALIDATOR_VALIDATION_POLICY_NDNS_HPP
+
+#include "common.hpp"
+
+#include <ndn-cxx/security/validation-policy.hpp>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <optional>
+
+namespace ndn {
+namespace ndns {
+
+/**
+ * @brief validation policy of the NDNS naming rules
+ *
+ * Accepts the same packets as the rules of validator.conf, without evaluating regular
+ * expressions:
+ *  - a certificate `<zone>/NDNS/KEY/<key-id>/<issuer>/<version>` must be signed by a key
+ *    `<parent>/NDNS/<label>/KEY/<key-id>` with `<parent>/<label>` equal to `<zone>`, so a
+ *    KSK is signed by the DSK of the parent zone and a DSK by the KSK of its own zone;
+ *  - any other Data `<zone>/NDNS/<label>/<type>/<version>` must be signed by a key
+ *    `<zone>/NDNS/KEY/<key-id>` of its own zone.
+ *
+ * In both cases `<zone>` ends before the first NDNS component and the signature must be
+ * ECDSA. Trust anchors are loaded from the `trust-anchor` sections of the configuration file.
+ */
+class ValidationPolicyNdns : public security::ValidationPolicy
+{
+public:
+  class Error : public std::runtime_error
+  {
+  public:
+    using std::runtime_error::runtime_error;
+  };
+
+  /**
+   * @brief load trust anchors from a validator.conf file
+   *
+   * `rule` sections are skipped, since the NDNS rules are built into this policy.
+   * The policy must be attached to a validator.
+   *
+   * @throw Error the file cannot be read or contains an invalid section
+   */
+  void
+  load(const std::string& filename);
+
+  void
+  load(std::istream& input, const std::string& filename);
+
+  void
+  load(const boost::property_tree::ptree& config, const std::string& filename);
+
+  /**
+   * @return the shortest refresh period of the file and dir trust anchors, after which the
+   *         validator may have reloaded them; time::nanoseconds::max() if none is refreshed
+   */
+  time::nanoseconds
+  getAnchorRefreshPeriod() const
+  {
+    return m_anchorRefreshPeriod;
+  }
+
+  void
+  checkPolicy(const Data& data, const shared_ptr<security::ValidationState>& state,
+              const ValidationContinuation& continueValidation) override;
+
+  void
+  checkPolicy(const Interest& interest, const shared_ptr<security::ValidationState>& state,
+              const ValidationContinuation& continueValidation) override;
+
+NDNS_PUBLIC_WITH_TESTS_ELSE_PRIVATE:
+  /**
+   * @return the zone authorized by key @p keyName, i.e., its components before and after the
+   *         first NDNS component without the trailing `KEY/<key-id>`; nullopt if @p keyName is
+   *         not an NDNS key name
+   * @param isSameZone if true, the key must be `<zone>/NDNS/KEY/<key-id>`
+   */
+  static std::optional<Name>
+  getKeyZone(const Name& keyName, bool isSameZone);
+
+private:
+  void
+  processTrustAnchor(const boost::property_tree::ptree& section, const std::string& filename);
+
+private:
+  bool m_shouldBypass = false;
+  time::nanoseconds m_anchorRefreshPeriod = time::nanoseconds::max();
+};
+
+} // namespace ndns
+} // namespace ndn
+
+#endif // NDNS_VALIDATOR_VALIDATION_POLICY_NDNS_HPP
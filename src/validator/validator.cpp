@@ -19,11 +19,11 @@
 
 #include "validator.hpp"
 #include "config.hpp"
+#include "certificate-fetcher-local-db.hpp"
 #include "certificate-fetcher-ndns-cert.hpp"
+#include "validation-policy-ndns.hpp"
 #include "logger.hpp"
 
-#include <ndn-cxx/security/validation-policy-config.hpp>
-
 namespace ndn {
 namespace ndns {
 
@@ -35,16 +35,32 @@ unique_ptr<security::Validator>
 NdnsValidatorBuilder::create(Face& face,
                              size_t nsCacheSize,
                              size_t startComponentIndex,
-                             const std::string& confFile)
+                             const std::string& confFile,
+                             ResolverCache* resolverCache,
+                             DbMgr* dbMgr)
 {
-  auto validator = make_unique<security::Validator>(make_unique<security::ValidationPolicyConfig>(),
-                                                    make_unique<CertificateFetcherNdnsCert>(face,
-                                                                                            nsCacheSize,
-                                                                                            startComponentIndex));
-  auto& policy = dynamic_cast<security::ValidationPolicyConfig&>(validator->getPolicy());
+  unique_ptr<security::CertificateFetcher> fetcher;
+  CertificateFetcherLocalDb* localDbFetcher = nullptr;
+  if (dbMgr != nullptr) {
+    auto ptr = make_unique<CertificateFetcherLocalDb>(*dbMgr, face, nsCacheSize,
+                                                      startComponentIndex, resolverCache);
+    localDbFetcher = ptr.get();
+    fetcher = std::move(ptr);
+  }
+  else {
+    fetcher = make_unique<CertificateFetcherNdnsCert>(face, nsCacheSize,
+                                                      startComponentIndex, resolverCache);
+  }
+  auto validator = make_unique<security::Validator>(make_unique<ValidationPolicyNdns>(),
+                                                    std::move(fetcher));
+  auto& policy = dynamic_cast<ValidationPolicyNdns&>(validator->getPolicy());
   policy.load(confFile);
   NDNS_LOG_TRACE("Validator loads configuration: " << confFile);
 
+  if (localDbFetcher != nullptr) {
+    localDbFetcher->loadPersistentCache();
+  }
+
   return validator;
 }
 
@@ -28,16 +28,31 @@
 namespace ndn {
 namespace ndns {
 
+class DbMgr;
+class ResolverCache;
+
 class NdnsValidatorBuilder
 {
 public:
   static std::string VALIDATOR_CONF_FILE;
 
+  /**
+   * @brief create a validator enforcing the NDNS naming rules (ValidationPolicyNdns)
+   *
+   * @param confFile file from which trust anchors are loaded
+   * @param resolverCache if not nullptr, certificates are looked up in this persistent cache
+   *                      before being fetched from the network
+   * @param dbMgr if not nullptr, certificates of the zones hosted in this database are
+   *              retrieved from it instead of the network, and other verified certificates
+   *              are kept in it across restarts
+   */
   static unique_ptr<security::Validator>
   create(Face& face,
          size_t nsCacheSize = 500,
          size_t startComponentIndex = 0,
-         const std::string& confFile = VALIDATOR_CONF_FILE);
+         const std::string& confFile = VALIDATOR_CONF_FILE,
+         ResolverCache* resolverCache = nullptr,
+         DbMgr* dbMgr = nullptr);
 };
 
 } // namespace ndns
@@ -0,0 +1,170 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "benchmark-runner.hpp"
+#include "version.hpp"
+
+#include <cstdio>
+#include <iostream>
+
+namespace ndn {
+namespace ndns {
+namespace benchmarks {
+
+BenchmarkRunner::BenchmarkRunner(const Options& options)
+  : m_options(options)
+{
+}
+
+bool
+BenchmarkRunner::isSelected(const std::string& name) const
+{
+  return m_options.filter.empty() || name.find(m_options.filter) != std::string::npos;
+}
+
+void
+BenchmarkRunner::addResult(const std::string& name, size_t zoneSize,
+                           std::vector<time::nanoseconds> samples, time::nanoseconds wallTime)
+{
+  BOOST_ASSERT(!samples.empty());
+
+  BenchmarkResult result;
+  result.name = name;
+  result.zoneSize = zoneSize;
+  result.nIterations = samples.size();
+  result.wallTime = wallTime;
+  for (const auto& sample : samples) {
+    result.totalTime += sample;
+  }
+
+  std::sort(samples.begin(), samples.end());
+  size_t n = samples.size();
+  result.minTime = samples.front();
+  result.meanTime = result.totalTime / n;
+  result.p50Time = samples[(n - 1) * 50 / 100];
+  result.p99Time = samples[(n - 1) * 99 / 100];
+  result.p999Time = samples[(n - 1) * 999 / 1000];
+  result.maxTime = samples.back();
+
+  std::cerr << name << " zoneSize=" << zoneSize << " iterations=" << n
+            << " mean=" << result.meanTime.count() << "ns"
+            << " p50=" << result.p50Time.count() << "ns"
+            << " p99=" << result.p99Time.count() << "ns"
+            << " p999=" << result.p999Time.count() << "ns" << std::endl;
+  m_results.push_back(std::move(result));
+}
+
+void
+BenchmarkRunner::addCostResult(CostResult result)
+{
+  BOOST_ASSERT(result.nResolutions > 0);
+
+  std::cerr << result.name << " resolutions=" << result.nResolutions
+            << " succeeded=" << result.nSucceeded
+            << " interests=" << result.nInterests
+            << " roundTrips=" << result.nRoundTrips
+            << " validations=" << result.nValidations
+            << " bytes=" << result.nBytes << std::endl;
+  m_costResults.push_back(std::move(result));
+}
+
+void
+BenchmarkRunner::writeJson(std::ostream& os,
+                           const std::vector<std::pair<std::string, std::string>>& parameters) const
+{
+  os << "{\n"
+     << "  \"ndnsVersion\": " << toJsonString(NDNS_VERSION_BUILD_STRING) << ",\n"
+     << "  \"timestamp\": " << toJsonString(time::toIsoString(time::system_clock::now())) << ",\n"
+     << "  \"parameters\": {";
+  for (size_t i = 0; i < parameters.size(); ++i) {
+    os << (i == 0 ? "\n" : ",\n")
+       << "    " << toJsonString(parameters[i].first) << ": " << parameters[i].second;
+  }
+  os << "\n  },\n"
+     << "  \"results\": [";
+  for (size_t i = 0; i < m_results.size(); ++i) {
+    const auto& result = m_results[i];
+    double opsPerSecond = result.wallTime > 0_ns ?
+                          result.nIterations * 1e9 / result.wallTime.count() : 0;
+    os << (i == 0 ? "\n" : ",\n")
+       << "    {\"name\": " << toJsonString(result.name)
+       << ", \"zoneSize\": " << result.zoneSize
+       << ", \"iterations\": " << result.nIterations
+       << ", \"opsPerSecond\": " << static_cast<uint64_t>(opsPerSecond)
+       << ", \"ns\": {\"min\": " << result.minTime.count()
+       << ", \"mean\": " << result.meanTime.count()
+       << ", \"p50\": " << result.p50Time.count()
+       << ", \"p99\": " << result.p99Time.count()
+       << ", \"p999\": " << result.p999Time.count()
+       << ", \"max\": " << result.maxTime.count() << "}}";
+  }
+  os << "\n  ],\n"
+     << "  \"costs\": [";
+  for (size_t i = 0; i < m_costResults.size(); ++i) {
+    const auto& cost = m_costResults[i];
+    auto perResolution = [n = cost.nResolutions] (double value) { return value / n; };
+    os << (i == 0 ? "\n" : ",\n")
+       << "    {\"name\": " << toJsonString(cost.name)
+       << ", \"resolutions\": " << cost.nResolutions
+       << ", \"succeeded\": " << cost.nSucceeded
+       << ", \"perResolution\": {\"interests\": " << perResolution(cost.nInterests)
+       << ", \"data\": " << perResolution(cost.nData)
+       << ", \"roundTrips\": " << perResolution(cost.nRoundTrips)
+       << ", \"validations\": " << perResolution(cost.nValidations)
+       << ", \"bytes\": " << perResolution(cost.nBytes)
+       << ", \"virtualMs\": " << perResolution(cost.virtualTime.count() / 1e6) << "}}";
+  }
+  os << "\n  ]\n"
+     << "}" << std::endl;
+}
+
+std::string
+toJsonString(const std::string& str)
+{
+  std::string quoted = "\"";
+  for (char c : str) {
+    switch (c) {
+    case '"':
+      quoted += "\\\"";
+      break;
+    case '\\':
+      quoted += "\\\\";
+      break;
+    case '\n':
+      quoted += "\\n";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        char escaped[8];
+        std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+        quoted += escaped;
+      }
+      else {
+        quoted += c;
+      }
+      break;
+    }
+  }
+  return quoted + "\"";
+}
+
+} // namespace benchmarks
+} // namespace ndns
+} // namespace ndn
@@ -0,0 +1,189 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef NDNS_TESTS_BENCHMARKS_BENCHMARK_RUNNER_HPP
+#define NDNS_TESTS_BENCHMARKS_BENCHMARK_RUNNER_HPP
+
+#include "common.hpp"
+
+#include <ndn-cxx/util/time.hpp>
+
+#include <algorithm>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace ndn {
+namespace ndns {
+namespace benchmarks {
+
+/**
+ * @brief timing of one benchmark on one zone size
+ */
+struct BenchmarkResult
+{
+  std::string name;
+  size_t zoneSize = 0; ///< number of records of the zone, 0 if the benchmark uses no zone
+  size_t nIterations = 0;
+  time::nanoseconds totalTime = 0_ns; ///< sum of the timings of the iterations
+  time::nanoseconds wallTime = 0_ns; ///< elapsed time, shorter than totalTime if calls overlap
+  time::nanoseconds minTime = 0_ns;
+  time::nanoseconds meanTime = 0_ns;
+  time::nanoseconds p50Time = 0_ns;
+  time::nanoseconds p99Time = 0_ns;
+  time::nanoseconds p999Time = 0_ns;
+  time::nanoseconds maxTime = 0_ns;
+};
+
+/**
+ * @brief network cost of the resolutions of one scenario, counted in virtual time
+ */
+struct CostResult
+{
+  std::string name;
+  size_t nResolutions = 0;
+  size_t nSucceeded = 0;
+  size_t nInterests = 0; ///< Interests sent by the resolver, certificate fetches included
+  size_t nData = 0; ///< Data received by the resolver
+  size_t nRoundTrips = 0; ///< sequential exchanges, i.e., virtual latency divided by the RTT
+  size_t nValidations = 0; ///< packets checked by the validation policy
+  size_t nBytes = 0; ///< wire size of the Interests and Data exchanged with the name servers
+  time::nanoseconds virtualTime = 0_ns; ///< sum of the virtual latencies of the resolutions
+};
+
+/**
+ * @brief times benchmarked operations and collects the results
+ */
+class BenchmarkRunner : boost::noncopyable
+{
+public:
+  struct Options
+  {
+    size_t nIterations = 10000; ///< default number of timed iterations of each benchmark
+    size_t nWarmups = 100; ///< untimed iterations run before the timed ones
+    std::string filter; ///< only benchmarks whose name contains this string are run
+  };
+
+  explicit
+  BenchmarkRunner(const Options& options);
+
+  const Options&
+  getOptions() const
+  {
+    return m_options;
+  }
+
+  bool
+  isSelected(const std::string& name) const;
+
+  /**
+   * @brief time @p nIterations calls of @p fn, each one is given the index of the iteration
+   *
+   * Warm-up calls are given the indexes following the timed ones, so that benchmarks which
+   * insert records can derive a distinct record from each index.
+   */
+  template<typename Fn>
+  void
+  run(const std::string& name, size_t zoneSize, size_t nIterations, Fn&& fn)
+  {
+    if (!isSelected(name) || nIterations == 0) {
+      return;
+    }
+
+    size_t nWarmups = std::min(m_options.nWarmups, nIterations);
+    for (size_t i = 0; i < nWarmups; ++i) {
+      fn(nIterations + i);
+    }
+
+    std::vector<time::nanoseconds> samples;
+    samples.reserve(nIterations);
+    time::nanoseconds wallTime = 0_ns;
+    for (size_t i = 0; i < nIterations; ++i) {
+      auto start = time::steady_clock::now();
+      fn(i);
+      samples.push_back(time::steady_clock::now() - start);
+      wallTime += samples.back();
+    }
+    addResult(name, zoneSize, std::move(samples), wallTime);
+  }
+
+  template<typename Fn>
+  void
+  run(const std::string& name, size_t zoneSize, Fn&& fn)
+  {
+    run(name, zoneSize, m_options.nIterations, std::forward<Fn>(fn));
+  }
+
+  const std::vector<BenchmarkResult>&
+  getResults() const
+  {
+    return m_results;
+  }
+
+  /**
+   * @brief write the results as a JSON document
+   * @param parameters name and JSON value of the parameters of the run
+   */
+  void
+  writeJson(std::ostream& os,
+            const std::vector<std::pair<std::string, std::string>>& parameters) const;
+
+  /**
+   * @brief add the result of a benchmark timed by the caller
+   * @param samples latency of each operation
+   * @param wallTime time taken by all operations, used to compute the throughput
+   */
+  void
+  addResult(const std::string& name, size_t zoneSize, std::vector<time::nanoseconds> samples,
+            time::nanoseconds wallTime);
+
+  /**
+   * @brief add the counts of a simulated scenario
+   */
+  void
+  addCostResult(CostResult result);
+
+private:
+  const Options m_options;
+  std::vector<BenchmarkResult> m_results;
+  std::vector<CostResult> m_costResults;
+};
+
+/**
+ * @brief prevent the compiler from discarding the computation of @p value
+ */
+template<typename T>
+inline void
+doNotOptimize(const T& value)
+{
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+/**
+ * @brief quote and escape @p str as a JSON string
+ */
+std::string
+toJsonString(const std::string& str);
+
+} // namespace benchmarks
+} // namespace ndns
+} // namespace ndn
+
+#endif // NDNS_TESTS_BENCHMARKS_BENCHMARK_RUNNER_HPP
@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef NDNS_TESTS_BENCHMARKS_BENCHMARK_SUITES_HPP
+#define NDNS_TESTS_BENCHMARKS_BENCHMARK_SUITES_HPP
+
+#include "benchmark-runner.hpp"
+#include "synthetic-zone.hpp"
+
+namespace ndn {
+namespace ndns {
+namespace benchmarks {
+
+/**
+ * @brief label::matchName on query Interests and response Data
+ */
+void
+runLabelBenchmarks(BenchmarkRunner& runner);
+
+/**
+ * @brief Response::fromData, Response::wireEncode, Response::toData and Query::toInterest
+ */
+void
+runResponseBenchmarks(BenchmarkRunner& runner);
+
+/**
+ * @brief checkPolicy of ValidationPolicyNdns and of ValidationPolicyConfig loaded with the
+ *        rules of validator.conf, on the same Data packets
+ */
+void
+runValidationPolicyBenchmarks(BenchmarkRunner& runner, KeyChain& keyChain);
+
+/**
+ * @brief RrsetFactory::generate*Rrset, including the signing of the record
+ */
+void
+runRrsetFactoryBenchmarks(BenchmarkRunner& runner, SyntheticZone& zone, KeyChain& keyChain);
+
+/**
+ * @brief DbMgr lookups and insertions on @p zone
+ *
+ * Inserted records are removed or rolled back, so @p zone is left unchanged.
+ */
+void
+runDbMgrBenchmarks(BenchmarkRunner& runner, SyntheticZone& zone, uint32_t seed);
+
+/**
+ * @brief ManagementTool::generateDoe, which signs one DoE record per record of @p zone
+ */
+void
+runManagementToolBenchmarks(BenchmarkRunner& runner, SyntheticZone& zone, KeyChain& keyChain);
+
+/**
+ * @brief proportions of the operations sent to the name server by runNameServerBenchmarks
+ */
+struct QueryMix
+{
+  std::string name;
+  double hitRatio = 1; ///< queries for records of the zone
+  double nackRatio = 0; ///< queries for absent records, answered with NDNS NACK
+  double updateRatio = 0; ///< updates replacing records of the zone
+  size_t labelDepth = 0; ///< number of components of the labels, 0 for any depth
+};
+
+/**
+ * @brief parse a query mix `<name>[:hit=<r>,nack=<r>,update=<r>,depth=<n>]`
+ *
+ * Omitted ratios are 0, except hit which defaults to the remainder. Ratios must add up to 1.
+ *
+ * @throw std::invalid_argument the mix is malformed
+ */
+QueryMix
+parseQueryMix(const std::string& spec);
+
+/**
+ * @brief drive a NameServer of @p zone through an in-process face with each of @p mixes
+ *
+ * Operations are delivered in groups of @p window, and the next group is sent once the name
+ * server has answered the previous one. The latency of an operation is measured from its
+ * delivery to the face until the name server puts the answer.
+ */
+void
+runNameServerBenchmarks(BenchmarkRunner& runner, SyntheticZone& zone, KeyChain& keyChain,
+                        const std::vector<QueryMix>& mixes, size_t window, uint32_t seed);
+
+/**
+ * @brief network cost of iterative resolutions over a simulated zone hierarchy
+ *
+ * A hierarchy of zones (top zone, TLDs, second-level zones with deep labels) is served by one
+ * NameServer per zone, and resolved by IterativeQueryController through a link with a fixed
+ * delay in virtual time. For existing and absent labels, and for each combination of
+ * resolver-side caches, the Interests, round trips, validations, and bytes of @p nResolutions
+ * resolutions are counted. The counts depend only on @p seed.
+ */
+void
+runResolutionBenchmarks(BenchmarkRunner& runner, KeyChain& keyChain, const std::string& dbDir,
+                        size_t nResolutions, uint32_t seed);
+
+} // namespace benchmarks
+} // namespace ndns
+} // namespace ndn
+
+#endif // NDNS_TESTS_BENCHMARKS_BENCHMARK_SUITES_HPP
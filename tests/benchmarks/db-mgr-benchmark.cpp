@@ -0,0 +1,111 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "benchmark-suites.hpp"
+
+#include <algorithm>
+#include <random>
+
+namespace ndn {
+namespace ndns {
+namespace benchmarks {
+
+/**
+ * @brief upper bound of the records read by the findRrsets benchmark of one zone size
+ */
+static const size_t FIND_RRSETS_BUDGET = 1000000;
+
+/**
+ * @brief iterations of the autocommit insert benchmark, each of them syncs the database file
+ */
+static const size_t MAX_AUTOCOMMIT_INSERTS = 1000;
+
+void
+runDbMgrBenchmarks(BenchmarkRunner& runner, SyntheticZone& zone, uint32_t seed)
+{
+  DbMgr& dbMgr = zone.getDbMgr();
+  const auto& labels = zone.getLabels();
+  const size_t n = zone.size();
+  const size_t nIterations = runner.getOptions().nIterations;
+  const size_t nCalls = nIterations + runner.getOptions().nWarmups;
+  BOOST_ASSERT(n > 0);
+
+  // look up existing labels in a random order, so that the database pages are not visited
+  // sequentially
+  std::mt19937 rng(seed);
+  std::vector<size_t> order(nCalls);
+  std::uniform_int_distribution<size_t> pick(0, n - 1);
+  std::generate(order.begin(), order.end(), [&] { return pick(rng); });
+
+  runner.run("db-mgr/find", n, [&] (size_t i) {
+    Rrset rrset(&zone.getZone());
+    rrset.setLabel(labels[order[i]]);
+    rrset.setType(label::TXT_RR_TYPE);
+    doNotOptimize(dbMgr.find(rrset));
+  });
+  runner.run("db-mgr/find-missing", n, [&] (size_t i) {
+    Rrset rrset(&zone.getZone());
+    rrset.setLabel(Name(labels[order[i]]).append("missing"));
+    rrset.setType(label::TXT_RR_TYPE);
+    doNotOptimize(dbMgr.find(rrset));
+  });
+  runner.run("db-mgr/findLowerBound", n, [&] (size_t i) {
+    Rrset rrset(&zone.getZone());
+    rrset.setLabel(Name(labels[order[i]]).append("missing"));
+    rrset.setType(label::DOE_RR_TYPE);
+    doNotOptimize(dbMgr.findLowerBound(rrset));
+  });
+
+  std::vector<Rrset> inserted;
+  auto makeNewRrset = [&] (size_t i) {
+    return zone.makeRrset(Name("inserted").append("r" + to_string(i)));
+  };
+  size_t nAutocommits = std::min(nIterations, MAX_AUTOCOMMIT_INSERTS);
+  runner.run("db-mgr/insert", n, nAutocommits, [&] (size_t i) {
+    inserted.push_back(makeNewRrset(i));
+    dbMgr.insert(inserted.back());
+  });
+  dbMgr.beginTransaction();
+  for (auto& rrset : inserted) {
+    dbMgr.remove(rrset);
+  }
+  dbMgr.commitTransaction();
+
+  // the records are prepared outside of the timed section
+  std::vector<Rrset> batch;
+  batch.reserve(nCalls);
+  for (size_t i = 0; i < nCalls; ++i) {
+    batch.push_back(makeNewRrset(i));
+  }
+  dbMgr.beginTransaction();
+  runner.run("db-mgr/insert-transaction", n, [&] (size_t i) {
+    dbMgr.insert(batch[i]);
+  });
+  dbMgr.rollbackTransaction();
+
+  size_t nFindRrsets = std::max<size_t>(1, std::min(nIterations, FIND_RRSETS_BUDGET / n));
+  runner.run("db-mgr/findRrsets", n, nFindRrsets, [&] (size_t) {
+    doNotOptimize(dbMgr.findRrsets(zone.getZone()));
+  });
+}
+
+} // namespace benchmarks
+} // namespace ndns
+} // namespace ndn
@@ -0,0 +1,206 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "benchmark-suites.hpp"
+
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/program_options.hpp>
+
+#include <fstream>
+#include <iostream>
+
+namespace ndn {
+namespace ndns {
+namespace benchmarks {
+
+static std::vector<size_t>
+parseZoneSizes(const std::string& str)
+{
+  std::vector<std::string> tokens;
+  boost::split(tokens, str, boost::is_any_of(","));
+  std::vector<size_t> sizes;
+  for (const auto& token : tokens) {
+    size_t size = std::stoul(token);
+    if (size == 0) {
+      NDN_THROW(std::invalid_argument("zone sizes must be positive"));
+    }
+    sizes.push_back(size);
+  }
+  return sizes;
+}
+
+static std::string
+toJsonArray(const std::vector<size_t>& values)
+{
+  std::string json = "[";
+  for (size_t i = 0; i < values.size(); ++i) {
+    json += (i > 0 ? "," : "") + to_string(values[i]);
+  }
+  return json + "]";
+}
+
+static std::string
+toJsonArray(const std::vector<std::string>& values)
+{
+  std::string json = "[";
+  for (size_t i = 0; i < values.size(); ++i) {
+    json += (i > 0 ? "," : "") + toJsonString(values[i]);
+  }
+  return json + "]";
+}
+
+static int
+main(int argc, char* argv[])
+{
+  namespace fs = boost::filesystem;
+  namespace po = boost::program_options;
+
+  BenchmarkRunner::Options options;
+  std::string zoneSizesStr = "1000,100000,1000000";
+  uint32_t seed = 1;
+  size_t maxDoeZoneSize = 100000;
+  std::string output = "-";
+  std::string dbDir = BENCHMARKS_TMPDIR;
+  std::vector<std::string> mixSpecs{"hit", "nack:nack=1", "mixed:nack=0.1,update=0.05",
+                                    "update:update=1", "deep:depth=3"};
+  size_t window = 1;
+  size_t nResolutions = 500;
+
+  po::options_description description("Options");
+  description.add_options()
+    ("help,h", "print this help message and exit")
+    ("zone-sizes,z", po::value<std::string>(&zoneSizesStr)->default_value(zoneSizesStr),
+     "comma-separated numbers of records of the synthetic zones")
+    ("iterations,n", po::value<size_t>(&options.nIterations)->default_value(options.nIterations),
+     "timed iterations of each benchmark")
+    ("warmup,w", po::value<size_t>(&options.nWarmups)->default_value(options.nWarmups),
+     "untimed iterations before the timed ones")
+    ("filter,f", po::value<std::string>(&options.filter),
+     "only run the benchmarks whose name contains this string")
+    ("seed,s", po::value<uint32_t>(&seed)->default_value(seed),
+     "seed of the synthetic zones and of the lookup order")
+    ("max-doe-zone-size", po::value<size_t>(&maxDoeZoneSize)->default_value(maxDoeZoneSize),
+     "largest zone on which ManagementTool::generateDoe is benchmarked")
+    ("mix,m", po::value<std::vector<std::string>>(&mixSpecs)->multitoken(),
+     "query mixes of the name server benchmark, each one as "
+     "<name>[:hit=<ratio>,nack=<ratio>,update=<ratio>,depth=<label depth>]")
+    ("window", po::value<size_t>(&window)->default_value(window),
+     "operations delivered to the name server before waiting for its answers")
+    ("resolutions", po::value<size_t>(&nResolutions)->default_value(nResolutions),
+     "resolutions of each scenario of the simulated zone hierarchy")
+    ("output,o", po::value<std::string>(&output)->default_value(output),
+     "JSON output file, '-' for the standard output")
+    ("db-dir,d", po::value<std::string>(&dbDir)->default_value(dbDir),
+     "directory of the synthetic zone databases")
+    ;
+
+  std::vector<size_t> zoneSizes;
+  std::vector<QueryMix> mixes;
+  try {
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, description), vm);
+    po::notify(vm);
+
+    if (vm.count("help") > 0) {
+      std::cout << "Usage: ndns-benchmarks [options]\n" << description << std::endl;
+      return 0;
+    }
+    zoneSizes = parseZoneSizes(zoneSizesStr);
+    for (const auto& spec : mixSpecs) {
+      mixes.push_back(parseQueryMix(spec));
+    }
+    if (window == 0) {
+      NDN_THROW(std::invalid_argument("window must be positive"));
+    }
+  }
+  catch (const std::exception& e) {
+    std::cerr << "Parameter Error: " << e.what() << std::endl;
+    return 2;
+  }
+
+  BenchmarkRunner runner(options);
+  KeyChain keyChain("pib-memory:", "tpm-memory:");
+
+  runLabelBenchmarks(runner);
+  runResponseBenchmarks(runner);
+  runValidationPolicyBenchmarks(runner, keyChain);
+
+  fs::create_directories(dbDir);
+  for (size_t zoneSize : zoneSizes) {
+    auto dbFile = (fs::path(dbDir) / ("benchmark-" + to_string(zoneSize) + ".db")).string();
+    fs::remove(dbFile);
+
+    std::cerr << "creating a zone of " << zoneSize << " records in " << dbFile << std::endl;
+    {
+      SyntheticZone zone(dbFile, keyChain, Name("/bench").append("z" + to_string(zoneSize)),
+                         zoneSize, seed);
+      runDbMgrBenchmarks(runner, zone, seed);
+      runRrsetFactoryBenchmarks(runner, zone, keyChain);
+      runNameServerBenchmarks(runner, zone, keyChain, mixes, window, seed);
+      if (zoneSize <= maxDoeZoneSize) {
+        runManagementToolBenchmarks(runner, zone, keyChain);
+      }
+    }
+    fs::remove(dbFile);
+  }
+  runResolutionBenchmarks(runner, keyChain, dbDir, nResolutions, seed);
+
+  std::vector<std::pair<std::string, std::string>> parameters{
+    {"zoneSizes", toJsonArray(zoneSizes)},
+    {"iterations", to_string(options.nIterations)},
+    {"warmup", to_string(options.nWarmups)},
+    {"filter", toJsonString(options.filter)},
+    {"seed", to_string(seed)},
+    {"maxDoeZoneSize", to_string(maxDoeZoneSize)},
+    {"mixes", toJsonArray(mixSpecs)},
+    {"window", to_string(window)},
+    {"resolutions", to_string(nResolutions)},
+  };
+  if (output == "-") {
+    runner.writeJson(std::cout, parameters);
+  }
+  else {
+    std::ofstream os(output);
+    runner.writeJson(os, parameters);
+    if (!os) {
+      std::cerr << "ERROR: cannot write " << output << std::endl;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+} // namespace benchmarks
+} // namespace ndns
+} // namespace ndn
+
+int
+main(int argc, char* argv[])
+{
+  try {
+    return ndn::ndns::benchmarks::main(argc, argv);
+  }
+  catch (const std::exception& e) {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,78 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "benchmark-suites.hpp"
+#include "daemon/rrset-factory.hpp"
+#include "mgmt/management-tool.hpp"
+
+namespace ndn {
+namespace ndns {
+namespace benchmarks {
+
+void
+runRrsetFactoryBenchmarks(BenchmarkRunner& runner, SyntheticZone& zone, KeyChain& keyChain)
+{
+  const Name& zoneName = zone.getZone().getName();
+  RrsetFactory factory(zone.getDbMgr().getDbFile(), zoneName, keyChain, DEFAULT_CERT);
+  factory.checkZoneKey();
+
+  auto cert = keyChain.getPib().getIdentity(Name(zoneName).append(label::NDNS_ITERATIVE_QUERY))
+                .getDefaultKey().getDefaultCertificate();
+  std::vector<Name> delegations{"/bench/ns1", "/bench/ns2"};
+  std::vector<std::string> txt{"first string of the TXT rrset", "second string of the TXT rrset"};
+
+  // each of these signs one record, so they are not affected by the size of the zone
+  runner.run("rrset-factory/generateTxtRrset", 0, [&] (size_t i) {
+    doNotOptimize(factory.generateTxtRrset(Name("host" + to_string(i)), 1, DEFAULT_CACHE_TTL,
+                                           txt));
+  });
+  runner.run("rrset-factory/generateNsRrset", 0, [&] (size_t i) {
+    doNotOptimize(factory.generateNsRrset(Name("sub" + to_string(i)), 1, DEFAULT_CACHE_TTL,
+                                          delegations));
+  });
+  runner.run("rrset-factory/generateAuthRrset", 0, [&] (size_t i) {
+    doNotOptimize(factory.generateAuthRrset(Name("sub" + to_string(i)), 1, DEFAULT_CACHE_TTL));
+  });
+  runner.run("rrset-factory/generateCertRrset", 0, [&] (size_t i) {
+    doNotOptimize(factory.generateCertRrset(Name("cert" + to_string(i)), 1, DEFAULT_CACHE_TTL,
+                                            cert));
+  });
+  runner.run("rrset-factory/generateDoeRrset", 0, [&] (size_t i) {
+    Name lower("host" + to_string(i));
+    Name upper("host" + to_string(i + 1));
+    doNotOptimize(factory.generateDoeRrset(lower, 1, DEFAULT_CACHE_TTL, lower, upper));
+  });
+}
+
+void
+runManagementToolBenchmarks(BenchmarkRunner& runner, SyntheticZone& zone, KeyChain& keyChain)
+{
+  ManagementTool tool(zone.getDbMgr().getDbFile(), keyChain);
+  Zone target(zone.getZone().getName());
+
+  // every iteration signs one DoE record per record of the zone
+  runner.run("management-tool/generateDoe", zone.size(), 3, [&] (size_t) {
+    tool.generateDoe(target);
+  });
+}
+
+} // namespace benchmarks
+} // namespace ndns
+} // namespace ndn
@@ -0,0 +1,248 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "benchmark-suites.hpp"
+#include "clients/query.hpp"
+#include "clients/response.hpp"
+#include "daemon/name-server.hpp"
+#include "validator/validation-policy-ndns.hpp"
+
+#include <ndn-cxx/security/certificate-fetcher-offline.hpp>
+#include <ndn-cxx/security/signing-helpers.hpp>
+#include <ndn-cxx/util/dummy-client-face.hpp>
+
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
+
+#include <cmath>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <random>
+
+namespace ndn {
+namespace ndns {
+namespace benchmarks {
+
+QueryMix
+parseQueryMix(const std::string& spec)
+{
+  QueryMix mix;
+  auto colon = spec.find(':');
+  mix.name = spec.substr(0, colon);
+  if (mix.name.empty()) {
+    NDN_THROW(std::invalid_argument("query mix '" + spec + "' has no name"));
+  }
+
+  double hitRatio = -1;
+  if (colon != std::string::npos) {
+    std::string paramsStr = spec.substr(colon + 1);
+    std::vector<std::string> params;
+    boost::split(params, paramsStr, boost::is_any_of(","));
+    for (const auto& param : params) {
+      auto eq = param.find('=');
+      if (eq == std::string::npos) {
+        NDN_THROW(std::invalid_argument("query mix parameter '" + param + "' has no value"));
+      }
+      std::string key = param.substr(0, eq);
+      std::string value = param.substr(eq + 1);
+      if (key == "hit") {
+        hitRatio = std::stod(value);
+      }
+      else if (key == "nack") {
+        mix.nackRatio = std::stod(value);
+      }
+      else if (key == "update") {
+        mix.updateRatio = std::stod(value);
+      }
+      else if (key == "depth") {
+        mix.labelDepth = std::stoul(value);
+      }
+      else {
+        NDN_THROW(std::invalid_argument("unknown query mix parameter '" + key + "'"));
+      }
+    }
+  }
+
+  mix.hitRatio = hitRatio < 0 ? 1 - mix.nackRatio - mix.updateRatio : hitRatio;
+  if (mix.hitRatio < 0 || mix.nackRatio < 0 || mix.updateRatio < 0 ||
+      std::abs(mix.hitRatio + mix.nackRatio + mix.updateRatio - 1) > 1e-6) {
+    NDN_THROW(std::invalid_argument("ratios of query mix '" + mix.name + "' do not add up to 1"));
+  }
+  return mix;
+}
+
+/**
+ * @brief run the handlers of @p io until none is ready
+ */
+static void
+runReadyHandlers(boost::asio::io_context& io)
+{
+  io.restart();
+  while (io.poll() > 0) {
+    io.restart();
+  }
+}
+
+namespace {
+
+/**
+ * @brief an NDNS query or update prepared before the timed section
+ */
+struct Operation
+{
+  Interest interest;
+  bool isTimed;
+};
+
+} // namespace
+
+void
+runNameServerBenchmarks(BenchmarkRunner& runner, SyntheticZone& zone, KeyChain& keyChain,
+                        const std::vector<QueryMix>& mixes, size_t window, uint32_t seed)
+{
+  BOOST_ASSERT(window > 0);
+  const Name& zoneName = zone.getZone().getName();
+  Name identityName = Name(zoneName).append(label::NDNS_ITERATIVE_QUERY);
+  auto dskCert = keyChain.getPib().getIdentity(identityName)
+                   .getDefaultKey().getDefaultCertificate();
+
+  // updates are signed with the DSK of the zone, which is trusted by the validator
+  security::Validator validator(make_unique<ValidationPolicyNdns>(),
+                                make_unique<security::CertificateFetcherOffline>());
+  validator.loadAnchor("benchmark", security::Certificate(dskCert));
+
+  ndn::DummyClientFace face({false, true});
+  auto& io = face.getIoContext();
+  NameServer server(zoneName, dskCert.getName(), face, zone.getDbMgr(), keyChain, validator);
+  runReadyHandlers(io); // prefix registration
+
+  std::map<Name, std::deque<std::pair<time::steady_clock::time_point, bool>>> pending;
+  std::vector<time::nanoseconds> samples;
+  face.onSendData.connect([&] (const Data& data) {
+    // the answer is named after the query, followed by a version
+    auto it = pending.find(data.getName().getPrefix(-1));
+    if (it == pending.end()) {
+      return;
+    }
+    auto [sentTime, isTimed] = it->second.front();
+    if (isTimed) {
+      samples.push_back(time::steady_clock::now() - sentTime);
+    }
+    it->second.pop_front();
+    if (it->second.empty()) {
+      pending.erase(it);
+    }
+  });
+
+  std::mt19937 rng(seed);
+  // versions of the updates increase across mixes, so that every update replaces the record
+  uint64_t updateVersion = 1;
+  const size_t nIterations = runner.getOptions().nIterations;
+  const size_t nWarmups = runner.getOptions().nWarmups;
+
+  for (const auto& mix : mixes) {
+    std::string benchmarkName = "name-server/" + mix.name;
+    if (!runner.isSelected(benchmarkName)) {
+      continue;
+    }
+
+    std::vector<Name> labels;
+    for (const auto& label : zone.getLabels()) {
+      if (mix.labelDepth == 0 || label.size() == mix.labelDepth) {
+        labels.push_back(label);
+      }
+    }
+    if (labels.empty()) {
+      std::cerr << benchmarkName << " skipped: the zone has no label of depth " << mix.labelDepth
+                << std::endl;
+      continue;
+    }
+
+    std::uniform_int_distribution<size_t> pickLabel(0, labels.size() - 1);
+    std::uniform_real_distribution<double> pickKind(0, 1);
+    std::vector<Operation> operations;
+    operations.reserve(nWarmups + nIterations);
+    for (size_t i = 0; i < nWarmups + nIterations; ++i) {
+      const Name& label = labels[pickLabel(rng)];
+      double kind = pickKind(rng);
+      Query query(zoneName, label::NDNS_ITERATIVE_QUERY);
+      if (kind < mix.updateRatio) {
+        Response response(zoneName, label::NDNS_ITERATIVE_QUERY);
+        response.setRrLabel(label);
+        response.setRrType(label::TXT_RR_TYPE);
+        response.setVersion(name::Component::fromVersion(++updateVersion));
+        response.setContentType(NDNS_RESP);
+        response.addRr("updated by the benchmark");
+        auto data = response.toData();
+        keyChain.sign(*data, signingByCertificate(dskCert));
+
+        query.setRrLabel(Name().append(ndn::tlv::GenericNameComponent, data->wireEncode()));
+        query.setRrType(label::NDNS_UPDATE_LABEL);
+      }
+      else if (kind < mix.updateRatio + mix.nackRatio) {
+        query.setRrLabel(label.getPrefix(-1).append("missing" + to_string(i)));
+        query.setRrType(label::TXT_RR_TYPE);
+      }
+      else {
+        query.setRrLabel(label);
+        query.setRrType(label::TXT_RR_TYPE);
+      }
+      operations.push_back({query.toInterest(), i >= nWarmups});
+    }
+
+    size_t nUnanswered = 0;
+    auto deliver = [&] (size_t begin, size_t end) {
+      while (begin < end) {
+        size_t groupEnd = std::min(begin + window, end);
+        for (; begin < groupEnd; ++begin) {
+          const auto& op = operations[begin];
+          pending[op.interest.getName()].emplace_back(time::steady_clock::now(), op.isTimed);
+          face.receive(op.interest);
+        }
+        runReadyHandlers(io);
+
+        // e.g., updates that failed validation
+        for (const auto& entry : pending) {
+          nUnanswered += entry.second.size();
+        }
+        pending.clear();
+      }
+    };
+
+    samples.clear();
+    samples.reserve(nIterations);
+    deliver(0, nWarmups);
+    auto startTime = time::steady_clock::now();
+    deliver(nWarmups, operations.size());
+    auto wallTime = time::steady_clock::now() - startTime;
+
+    if (nUnanswered > 0) {
+      std::cerr << benchmarkName << ": " << nUnanswered << " operations were not answered" << std::endl;
+    }
+    if (!samples.empty()) {
+      runner.addResult(benchmarkName, zone.size(), std::move(samples), wallTime);
+    }
+  }
+}
+
+} // namespace benchmarks
+} // namespace ndns
+} // namespace ndn
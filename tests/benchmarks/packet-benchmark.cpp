@@ -0,0 +1,101 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "benchmark-suites.hpp"
+#include "ndns-label.hpp"
+#include "clients/query.hpp"
+#include "clients/response.hpp"
+
+namespace ndn {
+namespace ndns {
+namespace benchmarks {
+
+static const Name ZONE_NAME("/bench/zone");
+static const size_t N_PACKETS = 1000;
+
+void
+runLabelBenchmarks(BenchmarkRunner& runner)
+{
+  std::vector<Interest> interests;
+  std::vector<Data> data;
+  for (size_t i = 0; i < N_PACKETS; ++i) {
+    Name label = Name("www").append("host" + to_string(i));
+
+    Query query(ZONE_NAME, label::NDNS_ITERATIVE_QUERY);
+    query.setRrLabel(label);
+    query.setRrType(label::TXT_RR_TYPE);
+    interests.push_back(query.toInterest());
+
+    Response response(ZONE_NAME, label::NDNS_ITERATIVE_QUERY);
+    response.setRrLabel(label);
+    response.setRrType(label::TXT_RR_TYPE);
+    response.setContentType(NDNS_RESP);
+    data.push_back(*response.toData());
+  }
+
+  runner.run("label/matchName-interest", 0, [&] (size_t i) {
+    label::MatchResult result;
+    doNotOptimize(label::matchName(interests[i % N_PACKETS], ZONE_NAME, result));
+  });
+  runner.run("label/matchName-data", 0, [&] (size_t i) {
+    label::MatchResult result;
+    doNotOptimize(label::matchName(data[i % N_PACKETS], ZONE_NAME, result));
+  });
+}
+
+void
+runResponseBenchmarks(BenchmarkRunner& runner)
+{
+  std::vector<Response> responses;
+  std::vector<shared_ptr<Data>> data;
+  for (size_t i = 0; i < N_PACKETS; ++i) {
+    Response response(ZONE_NAME, label::NDNS_ITERATIVE_QUERY);
+    response.setRrLabel(Name("host" + to_string(i)));
+    response.setRrType(label::TXT_RR_TYPE);
+    response.setContentType(NDNS_RESP);
+    response.addRr("first string of host" + to_string(i));
+    response.addRr("second string of host" + to_string(i));
+    data.push_back(response.toData());
+    responses.push_back(std::move(response));
+  }
+
+  runner.run("response/fromData", 0, [&] (size_t i) {
+    Response response;
+    response.fromData(ZONE_NAME, *data[i % N_PACKETS]);
+    doNotOptimize(response);
+  });
+  runner.run("response/wireEncode", 0, [&] (size_t i) {
+    doNotOptimize(responses[i % N_PACKETS].wireEncode());
+  });
+  runner.run("response/toData", 0, [&] (size_t i) {
+    doNotOptimize(responses[i % N_PACKETS].toData());
+  });
+
+  Query query(ZONE_NAME, label::NDNS_ITERATIVE_QUERY);
+  query.setRrType(label::TXT_RR_TYPE);
+  runner.run("query/toInterest", 0, [&] (size_t i) {
+    query.setRrLabel(responses[i % N_PACKETS].getRrLabel());
+    doNotOptimize(query.toInterest());
+  });
+}
+
+} // namespace benchmarks
+} // namespace ndns
+} // namespace ndn
@@ -0,0 +1,327 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "benchmark-suites.hpp"
+#include "io-fixture.hpp"
+#include "clients/iterative-query-controller.hpp"
+#include "clients/ns-cache.hpp"
+#include "clients/resolver-cache.hpp"
+#include "daemon/name-server.hpp"
+#include "mgmt/zone-generator.hpp"
+#include "util/cert-helper.hpp"
+#include "validator/certificate-fetcher-ndns-cert.hpp"
+#include "validator/validation-cache.hpp"
+#include "validator/validation-policy-ndns.hpp"
+
+#include <ndn-cxx/security/validator-null.hpp>
+#include <ndn-cxx/util/dummy-client-face.hpp>
+#include <ndn-cxx/util/scheduler.hpp>
+
+#include <boost/filesystem/operations.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+namespace ndn {
+namespace ndns {
+namespace benchmarks {
+
+namespace {
+
+const Name TOP_ZONE("/sim");
+const size_t FANOUT = 3; ///< child zones of each zone, i.e., three TLDs with three zones each
+const size_t ZONE_LEVELS = 3;
+const size_t RECORDS_PER_ZONE = 100;
+const size_t ABSENT_LABELS_PER_ZONE = 20;
+const time::nanoseconds LINK_DELAY = 10_ms;
+const time::nanoseconds TICK = 1_ms;
+const time::nanoseconds MAX_RESOLUTION_TIME = 60_s;
+
+/**
+ * @brief resolver-side state kept across the resolutions of a scenario
+ */
+struct Scenario
+{
+  std::string name;
+  bool shouldKeepValidator; ///< certificates verified by earlier resolutions are trusted
+  bool hasNsCache;
+  bool hasValidationCache;
+  bool hasResolverCache; ///< answers and NACKs are cached as well as delegations
+};
+
+const std::vector<Scenario> SCENARIOS{
+  {"cold", false, false, false, false},
+  {"certificate-cache", true, false, false, false},
+  {"ns-cache", true, true, false, false},
+  {"validation-cache", true, true, true, false},
+  {"resolver-cache", true, true, true, true},
+};
+
+/**
+ * @brief ValidationPolicyNdns counting the packets it checks
+ */
+class CountingPolicy : public ValidationPolicyNdns
+{
+public:
+  explicit
+  CountingPolicy(size_t& nChecks)
+    : m_nChecks(nChecks)
+  {
+  }
+
+  using ValidationPolicyNdns::checkPolicy;
+
+  void
+  checkPolicy(const Data& data, const shared_ptr<security::ValidationState>& state,
+              const ValidationContinuation& continueValidation) override
+  {
+    ++m_nChecks;
+    ValidationPolicyNdns::checkPolicy(data, state, continueValidation);
+  }
+
+private:
+  size_t& m_nChecks;
+};
+
+/**
+ * @brief name servers of a zone hierarchy and a resolver, connected in virtual time
+ *
+ * All name servers share one face, and every packet between the resolver and that face is
+ * delayed by LINK_DELAY. Name servers answer in zero virtual time, so the virtual latency of a
+ * resolution is a whole number of round trips.
+ */
+class ResolutionSimulation : public tests::IoFixture
+{
+public:
+  ResolutionSimulation(KeyChain& keyChain, const std::string& dbFile, uint32_t seed)
+    : m_dbFile(dbFile)
+    , m_dbMgr(dbFile)
+    , m_producerFace(m_io, {false, true})
+    , m_consumerFace(m_io, {false, true})
+    , m_scheduler(m_io)
+  {
+    // generated after the clocks became virtual, so that certificates are valid in virtual time
+    ZoneGenerator::Options options;
+    options.nRecords = RECORDS_PER_ZONE;
+    options.nChildRecords = RECORDS_PER_ZONE;
+    options.nChildZones = FANOUT;
+    options.zoneLevels = ZONE_LEVELS;
+    options.seed = seed;
+    auto summary = ZoneGenerator(dbFile, keyChain, options).generate(TOP_ZONE, Name("/"));
+    std::cerr << "simulating " << summary.nZones << " zones with " << summary.nRecords
+              << " records" << std::endl;
+
+    for (auto& zone : m_dbMgr.listZones()) {
+      Name identity = Name(zone.getName()).append(label::NDNS_ITERATIVE_QUERY);
+      Name certName = CertHelper::getDefaultCertificateNameOfIdentity(keyChain, identity);
+      m_servers.push_back(make_unique<NameServer>(zone.getName(), certName, m_producerFace,
+                                                  m_dbMgr, keyChain, m_serverValidator));
+      if (zone.getName() == TOP_ZONE) {
+        m_anchor = CertHelper::getCertificate(keyChain, identity, certName);
+      }
+      if (zone.getName().size() == TOP_ZONE.size() + ZONE_LEVELS - 1) {
+        for (auto& rrset : m_dbMgr.findRrsets(zone)) {
+          if (rrset.getType() == label::TXT_RR_TYPE) {
+            m_existingLabels.push_back(Name(zone.getName()).append(rrset.getLabel()));
+          }
+        }
+        for (size_t i = 0; i < ABSENT_LABELS_PER_ZONE; ++i) {
+          m_absentLabels.push_back(Name(zone.getName()).append("nx" + to_string(i)));
+        }
+      }
+    }
+
+    m_consumerFace.onSendInterest.connect([this] (const Interest& interest) {
+      ++m_nInterests;
+      m_nBytes += interest.wireEncode().size();
+      m_scheduler.schedule(LINK_DELAY, [this, interest] { m_producerFace.receive(interest); });
+    });
+    m_producerFace.onSendData.connect([this] (const Data& data) {
+      ++m_nData;
+      m_nBytes += data.wireEncode().size();
+      m_scheduler.schedule(LINK_DELAY, [this, data] { m_consumerFace.receive(data); });
+    });
+    advanceClocks(TICK); // prefix registrations
+  }
+
+  const std::vector<Name>&
+  getExistingLabels() const
+  {
+    return m_existingLabels;
+  }
+
+  const std::vector<Name>&
+  getAbsentLabels() const
+  {
+    return m_absentLabels;
+  }
+
+  CostResult
+  run(const std::string& name, const Scenario& scenario, const std::vector<Name>& targets)
+  {
+    m_nInterests = m_nData = m_nBytes = m_nChecks = 0;
+
+    unique_ptr<security::Validator> validator;
+    auto nsCache = scenario.hasNsCache ? make_unique<NsCache>(m_io, 500) : nullptr;
+    auto validationCache = scenario.hasValidationCache ? make_unique<ValidationCache>() : nullptr;
+    std::string cacheFile = m_dbFile + "-resolver-cache";
+    boost::filesystem::remove(cacheFile);
+    auto resolverCache = scenario.hasResolverCache ? make_unique<ResolverCache>(cacheFile) :
+                                                     nullptr;
+
+    CostResult result;
+    result.name = name;
+    for (const auto& target : targets) {
+      if (validator == nullptr || !scenario.shouldKeepValidator) {
+        validator = makeValidator();
+      }
+
+      bool isDone = false;
+      auto startTime = time::steady_clock::now();
+      auto controller = make_shared<IterativeQueryController>(
+        target, label::TXT_RR_TYPE, DEFAULT_INTEREST_LIFETIME,
+        [&] (const Data&, const Response&) {
+          isDone = true;
+          ++result.nSucceeded;
+        },
+        [&] (uint32_t, const std::string& errMsg) {
+          isDone = true;
+          std::cerr << "resolution of " << target << " failed: " << errMsg << std::endl;
+        },
+        m_consumerFace, validator.get(), nsCache.get());
+      controller->setStartComponentIndex(TOP_ZONE.size());
+      controller->setValidationCache(validationCache.get());
+      controller->setResolverCache(resolverCache.get());
+      controller->start();
+
+      for (auto elapsed = 0_ns; !isDone && elapsed < MAX_RESOLUTION_TIME; elapsed += TICK) {
+        advanceClocks(TICK);
+      }
+      auto latency = time::steady_clock::now() - startTime;
+      ++result.nResolutions;
+      result.virtualTime += latency;
+      result.nRoundTrips += static_cast<size_t>(std::lround(latency / (2 * LINK_DELAY * 1.0)));
+    }
+
+    result.nInterests = m_nInterests;
+    result.nData = m_nData;
+    result.nBytes = m_nBytes;
+    result.nValidations = m_nChecks;
+
+    resolverCache.reset();
+    boost::filesystem::remove(cacheFile);
+    return result;
+  }
+
+private:
+  unique_ptr<security::Validator>
+  makeValidator()
+  {
+    auto validator = make_unique<security::Validator>(
+      make_unique<CountingPolicy>(m_nChecks),
+      make_unique<CertificateFetcherNdnsCert>(m_consumerFace, 100, TOP_ZONE.size()));
+    validator->loadAnchor("simulation", security::Certificate(m_anchor));
+    return validator;
+  }
+
+private:
+  std::string m_dbFile;
+  DbMgr m_dbMgr;
+  ndn::DummyClientFace m_producerFace;
+  ndn::DummyClientFace m_consumerFace;
+  Scheduler m_scheduler;
+  security::ValidatorNull m_serverValidator;
+  std::vector<unique_ptr<NameServer>> m_servers;
+  security::Certificate m_anchor;
+
+  std::vector<Name> m_existingLabels;
+  std::vector<Name> m_absentLabels;
+
+  size_t m_nInterests = 0;
+  size_t m_nData = 0;
+  size_t m_nBytes = 0;
+  size_t m_nChecks = 0;
+};
+
+/**
+ * @brief draw @p n labels of @p pool with a Zipf distribution over a random ranking of the pool
+ */
+std::vector<Name>
+makeTargets(std::vector<Name> pool, size_t n, std::mt19937& rng)
+{
+  std::shuffle(pool.begin(), pool.end(), rng);
+  std::vector<double> weights(pool.size());
+  for (size_t i = 0; i < weights.size(); ++i) {
+    weights[i] = 1.0 / (i + 1);
+  }
+  std::discrete_distribution<size_t> pick(weights.begin(), weights.end());
+
+  std::vector<Name> targets;
+  targets.reserve(n);
+  for (size_t i = 0; i < n; ++i) {
+    targets.push_back(pool[pick(rng)]);
+  }
+  return targets;
+}
+
+} // namespace
+
+void
+runResolutionBenchmarks(BenchmarkRunner& runner, KeyChain& keyChain, const std::string& dbDir,
+                        size_t nResolutions, uint32_t seed)
+{
+  const std::vector<std::string> workloads{"existing", "absent"};
+  bool isAnySelected = false;
+  for (const auto& workload : workloads) {
+    for (const auto& scenario : SCENARIOS) {
+      isAnySelected = isAnySelected ||
+                      runner.isSelected("resolution/" + workload + "/" + scenario.name);
+    }
+  }
+  if (!isAnySelected || nResolutions == 0) {
+    return;
+  }
+
+  auto dbFile = (boost::filesystem::path(dbDir) / "resolution-simulation.db").string();
+  boost::filesystem::remove(dbFile);
+  {
+    ResolutionSimulation simulation(keyChain, dbFile, seed);
+    std::mt19937 rng(seed);
+    for (const auto& workload : workloads) {
+      // every scenario resolves the same sequence of labels
+      auto targets = makeTargets(workload == "existing" ? simulation.getExistingLabels() :
+                                                          simulation.getAbsentLabels(),
+                                 nResolutions, rng);
+      for (const auto& scenario : SCENARIOS) {
+        std::string benchmarkName = "resolution/" + workload + "/" + scenario.name;
+        if (runner.isSelected(benchmarkName)) {
+          runner.addCostResult(simulation.run(benchmarkName, scenario, targets));
+        }
+      }
+    }
+  }
+  boost::filesystem::remove(dbFile);
+}
+
+} // namespace benchmarks
+} // namespace ndns
+} // namespace ndn
@@ -0,0 +1,94 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "synthetic-zone.hpp"
+#include "clients/response.hpp"
+#include "mgmt/management-tool.hpp"
+#include "util/cert-helper.hpp"
+
+#include <random>
+
+namespace ndn {
+namespace ndns {
+namespace benchmarks {
+
+SyntheticZone::SyntheticZone(const std::string& dbFile, KeyChain& keyChain, const Name& zoneName,
+                             size_t nRecords, uint32_t seed)
+  : m_dbMgr(dbFile)
+{
+  ManagementTool tool(dbFile, keyChain);
+  m_zone = tool.createZone(zoneName, ROOT_ZONE);
+  m_dbMgr.find(m_zone);
+  Name identityName = Name(zoneName).append(label::NDNS_ITERATIVE_QUERY);
+  m_dskName = CertHelper::getDefaultKeyNameOfIdentity(keyChain, identityName);
+
+  // labels share their first components, like the names of a real zone;
+  // the last component is unique, so the labels are unique
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<size_t> depthDist(1, 3);
+  std::uniform_int_distribution<size_t> branchDist(0, 99);
+  m_labels.reserve(nRecords);
+  for (size_t i = 0; i < nRecords; ++i) {
+    Name label;
+    size_t depth = depthDist(rng);
+    for (size_t j = 1; j < depth; ++j) {
+      label.append("d" + to_string(branchDist(rng)));
+    }
+    label.append("r" + to_string(i));
+    m_labels.push_back(std::move(label));
+  }
+
+  m_dbMgr.beginTransaction();
+  for (const auto& label : m_labels) {
+    Rrset rrset = makeRrset(label);
+    m_dbMgr.insert(rrset);
+  }
+  m_dbMgr.commitTransaction();
+}
+
+Rrset
+SyntheticZone::makeRrset(const Name& label)
+{
+  Response response(m_zone.getName(), label::NDNS_ITERATIVE_QUERY);
+  response.setRrLabel(label);
+  response.setRrType(label::TXT_RR_TYPE);
+  response.setVersion(name::Component::fromVersion(1));
+  response.setContentType(NDNS_RESP);
+  response.setFreshnessPeriod(time::seconds(3600));
+  response.addRr("v=synthetic record of " + label.toUri());
+  response.addRr("a second string of the synthetic TXT rrset");
+
+  auto data = response.toData();
+  SignatureInfo info(ndn::tlv::SignatureSha256WithEcdsa, KeyLocator(m_dskName));
+  data->setSignatureInfo(info);
+  data->setSignatureValue(std::make_shared<Buffer>(72));
+
+  Rrset rrset(&m_zone);
+  rrset.setLabel(label);
+  rrset.setType(label::TXT_RR_TYPE);
+  rrset.setVersion(response.getVersion());
+  rrset.setTtl(time::seconds(3600));
+  rrset.setData(data->wireEncode());
+  return rrset;
+}
+
+} // namespace benchmarks
+} // namespace ndns
+} // namespace ndn
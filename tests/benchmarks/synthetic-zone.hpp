@@ -0,0 +1,90 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef NDNS_TESTS_BENCHMARKS_SYNTHETIC_ZONE_HPP
+#define NDNS_TESTS_BENCHMARKS_SYNTHETIC_ZONE_HPP
+
+#include "daemon/db-mgr.hpp"
+
+#include <ndn-cxx/security/key-chain.hpp>
+
+namespace ndn {
+namespace ndns {
+namespace benchmarks {
+
+/**
+ * @brief a zone of synthetic TXT records in a benchmark database
+ *
+ * The zone and its keys are created with ManagementTool::createZone. Labels have one to three
+ * components and are drawn from a generator seeded with @p seed, so the same parameters always
+ * produce the same zone. Records carry a placeholder ECDSA signature, since signing them is not
+ * what the database benchmarks measure, and are inserted in a single transaction.
+ */
+class SyntheticZone : boost::noncopyable
+{
+public:
+  SyntheticZone(const std::string& dbFile, KeyChain& keyChain, const Name& zoneName,
+                size_t nRecords, uint32_t seed);
+
+  DbMgr&
+  getDbMgr()
+  {
+    return m_dbMgr;
+  }
+
+  Zone&
+  getZone()
+  {
+    return m_zone;
+  }
+
+  /**
+   * @return labels of the synthetic records, in insertion order
+   */
+  const std::vector<Name>&
+  getLabels() const
+  {
+    return m_labels;
+  }
+
+  size_t
+  size() const
+  {
+    return m_labels.size();
+  }
+
+  /**
+   * @brief make a TXT rrset of the zone, with the same layout as the synthetic records
+   */
+  Rrset
+  makeRrset(const Name& label);
+
+private:
+  DbMgr m_dbMgr;
+  Zone m_zone;
+  Name m_dskName;
+  std::vector<Name> m_labels;
+};
+
+} // namespace benchmarks
+} // namespace ndns
+} // namespace ndn
+
+#endif // NDNS_TESTS_BENCHMARKS_SYNTHETIC_ZONE_HPP
@@ -0,0 +1,103 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "benchmark-suites.hpp"
+#include "validator/validation-policy-ndns.hpp"
+
+#include <ndn-cxx/security/certificate-fetcher-offline.hpp>
+#include <ndn-cxx/security/validation-policy-config.hpp>
+#include <ndn-cxx/security/validation-state.hpp>
+#include <ndn-cxx/security/validator.hpp>
+#include <ndn-cxx/util/io.hpp>
+
+namespace ndn {
+namespace ndns {
+namespace benchmarks {
+
+static const size_t N_PACKETS = 1000;
+
+static Data
+makeData(const Name& name, const Name& keyLocator)
+{
+  Data data(name);
+  SignatureInfo info(ndn::tlv::SignatureSha256WithEcdsa, KeyLocator(keyLocator));
+  data.setSignatureInfo(info);
+  data.setSignatureValue(std::make_shared<Buffer>(72));
+  data.wireEncode();
+  return data;
+}
+
+static void
+checkPolicy(security::ValidationPolicy& policy, const Data& data)
+{
+  auto state = make_shared<security::DataValidationState>(
+    data,
+    [] (const Data&) {},
+    [] (const Data&, const security::ValidationError&) {});
+  policy.checkPolicy(data, state,
+                     [] (const shared_ptr<security::CertificateRequest>& certRequest,
+                         const shared_ptr<security::ValidationState>&) {
+                       doNotOptimize(certRequest);
+                     });
+}
+
+void
+runValidationPolicyBenchmarks(BenchmarkRunner& runner, KeyChain& keyChain)
+{
+  // validator.conf of the benchmarks refers to this trust anchor
+  auto anchor = keyChain.createIdentity("/bench-anchor").getDefaultKey().getDefaultCertificate();
+  io::save(anchor, BENCHMARKS_TMPDIR "/anchors/root.cert");
+
+  security::Validator configValidator(make_unique<security::ValidationPolicyConfig>(),
+                                      make_unique<security::CertificateFetcherOffline>());
+  static_cast<security::ValidationPolicyConfig&>(configValidator.getPolicy())
+    .load(BENCHMARKS_TMPDIR "/validator.conf");
+  security::Validator ndnsValidator(make_unique<ValidationPolicyNdns>(),
+                                    make_unique<security::CertificateFetcherOffline>());
+  static_cast<ValidationPolicyNdns&>(ndnsValidator.getPolicy())
+    .load(BENCHMARKS_TMPDIR "/validator.conf");
+
+  // records signed by the DSK of their zone, and DSK certificates signed by the zone KSK
+  std::vector<Data> packets;
+  for (size_t i = 0; i < N_PACKETS; ++i) {
+    Name zone = Name("/bench").append("zone" + to_string(i % 10))
+                              .append("sub" + to_string(i));
+    Name keyPrefix = Name(zone).append("NDNS").append("KEY");
+    if (i % 2 == 0) {
+      Name name = Name(zone).append("NDNS").append("host" + to_string(i)).append("TXT");
+      packets.push_back(makeData(name.appendVersion(1), Name(keyPrefix).append("dsk-1")));
+    }
+    else {
+      Name name = Name(keyPrefix).append("dsk-1").append("CERT");
+      packets.push_back(makeData(name.appendVersion(1), Name(keyPrefix).append("ksk-1")));
+    }
+  }
+
+  runner.run("validation-policy/config", 0, [&] (size_t i) {
+    checkPolicy(configValidator.getPolicy(), packets[i % N_PACKETS]);
+  });
+  runner.run("validation-policy/ndns", 0, [&] (size_t i) {
+    checkPolicy(ndnsValidator.getPolicy(), packets[i % N_PACKETS]);
+  });
+}
+
+} // namespace benchmarks
+} // namespace ndns
+} // namespace ndn
@@ -0,0 +1,181 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "clients/batch-resolver.hpp"
+#include "daemon/name-server.hpp"
+
+#include "boost-test.hpp"
+#include "unit/database-test-data.hpp"
+
+#include <ndn-cxx/util/dummy-client-face.hpp>
+
+namespace ndn {
+namespace ndns {
+namespace tests {
+
+class BatchResolverFixture : public DbTestData
+{
+public:
+  BatchResolverFixture()
+    : producerFace(io, {false, true})
+    , consumerFace(io, {true, true})
+    , validator(NdnsValidatorBuilder::create(producerFace))
+    , top(m_test.getName(), m_certName, producerFace, m_session, m_keyChain, *validator)
+    , net(m_net.getName(), m_certName, producerFace, m_session, m_keyChain, *validator)
+    , ndnsim(m_ndnsim.getName(), m_certName, producerFace, m_session, m_keyChain, *validator)
+  {
+    run();
+    consumerFace.onSendInterest.connect([this] (const Interest& interest) {
+      io.post([=] { producerFace.receive(interest); });
+    });
+    producerFace.onSendData.connect([this] (const Data& data) {
+      io.post([=] { consumerFace.receive(data); });
+    });
+  }
+
+  void
+  run()
+  {
+    io.poll();
+    io.reset();
+  }
+
+public:
+  boost::asio::io_service io;
+  ndn::DummyClientFace producerFace;
+  ndn::DummyClientFace consumerFace;
+
+  unique_ptr<security::Validator> validator;
+  ndns::NameServer top;
+  ndns::NameServer net;
+  ndns::NameServer ndnsim;
+};
+
+BOOST_FIXTURE_TEST_SUITE(BatchResolver, BatchResolverFixture)
+
+BOOST_AUTO_TEST_CASE(MergeInFlight)
+{
+  ndns::BatchResolver resolver(consumerFace, 4, 4_s);
+  resolver.setStartComponentIndex(1);
+
+  std::vector<Name> succeeded;
+  auto addItem = [&] (const Name& label) {
+    resolver.add(label, label::TXT_RR_TYPE,
+                 [&succeeded] (const Data&, const Response& response) {
+                   succeeded.push_back(Name(response.getZone()).append(response.getRrLabel()));
+                 },
+                 [] (uint32_t, const std::string& errMsg) {
+                   BOOST_ERROR("resolution failed: " << errMsg);
+                 });
+  };
+
+  Name www = Name(m_ndnsimName).append("www");
+  Name docWww = Name(m_ndnsimName).append("doc").append("www");
+  addItem(www);
+  addItem(docWww);
+  addItem(www); // identical to the first item
+
+  bool hasFinished = false;
+  resolver.start([&] (const ndns::BatchResolver::Summary& summary) {
+    hasFinished = true;
+    BOOST_CHECK_EQUAL(summary.nSucceeded, 3);
+    BOOST_CHECK_EQUAL(summary.nFailed, 0);
+    BOOST_CHECK_EQUAL(summary.nResolutions, 2);
+    BOOST_CHECK_EQUAL(summary.nInterests, consumerFace.sentInterests.size());
+    BOOST_CHECK_GE(summary.nMergedInterests, 2);
+  });
+  BOOST_CHECK_EQUAL(resolver.getNInFlight(), 2);
+
+  run();
+
+  BOOST_CHECK(hasFinished);
+  BOOST_CHECK_EQUAL(resolver.getNInFlight(), 0);
+  BOOST_CHECK_EQUAL(succeeded.size(), 3);
+
+  // NS queries for /test19/net and /test19/net/ndnsim are shared by both resolutions:
+  // 4 Interests for www/TXT and 5 Interests for doc/www/TXT, 2 of them merged
+  BOOST_CHECK_EQUAL(consumerFace.sentInterests.size(), 7);
+}
+
+BOOST_AUTO_TEST_CASE(ConcurrencyWindow)
+{
+  ndns::BatchResolver resolver(consumerFace, 1, 4_s);
+  resolver.setStartComponentIndex(1);
+
+  size_t nSucceeded = 0;
+  for (const auto& label : {"www", "doc/www"}) {
+    resolver.add(Name(m_ndnsimName).append(Name(label)), label::TXT_RR_TYPE,
+                 [&] (const Data&, const Response&) { ++nSucceeded; },
+                 nullptr);
+  }
+
+  bool hasFinished = false;
+  resolver.start([&] (const ndns::BatchResolver::Summary&) { hasFinished = true; });
+  BOOST_CHECK_EQUAL(resolver.getNInFlight(), 1);
+  BOOST_CHECK_EQUAL(resolver.getNQueued(), 1);
+
+  run();
+
+  BOOST_CHECK(hasFinished);
+  BOOST_CHECK_EQUAL(nSucceeded, 2);
+}
+
+BOOST_AUTO_TEST_CASE(EmptyBatch)
+{
+  ndns::BatchResolver resolver(consumerFace, 4);
+
+  bool hasFinished = false;
+  resolver.start([&] (const ndns::BatchResolver::Summary& summary) {
+    hasFinished = true;
+    BOOST_CHECK_EQUAL(summary.nResolutions, 0);
+  });
+  BOOST_CHECK(hasFinished);
+}
+
+BOOST_AUTO_TEST_CASE(LateDataAfterAbort)
+{
+  // nobody answers on this face
+  ndn::DummyClientFace face(m_io, {true, true});
+  ndns::BatchResolver resolver(face, 1, 10_s);
+
+  size_t nFailed = 0;
+  resolver.add(Name(m_ndnsimName).append("www"), label::TXT_RR_TYPE,
+               [] (const Data&, const Response&) { BOOST_ERROR("unexpected success"); },
+               [&] (uint32_t, const std::string&) { ++nFailed; });
+  resolver.start();
+
+  // the query gives up after its retransmissions, while the last one has not expired yet
+  advanceClocks(500_ms, 32);
+  BOOST_CHECK_EQUAL(nFailed, 1);
+  BOOST_CHECK_EQUAL(resolver.getNInFlight(), 0);
+  BOOST_REQUIRE(!face.sentInterests.empty());
+
+  // the Interests of the aborted query were cancelled, a late Data is not delivered to it
+  auto data = make_shared<Data>(face.sentInterests.back().getName());
+  m_keyChain.sign(*data);
+  face.receive(*data);
+  advanceClocks(10_ms, 1);
+  BOOST_CHECK_EQUAL(nFailed, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace ndns
+} // namespace ndn
@@ -1,6 +1,6 @@
 /* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
 /*
- * Copyright (c) 2014-2023, Regents of the University of California.
+ * Copyright (c) 2014-2024, Regents of the University of California.
  *
  * This file is part of NDNS (Named Data Networking Domain Name Service).
  * See AUTHORS.md for complete list of NDNS authors and contributors.
@@ -18,13 +18,19 @@
  */
 
 #include "clients/iterative-query-controller.hpp"
+#include "clients/multi-response.hpp"
 #include "daemon/name-server.hpp"
+#include "daemon/rrset-factory.hpp"
 
 #include "boost-test.hpp"
 #include "unit/database-test-data.hpp"
 
 #include <ndn-cxx/util/dummy-client-face.hpp>
 
+#include <boost/filesystem/operations.hpp>
+
+#include <optional>
+
 namespace ndn {
 namespace ndns {
 namespace tests {
@@ -134,6 +140,394 @@ BOOST_FIXTURE_TEST_CASE(Basic, QueryControllerFixture)
   }
 }
 
+BOOST_FIXTURE_TEST_CASE(MultiType, QueryControllerFixture)
+{
+  Name dstLabel = Name(m_ndnsim.getName()).append("www");
+  auto rrType = label::makeMultiRrType({label::TXT_RR_TYPE, label::APPCERT_RR_TYPE});
+
+  std::optional<ndns::MultiResponse> answer;
+  auto ctr = std::make_shared<ndns::IterativeQueryController>(
+    dstLabel, rrType, 4_s,
+    [&] (const Data&, const Response& response) { answer.emplace(response); },
+    [] (uint32_t, const std::string& errMsg) { BOOST_ERROR(errMsg); },
+    consumerFace);
+  ctr->setStartComponentIndex(1);
+  ctr->start();
+  run();
+
+  // both records are retrieved by the last Interest
+  BOOST_REQUIRE_EQUAL(consumerFace.sentInterests.size(), 4);
+  BOOST_CHECK_EQUAL(consumerFace.sentInterests.back().getName(),
+                    "/test19/net/ndnsim/NDNS/www/MULTI.TXT.APPCERT");
+
+  BOOST_REQUIRE(answer);
+  BOOST_REQUIRE_EQUAL(answer->getRecords().size(), 2);
+  const auto* txt = answer->find(label::TXT_RR_TYPE);
+  BOOST_REQUIRE(txt != nullptr);
+  BOOST_CHECK(txt->exists);
+  BOOST_CHECK_EQUAL(txt->data.getName().getPrefix(-1), "/test19/net/ndnsim/NDNS/www/TXT");
+  const auto* appcert = answer->find(label::APPCERT_RR_TYPE);
+  BOOST_REQUIRE(appcert != nullptr);
+  BOOST_CHECK(!appcert->exists);
+  BOOST_CHECK_EQUAL(appcert->data.getContentType(), NDNS_DOE);
+  BOOST_CHECK(answer->find(label::NS_RR_TYPE) == nullptr);
+}
+
+BOOST_FIXTURE_TEST_CASE(SegmentedAnswer, QueryControllerFixture)
+{
+  ndnsim.setSegmentSize(100);
+
+  std::optional<Response> answer;
+  auto ctr = std::make_shared<ndns::IterativeQueryController>(
+    Name(m_ndnsim.getName()).append("www"), label::TXT_RR_TYPE, 4_s,
+    [&] (const Data&, const Response& response) { answer = response; },
+    [] (uint32_t, const std::string& errMsg) { BOOST_ERROR(errMsg); },
+    consumerFace);
+  ctr->setStartComponentIndex(1);
+  ctr->start();
+  run();
+
+  // the TXT record is answered with its first segment, the others are fetched by name
+  BOOST_REQUIRE_GT(consumerFace.sentInterests.size(), 5);
+  Name txtName("/test19/net/ndnsim/NDNS/www/TXT");
+  BOOST_CHECK_EQUAL(consumerFace.sentInterests[3].getName(), txtName);
+  for (size_t i = 4; i < consumerFace.sentInterests.size(); ++i) {
+    const Name& name = consumerFace.sentInterests[i].getName();
+    BOOST_CHECK(txtName.isPrefixOf(name));
+    // segment Interests reach the name server through the same delegation
+    BOOST_CHECK(!consumerFace.sentInterests[i].getForwardingHint().empty());
+  }
+
+  BOOST_REQUIRE(answer);
+  BOOST_CHECK_EQUAL(answer->getContentType(), NDNS_RESP);
+  BOOST_CHECK_EQUAL(answer->getRrLabel(), Name("www"));
+}
+
+BOOST_FIXTURE_TEST_CASE(Timeline, QueryControllerFixture)
+{
+  bool hasTimeline = false;
+  auto ctr = std::make_shared<ndns::IterativeQueryController>(
+    Name(m_ndnsim.getName()).append("www"), name::Component("TXT"), 4_s,
+    [&] (const Data&, const Response&) { BOOST_CHECK(hasTimeline); },
+    [] (uint32_t, const std::string& errMsg) { BOOST_ERROR("query failed: " << errMsg); },
+    consumerFace);
+  ctr->setStartComponentIndex(1);
+  ctr->setTimelineObserver([&] (const ndns::ResolutionTimeline& timeline) {
+    hasTimeline = true;
+
+    const auto& events = timeline.getEvents();
+    BOOST_REQUIRE_EQUAL(events.size(), 12);
+    for (size_t i = 0; i < 4; ++i) {
+      BOOST_CHECK_EQUAL(events[3 * i].type, ndns::TimelineEvent::INTEREST_SENT);
+      BOOST_CHECK_EQUAL(events[3 * i + 1].type, ndns::TimelineEvent::DATA_RECEIVED);
+      BOOST_CHECK_EQUAL(events[3 * i + 2].type, ndns::TimelineEvent::STEP_END);
+      BOOST_CHECK(events[3 * i].name.isPrefixOf(events[3 * i + 1].name));
+    }
+    BOOST_CHECK(events[0].via.empty());
+    BOOST_CHECK_EQUAL(events[3].via, m_links[0].getDelegationList().front());
+    BOOST_CHECK_EQUAL(events[11].contentType, NDNS_RESP);
+
+    auto breakdown = timeline.getBreakdown();
+    BOOST_CHECK_EQUAL(breakdown.nSteps, 4);
+    BOOST_CHECK_EQUAL(breakdown.nInterests, 4);
+    BOOST_CHECK_EQUAL(breakdown.nRetransmissions, 0);
+    BOOST_CHECK_EQUAL(breakdown.nCacheHits, 0);
+  });
+
+  ctr->start();
+  run();
+
+  BOOST_CHECK(hasTimeline);
+}
+
+BOOST_FIXTURE_TEST_CASE(PersistentCache, QueryControllerFixture)
+{
+  auto cacheFile = boost::filesystem::path(UNIT_TESTS_TMPDIR) / "iterative-resolver-cache.db";
+  boost::filesystem::remove(cacheFile);
+  ndns::ResolverCache cache(cacheFile.string());
+
+  Name dstLabel = Name(m_ndnsim.getName()).append("www");
+  auto resolve = [&] {
+    bool hasDataBack = false;
+    auto ctr = std::make_shared<ndns::IterativeQueryController>(
+      dstLabel, name::Component("TXT"), 4_s,
+      [&] (const Data&, const Response&) { hasDataBack = true; },
+      [] (uint32_t, const std::string& errMsg) { BOOST_ERROR("query failed: " << errMsg); },
+      consumerFace);
+    ctr->setStartComponentIndex(1);
+    ctr->setResolverCache(&cache);
+    ctr->start();
+    run();
+    return hasDataBack;
+  };
+
+  BOOST_CHECK(resolve());
+  BOOST_REQUIRE_EQUAL(consumerFace.sentInterests.size(), 4);
+  BOOST_REQUIRE_EQUAL(producerFace.sentData.size(), 4);
+
+  // without a validator, responses are not stored; store them as if they had been validated
+  for (size_t i = 0; i < 4; ++i) {
+    cache.insert(consumerFace.sentInterests[i].getName(), producerFace.sentData[i], true);
+  }
+
+  // another process sharing the cache file resolves without sending any Interest
+  consumerFace.sentInterests.clear();
+  BOOST_CHECK(resolve());
+  BOOST_CHECK_EQUAL(consumerFace.sentInterests.size(), 0);
+
+  boost::filesystem::remove(cacheFile);
+}
+
+class RetransmissionFixture : public DbTestData
+{
+public:
+  RetransmissionFixture()
+    : producerFace(m_io, {false, true})
+    , consumerFace(m_io, {true, true})
+    , validator(NdnsValidatorBuilder::create(producerFace))
+    , top(m_test.getName(), m_certName, producerFace, m_session, m_keyChain, *validator)
+    , net(m_net.getName(), m_certName, producerFace, m_session, m_keyChain, *validator)
+    , ndnsim(m_ndnsim.getName(), m_certName, producerFace, m_session, m_keyChain, *validator)
+  {
+    advanceClocks(1_ms);
+    consumerFace.onSendInterest.connect([this] (const Interest& interest) {
+      if (interest.getName() == heldName) {
+        heldInterests.emplace_back(interest, time::steady_clock::now());
+        return;
+      }
+      if (nDrops > 0) {
+        --nDrops;
+        return;
+      }
+      if (nNacks > 0) {
+        --nNacks;
+        lp::Nack nack(interest);
+        nack.setReason(lp::NackReason::NO_ROUTE);
+        m_io.post([=] { consumerFace.receive(nack); });
+        return;
+      }
+      m_io.post([=] { producerFace.receive(interest); });
+    });
+    producerFace.onSendData.connect([this] (const Data& data) {
+      m_io.post([=] { consumerFace.receive(data); });
+    });
+  }
+
+public:
+  ndn::DummyClientFace producerFace;
+  ndn::DummyClientFace consumerFace;
+
+  unique_ptr<security::Validator> validator;
+  ndns::NameServer top;
+  ndns::NameServer net;
+  ndns::NameServer ndnsim;
+
+  size_t nDrops = 0; ///< number of Interests from consumer to be lost
+  size_t nNacks = 0; ///< number of Interests from consumer to be Nacked
+  Name heldName; ///< Interests from consumer with this name are held instead of being sent
+  std::vector<std::pair<Interest, time::steady_clock::time_point>> heldInterests;
+};
+
+BOOST_FIXTURE_TEST_CASE(Retransmission, RetransmissionFixture)
+{
+  bool hasDataBack = false;
+  auto ctr = std::make_shared<ndns::IterativeQueryController>(
+    Name(m_ndnsim.getName()).append("www"), name::Component("TXT"), 4_s,
+    [&] (const Data&, const Response&) { hasDataBack = true; },
+    [] (uint32_t, const std::string& errMsg) { BOOST_ERROR("query failed: " << errMsg); },
+    consumerFace);
+  ctr->setStartComponentIndex(1);
+
+  nDrops = 1;
+  ctr->start();
+  advanceClocks(10_ms, 2_s);
+
+  BOOST_CHECK(hasDataBack);
+  BOOST_CHECK_EQUAL(ctr->getNRetransmissions(), 1);
+  BOOST_REQUIRE_EQUAL(consumerFace.sentInterests.size(), 5);
+  BOOST_CHECK_EQUAL(consumerFace.sentInterests[0].getName(),
+                    consumerFace.sentInterests[1].getName());
+  BOOST_CHECK_NE(consumerFace.sentInterests[0].getNonce(),
+                 consumerFace.sentInterests[1].getNonce());
+}
+
+BOOST_FIXTURE_TEST_CASE(NackIsOneFailure, RetransmissionFixture)
+{
+  auto rttTable = make_shared<RttTable>();
+  bool hasDataBack = false;
+  auto ctr = std::make_shared<ndns::IterativeQueryController>(
+    Name(m_ndnsim.getName()).append("www"), name::Component("TXT"), 4_s,
+    [&] (const Data&, const Response&) { hasDataBack = true; },
+    [] (uint32_t, const std::string& errMsg) { BOOST_ERROR("query failed: " << errMsg); },
+    consumerFace);
+  ctr->setStartComponentIndex(1);
+  ctr->setRttTable(rttTable);
+
+  nNacks = 1;
+  ctr->start();
+  advanceClocks(10_ms, 2_s);
+
+  BOOST_CHECK(hasDataBack);
+  BOOST_CHECK_EQUAL(ctr->getNRetransmissions(), 1);
+  // the retransmission is answered but not measured, so the failure is still remembered
+  RttTable::Options options;
+  BOOST_CHECK_EQUAL(rttTable->getScore(m_test.getName()), options.minRto * 2);
+}
+
+BOOST_FIXTURE_TEST_CASE(RetryLimit, RetransmissionFixture)
+{
+  bool hasFailed = false;
+  auto ctr = std::make_shared<ndns::IterativeQueryController>(
+    Name(m_ndnsim.getName()).append("www"), name::Component("TXT"), 4_s,
+    [] (const Data&, const Response&) { BOOST_ERROR("query should fail"); },
+    [&] (uint32_t, const std::string&) { hasFailed = true; },
+    consumerFace);
+  ctr->setStartComponentIndex(1);
+  ctr->setMaxRetries(2);
+
+  nDrops = 100;
+  ctr->start();
+  advanceClocks(100_ms, 20_s);
+
+  BOOST_CHECK(hasFailed);
+  BOOST_CHECK_EQUAL(consumerFace.sentInterests.size(), 3);
+  BOOST_CHECK_EQUAL(ctr->getStep(), ndns::IterativeQueryController::QUERY_STEP_ABORT);
+}
+
+class HedgingFixture : public RetransmissionFixture
+{
+public:
+  HedgingFixture()
+  {
+    // the zone /test19/net is served by two name servers
+    RrsetFactory rf(TEST_DATABASE.string(), m_test.getName(), m_keyChain, m_certName);
+    rf.onlyCheckZone();
+    Rrset link = rf.generateNsRrset("net", 101, time::seconds(3000), {"/xx", "/yy"});
+    Rrset stored(&m_test);
+    stored.setLabel("net");
+    stored.setType(label::NS_RR_TYPE);
+    BOOST_VERIFY(m_session.find(stored));
+    stored.setVersion(link.getVersion());
+    stored.setData(link.getData());
+    m_session.update(stored);
+
+    // the Interests for the NS record of /test19/net/ndnsim are sent with both delegations
+    heldName = "/test19/net/NDNS/ndnsim/NS";
+  }
+
+  shared_ptr<ndns::IterativeQueryController>
+  makeController(shared_ptr<RttTable> rttTable = make_shared<RttTable>())
+  {
+    auto ctr = std::make_shared<ndns::IterativeQueryController>(
+      Name(m_ndnsim.getName()).append("www"), name::Component("TXT"), 4_s,
+      [this] (const Data&, const Response&) { hasDataBack = true; },
+      [] (uint32_t, const std::string& errMsg) { BOOST_ERROR("query failed: " << errMsg); },
+      consumerFace);
+    ctr->setStartComponentIndex(1);
+    ctr->setRttTable(std::move(rttTable));
+    return ctr;
+  }
+
+  /**
+   * @brief wait until the first held Interest is sent
+   */
+  void
+  waitForHeldInterest()
+  {
+    for (int i = 0; i < 1000 && heldInterests.empty(); ++i) {
+      advanceClocks(1_ms);
+    }
+    BOOST_REQUIRE_EQUAL(heldInterests.size(), 1);
+  }
+
+  /**
+   * @brief let the name server receive the held Interest @p i
+   */
+  void
+  release(size_t i)
+  {
+    Interest interest = heldInterests.at(i).first;
+    m_io.post([=] { producerFace.receive(interest); });
+  }
+
+  static Name
+  getHint(const Interest& interest)
+  {
+    BOOST_REQUIRE_EQUAL(interest.getForwardingHint().size(), 1);
+    return interest.getForwardingHint().front();
+  }
+
+public:
+  bool hasDataBack = false;
+};
+
+BOOST_FIXTURE_TEST_CASE(HedgedRequest, HedgingFixture)
+{
+  auto ctr = makeController();
+  ctr->start();
+  waitForHeldInterest();
+  BOOST_CHECK_EQUAL(getHint(heldInterests[0].first), "/xx");
+
+  // without RTT samples, the second name server is tried after the default hedging delay
+  advanceClocks(1_ms, 199);
+  BOOST_CHECK_EQUAL(heldInterests.size(), 1);
+  BOOST_CHECK_EQUAL(ctr->getNHedges(), 0);
+  advanceClocks(1_ms);
+  BOOST_REQUIRE_EQUAL(heldInterests.size(), 2);
+  BOOST_CHECK_EQUAL(heldInterests[1].second - heldInterests[0].second, 200_ms);
+  BOOST_CHECK_EQUAL(getHint(heldInterests[1].first), "/yy");
+  BOOST_CHECK_NE(heldInterests[0].first.getNonce(), heldInterests[1].first.getNonce());
+  BOOST_CHECK_EQUAL(ctr->getNHedges(), 1);
+
+  // the hedged Interest is answered, the query goes on with a single Interest per step
+  release(1);
+  advanceClocks(10_ms, 2_s);
+  BOOST_CHECK(hasDataBack);
+  BOOST_CHECK_EQUAL(heldInterests.size(), 2);
+  BOOST_CHECK_EQUAL(ctr->getNHedges(), 1);
+}
+
+BOOST_FIXTURE_TEST_CASE(HedgeCancelledByAnswer, HedgingFixture)
+{
+  auto ctr = makeController();
+  ctr->start();
+  waitForHeldInterest();
+
+  // the first name server answers before the hedging delay
+  advanceClocks(1_ms, 150);
+  release(0);
+  advanceClocks(1_ms, 2000);
+  BOOST_CHECK(hasDataBack);
+  BOOST_CHECK_EQUAL(heldInterests.size(), 1);
+  BOOST_CHECK_EQUAL(ctr->getNHedges(), 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(HedgingDelayFromRtt, HedgingFixture)
+{
+  // the name server reached through /yy used to be faster, it is tried first
+  auto rttTable = make_shared<RttTable>();
+  rttTable->addMeasurement("/xx", 300_ms);
+  rttTable->addMeasurement("/yy", 40_ms);
+  BOOST_CHECK_EQUAL(rttTable->getSmoothedRtt("/yy"), 40_ms);
+
+  auto ctr = makeController(rttTable);
+  ctr->start();
+  waitForHeldInterest();
+  BOOST_CHECK_EQUAL(getHint(heldInterests[0].first), "/yy");
+
+  // the hedging delay is twice its smoothed RTT
+  advanceClocks(1_ms, 79);
+  BOOST_CHECK_EQUAL(heldInterests.size(), 1);
+  advanceClocks(1_ms);
+  BOOST_REQUIRE_EQUAL(heldInterests.size(), 2);
+  BOOST_CHECK_EQUAL(heldInterests[1].second - heldInterests[0].second, 80_ms);
+  BOOST_CHECK_EQUAL(getHint(heldInterests[1].first), "/xx");
+
+  release(0);
+  advanceClocks(10_ms, 2_s);
+  BOOST_CHECK(hasDataBack);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace tests
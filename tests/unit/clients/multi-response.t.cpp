@@ -0,0 +1,139 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "clients/multi-response.hpp"
+
+#include "boost-test.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+
+namespace ndn {
+namespace ndns {
+namespace tests {
+
+class MultiResponseFixture
+{
+public:
+  static Data
+  makeRecord(const Name& name, NdnsContentType contentType, const Block& content)
+  {
+    Data data(name);
+    data.setContentType(contentType);
+    data.setContent(content);
+    data.setSignatureInfo(SignatureInfo(ndn::tlv::DigestSha256));
+    data.setSignatureValue(std::make_shared<Buffer>(32));
+    return data;
+  }
+
+  /**
+   * @return a DoE record of /test19 covering the labels between @p first and @p last
+   */
+  static Data
+  makeDoe(const Name& first, const Name& last)
+  {
+    Block content(ndn::tlv::Content);
+    content.push_back(first.wireEncode());
+    content.push_back(last.wireEncode());
+    content.encode();
+    Name name("/test19/NDNS");
+    name.append(first).append(label::DOE_RR_TYPE).appendVersion(1);
+    return makeRecord(name, NDNS_DOE, content);
+  }
+
+  static ndns::Response
+  makeResponse(const std::vector<Data>& records)
+  {
+    ndns::Response response("/test19", label::NDNS_ITERATIVE_QUERY);
+    response.setRrLabel(Name("www"));
+    response.setRrType(label::makeMultiRrType({label::TXT_RR_TYPE, label::APPCERT_RR_TYPE}));
+    response.setContentType(NDNS_MULTI);
+    for (const auto& record : records) {
+      response.addRr(record.wireEncode());
+    }
+    return response;
+  }
+
+public:
+  Data txt = makeRecord(Name("/test19/NDNS/www/TXT").appendVersion(1), NDNS_RESP,
+                        makeStringBlock(ndn::tlv::Content, "hello"));
+  Data doe = makeDoe(Name("www/AAAAAAA"), Name("www/ZZZZZZZ"));
+};
+
+BOOST_FIXTURE_TEST_SUITE(MultiResponse, MultiResponseFixture)
+
+BOOST_AUTO_TEST_CASE(Decode)
+{
+  ndns::MultiResponse multi(makeResponse({txt, doe}));
+  BOOST_REQUIRE_EQUAL(multi.getRecords().size(), 2);
+  const auto* record = multi.find(label::TXT_RR_TYPE);
+  BOOST_REQUIRE(record != nullptr);
+  BOOST_CHECK(record->exists);
+  BOOST_CHECK_EQUAL(record->data.getName(), txt.getName());
+  record = multi.find(label::APPCERT_RR_TYPE);
+  BOOST_REQUIRE(record != nullptr);
+  BOOST_CHECK(!record->exists);
+  BOOST_CHECK(multi.find(label::NS_RR_TYPE) == nullptr);
+
+  // the last DoE record of the zone wraps around
+  BOOST_CHECK_NO_THROW(ndns::MultiResponse(makeResponse({txt, makeDoe(Name("zzz/TXT"),
+                                                                      Name("aaa/TXT"))})));
+}
+
+BOOST_AUTO_TEST_CASE(WrongRecord)
+{
+  // wrong number of records
+  BOOST_CHECK_THROW(ndns::MultiResponse(makeResponse({txt})), ndns::MultiResponse::Error);
+
+  // records in the wrong order
+  Data appcert = makeRecord(Name("/test19/NDNS/www/APPCERT").appendVersion(1), NDNS_RESP,
+                            Block(ndn::tlv::Content));
+  BOOST_CHECK_THROW(ndns::MultiResponse(makeResponse({appcert, txt})),
+                    ndns::MultiResponse::Error);
+
+  // record of another label, or of another zone
+  Data other = makeRecord(Name("/test19/NDNS/ftp/TXT").appendVersion(1), NDNS_RESP,
+                          Block(ndn::tlv::Content));
+  BOOST_CHECK_THROW(ndns::MultiResponse(makeResponse({other, doe})), ndns::MultiResponse::Error);
+  other.setName(Name("/other/NDNS/www/TXT").appendVersion(1));
+  BOOST_CHECK_THROW(ndns::MultiResponse(makeResponse({other, doe})), ndns::MultiResponse::Error);
+}
+
+BOOST_AUTO_TEST_CASE(WrongDoe)
+{
+  // DoE record that does not cover www/APPCERT, shorter components being ordered first
+  BOOST_CHECK_THROW(ndns::MultiResponse(makeResponse({txt, makeDoe(Name("www/A"), Name("www/B"))})),
+                    ndns::MultiResponse::Error);
+
+  // not a DoE record of the zone
+  Data notDoe = doe;
+  notDoe.setName(Name("/other/NDNS/www/AAAAAAA/DOE").appendVersion(1));
+  BOOST_CHECK_THROW(ndns::MultiResponse(makeResponse({txt, notDoe})), ndns::MultiResponse::Error);
+
+  // malformed DoE record
+  Data malformed = makeRecord(doe.getName(), NDNS_DOE, Block(ndn::tlv::Content));
+  BOOST_CHECK_THROW(ndns::MultiResponse(makeResponse({txt, malformed})),
+                    ndns::MultiResponse::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace ndns
+} // namespace ndn
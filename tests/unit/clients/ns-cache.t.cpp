@@ -0,0 +1,133 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "clients/ns-cache.hpp"
+
+#include "boost-test.hpp"
+#include "io-fixture.hpp"
+
+namespace ndn {
+namespace ndns {
+namespace tests {
+
+class NsCacheFixture : public IoFixture
+{
+public:
+  static Data
+  makeData(const Name& name, time::milliseconds freshness = 0_ms)
+  {
+    Data data(name);
+    data.setFreshnessPeriod(freshness);
+    data.setSignatureInfo(SignatureInfo(ndn::tlv::DigestSha256));
+    data.setSignatureValue(std::make_shared<Buffer>(32));
+    return data;
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE(NsCache, NsCacheFixture)
+
+BOOST_AUTO_TEST_CASE(Expiry)
+{
+  ndns::NsCache cache(m_io, 10);
+  Name shortLived = Name("/test19/NDNS/net/NS").appendVersion(1);
+  Name longLived = Name("/test19/NDNS/org/NS").appendVersion(1);
+  Name permanent = Name("/test19/NDNS/com/NS").appendVersion(1);
+  cache.insert(makeData(shortLived, 1_s));
+  cache.insert(makeData(longLived, 10_s));
+  cache.insert(makeData(permanent));
+  BOOST_CHECK_EQUAL(cache.size(), 3);
+
+  advanceClocks(100_ms, 15);
+  BOOST_CHECK(cache.find(shortLived) == nullptr);
+  BOOST_CHECK(cache.find(longLived) != nullptr);
+  BOOST_CHECK_EQUAL(cache.getNExpirations(), 1);
+
+  advanceClocks(1_s, 10);
+  BOOST_CHECK(cache.find(longLived) == nullptr);
+  BOOST_CHECK(cache.find(permanent) != nullptr);
+  BOOST_CHECK_EQUAL(cache.size(), 1);
+  BOOST_CHECK_EQUAL(cache.getNExpirations(), 2);
+  BOOST_CHECK_EQUAL(cache.getNEvictions(), 0);
+  BOOST_CHECK_EQUAL(cache.getNHits(), 2);
+  BOOST_CHECK_EQUAL(cache.getNMisses(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(PopularEntrySurvivesScan)
+{
+  ndns::NsCache cache(m_io, 4);
+  Name popular("/test19/NDNS/net/NS");
+
+  cache.insert(makeData(Name(popular).appendVersion(1), 1_s));
+  for (int i = 0; i < 5; ++i) {
+    BOOST_CHECK(cache.find(Name(popular).appendVersion(1)) != nullptr);
+  }
+  advanceClocks(100_ms, 15);
+  BOOST_CHECK_EQUAL(cache.size(), 0);
+
+  // the frequency of a name is remembered across versions and after removal
+  BOOST_CHECK_GE(cache.estimateFrequency(Name(popular).appendVersion(2)), 6);
+
+  // a newer version enters the cache again, followed by a scan of one-off delegations;
+  // plain LRU would evict it after 4 insertions
+  cache.insert(makeData(Name(popular).appendVersion(2)));
+  for (int i = 0; i < 10; ++i) {
+    cache.insert(makeData(Name("/test19/NDNS/one-off").appendNumber(i).append("NS").appendVersion(1)));
+  }
+  BOOST_CHECK_EQUAL(cache.size(), 4);
+  BOOST_CHECK(cache.find(Name(popular).appendVersion(2)) != nullptr);
+
+  BOOST_CHECK_EQUAL(cache.getNHits(), 6);
+  BOOST_CHECK_EQUAL(cache.getNMisses(), 0);
+  BOOST_CHECK_EQUAL(cache.getNInsertions(), 12);
+  BOOST_CHECK_EQUAL(cache.getNExpirations(), 1);
+  BOOST_CHECK_EQUAL(cache.getNEvictions(), 7);
+}
+
+BOOST_AUTO_TEST_CASE(ProtectedSegment)
+{
+  ndns::NsCache cache(m_io, 5); // 4 protected entries
+  std::vector<Name> names;
+  for (int i = 0; i < 5; ++i) {
+    names.push_back(Name("/test19/NDNS").appendNumber(i).append("NS").appendVersion(1));
+    cache.insert(makeData(names.back()));
+  }
+
+  // entries found again are protected from one-off insertions
+  for (int i = 0; i < 4; ++i) {
+    BOOST_CHECK(cache.find(names[i]) != nullptr);
+  }
+  cache.insert(makeData("/test19/NDNS/other/NS/v=1"));
+  BOOST_CHECK(cache.find(names[4]) == nullptr);
+  for (int i = 0; i < 4; ++i) {
+    BOOST_CHECK(cache.find(names[i]) != nullptr);
+  }
+
+  // explicitly erased entries are forgotten by the replacement policy
+  cache.erase(names[0], true);
+  BOOST_CHECK_EQUAL(cache.size(), 4);
+  cache.insert(makeData("/test19/NDNS/another/NS/v=1"));
+  BOOST_CHECK_EQUAL(cache.size(), 5);
+  BOOST_CHECK_EQUAL(cache.getNEvictions(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace ndns
+} // namespace ndn
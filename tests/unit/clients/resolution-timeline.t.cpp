@@ -0,0 +1,78 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "clients/resolution-timeline.hpp"
+
+#include "boost-test.hpp"
+
+namespace ndn {
+namespace ndns {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(ResolutionTimeline)
+
+BOOST_AUTO_TEST_CASE(Breakdown)
+{
+  ndns::ResolutionTimeline timeline;
+  BOOST_CHECK_EQUAL(timeline.getBreakdown().total, 0_ns);
+
+  auto t0 = time::steady_clock::now();
+  auto addEvent = [&] (TimelineEvent::Type type, time::milliseconds at,
+                       time::milliseconds duration = 0_ms) {
+    TimelineEvent event;
+    event.type = type;
+    event.time = t0 + at;
+    event.name = "/test19/NDNS/net/NS";
+    event.duration = duration;
+    timeline.add(event);
+  };
+
+  addEvent(TimelineEvent::CACHE_MISS, 0_ms, 1_ms);
+  addEvent(TimelineEvent::INTEREST_SENT, 1_ms);
+  addEvent(TimelineEvent::TIMEOUT, 201_ms);
+  addEvent(TimelineEvent::INTEREST_RETRANSMITTED, 201_ms);
+  addEvent(TimelineEvent::DATA_RECEIVED, 251_ms, 250_ms);
+  addEvent(TimelineEvent::VALIDATION_START, 252_ms);
+  addEvent(TimelineEvent::VALIDATION_END, 262_ms, 10_ms);
+  addEvent(TimelineEvent::STEP_END, 262_ms, 262_ms);
+  addEvent(TimelineEvent::CACHE_HIT, 263_ms, 2_ms);
+  addEvent(TimelineEvent::STEP_END, 270_ms, 7_ms);
+
+  auto breakdown = timeline.getBreakdown();
+  BOOST_CHECK_EQUAL(breakdown.total, 270_ms);
+  BOOST_CHECK_EQUAL(breakdown.network, 250_ms);
+  BOOST_CHECK_EQUAL(breakdown.validation, 10_ms);
+  BOOST_CHECK_EQUAL(breakdown.cache, 3_ms);
+  BOOST_CHECK_EQUAL(breakdown.other, 7_ms);
+  BOOST_CHECK_EQUAL(breakdown.nSteps, 2);
+  BOOST_CHECK_EQUAL(breakdown.nInterests, 2);
+  BOOST_CHECK_EQUAL(breakdown.nRetransmissions, 1);
+  BOOST_CHECK_EQUAL(breakdown.nCacheHits, 1);
+
+  std::ostringstream os;
+  os << timeline;
+  BOOST_CHECK_NE(os.str().find("+201000us InterestRetransmitted /test19/NDNS/net/NS"),
+                 std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace ndns
+} // namespace ndn
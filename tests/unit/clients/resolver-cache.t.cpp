@@ -0,0 +1,124 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "clients/resolver-cache.hpp"
+
+#include "boost-test.hpp"
+#include "clock-fixture.hpp"
+
+#include <boost/filesystem/operations.hpp>
+
+namespace ndn {
+namespace ndns {
+namespace tests {
+
+const auto TEST_CACHE_FILE = boost::filesystem::path(UNIT_TESTS_TMPDIR) / "resolver-cache.db";
+
+class ResolverCacheFixture : public ClockFixture
+{
+public:
+  ResolverCacheFixture()
+  {
+    boost::filesystem::remove(TEST_CACHE_FILE);
+  }
+
+  ~ResolverCacheFixture() override
+  {
+    boost::system::error_code ec;
+    boost::filesystem::remove(TEST_CACHE_FILE, ec);
+  }
+
+  static Data
+  makeData(const Name& name, time::milliseconds freshness)
+  {
+    Data data(name);
+    data.setFreshnessPeriod(freshness);
+    data.setSignatureInfo(SignatureInfo(tlv::DigestSha256));
+    data.setSignatureValue(std::make_shared<Buffer>(32));
+    return data;
+  }
+};
+
+BOOST_FIXTURE_TEST_SUITE(ResolverCache, ResolverCacheFixture)
+
+BOOST_AUTO_TEST_CASE(InsertFind)
+{
+  ndns::ResolverCache cache(TEST_CACHE_FILE.string());
+  Name key("/test19/net/NDNS/ndnsim/NS");
+  Data data = makeData(Name(key).appendVersion(1), 10_s);
+
+  BOOST_CHECK(cache.find(key) == nullptr);
+  cache.insert(key, data, true);
+
+  auto found = cache.find(key);
+  BOOST_REQUIRE(found != nullptr);
+  BOOST_CHECK_EQUAL(found->wireEncode(), data.wireEncode());
+
+  // Data without FreshnessPeriod are not cached
+  Name key2("/test19/net/NDNS/www/TXT");
+  cache.insert(key2, makeData(Name(key2).appendVersion(1), 0_ms), true);
+  BOOST_CHECK(cache.find(key2) == nullptr);
+
+  advanceClocks(11_s);
+  BOOST_CHECK(cache.find(key) == nullptr);
+  BOOST_CHECK_EQUAL(cache.evictExpired(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(Validated)
+{
+  ndns::ResolverCache cache(TEST_CACHE_FILE.string());
+  Name key("/test19/net/NDNS/KEY/%01/CERT");
+  Data unvalidated = makeData(Name(key).appendVersion(1), 10_s);
+  Data validated = makeData(Name(key).appendVersion(2), 10_s);
+
+  cache.insert(key, unvalidated, false);
+  BOOST_CHECK(cache.find(key) == nullptr);
+  BOOST_CHECK(cache.find(key, false) != nullptr);
+
+  cache.insert(key, validated, true);
+  BOOST_REQUIRE(cache.find(key) != nullptr);
+  BOOST_CHECK_EQUAL(cache.find(key)->getName(), validated.getName());
+
+  // an unvalidated response does not replace a validated one
+  cache.insert(key, unvalidated, false);
+  BOOST_CHECK_EQUAL(cache.find(key, false)->getName(), validated.getName());
+}
+
+BOOST_AUTO_TEST_CASE(SharedFile)
+{
+  Name key("/test19/NDNS/net/NS");
+  Data data = makeData(Name(key).appendVersion(1), 10_s);
+
+  ndns::ResolverCache writer(TEST_CACHE_FILE.string());
+  ndns::ResolverCache reader(TEST_CACHE_FILE.string());
+  writer.insert(key, data, true);
+  BOOST_CHECK(reader.find(key) != nullptr);
+
+  {
+    ndns::ResolverCache other(TEST_CACHE_FILE.string());
+    other.insert(Name(key).append("x"), data, true);
+  }
+  BOOST_CHECK(reader.find(Name(key).append("x")) != nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace ndns
+} // namespace ndn
@@ -0,0 +1,112 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "clients/rtt-table.hpp"
+
+#include "boost-test.hpp"
+#include "clock-fixture.hpp"
+
+namespace ndn {
+namespace ndns {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(RttTable)
+
+BOOST_AUTO_TEST_CASE(Estimator)
+{
+  ndns::RttTable table;
+  Name ns("/net/ndnsim/ns1");
+
+  BOOST_CHECK_EQUAL(table.getRto(ns), 1_s);
+  BOOST_CHECK_LT(table.getSmoothedRtt(ns), 0_ns);
+
+  table.addMeasurement(ns, 100_ms);
+  BOOST_CHECK_EQUAL(table.getSmoothedRtt(ns), 100_ms);
+  BOOST_CHECK_EQUAL(table.getRto(ns), 300_ms); // 100 + 4 * 50
+
+  table.addMeasurement(ns, 200_ms);
+  BOOST_CHECK_EQUAL(table.getSmoothedRtt(ns), 112500_us); // 0.875 * 100 + 0.125 * 200
+  BOOST_CHECK_EQUAL(table.getRto(ns), 362500_us); // 112.5 + 4 * (0.75 * 50 + 0.25 * 100)
+
+  table.backoffRto(ns);
+  BOOST_CHECK_EQUAL(table.getRto(ns), 725_ms);
+
+  // other keys are not affected
+  BOOST_CHECK_EQUAL(table.getRto("/net/ndnsim/ns2"), 1_s);
+}
+
+BOOST_AUTO_TEST_CASE(Bounds)
+{
+  ndns::RttTable::Options options;
+  options.maxRto = 4_s;
+  options.maxEntries = 2;
+  ndns::RttTable table(options);
+
+  table.addMeasurement("/A", 1_ms);
+  BOOST_CHECK_EQUAL(table.getRto("/A"), 200_ms);
+
+  for (int i = 0; i < 10; ++i) {
+    table.backoffRto("/A");
+  }
+  BOOST_CHECK_EQUAL(table.getRto("/A"), 4_s);
+
+  table.addMeasurement("/B", 10_ms);
+  table.addMeasurement("/C", 10_ms);
+  BOOST_CHECK_EQUAL(table.size(), 2);
+}
+
+BOOST_FIXTURE_TEST_CASE(Ranking, ClockFixture)
+{
+  ndns::RttTable table;
+  Name a("/ns-a"), b("/ns-b"), c("/ns-c"), d("/ns-d");
+
+  table.addMeasurement(a, 80_ms);
+  table.addMeasurement(b, 20_ms);
+  // c has no measurement and ranks as if its RTT was the minimum RTO
+  table.addMeasurement(d, 150_ms);
+
+  auto ranked = table.rankDelegations({a, b, c, d});
+  BOOST_CHECK_EQUAL_COLLECTIONS(ranked.begin(), ranked.end(),
+                                std::vector<Name>({b, a, d, c}).begin(),
+                                std::vector<Name>({b, a, d, c}).end());
+
+  // each consecutive failure doubles the score
+  table.recordFailure(b);
+  table.recordFailure(b);
+  table.recordFailure(b);
+  BOOST_CHECK_EQUAL(table.getScore(b), 160_ms);
+  ranked = table.rankDelegations({a, b, c, d});
+  BOOST_CHECK_EQUAL(ranked.front(), a);
+  BOOST_CHECK_EQUAL(ranked.at(1), d);
+
+  // failures are forgotten after a while
+  advanceClocks(61_s);
+  BOOST_CHECK_EQUAL(table.getScore(b), 20_ms);
+
+  // and once the name server answers again
+  table.recordFailure(a);
+  table.addMeasurement(a, 80_ms);
+  BOOST_CHECK_EQUAL(table.getScore(a), 80_ms);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace ndns
+} // namespace ndn
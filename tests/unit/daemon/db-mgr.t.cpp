@@ -252,6 +252,73 @@ BOOST_FIXTURE_TEST_CASE(FindRrsets, DbMgrFixture)
   BOOST_CHECK_EQUAL(vec[1].getLabel(), "/net/ksk-123");
 }
 
+BOOST_FIXTURE_TEST_CASE(Transactions, DbMgrFixture)
+{
+  Zone zone("/net");
+  session.insert(zone);
+
+  auto makeRrset = [&] (const std::string& label) {
+    Rrset rrset(&zone);
+    rrset.setLabel(Name(label));
+    rrset.setType(name::Component("TXT"));
+    rrset.setVersion(name::Component::fromVersion(1));
+    rrset.setTtl(time::seconds(3600));
+    rrset.setData(makeStringBlock(ndn::tlv::Content, label));
+    return rrset;
+  };
+
+  session.beginTransaction();
+  for (const auto& label : {"/a", "/b", "/c"}) {
+    Rrset rrset = makeRrset(label);
+    session.insert(rrset);
+  }
+  session.commitTransaction();
+  BOOST_CHECK_EQUAL(session.findRrsets(zone).size(), 3);
+
+  session.beginTransaction();
+  Rrset rrset = makeRrset("/d");
+  session.insert(rrset);
+  session.rollbackTransaction();
+  BOOST_CHECK_EQUAL(session.findRrsets(zone).size(), 3);
+
+  // transactions cannot be nested
+  session.beginTransaction();
+  BOOST_CHECK_THROW(session.beginTransaction(), ndns::DbMgr::ExecuteError);
+  session.commitTransaction();
+  BOOST_CHECK_THROW(session.commitTransaction(), ndns::DbMgr::ExecuteError);
+}
+
+BOOST_FIXTURE_TEST_CASE(ValidatorCache, DbMgrFixture)
+{
+  auto makeData = [] (const Name& name) {
+    Data data(name);
+    data.setSignatureInfo(SignatureInfo(ndn::tlv::DigestSha256));
+    data.setSignatureValue(std::make_shared<Buffer>(32));
+    data.wireEncode();
+    return data;
+  };
+  using Type = ndns::DbMgr::ValidatorCacheType;
+  auto now = time::system_clock::now();
+
+  session.insert(Type::CERTIFICATE, makeData("/net/NDNS/KEY/1/CERT/%FD%01"), now + 1_h);
+  session.insert(Type::CERTIFICATE, makeData("/net/NDNS/KEY/2/CERT/%FD%01"), now - 1_s);
+  session.insert(Type::NS_LINK, makeData("/net/NDNS/NS/%FD%01"), now + 1_h);
+
+  auto certs = session.find(Type::CERTIFICATE);
+  BOOST_REQUIRE_EQUAL(certs.size(), 1);
+  BOOST_CHECK_EQUAL(certs[0].first.getName(), "/net/NDNS/KEY/1/CERT/%FD%01");
+  BOOST_CHECK(certs[0].second > now);
+  BOOST_CHECK_EQUAL(session.find(Type::NS_LINK).size(), 1);
+
+  // replace
+  session.insert(Type::NS_LINK, makeData("/net/NDNS/NS/%FD%01"), now - 1_s);
+  BOOST_CHECK_EQUAL(session.find(Type::NS_LINK).size(), 0);
+
+  session.removeExpiredValidatorCacheEntries();
+  session.insert(Type::CERTIFICATE, makeData("/net/NDNS/KEY/2/CERT/%FD%01"), now + 1_h);
+  BOOST_CHECK_EQUAL(session.find(Type::CERTIFICATE).size(), 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace tests
@@ -22,10 +22,14 @@
 #include "clients/query.hpp"
 #include "clients/response.hpp"
 #include "daemon/db-mgr.hpp"
+#include "daemon/status-server.hpp"
+#include "validator/certificate-fetcher-ndns-cert.hpp"
 
 #include "boost-test.hpp"
 #include "unit/database-test-data.hpp"
 
+#include <boost/filesystem/operations.hpp>
+
 #include <ndn-cxx/util/dummy-client-face.hpp>
 #include <ndn-cxx/util/regex.hpp>
 
@@ -157,6 +161,89 @@ BOOST_AUTO_TEST_CASE(KeyQuery)
   BOOST_CHECK_EQUAL(nDataBack, 4);
 }
 
+BOOST_AUTO_TEST_CASE(CertificateBundle)
+{
+  Interest interest(Name(zone).append(label::NDNS_ITERATIVE_QUERY).append(label::BUNDLE_RR_TYPE));
+  interest.setCanBePrefix(true);
+
+  // disabled by default: the query is answered like any other missing record
+  face.receive(interest);
+  run();
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 1);
+  BOOST_CHECK_EQUAL(face.sentData.back().getContentType(), NDNS_NACK);
+
+  server.setCertificateBundleEnabled(true);
+  face.receive(interest);
+  run();
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 2);
+  const Data& answer = face.sentData.back();
+  BOOST_CHECK_EQUAL(answer.getContentType(), NDNS_BUNDLE);
+  BOOST_CHECK(interest.matchesData(answer));
+
+  ndns::CertificateBundle bundle(answer);
+  BOOST_REQUIRE(!bundle.getCertificates().empty());
+  BOOST_CHECK_EQUAL(bundle.getCertificates().front().getName(), m_certName);
+  BOOST_CHECK(bundle.find(m_cert.getKeyName()) != nullptr);
+  BOOST_CHECK(bundle.find("/random/NDNS/KEY/%01") == nullptr);
+
+  // the bundle is reused while it is fresh
+  face.receive(interest);
+  run();
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 3);
+  BOOST_CHECK_EQUAL(face.sentData.back().getName(), answer.getName());
+
+  // a record that is not a bundle is rejected
+  BOOST_CHECK_THROW(ndns::CertificateBundle(face.sentData.front()), ndns::CertificateBundle::Error);
+}
+
+BOOST_AUTO_TEST_CASE(SegmentedRecord)
+{
+  server.setSegmentSize(100);
+  BOOST_CHECK_EQUAL(server.getSegmentSize(), 100);
+
+  Response certResp;
+  certResp.fromData(zone, m_cert);
+  Query q(zone, ndns::label::NDNS_ITERATIVE_QUERY);
+  q.setRrLabel(certResp.getRrLabel());
+  q.setRrType(ndns::label::CERT_RR_TYPE);
+
+  // the certificate is larger than a segment, the query is answered with the first segment
+  face.receive(q.toInterest());
+  run();
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 1);
+  Data first = face.sentData.back();
+  BOOST_CHECK_EQUAL(first.getContentType(), NDNS_SEGMENT);
+  BOOST_CHECK_EQUAL(first.getName(), Name(m_cert.getName()).appendSegment(0));
+  BOOST_CHECK_EQUAL(first.getContent().value_size(), 100);
+  BOOST_REQUIRE(first.getFinalBlock());
+  uint64_t lastSegment = first.getFinalBlock()->toSegment();
+  BOOST_CHECK_EQUAL(lastSegment, (m_cert.wireEncode().size() - 1) / 100);
+
+  // the remaining segments are served from the segments made for the first one
+  Buffer wire(first.getContent().value_begin(), first.getContent().value_end());
+  for (uint64_t i = 1; i <= lastSegment; ++i) {
+    face.receive(Interest(Name(m_cert.getName()).appendSegment(i)));
+    run();
+    BOOST_REQUIRE_EQUAL(face.sentData.size(), i + 1);
+    const Data& segment = face.sentData.back();
+    BOOST_CHECK_EQUAL(segment.getName(), Name(m_cert.getName()).appendSegment(i));
+    wire.insert(wire.end(), segment.getContent().value_begin(), segment.getContent().value_end());
+  }
+  BOOST_CHECK(Data(Block(wire)) == m_cert);
+
+  // a segment beyond the last one is not answered
+  face.receive(Interest(Name(m_cert.getName()).appendSegment(lastSegment + 1)));
+  run();
+  BOOST_CHECK_EQUAL(face.sentData.size(), lastSegment + 1);
+
+  // small records are still served in one packet
+  server.setSegmentSize(DEFAULT_SEGMENT_SIZE);
+  face.receive(q.toInterest());
+  run();
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), lastSegment + 2);
+  BOOST_CHECK(face.sentData.back() == m_cert);
+}
+
 BOOST_AUTO_TEST_CASE(UpdateReplaceRr)
 {
   Response re;
@@ -419,6 +506,276 @@ BOOST_FIXTURE_TEST_CASE(UpdateValidatorFetchCert, NameServerFixture2)
   BOOST_CHECK_EQUAL(hasDataBack, true);
 }
 
+BOOST_AUTO_TEST_CASE(QueryLogging)
+{
+  auto logPath = boost::filesystem::path(UNIT_TESTS_TMPDIR) / "name-server-query.log";
+  boost::filesystem::remove(logPath);
+  boost::filesystem::remove(logPath.string() + ".1");
+
+  ndns::QueryLog::Options options;
+  options.path = logPath.string();
+  ndns::QueryLog queryLog(options);
+  server.setQueryLog(&queryLog);
+
+  Query q(zone, ndns::label::NDNS_ITERATIVE_QUERY);
+  q.setRrLabel(Name("net"));
+  q.setRrType(ndns::label::NS_RR_TYPE);
+  face.receive(q.toInterest());
+  q.setRrLabel(Name("no-such-label"));
+  face.receive(q.toInterest());
+  run();
+  queryLog.flush();
+
+  std::vector<QueryLogEntry> entries;
+  ndns::QueryLog::readFile(options.path, [&] (const QueryLogEntry& entry) {
+    entries.push_back(entry);
+  });
+  BOOST_REQUIRE_EQUAL(entries.size(), 2);
+  BOOST_CHECK_EQUAL(entries[0].kind, QueryLogEntry::QUERY);
+  BOOST_CHECK_EQUAL(entries[0].outcome, QueryLogEntry::ANSWER);
+  BOOST_CHECK_EQUAL(entries[0].getZone(), zone);
+  BOOST_CHECK_EQUAL(entries[0].getLabel(), Name("net"));
+  BOOST_CHECK_EQUAL(entries[0].getRrType(), ndns::label::NS_RR_TYPE);
+  BOOST_CHECK_EQUAL(entries[1].outcome, QueryLogEntry::NACK);
+  BOOST_CHECK_EQUAL(entries[1].getLabel(), Name("no-such-label"));
+
+  server.setQueryLog(nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(Counters)
+{
+  Query q(zone, ndns::label::NDNS_ITERATIVE_QUERY);
+  q.setRrLabel(Name("net"));
+  q.setRrType(ndns::label::NS_RR_TYPE);
+  face.receive(q.toInterest());
+  q.setRrLabel(Name("no-such-label"));
+  face.receive(q.toInterest());
+  run();
+
+  ndns::ZoneStatus counters(zone, server.getCounters());
+  BOOST_CHECK_EQUAL(counters.nQueries, 2);
+  BOOST_CHECK_EQUAL(counters.nAnswers, 1);
+  BOOST_CHECK_EQUAL(counters.nNacks, 1);
+  BOOST_CHECK_EQUAL(counters.nUnanswered, 0);
+  BOOST_CHECK_EQUAL(counters.nUpdatesAccepted, 0);
+  BOOST_CHECK_EQUAL(counters.nDbOperations, 3); // two lookups and the DoE record
+  BOOST_CHECK_GT(counters.dbTime, 0);
+  BOOST_CHECK_EQUAL(counters.nSignings, 1); // only the NACK is signed on the fly
+  BOOST_CHECK_GT(counters.signingTime, 0);
+}
+
+BOOST_AUTO_TEST_CASE(MultiTypeAnswerCache)
+{
+  Query q(zone, ndns::label::NDNS_ITERATIVE_QUERY);
+  q.setRrLabel(Name("net"));
+  q.setRrType(label::makeMultiRrType({label::NS_RR_TYPE, label::TXT_RR_TYPE}));
+  face.receive(q.toInterest());
+  run();
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 1);
+  Data first = face.sentData.back();
+  BOOST_CHECK_EQUAL(first.getContentType(), NDNS_MULTI);
+
+  // the records are unchanged, the signed answer is reused
+  advanceClocks(time::milliseconds(10), 1);
+  face.receive(q.toInterest());
+  run();
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 2);
+  BOOST_CHECK(face.sentData.back().wireEncode() == first.wireEncode());
+
+  ndns::ZoneStatus counters(zone, server.getCounters());
+  BOOST_CHECK_EQUAL(counters.nSignings, 1);
+  BOOST_CHECK_EQUAL(counters.nMultiCacheHits, 1);
+  BOOST_CHECK_EQUAL(counters.nMultiCacheMisses, 1);
+}
+
+BOOST_AUTO_TEST_CASE(MultiTypeAnswerVersion)
+{
+  Query q(zone, ndns::label::NDNS_ITERATIVE_QUERY);
+  q.setRrLabel(Name("net"));
+  q.setRrType(label::makeMultiRrType({label::NS_RR_TYPE, label::TXT_RR_TYPE}));
+  face.receive(q.toInterest());
+  run();
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 1);
+  Data first = face.sentData.back();
+  BOOST_CHECK_EQUAL(first.getContentType(), NDNS_MULTI);
+  BOOST_REQUIRE(first.getName().get(-1).isVersion());
+
+  // the version of the answer is chosen by the server, the same version gets the same answer
+  face.receive(Interest(first.getName()));
+  run();
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 2);
+  BOOST_CHECK(face.sentData.back().wireEncode() == first.wireEncode());
+
+  // another version does not make the server sign a new answer
+  Name other = q.toInterest().getName();
+  other.appendVersion(first.getName().get(-1).toVersion() + 1);
+  face.receive(Interest(other));
+  run();
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 3);
+  BOOST_CHECK_EQUAL(face.sentData.back().getContentType(), NDNS_NACK);
+
+  face.receive(q.toInterest());
+  run();
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 4);
+  BOOST_CHECK(face.sentData.back().wireEncode() == first.wireEncode());
+
+  ndns::ZoneStatus counters(zone, server.getCounters());
+  BOOST_CHECK_EQUAL(counters.nMultiCacheMisses, 1);
+}
+
+BOOST_AUTO_TEST_CASE(MultiTypeDuplicateType)
+{
+  Query q(zone, ndns::label::NDNS_ITERATIVE_QUERY);
+  q.setRrLabel(Name("net"));
+  q.setRrType(name::Component("MULTI.NS.NS"));
+  face.receive(q.toInterest());
+  run();
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 1);
+  BOOST_CHECK_EQUAL(face.sentData.back().getContentType(), NDNS_NACK);
+
+  ndns::ZoneStatus counters(zone, server.getCounters());
+  BOOST_CHECK_EQUAL(counters.nMultiCacheMisses, 0);
+}
+
+BOOST_AUTO_TEST_CASE(SegmentedMultiTypeAnswer)
+{
+  server.setSegmentSize(100);
+
+  Query q(zone, ndns::label::NDNS_ITERATIVE_QUERY);
+  q.setRrLabel(Name("net"));
+  q.setRrType(label::makeMultiRrType({label::NS_RR_TYPE, label::TXT_RR_TYPE}));
+
+  // the answer is larger than a segment, the query is answered with the first segment
+  face.receive(q.toInterest());
+  run();
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 1);
+  Data first = face.sentData.back();
+  BOOST_CHECK_EQUAL(first.getContentType(), NDNS_SEGMENT);
+  BOOST_CHECK(first.getName().get(-1).isSegment());
+  BOOST_CHECK(first.getName().get(-2).isVersion());
+  BOOST_REQUIRE(first.getFinalBlock());
+  uint64_t lastSegment = first.getFinalBlock()->toSegment();
+  BOOST_CHECK_GT(lastSegment, 0);
+
+  Buffer wire(first.getContent().value_begin(), first.getContent().value_end());
+  for (uint64_t i = 1; i <= lastSegment; ++i) {
+    face.receive(Interest(first.getName().getPrefix(-1).appendSegment(i)));
+    run();
+    BOOST_REQUIRE_EQUAL(face.sentData.size(), i + 1);
+    const Data& segment = face.sentData.back();
+    wire.insert(wire.end(), segment.getContent().value_begin(), segment.getContent().value_end());
+  }
+  Data answer{Block(wire)};
+  BOOST_CHECK_EQUAL(answer.getContentType(), NDNS_MULTI);
+  BOOST_CHECK_EQUAL(answer.getName(), first.getName().getPrefix(-1));
+}
+
+BOOST_AUTO_TEST_CASE(StatusDataset)
+{
+  ndns::StatusServer statusServer(face, m_keyChain);
+  statusServer.addNameServer(server);
+  advanceClocks(time::milliseconds(10), 1);
+
+  Query q(zone, ndns::label::NDNS_ITERATIVE_QUERY);
+  q.setRrLabel(Name("net"));
+  q.setRrType(ndns::label::NS_RR_TYPE);
+  face.receive(q.toInterest());
+  run();
+
+  face.sentData.clear();
+  face.receive(Interest("/localhost/ndns/zones/list").setCanBePrefix(true).setMustBeFresh(true));
+  run();
+
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 1);
+  const Data& data = face.sentData.front();
+  BOOST_CHECK(Name("/localhost/ndns/zones/list").isPrefixOf(data.getName()));
+  BOOST_CHECK(data.getName().get(-1).isSegment());
+
+  Block content = data.getContent();
+  content.parse();
+  BOOST_REQUIRE_EQUAL(content.elements_size(), 1);
+  ndns::ZoneStatus status(content.elements().front());
+  BOOST_CHECK_EQUAL(status.zone, zone);
+  BOOST_CHECK_EQUAL(status.nQueries, 1);
+  BOOST_CHECK_EQUAL(status.nAnswers, 1);
+}
+
+BOOST_AUTO_TEST_CASE(ValidatorDataset)
+{
+  ValidationCache validationCache;
+  UpdateVerifier verifier(*validator, face.getIoContext(), 1);
+  verifier.setValidationCache(&validationCache);
+  auto* nsCache = dynamic_cast<CertificateFetcherNdnsCert&>(validator->getFetcher()).getNsCache();
+  ndns::StatusServer statusServer(face, m_keyChain);
+  statusServer.setUpdateVerifier(&verifier);
+  statusServer.setValidationCache(&validationCache);
+  statusServer.setNsCache(nsCache);
+  advanceClocks(time::milliseconds(10), 1);
+
+  // the signer certificate is not verified yet, the update waits for the validator to fetch it
+  auto update = make_shared<Data>(Name(zone).append("NDNS").append("www").append("TXT")
+                                  .appendVersion());
+  m_keyChain.sign(*update, security::signingByCertificate(m_cert));
+  verifier.verify(update, nullptr, nullptr);
+
+  face.sentData.clear();
+  face.receive(Interest("/localhost/ndns/validator").setCanBePrefix(true).setMustBeFresh(true));
+  run();
+
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 1);
+  Block content = face.sentData.front().getContent();
+  content.parse();
+  BOOST_REQUIRE_EQUAL(content.elements_size(), 1);
+  ndns::ValidatorStatus status(content.elements().front());
+  BOOST_CHECK_EQUAL(status.verifierQueueDepth, 1);
+  BOOST_CHECK_EQUAL(status.verifierMaxQueueDepth, 1);
+  BOOST_CHECK_EQUAL(status.nVerifierFallbacks, 1);
+  BOOST_CHECK_EQUAL(status.nVerifierOffloaded, 0);
+  BOOST_CHECK_EQUAL(status.nValidationCacheHits, 0);
+  BOOST_CHECK_EQUAL(status.nValidationCacheMisses, 1);
+  BOOST_CHECK_EQUAL(status.nNsCacheHits, nsCache->getNHits());
+  BOOST_CHECK_EQUAL(status.nNsCacheMisses, nsCache->getNMisses());
+}
+
+BOOST_AUTO_TEST_CASE(StageLatencies)
+{
+  BOOST_CHECK(server.getStageHistograms() == nullptr);
+  server.setStageHistogramsEnabled(true);
+  ndns::StatusServer statusServer(face, m_keyChain);
+  statusServer.addNameServer(server);
+  advanceClocks(time::milliseconds(10), 1);
+
+  Query q(zone, ndns::label::NDNS_ITERATIVE_QUERY);
+  q.setRrLabel(Name("net"));
+  q.setRrType(ndns::label::NS_RR_TYPE);
+  face.receive(q.toInterest());
+  q.setRrLabel(Name("no-such-label"));
+  face.receive(q.toInterest());
+  run();
+
+  const auto* histograms = server.getStageHistograms();
+  BOOST_REQUIRE(histograms != nullptr);
+  BOOST_CHECK_EQUAL(histograms->get(StageHistograms::MATCH).getCount(), 2);
+  BOOST_CHECK_EQUAL(histograms->get(StageHistograms::DATABASE).getCount(), 3);
+  BOOST_CHECK_EQUAL(histograms->get(StageHistograms::ENCODE).getCount(), 2);
+  BOOST_CHECK_EQUAL(histograms->get(StageHistograms::SIGN).getCount(), 1);
+  BOOST_CHECK_EQUAL(histograms->get(StageHistograms::VALIDATE).getCount(), 0);
+  BOOST_CHECK_EQUAL(histograms->get(StageHistograms::PUT).getCount(), 2);
+
+  face.sentData.clear();
+  face.receive(Interest("/localhost/ndns/zones/stages").setCanBePrefix(true).setMustBeFresh(true));
+  run();
+
+  BOOST_REQUIRE_EQUAL(face.sentData.size(), 1);
+  Block content = face.sentData.front().getContent();
+  content.parse();
+  BOOST_REQUIRE_EQUAL(content.elements_size(), 1);
+  ZoneStageStatus status(content.elements().front());
+  BOOST_CHECK_EQUAL(status.zone, zone);
+  BOOST_CHECK_EQUAL(status.stages[StageHistograms::MATCH].count, 2);
+  BOOST_CHECK_EQUAL(status.stages[StageHistograms::PUT].count, 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace tests
@@ -0,0 +1,207 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "daemon/query-log.hpp"
+
+#include "boost-test.hpp"
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <limits>
+
+namespace ndn {
+namespace ndns {
+namespace tests {
+
+namespace fs = boost::filesystem;
+
+BOOST_AUTO_TEST_SUITE(QueryLog)
+
+const auto TEST_QUERY_LOG = fs::path(UNIT_TESTS_TMPDIR) / "query.log";
+
+class QueryLogFixture
+{
+public:
+  QueryLogFixture()
+  {
+    removeLogs();
+    options.path = TEST_QUERY_LOG.string();
+  }
+
+  ~QueryLogFixture()
+  {
+    removeLogs();
+  }
+
+  static void
+  removeLogs()
+  {
+    for (const auto& suffix : {"", ".1", ".2", ".3"}) {
+      fs::remove(TEST_QUERY_LOG.string() + suffix);
+    }
+  }
+
+  static QueryLogEntry
+  makeEntry(const Name& label, QueryLogEntry::Outcome outcome = QueryLogEntry::ANSWER)
+  {
+    QueryLogEntry entry{};
+    entry.setTimestamp(time::system_clock::now());
+    entry.setLatency(25_us);
+    entry.kind = QueryLogEntry::QUERY;
+    entry.outcome = outcome;
+    entry.setNames("/ndn/edu", label, name::Component("TXT"));
+    return entry;
+  }
+
+  static std::vector<QueryLogEntry>
+  readLog(const std::string& path)
+  {
+    std::vector<QueryLogEntry> entries;
+    ndns::QueryLog::readFile(path, [&] (const QueryLogEntry& entry) {
+      entries.push_back(entry);
+    });
+    return entries;
+  }
+
+public:
+  ndns::QueryLog::Options options;
+};
+
+BOOST_AUTO_TEST_CASE(Entry)
+{
+  QueryLogEntry entry{};
+  entry.setNames("/ndn/edu", "/ucla/www", name::Component("TXT"));
+  BOOST_CHECK_EQUAL(entry.getZone(), "/ndn/edu");
+  BOOST_CHECK_EQUAL(entry.getLabel(), "/ucla/www");
+  BOOST_CHECK_EQUAL(entry.getRrType(), name::Component("TXT"));
+  BOOST_CHECK_EQUAL(entry.flags & QueryLogEntry::TRUNCATED, 0);
+
+  entry.setNames("/ndn", Name(), name::Component("NS"));
+  BOOST_CHECK_EQUAL(entry.getZone(), "/ndn");
+  BOOST_CHECK_EQUAL(entry.getLabel(), Name());
+  BOOST_CHECK_EQUAL(entry.getRrType(), name::Component("NS"));
+
+  // names longer than the entry are truncated at a component boundary
+  Name longLabel;
+  for (int i = 0; i < 20; ++i) {
+    longLabel.append("component" + to_string(i));
+  }
+  entry.setNames("/ndn", longLabel, name::Component("TXT"));
+  BOOST_CHECK_NE(entry.flags & QueryLogEntry::TRUNCATED, 0);
+  BOOST_CHECK_EQUAL(entry.getZone(), "/ndn");
+  BOOST_CHECK(entry.getLabel().isPrefixOf(longLabel));
+  BOOST_CHECK_LT(entry.getLabel().size(), longLabel.size());
+  BOOST_CHECK_EQUAL(entry.getRrType(), name::Component());
+
+  entry.setLatency(-1_s);
+  BOOST_CHECK_EQUAL(entry.latency, 0);
+  entry.setLatency(1_h);
+  BOOST_CHECK_EQUAL(entry.latency, std::numeric_limits<uint32_t>::max());
+
+  auto now = time::system_clock::now();
+  entry.setTimestamp(now);
+  BOOST_CHECK(entry.getTimestamp() == now);
+
+  BOOST_CHECK_EQUAL(toString(QueryLogEntry::NACK), std::string("NACK"));
+  BOOST_CHECK_EQUAL(toString(QueryLogEntry::UPDATE), std::string("UPDATE"));
+}
+
+BOOST_FIXTURE_TEST_CASE(WriteAndRead, QueryLogFixture)
+{
+  {
+    ndns::QueryLog log(options);
+    BOOST_CHECK(log.add(makeEntry("/www")));
+    BOOST_CHECK(log.add(makeEntry("/ftp", QueryLogEntry::NACK)));
+    log.flush();
+    BOOST_CHECK_EQUAL(log.getNWritten(), 2);
+
+    auto entries = readLog(options.path);
+    BOOST_REQUIRE_EQUAL(entries.size(), 2);
+    BOOST_CHECK_EQUAL(entries[0].getLabel(), "/www");
+    BOOST_CHECK_EQUAL(entries[1].getLabel(), "/ftp");
+    BOOST_CHECK_EQUAL(entries[1].outcome, QueryLogEntry::NACK);
+    BOOST_CHECK_EQUAL(entries[1].latency, 25000);
+
+    // entries added before the destruction are written
+    BOOST_CHECK(log.add(makeEntry("/mail")));
+  }
+  BOOST_CHECK_EQUAL(readLog(options.path).size(), 3);
+
+  // a new log keeps the previous one as the first rotated file
+  {
+    ndns::QueryLog log(options);
+  }
+  BOOST_CHECK_EQUAL(readLog(options.path).size(), 0);
+  BOOST_CHECK_EQUAL(readLog(options.path + ".1").size(), 3);
+}
+
+BOOST_FIXTURE_TEST_CASE(Rotation, QueryLogFixture)
+{
+  options.maxFileSize = 16 + 4 * sizeof(QueryLogEntry); // header and four entries
+  options.maxFiles = 2;
+  {
+    ndns::QueryLog log(options);
+    for (int i = 0; i < 14; ++i) {
+      log.add(makeEntry(Name("/r").appendNumber(i)));
+    }
+  }
+
+  // 14 entries: the oldest file was deleted, the next two were rotated
+  auto current = readLog(options.path);
+  BOOST_REQUIRE_EQUAL(current.size(), 2);
+  BOOST_CHECK_EQUAL(current[0].getLabel(), Name("/r").appendNumber(12));
+  BOOST_CHECK_EQUAL(readLog(options.path + ".1").size(), 4);
+  BOOST_CHECK_EQUAL(readLog(options.path + ".2").size(), 4);
+  BOOST_CHECK(!fs::exists(options.path + ".3"));
+}
+
+BOOST_FIXTURE_TEST_CASE(Overflow, QueryLogFixture)
+{
+  options.capacity = 3; // rounded up to 4
+  options.flushInterval = 1_h;
+  ndns::QueryLog log(options);
+  BOOST_CHECK_EQUAL(log.getCapacity(), 4);
+
+  // the writer thread sleeps until flush() is called
+  for (int i = 0; i < 4; ++i) {
+    BOOST_CHECK(log.add(makeEntry("/www")));
+  }
+  BOOST_CHECK(!log.add(makeEntry("/www")));
+  BOOST_CHECK_EQUAL(log.getNDropped(), 1);
+
+  log.flush();
+  BOOST_CHECK_EQUAL(log.getNWritten(), 4);
+  BOOST_CHECK(log.add(makeEntry("/www")));
+}
+
+BOOST_FIXTURE_TEST_CASE(InvalidFile, QueryLogFixture)
+{
+  BOOST_CHECK_THROW(readLog(options.path), ndns::QueryLog::Error);
+
+  std::ofstream(options.path) << "not a query log";
+  BOOST_CHECK_THROW(readLog(options.path), ndns::QueryLog::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // QueryLog
+
+} // namespace tests
+} // namespace ndns
+} // namespace ndn
@@ -0,0 +1,137 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "daemon/stage-histograms.hpp"
+#include "ndns-tlv.hpp"
+
+#include "boost-test.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+
+#include <algorithm>
+#include <sstream>
+
+namespace ndn {
+namespace ndns {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(StageHistograms)
+
+BOOST_AUTO_TEST_CASE(Timer)
+{
+  ndns::StageHistograms histograms;
+  {
+    ScopedStageTimer timer(&histograms.get(ndns::StageHistograms::SIGN));
+  }
+  {
+    ScopedStageTimer disabled(nullptr);
+  }
+  BOOST_CHECK_EQUAL(histograms.get(ndns::StageHistograms::SIGN).getCount(), 1);
+  BOOST_CHECK_EQUAL(histograms.get(ndns::StageHistograms::MATCH).getCount(), 0);
+
+  BOOST_CHECK_EQUAL(toString(ndns::StageHistograms::DATABASE), std::string("database"));
+  BOOST_CHECK_EQUAL(toString(ndns::StageHistograms::PUT), std::string("put"));
+}
+
+BOOST_AUTO_TEST_CASE(EncodeDecode)
+{
+  ndns::StageHistograms histograms;
+  auto& database = histograms.get(ndns::StageHistograms::DATABASE);
+  for (int i = 1; i <= 100; ++i) {
+    database.add(time::microseconds(i));
+  }
+  histograms.get(ndns::StageHistograms::VALIDATE).add(5_ms);
+
+  ZoneStageStatus status("/example", histograms);
+  BOOST_CHECK_EQUAL(status.zone, "/example");
+  const auto& db = status.stages[ndns::StageHistograms::DATABASE];
+  BOOST_CHECK_EQUAL(db.count, 100);
+  BOOST_CHECK_EQUAL(db.max, 100000);
+  BOOST_CHECK_EQUAL(db.p50, static_cast<uint64_t>(database.getPercentile(50).count()));
+  BOOST_CHECK_EQUAL(db.p999, static_cast<uint64_t>(database.getPercentile(99.9).count()));
+  BOOST_CHECK_EQUAL(status.stages[ndns::StageHistograms::VALIDATE].mean, 5000000);
+  BOOST_CHECK_EQUAL(status.stages[ndns::StageHistograms::PUT].count, 0);
+
+  Block wire = status.wireEncode();
+  BOOST_CHECK_EQUAL(wire.type(), ndns::tlv::ZoneStageStatus);
+  ZoneStageStatus decoded(wire);
+  BOOST_CHECK_EQUAL(decoded.zone, "/example");
+  for (size_t i = 0; i < decoded.stages.size(); ++i) {
+    BOOST_CHECK_EQUAL(decoded.stages[i].count, status.stages[i].count);
+    BOOST_CHECK_EQUAL(decoded.stages[i].mean, status.stages[i].mean);
+    BOOST_CHECK_EQUAL(decoded.stages[i].p99, status.stages[i].p99);
+    BOOST_CHECK_EQUAL(decoded.stages[i].max, status.stages[i].max);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(DecodeUnknownStage)
+{
+  Block unknown(ndns::tlv::StageLatency);
+  unknown.push_back(makeNonNegativeIntegerBlock(ndns::tlv::StageId, 100));
+  unknown.push_back(makeNonNegativeIntegerBlock(ndns::tlv::LatencyCount, 1));
+  unknown.encode();
+  Block sign(ndns::tlv::StageLatency);
+  sign.push_back(makeNonNegativeIntegerBlock(ndns::tlv::StageId, ndns::StageHistograms::SIGN));
+  sign.push_back(makeNonNegativeIntegerBlock(ndns::tlv::LatencyCount, 7));
+  sign.encode();
+
+  Block wire(ndns::tlv::ZoneStageStatus);
+  wire.push_back(Name("/example").wireEncode());
+  wire.push_back(unknown);
+  wire.push_back(sign);
+  wire.encode();
+
+  ZoneStageStatus status(wire);
+  BOOST_CHECK_EQUAL(status.stages[ndns::StageHistograms::SIGN].count, 7);
+  BOOST_CHECK_EQUAL(status.stages[ndns::StageHistograms::SIGN].max, 0);
+
+  Block noId(ndns::tlv::StageLatency);
+  noId.push_back(makeNonNegativeIntegerBlock(ndns::tlv::LatencyCount, 1));
+  noId.encode();
+  Block invalid(ndns::tlv::ZoneStageStatus);
+  invalid.push_back(Name("/example").wireEncode());
+  invalid.push_back(noId);
+  invalid.encode();
+  BOOST_CHECK_THROW(ZoneStageStatus{invalid}, ZoneStageStatus::Error);
+  BOOST_CHECK_THROW(ZoneStageStatus{noId}, ZoneStageStatus::Error);
+}
+
+BOOST_AUTO_TEST_CASE(Print)
+{
+  ZoneStageStatus status;
+  status.zone = "/example";
+  status.stages[ndns::StageHistograms::PUT].count = 2;
+  status.stages[ndns::StageHistograms::PUT].max = 15000;
+
+  std::ostringstream os;
+  os << status;
+  std::string output = os.str();
+  BOOST_CHECK_EQUAL(output.substr(0, output.find('\n')), "/example (us)");
+  // a header line and one line per stage
+  BOOST_CHECK_EQUAL(std::count(output.begin(), output.end(), '\n'),
+                    2 + ndns::StageHistograms::N_STAGES);
+  BOOST_CHECK(output.find("  put                 2") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // StageHistograms
+
+} // namespace tests
+} // namespace ndns
+} // namespace ndn
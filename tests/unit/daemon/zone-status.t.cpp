@@ -0,0 +1,179 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "daemon/zone-status.hpp"
+#include "ndns-tlv.hpp"
+
+#include "boost-test.hpp"
+
+#include <ndn-cxx/encoding/block-helpers.hpp>
+
+#include <boost/test/tools/output_test_stream.hpp>
+
+#include <thread>
+
+namespace ndn {
+namespace ndns {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(ZoneStatus)
+
+BOOST_AUTO_TEST_CASE(Counters)
+{
+  ZoneCounters counters;
+  ++counters.nQueries;
+  ++counters.nQueries;
+  counters.dbTime += 1500;
+  BOOST_CHECK_EQUAL(uint64_t(counters.nQueries), 2);
+  BOOST_CHECK_EQUAL(uint64_t(counters.dbTime), 1500);
+
+  {
+    ScopedCounterTimer timer(counters.nSignings, counters.signingTime);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  BOOST_CHECK_EQUAL(uint64_t(counters.nSignings), 1);
+  BOOST_CHECK_GE(uint64_t(counters.signingTime), 1000000);
+
+  ndns::ZoneStatus status("/example", counters);
+  BOOST_CHECK_EQUAL(status.zone, "/example");
+  BOOST_CHECK_EQUAL(status.nQueries, 2);
+  BOOST_CHECK_EQUAL(status.dbTime, 1500);
+  BOOST_CHECK_EQUAL(status.nSignings, 1);
+  BOOST_CHECK_EQUAL(status.nAnswers, 0);
+}
+
+BOOST_AUTO_TEST_CASE(EncodeDecode)
+{
+  ndns::ZoneStatus status;
+  status.zone = "/example";
+  status.nQueries = 1000;
+  status.nNacks = 10;
+  status.nUpdatesRejected = 3;
+  status.nBundleCacheMisses = 1;
+  status.signingTime = 123456789;
+
+  Block wire = status.wireEncode();
+  BOOST_CHECK_EQUAL(wire.type(), ndns::tlv::ZoneStatus);
+
+  ndns::ZoneStatus decoded(wire);
+  BOOST_CHECK_EQUAL(decoded.zone, "/example");
+  BOOST_CHECK_EQUAL(decoded.nQueries, 1000);
+  BOOST_CHECK_EQUAL(decoded.nNacks, 10);
+  BOOST_CHECK_EQUAL(decoded.nUpdatesRejected, 3);
+  BOOST_CHECK_EQUAL(decoded.nBundleCacheMisses, 1);
+  BOOST_CHECK_EQUAL(decoded.signingTime, 123456789);
+  BOOST_CHECK_EQUAL(decoded.nAnswers, 0);
+  BOOST_CHECK(decoded.wireEncode() == wire);
+}
+
+BOOST_AUTO_TEST_CASE(DecodeUnknownAndMissing)
+{
+  // counters added by newer daemons are ignored, missing ones are zero
+  Block wire(ndns::tlv::ZoneStatus);
+  wire.push_back(Name("/example").wireEncode());
+  wire.push_back(makeNonNegativeIntegerBlock(ndns::tlv::NAnswers, 5));
+  wire.push_back(makeNonNegativeIntegerBlock(250, 7));
+  wire.encode();
+
+  ndns::ZoneStatus status(wire);
+  BOOST_CHECK_EQUAL(status.zone, "/example");
+  BOOST_CHECK_EQUAL(status.nAnswers, 5);
+  BOOST_CHECK_EQUAL(status.nQueries, 0);
+
+  BOOST_CHECK_THROW(ndns::ZoneStatus(Name("/example").wireEncode()), ndns::ZoneStatus::Error);
+  Block noName(ndns::tlv::ZoneStatus);
+  noName.push_back(makeNonNegativeIntegerBlock(ndns::tlv::NAnswers, 5));
+  noName.encode();
+  BOOST_CHECK_THROW(ndns::ZoneStatus{noName}, ndns::ZoneStatus::Error);
+}
+
+BOOST_AUTO_TEST_CASE(Print)
+{
+  ndns::ZoneStatus status;
+  status.zone = "/example";
+  status.nSegmentCacheHits = 3;
+  status.nSegmentCacheMisses = 1;
+  status.nDbOperations = 4;
+  status.dbTime = 8000000;
+
+  boost::test_tools::output_test_stream os;
+  os << status;
+  BOOST_CHECK(os.is_equal("/example\n"
+                          "  queries=0 answers=0 nacks=0 unanswered=0\n"
+                          "  updates: accepted=0 rejected=0 validationFailures=0\n"
+                          "  segment cache: hits=3 misses=1 (75% hits)\n"
+                          "  bundle cache: hits=0 misses=0\n"
+                          "  multi-type answer cache: hits=0 misses=0\n"
+                          "  database operations: 4 in 8 ms (mean 2000 us)\n"
+                          "  signings: 0 in 0 ms\n"));
+}
+
+BOOST_AUTO_TEST_SUITE_END() // ZoneStatus
+
+BOOST_AUTO_TEST_SUITE(ValidatorStatus)
+
+BOOST_AUTO_TEST_CASE(EncodeDecode)
+{
+  ndns::ValidatorStatus status;
+  status.verifierMaxQueueDepth = 8;
+  status.nVerifierOffloaded = 100;
+  status.verifierMeanLatency = 250000;
+  status.nNsCacheMisses = 5;
+
+  Block wire = status.wireEncode();
+  BOOST_CHECK_EQUAL(wire.type(), ndns::tlv::ValidatorStatus);
+
+  ndns::ValidatorStatus decoded(wire);
+  BOOST_CHECK_EQUAL(decoded.verifierMaxQueueDepth, 8);
+  BOOST_CHECK_EQUAL(decoded.nVerifierOffloaded, 100);
+  BOOST_CHECK_EQUAL(decoded.verifierMeanLatency, 250000);
+  BOOST_CHECK_EQUAL(decoded.nNsCacheMisses, 5);
+  BOOST_CHECK_EQUAL(decoded.verifierQueueDepth, 0);
+  BOOST_CHECK(decoded.wireEncode() == wire);
+
+  BOOST_CHECK_THROW(ndns::ValidatorStatus(Name("/example").wireEncode()),
+                    ndns::ValidatorStatus::Error);
+}
+
+BOOST_AUTO_TEST_CASE(Print)
+{
+  ndns::ValidatorStatus status;
+  status.verifierMaxQueueDepth = 8;
+  status.nVerifierOffloaded = 100;
+  status.nVerifierFallbacks = 2;
+  status.verifierMeanLatency = 250000;
+  status.verifierMaxLatency = 4000000;
+  status.nValidationCacheHits = 1;
+  status.nValidationCacheMisses = 3;
+
+  boost::test_tools::output_test_stream os;
+  os << status;
+  BOOST_CHECK(os.is_equal("validator\n"
+                          "  update verifier: queue=0 maxQueue=8 offloaded=100 fallbacks=2"
+                          " latency: mean 250 us, max 4000 us\n"
+                          "  validation cache: hits=1 misses=3 (25% hits)\n"
+                          "  NS cache: hits=0 misses=0\n"));
+}
+
+BOOST_AUTO_TEST_SUITE_END() // ValidatorStatus
+
+} // namespace tests
+} // namespace ndns
+} // namespace ndn
@@ -0,0 +1,161 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "mgmt/zone-generator.hpp"
+
+#include "boost-test.hpp"
+#include "key-chain-fixture.hpp"
+
+#include <ndn-cxx/security/verification-helpers.hpp>
+
+#include <boost/filesystem/operations.hpp>
+
+namespace ndn {
+namespace ndns {
+namespace tests {
+
+const auto GENERATOR_DATABASE = boost::filesystem::path(UNIT_TESTS_TMPDIR) / "zone-generator.db";
+
+class ZoneGeneratorFixture : public KeyChainFixture
+{
+public:
+  ZoneGeneratorFixture()
+  {
+    boost::filesystem::remove(GENERATOR_DATABASE);
+
+    options.nRecords = 50;
+    options.maxDepth = 3;
+    options.fanout = 4;
+    options.typeMix = {{label::TXT_RR_TYPE, 1.0}, {label::NS_RR_TYPE, 1.0}};
+    options.nChildZones = 2;
+    options.zoneLevels = 2;
+    options.nChildRecords = 5;
+  }
+
+  ~ZoneGeneratorFixture()
+  {
+    boost::filesystem::remove(GENERATOR_DATABASE);
+  }
+
+public:
+  ZoneGenerator::Options options;
+};
+
+BOOST_FIXTURE_TEST_SUITE(ZoneGenerator, ZoneGeneratorFixture)
+
+BOOST_AUTO_TEST_CASE(Hierarchy)
+{
+  ndns::ZoneGenerator generator(GENERATOR_DATABASE.string(), m_keyChain, options);
+  auto summary = generator.generate("/gen", ROOT_ZONE);
+  BOOST_CHECK_EQUAL(summary.nZones, 3);
+  BOOST_CHECK_EQUAL(summary.nRecords, 50 + 2 * 5 + 2); // including 2 delegations
+
+  DbMgr dbMgr(GENERATOR_DATABASE.string());
+  Zone zone("/gen");
+  BOOST_REQUIRE(dbMgr.find(zone));
+  for (const auto& childName : {"/gen/c0", "/gen/c1"}) {
+    Zone child(childName);
+    BOOST_CHECK(dbMgr.find(child));
+  }
+
+  auto dskCert = m_keyChain.getPib().getIdentity("/gen/NDNS").getDefaultKey()
+                   .getDefaultCertificate();
+  auto rrsets = dbMgr.findRrsets(zone);
+  size_t nDoe = 0;
+  size_t nAuth = 0;
+  size_t nDkeys = 0;
+  for (const auto& rrset : rrsets) {
+    Data data(rrset.getData());
+    if (rrset.getType() == label::DOE_RR_TYPE) {
+      ++nDoe;
+      continue;
+    }
+    if (data.getContentType() == NDNS_AUTH) {
+      ++nAuth;
+    }
+    if (rrset.getType() == label::CERT_RR_TYPE && rrset.getLabel().get(0).toUri()[0] == 'c') {
+      ++nDkeys;
+    }
+    if (rrset.getType() == label::TXT_RR_TYPE) {
+      BOOST_CHECK(security::verifySignature(data, dskCert));
+    }
+
+    // intermediate labels have AUTH records
+    for (size_t i = 1; i < rrset.getLabel().size() &&
+                       rrset.getType() != label::CERT_RR_TYPE; ++i) {
+      Rrset auth(&zone);
+      auth.setLabel(rrset.getLabel().getPrefix(i));
+      auth.setType(label::NS_RR_TYPE);
+      BOOST_REQUIRE(dbMgr.find(auth));
+      BOOST_CHECK_EQUAL(Data(auth.getData()).getContentType(), NDNS_AUTH);
+    }
+  }
+  BOOST_CHECK_GT(nAuth, 0);
+  BOOST_CHECK_EQUAL(nDkeys, 2);
+  // one DoE record per record, plus the guard
+  BOOST_CHECK_EQUAL(nDoe, rrsets.size() - nDoe + 1);
+
+  for (const auto& childLabel : {"c0", "c1"}) {
+    Rrset ns(&zone);
+    ns.setLabel(Name(childLabel));
+    ns.setType(label::NS_RR_TYPE);
+    BOOST_REQUIRE(dbMgr.find(ns));
+    BOOST_CHECK_EQUAL(Data(ns.getData()).getContentType(), NDNS_LINK);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Labels)
+{
+  options.maxDepth = 2;
+  ndns::ZoneGenerator generator(GENERATOR_DATABASE.string(), m_keyChain, options);
+  for (size_t i = 0; i < 100; ++i) {
+    Name label = generator.makeLabel(i);
+    BOOST_CHECK_GE(label.size(), 1);
+    BOOST_CHECK_LE(label.size(), 2);
+    BOOST_CHECK_EQUAL(label.get(-1).toUri(), "r" + to_string(i));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(InvalidOptions)
+{
+  options.typeMix = {{label::APPCERT_RR_TYPE, 1.0}};
+  BOOST_CHECK_THROW(ndns::ZoneGenerator(GENERATOR_DATABASE.string(), m_keyChain, options),
+                    ndns::ZoneGenerator::Error);
+
+  options.typeMix = {{label::TXT_RR_TYPE, 1.0}};
+  options.minRecordSize = 10;
+  options.maxRecordSize = 5;
+  BOOST_CHECK_THROW(ndns::ZoneGenerator(GENERATOR_DATABASE.string(), m_keyChain, options),
+                    ndns::ZoneGenerator::Error);
+}
+
+BOOST_AUTO_TEST_CASE(ExistingZone)
+{
+  options.nChildZones = 0;
+  ndns::ZoneGenerator generator(GENERATOR_DATABASE.string(), m_keyChain, options);
+  generator.generate("/gen", ROOT_ZONE);
+  BOOST_CHECK_THROW(generator.generate("/gen", ROOT_ZONE), ManagementTool::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace ndns
+} // namespace ndn
@@ -47,6 +47,14 @@ BOOST_AUTO_TEST_CASE(MatchInterest)
   BOOST_CHECK_EQUAL(re.rrLabel, Name("/www/dsk-111"));
   BOOST_CHECK_EQUAL(re.rrType, name::Component("NS"));
   BOOST_CHECK_EQUAL(re.version, name::Component::fromVersion(0));
+  BOOST_CHECK_EQUAL(re.segment, name::Component());
+
+  Interest interest3(Name("/net/ndnsim/NDNS/www/dsk-111/NS").appendVersion(0).appendSegment(2));
+  BOOST_CHECK_EQUAL(matchName(interest3, zone, re), true);
+  BOOST_CHECK_EQUAL(re.rrLabel, Name("/www/dsk-111"));
+  BOOST_CHECK_EQUAL(re.rrType, name::Component("NS"));
+  BOOST_CHECK_EQUAL(re.version, name::Component::fromVersion(0));
+  BOOST_CHECK_EQUAL(re.segment, name::Component::fromSegment(2));
 }
 
 BOOST_AUTO_TEST_CASE(MatchData)
@@ -64,6 +72,31 @@ BOOST_AUTO_TEST_CASE(MatchData)
   BOOST_CHECK_EQUAL(re.version.toVersion(), 0);
 }
 
+BOOST_AUTO_TEST_CASE(MultiRrType)
+{
+  using namespace label;
+
+  auto rrType = makeMultiRrType({TXT_RR_TYPE, APPCERT_RR_TYPE});
+  BOOST_CHECK_EQUAL(rrType, name::Component("MULTI.TXT.APPCERT"));
+  auto rrTypes = parseMultiRrType(rrType);
+  BOOST_REQUIRE_EQUAL(rrTypes.size(), 2);
+  BOOST_CHECK_EQUAL(rrTypes[0], TXT_RR_TYPE);
+  BOOST_CHECK_EQUAL(rrTypes[1], APPCERT_RR_TYPE);
+
+  BOOST_CHECK(parseMultiRrType(TXT_RR_TYPE).empty());
+  BOOST_CHECK(parseMultiRrType(name::Component("MULTI")).empty());
+  BOOST_CHECK(parseMultiRrType(name::Component("MULTI.")).empty());
+  BOOST_CHECK(parseMultiRrType(name::Component("MULTI.TXT..NS")).empty());
+  BOOST_CHECK(parseMultiRrType(name::Component("MULTI.A.B.C.D.E.F.G.H.I")).empty());
+  BOOST_CHECK_EQUAL(parseMultiRrType(name::Component("MULTI.A.B.C.D.E.F.G.H")).size(), 8);
+  BOOST_CHECK(parseMultiRrType(name::Component("MULTI.NS.NS")).empty());
+  BOOST_CHECK(parseMultiRrType(name::Component("MULTI.NS.TXT.NS")).empty());
+
+  BOOST_CHECK_THROW(makeMultiRrType({}), std::invalid_argument);
+  BOOST_CHECK_THROW(makeMultiRrType({name::Component("T.XT")}), std::invalid_argument);
+  BOOST_CHECK_THROW(makeMultiRrType({TXT_RR_TYPE, TXT_RR_TYPE}), std::invalid_argument);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace tests
@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "util/latency-histogram.hpp"
+
+#include "boost-test.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+namespace ndn {
+namespace ndns {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(LatencyHistogram)
+
+BOOST_AUTO_TEST_CASE(Buckets)
+{
+  using H = ndns::LatencyHistogram;
+
+  // small values have a bucket each
+  for (uint64_t v = 0; v < 32; ++v) {
+    BOOST_CHECK_EQUAL(H::getBucketIndex(v), v);
+    BOOST_CHECK_EQUAL(H::getBucketLowerBound(v), v);
+  }
+
+  // buckets are contiguous, and their width is 1/16 of their lower bound
+  for (size_t i = 32; i < 1000; ++i) {
+    uint64_t lower = H::getBucketLowerBound(i);
+    uint64_t next = H::getBucketLowerBound(i + 1);
+    BOOST_CHECK_EQUAL(H::getBucketIndex(lower), i);
+    BOOST_CHECK_EQUAL(H::getBucketIndex(next - 1), i);
+    BOOST_CHECK_LE((next - lower) * H::SUB_BUCKETS, lower);
+  }
+
+  BOOST_CHECK_EQUAL(H::getBucketIndex(32), 32);
+  BOOST_CHECK_EQUAL(H::getBucketIndex(63), 47);
+  BOOST_CHECK_EQUAL(H::getBucketIndex(64), 48);
+  BOOST_CHECK_EQUAL(H::getBucketLowerBound(48), 64);
+}
+
+BOOST_AUTO_TEST_CASE(Statistics)
+{
+  ndns::LatencyHistogram histogram;
+  BOOST_CHECK_EQUAL(histogram.getCount(), 0);
+  BOOST_CHECK_EQUAL(histogram.getPercentile(50), 0_ns);
+  BOOST_CHECK_EQUAL(histogram.getMean(), 0_ns);
+
+  for (int i = 1; i <= 1000; ++i) {
+    histogram.add(time::microseconds(i));
+  }
+  BOOST_CHECK_EQUAL(histogram.getCount(), 1000);
+  BOOST_CHECK_EQUAL(histogram.getMin(), 1_us);
+  BOOST_CHECK_EQUAL(histogram.getMax(), 1000_us);
+  BOOST_CHECK_EQUAL(histogram.getMean(), 500500_ns);
+
+  // percentiles are within the relative error of the buckets
+  for (double p : {10.0, 50.0, 90.0, 99.0}) {
+    auto expected = static_cast<double>(time::nanoseconds(time::microseconds(int(p * 10))).count());
+    auto actual = static_cast<double>(histogram.getPercentile(p).count());
+    BOOST_CHECK_GE(actual, expected);
+    BOOST_CHECK_LE(actual, expected * (1 + 1.0 / ndns::LatencyHistogram::SUB_BUCKETS));
+  }
+  BOOST_CHECK_EQUAL(histogram.getPercentile(100), 1000_us);
+  BOOST_CHECK_EQUAL(histogram.getPercentile(0), histogram.getPercentile(0.1));
+
+  // negative latencies are recorded as zero
+  histogram.add(-1_ms);
+  BOOST_CHECK_EQUAL(histogram.getMin(), 0_ns);
+
+  histogram.reset();
+  BOOST_CHECK_EQUAL(histogram.getCount(), 0);
+  BOOST_CHECK_EQUAL(histogram.getMax(), 0_ns);
+}
+
+BOOST_AUTO_TEST_CASE(Merge)
+{
+  ndns::LatencyHistogram a;
+  ndns::LatencyHistogram b;
+  a.add(5_ms);
+  b.add(1_ms);
+  b.add(9_ms);
+
+  a.merge(ndns::LatencyHistogram());
+  BOOST_CHECK_EQUAL(a.getCount(), 1);
+
+  a.merge(b);
+  BOOST_CHECK_EQUAL(a.getCount(), 3);
+  BOOST_CHECK_EQUAL(a.getMin(), 1_ms);
+  BOOST_CHECK_EQUAL(a.getMax(), 9_ms);
+  BOOST_CHECK_EQUAL(a.getMean(), 5_ms);
+
+  ndns::LatencyHistogram c;
+  c.merge(b);
+  BOOST_CHECK_EQUAL(c.getMin(), 1_ms);
+}
+
+BOOST_AUTO_TEST_CASE(Reserve)
+{
+  ndns::LatencyHistogram reserved;
+  reserved.reserve(10_s);
+  BOOST_CHECK_EQUAL(reserved.getCount(), 0);
+  BOOST_CHECK_EQUAL(reserved.getPercentile(99), 0_ns);
+
+  ndns::LatencyHistogram plain;
+  for (auto latency : {3_us, 40_us, 2000_us}) {
+    reserved.add(latency);
+    plain.add(latency);
+  }
+  BOOST_CHECK_EQUAL(reserved.getPercentile(50), plain.getPercentile(50));
+  BOOST_CHECK_EQUAL(reserved.getPercentile(100), 2_ms);
+
+  std::ostringstream a;
+  std::ostringstream b;
+  reserved.printBuckets(a);
+  plain.printBuckets(b);
+  BOOST_CHECK_EQUAL(a.str(), b.str());
+}
+
+BOOST_AUTO_TEST_CASE(Print)
+{
+  ndns::LatencyHistogram histogram;
+  histogram.add(1_ms);
+  histogram.add(1_ms);
+  histogram.add(3_ms);
+
+  std::ostringstream os;
+  os << histogram;
+  BOOST_CHECK_EQUAL(os.str().substr(0, 8), "count=3 ");
+
+  std::ostringstream buckets;
+  histogram.printBuckets(buckets);
+  std::string output = buckets.str();
+  // 1 ms and 3 ms fall in different power-of-two ranges
+  BOOST_CHECK_EQUAL(std::count(output.begin(), output.end(), '\n'), 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // LatencyHistogram
+
+} // namespace tests
+} // namespace ndns
+} // namespace ndn
@@ -0,0 +1,127 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "util/query-trace.hpp"
+
+#include "daemon/query-log.hpp"
+
+#include "boost-test.hpp"
+
+#include <boost/filesystem/operations.hpp>
+
+#include <sstream>
+
+namespace ndn {
+namespace ndns {
+namespace tests {
+
+BOOST_AUTO_TEST_SUITE(QueryTrace)
+
+BOOST_AUTO_TEST_CASE(Text)
+{
+  std::istringstream is(R"TRACE(
+; comment
+1697040000.5 /example/NDNS/www TXT
+1697040000 /example/NDNS/ftp/a NS
+1697040000.000001 /example/mail TXT
+1697040001.25 /other/NDNS/www TXT
+# comment
+1697040000.5 /unrelated TXT
+)TRACE");
+
+  ndns::QueryTrace trace("/example");
+  trace.addText(is, "trace");
+  BOOST_CHECK_EQUAL(trace.getNSkipped(), 2);
+
+  const auto& queries = trace.getQueries();
+  BOOST_REQUIRE_EQUAL(queries.size(), 3);
+  BOOST_CHECK_EQUAL(queries[0].timestamp, 1697040000000000000u);
+  BOOST_CHECK_EQUAL(queries[0].zone, "/example");
+  BOOST_CHECK_EQUAL(queries[0].label, "/ftp/a");
+  BOOST_CHECK_EQUAL(queries[0].rrType, name::Component("NS"));
+  BOOST_CHECK_EQUAL(queries[1].timestamp, 1697040000000001000u);
+  BOOST_CHECK_EQUAL(queries[1].label, "/mail");
+  BOOST_CHECK_EQUAL(queries[2].timestamp, 1697040000500000000u);
+  BOOST_CHECK_EQUAL(queries[2].label, "/www");
+  BOOST_CHECK_EQUAL(trace.getDuration(), 500_ms);
+
+  // without a zone, queries for all zones are kept, but names need the NDNS component
+  is.clear();
+  is.seekg(0);
+  ndns::QueryTrace allZones;
+  allZones.addText(is, "trace");
+  BOOST_CHECK_EQUAL(allZones.getQueries().size(), 3);
+  BOOST_CHECK_EQUAL(allZones.getQueries().back().zone, "/other");
+  BOOST_CHECK_EQUAL(allZones.getNSkipped(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(MalformedText)
+{
+  ndns::QueryTrace trace;
+  std::istringstream missingType("1697040000 /example/NDNS/www\n");
+  BOOST_CHECK_THROW(trace.addText(missingType, "trace"), ndns::QueryTrace::Error);
+  std::istringstream badTimestamp("16970x0000 /example/NDNS/www TXT\n");
+  BOOST_CHECK_THROW(trace.addText(badTimestamp, "trace"), ndns::QueryTrace::Error);
+  std::istringstream longFraction("1697040000.1234567890 /example/NDNS/www TXT\n");
+  BOOST_CHECK_THROW(trace.addText(longFraction, "trace"), ndns::QueryTrace::Error);
+}
+
+BOOST_AUTO_TEST_CASE(QueryLogFile)
+{
+  auto path = boost::filesystem::path(UNIT_TESTS_TMPDIR) / "trace-query.log";
+  boost::filesystem::remove(path);
+  boost::filesystem::remove(path.string() + ".1");
+
+  {
+    ndns::QueryLog::Options options;
+    options.path = path.string();
+    ndns::QueryLog log(options);
+
+    QueryLogEntry entry{};
+    entry.kind = QueryLogEntry::QUERY;
+    entry.timestamp = 2000;
+    entry.setNames("/example", "/www", name::Component("TXT"));
+    log.add(entry);
+    entry.timestamp = 1000;
+    entry.setNames("/example", "/ftp", name::Component("TXT"));
+    log.add(entry);
+    entry.kind = QueryLogEntry::UPDATE;
+    log.add(entry);
+  }
+  BOOST_CHECK(ndns::QueryLog::isQueryLog(path.string()));
+
+  ndns::QueryTrace trace;
+  trace.addFile(path.string());
+  BOOST_CHECK_EQUAL(trace.getNSkipped(), 1);
+  BOOST_REQUIRE_EQUAL(trace.getQueries().size(), 2);
+  BOOST_CHECK_EQUAL(trace.getQueries()[0].label, "/ftp");
+  BOOST_CHECK_EQUAL(trace.getQueries()[1].label, "/www");
+  BOOST_CHECK_EQUAL(trace.getQueries()[1].zone, "/example");
+  BOOST_CHECK_EQUAL(trace.getDuration(), 1_us);
+
+  boost::filesystem::remove(path);
+  BOOST_CHECK_THROW(trace.addFile(path.string()), ndns::QueryTrace::Error);
+}
+
+BOOST_AUTO_TEST_SUITE_END() // QueryTrace
+
+} // namespace tests
+} // namespace ndns
+} // namespace ndn
@@ -0,0 +1,270 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "validator/certificate-fetcher-local-db.hpp"
+#include "validator/validator.hpp"
+#include "util/cert-helper.hpp"
+
+#include "boost-test.hpp"
+#include "unit/database-test-data.hpp"
+
+#include <ndn-cxx/util/dummy-client-face.hpp>
+#include <ndn-cxx/util/io.hpp>
+
+#include <fstream>
+
+namespace ndn {
+namespace ndns {
+namespace tests {
+
+class LocalDbFetcherFixture : public DbTestData
+{
+public:
+  LocalDbFetcherFixture()
+    : m_validatorFace(m_io, m_keyChain, {true, true})
+    , m_validator(NdnsValidatorBuilder::create(m_validatorFace, 500, 0,
+                                               UNIT_TESTS_TMPDIR "/validator.conf",
+                                               nullptr, &m_session))
+  {
+    m_ndnsimCert = CertHelper::getDefaultCertificateNameOfIdentity(m_keyChain,
+                                                                   Name(m_ndnsimName).append("NDNS"));
+    advanceClocks(10_ms);
+  }
+
+  /**
+   * @return a certificate of a new @p identity issued by the certificate @p issuer
+   */
+  security::Certificate
+  makeCertificate(const Name& identity, const Name& issuer)
+  {
+    auto key = m_keyChain.createIdentity(identity).getDefaultKey();
+    security::Certificate cert = key.getDefaultCertificate();
+    cert.setName(Name(key.getName()).append("parent").appendVersion());
+    SignatureInfo info;
+    info.setValidityPeriod(security::ValidityPeriod(time::system_clock::now(),
+                                                    time::system_clock::now() + time::days(10)));
+    m_keyChain.sign(cert, signingByCertificate(issuer).setSignatureInfo(info));
+    return cert;
+  }
+
+  /**
+   * @return 1 if @p data is valid, 0 if it is invalid, -1 if validation has not completed
+   */
+  int
+  validate(const Data& data)
+  {
+    int result = -1;
+    m_validator->validate(data,
+                          [&] (const Data&) { result = 1; },
+                          [&] (const Data&, const security::ValidationError&) { result = 0; });
+    advanceClocks(1_s, 60);
+    return result;
+  }
+
+public:
+  DummyClientFace m_validatorFace;
+  unique_ptr<security::Validator> m_validator;
+  Name m_ndnsimCert;
+};
+
+BOOST_FIXTURE_TEST_SUITE(CertificateFetcherLocalDb, LocalDbFetcherFixture)
+
+BOOST_AUTO_TEST_CASE(FindLocalCertificate)
+{
+  ndns::CertificateFetcherLocalDb fetcher(m_session, m_validatorFace);
+
+  auto cert = fetcher.findLocalCertificate(m_ndnsimCert);
+  BOOST_REQUIRE(cert);
+  BOOST_CHECK_EQUAL(cert->getName(), m_ndnsimCert);
+
+  // key name
+  cert = fetcher.findLocalCertificate(m_ndnsimCert.getPrefix(-2));
+  BOOST_REQUIRE(cert);
+  BOOST_CHECK_EQUAL(cert->getName(), m_ndnsimCert);
+
+  // another version of the certificate
+  BOOST_CHECK(!fetcher.findLocalCertificate(m_ndnsimCert.getPrefix(-1).appendVersion(1)));
+  // zone not hosted locally
+  BOOST_CHECK(!fetcher.findLocalCertificate("/other/NDNS/KEY/%01/CERT/%FD%01"));
+  // not an NDNS certificate
+  BOOST_CHECK(!fetcher.findLocalCertificate("/random/KEY/%01"));
+}
+
+BOOST_AUTO_TEST_CASE(ValidateWithoutNetwork)
+{
+  SignatureInfo info;
+  info.setValidityPeriod(security::ValidityPeriod(time::system_clock::time_point::min(),
+                                                  time::system_clock::now() + time::days(10)));
+
+  Data data(Name(m_ndnsimName).append("NDNS").append("rrLabel").append("TXT").appendVersion());
+  m_keyChain.sign(data, signingByCertificate(m_ndnsimCert).setSignatureInfo(info));
+
+  // the whole chain up to the trust anchor is stored in the database
+  BOOST_CHECK_EQUAL(validate(data), 1);
+  BOOST_CHECK_EQUAL(m_validatorFace.sentInterests.size(), 0);
+
+  // a certificate which is not stored locally is looked up on the network, where no name
+  // server is reachable
+  auto unknownCert = m_keyChain.createIdentity("/unknown/NDNS").getDefaultKey()
+                     .getDefaultCertificate();
+  Data other(Name(m_ndnsimName).append("NDNS").append("rrLabel").append("TXT").appendVersion());
+  m_keyChain.sign(other, signingByCertificate(unknownCert));
+  BOOST_CHECK_EQUAL(validate(other), 0);
+}
+
+BOOST_AUTO_TEST_CASE(PersistentCache)
+{
+  auto& fetcher = dynamic_cast<ndns::CertificateFetcherLocalDb&>(m_validator->getFetcher());
+
+  // pretend that a certificate was fetched from the network and an NS link was cached
+  auto unknownCert = makeCertificate("/unknown/NDNS", m_certName);
+  fetcher.onCertificateFetched(unknownCert);
+  Data link(Name("/unknown/NDNS/NS").appendVersion());
+  link.setFreshnessPeriod(1_h);
+  m_keyChain.sign(link);
+  fetcher.getNsCache()->insert(link);
+
+  // not verified yet
+  fetcher.persistCache();
+  BOOST_CHECK_EQUAL(m_session.find(DbMgr::ValidatorCacheType::CERTIFICATE).size(), 0);
+  BOOST_CHECK_EQUAL(m_session.find(DbMgr::ValidatorCacheType::NS_LINK).size(), 1);
+
+  m_validator->cacheVerifiedCertificate(security::Certificate(unknownCert));
+  advanceClocks(1_s, 2);
+  BOOST_CHECK_EQUAL(m_session.find(DbMgr::ValidatorCacheType::CERTIFICATE).size(), 1);
+
+  // a validator created after a restart starts with the saved state
+  auto restarted = NdnsValidatorBuilder::create(m_validatorFace, 500, 0,
+                                                UNIT_TESTS_TMPDIR "/validator.conf",
+                                                nullptr, &m_session);
+  BOOST_CHECK(restarted->getVerifiedCertificateCache().find(unknownCert.getName()) != nullptr);
+  auto& restartedFetcher = dynamic_cast<ndns::CertificateFetcherLocalDb&>(restarted->getFetcher());
+  BOOST_CHECK_EQUAL(restartedFetcher.getNsCache()->size(), 1);
+
+  // saved entries expire
+  advanceClocks(10_min, 7);
+  BOOST_CHECK_EQUAL(m_session.find(DbMgr::ValidatorCacheType::CERTIFICATE).size(), 0);
+  BOOST_CHECK_EQUAL(m_session.find(DbMgr::ValidatorCacheType::NS_LINK).size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(PersistentCacheAnchorRotation)
+{
+  auto& fetcher = dynamic_cast<ndns::CertificateFetcherLocalDb&>(m_validator->getFetcher());
+
+  // one certificate is issued by the trust anchor, the other one by the first certificate
+  auto unknownCert = makeCertificate("/unknown/NDNS", m_certName);
+  auto childCert = makeCertificate("/unknown/child/NDNS", unknownCert.getName());
+  auto selfSignedCert = m_keyChain.createIdentity("/self-signed/NDNS").getDefaultKey()
+                        .getDefaultCertificate();
+  for (const auto& cert : {unknownCert, childCert, selfSignedCert}) {
+    fetcher.onCertificateFetched(cert);
+    m_validator->cacheVerifiedCertificate(security::Certificate(cert));
+  }
+  advanceClocks(1_s, 2);
+  BOOST_CHECK_EQUAL(m_session.find(DbMgr::ValidatorCacheType::CERTIFICATE).size(), 3);
+
+  // with the same trust anchor, the certificates chained to it are reloaded
+  auto restarted = NdnsValidatorBuilder::create(m_validatorFace, 500, 0,
+                                                UNIT_TESTS_TMPDIR "/validator.conf",
+                                                nullptr, &m_session);
+  BOOST_CHECK(restarted->getVerifiedCertificateCache().find(unknownCert.getName()) != nullptr);
+  BOOST_CHECK(restarted->getVerifiedCertificateCache().find(childCert.getName()) != nullptr);
+  BOOST_CHECK(restarted->getVerifiedCertificateCache().find(selfSignedCert.getName()) == nullptr);
+
+  // the trust anchor is replaced between the runs
+  auto newAnchor = m_keyChain.createIdentity("/new-anchor").getDefaultKey()
+                   .getDefaultCertificate();
+  io::save(newAnchor, UNIT_TESTS_TMPDIR "/rotated-anchor.cert");
+  {
+    std::ofstream conf(UNIT_TESTS_TMPDIR "/rotated-validator.conf");
+    conf << "trust-anchor\n"
+         << "{\n"
+         << "  type file\n"
+         << "  file-name rotated-anchor.cert\n"
+         << "}\n";
+  }
+  restarted = NdnsValidatorBuilder::create(m_validatorFace, 500, 0,
+                                           UNIT_TESTS_TMPDIR "/rotated-validator.conf",
+                                           nullptr, &m_session);
+  BOOST_CHECK(restarted->getVerifiedCertificateCache().find(unknownCert.getName()) == nullptr);
+  BOOST_CHECK(restarted->getVerifiedCertificateCache().find(childCert.getName()) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(ReloadedLinkLifetime)
+{
+  auto& fetcher = dynamic_cast<ndns::CertificateFetcherLocalDb&>(m_validator->getFetcher());
+  Data link(Name("/unknown/NDNS/NS").appendVersion());
+  link.setFreshnessPeriod(1_h);
+  m_keyChain.sign(link);
+  fetcher.getNsCache()->insert(link);
+  fetcher.persistCache();
+
+  // the link is reloaded with the 20 minutes it has left, not its FreshnessPeriod
+  advanceClocks(10_min, 4);
+  auto restarted = NdnsValidatorBuilder::create(m_validatorFace, 500, 0,
+                                                UNIT_TESTS_TMPDIR "/validator.conf",
+                                                nullptr, &m_session);
+  auto& restartedFetcher = dynamic_cast<ndns::CertificateFetcherLocalDb&>(restarted->getFetcher());
+  BOOST_CHECK_EQUAL(restartedFetcher.getNsCache()->size(), 1);
+  advanceClocks(10_min, 2);
+  BOOST_CHECK_EQUAL(restartedFetcher.getNsCache()->size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(UnusableDatabase)
+{
+  // every statement fails, as on a database that cannot be written
+  DbMgr closed(UNIT_TESTS_TMPDIR "/closed.db");
+  closed.close();
+
+  unique_ptr<security::Validator> validator;
+  BOOST_CHECK_NO_THROW(validator = NdnsValidatorBuilder::create(m_validatorFace, 500, 0,
+                                                                UNIT_TESTS_TMPDIR "/validator.conf",
+                                                                nullptr, &closed));
+  BOOST_CHECK(validator != nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(PersistFailure)
+{
+  DbMgr db(UNIT_TESTS_TMPDIR "/persist-failure.db");
+  auto validator = NdnsValidatorBuilder::create(m_validatorFace, 500, 0,
+                                                UNIT_TESTS_TMPDIR "/validator.conf",
+                                                nullptr, &db);
+  auto& fetcher = dynamic_cast<ndns::CertificateFetcherLocalDb&>(validator->getFetcher());
+
+  auto unknownCert = m_keyChain.createIdentity("/unknown/NDNS").getDefaultKey()
+                     .getDefaultCertificate();
+  fetcher.onCertificateFetched(unknownCert);
+  validator->cacheVerifiedCertificate(security::Certificate(unknownCert));
+  Data link(Name("/unknown/NDNS/NS").appendVersion());
+  link.setFreshnessPeriod(1_h);
+  m_keyChain.sign(link);
+  fetcher.getNsCache()->insert(link);
+
+  // writes fail from now on, the daemon keeps running
+  db.close();
+  BOOST_CHECK_NO_THROW(fetcher.persistCache());
+  BOOST_CHECK_NO_THROW(advanceClocks(1_s, 2));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace ndns
+} // namespace ndn
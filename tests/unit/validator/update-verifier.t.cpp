@@ -0,0 +1,163 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "validator/update-verifier.hpp"
+#include "validator/validator.hpp"
+#include "util/cert-helper.hpp"
+
+#include "boost-test.hpp"
+#include "unit/database-test-data.hpp"
+
+#include <ndn-cxx/util/dummy-client-face.hpp>
+
+#include <thread>
+
+namespace ndn {
+namespace ndns {
+namespace tests {
+
+class UpdateVerifierFixture : public DbTestData
+{
+public:
+  UpdateVerifierFixture()
+    : m_validatorFace(m_io, m_keyChain, {true, true})
+    , m_validator(NdnsValidatorBuilder::create(m_validatorFace, 500, 0,
+                                               UNIT_TESTS_TMPDIR "/validator.conf",
+                                               nullptr, &m_session))
+    , m_verifier(*m_validator, m_io, 2)
+  {
+    m_ndnsimCert = CertHelper::getDefaultCertificateNameOfIdentity(m_keyChain,
+                                                                   Name(m_ndnsimName).append("NDNS"));
+    advanceClocks(10_ms);
+  }
+
+  shared_ptr<Data>
+  makeUpdate(const Name& zone, const std::string& label)
+  {
+    auto data = make_shared<Data>(Name(zone).append("NDNS").append(label).append("TXT").appendVersion());
+    m_keyChain.sign(*data, signingByCertificate(m_ndnsimCert));
+    return data;
+  }
+
+  /**
+   * @brief submit @p data, recording its index in @p results and whether it was verified
+   */
+  void
+  verify(const shared_ptr<Data>& data, std::vector<std::pair<size_t, bool>>& results)
+  {
+    size_t index = m_nSubmitted++;
+    m_verifier.verify(data,
+                      [&results, index] (const Data&) { results.emplace_back(index, true); },
+                      [&results, index] (const Data&, const security::ValidationError&) {
+                        results.emplace_back(index, false);
+                      });
+  }
+
+  void
+  waitForQueue()
+  {
+    for (int i = 0; i < 1000 && m_verifier.getQueueDepth() > 0; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      advanceClocks(1_ms);
+    }
+  }
+
+public:
+  DummyClientFace m_validatorFace;
+  unique_ptr<security::Validator> m_validator;
+  ndns::UpdateVerifier m_verifier;
+  Name m_ndnsimCert;
+  size_t m_nSubmitted = 0;
+};
+
+BOOST_FIXTURE_TEST_SUITE(UpdateVerifier, UpdateVerifierFixture)
+
+BOOST_AUTO_TEST_CASE(OffloadInOrder)
+{
+  std::vector<std::pair<size_t, bool>> results;
+
+  // the signer certificate is not verified yet, the validator takes care of the first update
+  verify(makeUpdate(m_ndnsimName, "first"), results);
+  waitForQueue();
+  BOOST_CHECK_EQUAL(m_verifier.getNFallbacks(), 1);
+  BOOST_CHECK_EQUAL(m_verifier.getNOffloaded(), 0);
+
+  // a burst of updates by the same signer, one of them with a bad signature
+  for (int i = 0; i < 8; ++i) {
+    auto data = makeUpdate(m_ndnsimName, "label" + std::to_string(i));
+    if (i == 3) {
+      data->setSignatureValue(std::make_shared<Buffer>(64));
+    }
+    verify(data, results);
+  }
+  BOOST_CHECK_GT(m_verifier.getQueueDepth(), 0);
+  waitForQueue();
+
+  BOOST_CHECK_EQUAL(m_verifier.getQueueDepth(), 0);
+  BOOST_CHECK_EQUAL(m_verifier.getMaxQueueDepth(), 8);
+  BOOST_CHECK_EQUAL(m_verifier.getNFallbacks(), 1);
+  BOOST_CHECK_EQUAL(m_verifier.getNOffloaded(), 8);
+  BOOST_CHECK_GT(m_verifier.getMaxLatency(), 0_ns);
+  BOOST_CHECK_LE(m_verifier.getMeanLatency(), m_verifier.getMaxLatency());
+
+  BOOST_REQUIRE_EQUAL(results.size(), 9);
+  for (size_t i = 0; i < results.size(); ++i) {
+    BOOST_CHECK_EQUAL(results[i].first, i);
+    BOOST_CHECK_EQUAL(results[i].second, i != 4);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(PolicyRejection)
+{
+  std::vector<std::pair<size_t, bool>> results;
+
+  // signed by a key of a child zone, rejected before looking for the certificate
+  verify(makeUpdate(m_netName, "www"), results);
+  BOOST_REQUIRE_EQUAL(results.size(), 1);
+  BOOST_CHECK_EQUAL(results[0].second, false);
+  BOOST_CHECK_EQUAL(m_verifier.getNFallbacks(), 0);
+  BOOST_CHECK_EQUAL(m_verifier.getNOffloaded(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(ValidationCacheHit)
+{
+  ndns::ValidationCache cache;
+  m_verifier.setValidationCache(&cache);
+  std::vector<std::pair<size_t, bool>> results;
+
+  verify(makeUpdate(m_ndnsimName, "first"), results);
+  waitForQueue();
+  auto data = makeUpdate(m_ndnsimName, "www");
+  verify(data, results);
+  waitForQueue();
+  BOOST_CHECK_EQUAL(m_verifier.getNOffloaded(), 1);
+  BOOST_CHECK_EQUAL(cache.size(), 2);
+
+  // an identical packet is accepted without verification
+  verify(data, results);
+  BOOST_CHECK_EQUAL(results.size(), 3);
+  BOOST_CHECK_EQUAL(m_verifier.getNOffloaded(), 1);
+  BOOST_CHECK_EQUAL(cache.getNHits(), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace ndns
+} // namespace ndn
@@ -0,0 +1,190 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "validator/validation-cache.hpp"
+#include "validator/validator.hpp"
+#include "util/cert-helper.hpp"
+
+#include "boost-test.hpp"
+#include "unit/database-test-data.hpp"
+
+#include <ndn-cxx/util/dummy-client-face.hpp>
+
+namespace ndn {
+namespace ndns {
+namespace tests {
+
+class ValidationCacheFixture : public DbTestData
+{
+public:
+  ValidationCacheFixture()
+    : m_validatorFace(m_io, m_keyChain, {true, true})
+    , m_validator(NdnsValidatorBuilder::create(m_validatorFace, 500, 0,
+                                               UNIT_TESTS_TMPDIR "/validator.conf",
+                                               nullptr, &m_session))
+  {
+    m_ndnsimCert = CertHelper::getDefaultCertificateNameOfIdentity(m_keyChain,
+                                                                   Name(m_ndnsimName).append("NDNS"));
+    advanceClocks(10_ms);
+  }
+
+  Data
+  makeData(const Name& zone, const std::string& label)
+  {
+    Data data(Name(zone).append("NDNS").append(label).append("TXT").appendVersion());
+    m_keyChain.sign(data, signingByCertificate(m_ndnsimCert));
+    return data;
+  }
+
+  /**
+   * @return 1 if @p data is valid, 0 if it is invalid, -1 if validation has not completed
+   */
+  int
+  validate(ndns::ValidationCache& cache, const Data& data, bool shouldWait = true)
+  {
+    int result = -1;
+    cache.validate(*m_validator, data,
+                   [&] (const Data&) { result = 1; },
+                   [&] (const Data&, const security::ValidationError&) { result = 0; });
+    if (shouldWait) {
+      advanceClocks(10_ms, 10);
+    }
+    return result;
+  }
+
+public:
+  DummyClientFace m_validatorFace;
+  unique_ptr<security::Validator> m_validator;
+  Name m_ndnsimCert;
+};
+
+BOOST_FIXTURE_TEST_SUITE(ValidationCache, ValidationCacheFixture)
+
+BOOST_AUTO_TEST_CASE(SkipRevalidation)
+{
+  ndns::ValidationCache cache;
+  Data data = makeData(m_ndnsimName, "www");
+
+  BOOST_CHECK_EQUAL(validate(cache, data), 1);
+  BOOST_CHECK_EQUAL(cache.size(), 1);
+  BOOST_CHECK_EQUAL(cache.getNMisses(), 1);
+
+  // an identical packet is accepted synchronously
+  BOOST_CHECK_EQUAL(validate(cache, Data(data.wireEncode()), false), 1);
+  BOOST_CHECK_EQUAL(cache.getNHits(), 1);
+
+  // the same name with a different signature is a different packet
+  Data other = data;
+  m_keyChain.sign(other, signingByCertificate(m_ndnsimCert));
+  BOOST_CHECK(!cache.contains(other));
+}
+
+BOOST_AUTO_TEST_CASE(FailureNotCached)
+{
+  ndns::ValidationCache cache;
+  // signed by a key of a child zone
+  Data data = makeData(m_netName, "www");
+
+  BOOST_CHECK_EQUAL(validate(cache, data), 0);
+  BOOST_CHECK_EQUAL(cache.size(), 0);
+  BOOST_CHECK_EQUAL(validate(cache, data), 0);
+  BOOST_CHECK_EQUAL(cache.getNHits(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Expiry)
+{
+  ndns::ValidationCache cache(100, 10_s);
+  Data data = makeData(m_ndnsimName, "www");
+  BOOST_CHECK_EQUAL(validate(cache, data), 1);
+
+  advanceClocks(1_s, 5);
+  BOOST_CHECK(cache.contains(data));
+
+  advanceClocks(1_s, 10);
+  BOOST_CHECK(!cache.contains(data));
+  BOOST_CHECK_EQUAL(cache.size(), 0);
+
+  // the signer certificate expires before the maximum lifetime
+  cache.insert(data, time::system_clock::now() + 1_s);
+  BOOST_CHECK(cache.contains(data));
+  advanceClocks(1_s, 2);
+  BOOST_CHECK(!cache.contains(data));
+}
+
+BOOST_AUTO_TEST_CASE(Epoch)
+{
+  ndns::ValidationCache cache;
+  Data data = makeData(m_ndnsimName, "www");
+  cache.insert(data, time::system_clock::now() + 1_h);
+  BOOST_CHECK(cache.contains(data));
+
+  cache.bumpEpoch();
+  BOOST_CHECK_EQUAL(cache.getEpoch(), 1);
+  BOOST_CHECK(!cache.contains(data));
+
+  cache.insert(data, time::system_clock::now() + 1_h);
+  BOOST_CHECK(cache.contains(data));
+}
+
+BOOST_AUTO_TEST_CASE(PeriodicEpoch)
+{
+  Scheduler scheduler(m_io);
+  ndns::ValidationCache cache;
+  Data data = makeData(m_ndnsimName, "www");
+  cache.insert(data, time::system_clock::now() + 1_h);
+
+  cache.scheduleEpochBumps(scheduler, 10_min);
+  advanceClocks(1_min, 9);
+  BOOST_CHECK(cache.contains(data));
+  advanceClocks(1_min, 1);
+  BOOST_CHECK_EQUAL(cache.getEpoch(), 1);
+  BOOST_CHECK(!cache.contains(data));
+  advanceClocks(1_min, 10);
+  BOOST_CHECK_EQUAL(cache.getEpoch(), 2);
+
+  // trust anchors that are not refreshed
+  cache.scheduleEpochBumps(scheduler, time::nanoseconds::max());
+  advanceClocks(1_min, 20);
+  BOOST_CHECK_EQUAL(cache.getEpoch(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(Eviction)
+{
+  ndns::ValidationCache cache(2);
+  Data a = makeData(m_ndnsimName, "a");
+  Data b = makeData(m_ndnsimName, "b");
+  Data c = makeData(m_ndnsimName, "c");
+  auto notAfter = time::system_clock::now() + 1_h;
+
+  cache.insert(a, notAfter);
+  cache.insert(b, notAfter);
+  BOOST_CHECK(cache.contains(a)); // b becomes the least recently used entry
+  cache.insert(c, notAfter);
+
+  BOOST_CHECK_EQUAL(cache.size(), 2);
+  BOOST_CHECK(cache.contains(a));
+  BOOST_CHECK(!cache.contains(b));
+  BOOST_CHECK(cache.contains(c));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace ndns
+} // namespace ndn
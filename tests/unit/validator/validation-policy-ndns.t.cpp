@@ -0,0 +1,234 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "validator/validation-policy-ndns.hpp"
+
+#include "boost-test.hpp"
+#include "unit/database-test-data.hpp"
+
+#include <ndn-cxx/security/certificate-fetcher-offline.hpp>
+#include <ndn-cxx/security/validation-policy-config.hpp>
+#include <ndn-cxx/security/validation-state.hpp>
+#include <ndn-cxx/security/validator.hpp>
+
+#include <boost/filesystem/operations.hpp>
+
+namespace ndn {
+namespace ndns {
+namespace tests {
+
+class ValidationPolicyNdnsFixture : public DbTestData
+{
+public:
+  ValidationPolicyNdnsFixture()
+    : m_configValidator(make_unique<security::ValidationPolicyConfig>(),
+                        make_unique<security::CertificateFetcherOffline>())
+    , m_ndnsValidator(make_unique<ndns::ValidationPolicyNdns>(),
+                      make_unique<security::CertificateFetcherOffline>())
+  {
+    static_cast<security::ValidationPolicyConfig&>(m_configValidator.getPolicy())
+      .load(UNIT_TESTS_TMPDIR "/validator.conf");
+    static_cast<ndns::ValidationPolicyNdns&>(m_ndnsValidator.getPolicy())
+      .load(UNIT_TESTS_TMPDIR "/validator.conf");
+  }
+
+  /**
+   * @return the name of the certificate requested by @p policy for @p data, an empty name if
+   *         no certificate is needed, or nullopt if @p data is rejected
+   */
+  static std::optional<Name>
+  checkPolicy(security::ValidationPolicy& policy, const Data& data)
+  {
+    std::optional<Name> certName;
+    bool hasOutcome = false;
+    auto state = make_shared<security::DataValidationState>(
+      data,
+      [] (const Data&) {},
+      [&] (const Data&, const security::ValidationError&) { hasOutcome = true; });
+    policy.checkPolicy(data, state,
+                       [&] (const shared_ptr<security::CertificateRequest>& certRequest,
+                            const shared_ptr<security::ValidationState>&) {
+                         hasOutcome = true;
+                         // no request when the policy is bypassed
+                         certName = certRequest != nullptr ?
+                                    certRequest->interest.getName() : Name();
+                       });
+    BOOST_REQUIRE(hasOutcome);
+    return certName;
+  }
+
+  static Data
+  makeData(const Name& name, const Name& keyLocator,
+           uint32_t sigType = ndn::tlv::SignatureSha256WithEcdsa)
+  {
+    Data data(name);
+    SignatureInfo info(static_cast<ndn::tlv::SignatureTypeValue>(sigType));
+    if (!keyLocator.empty()) {
+      info.setKeyLocator(KeyLocator(keyLocator));
+    }
+    data.setSignatureInfo(info);
+    data.setSignatureValue(std::make_shared<Buffer>(32));
+    data.wireEncode();
+    return data;
+  }
+
+  void
+  checkEquivalence(const Data& data)
+  {
+    auto expected = checkPolicy(m_configValidator.getPolicy(), data);
+    auto actual = checkPolicy(m_ndnsValidator.getPolicy(), data);
+    BOOST_TEST_CONTEXT(data.getName() << " " << data.getSignatureInfo()) {
+      BOOST_CHECK_EQUAL(actual.has_value(), expected.has_value());
+      if (actual && expected) {
+        BOOST_CHECK_EQUAL(*actual, *expected);
+      }
+    }
+    ++m_nChecked;
+    m_nAccepted += expected.has_value();
+  }
+
+public:
+  security::Validator m_configValidator;
+  security::Validator m_ndnsValidator;
+  size_t m_nChecked = 0;
+  size_t m_nAccepted = 0;
+};
+
+BOOST_FIXTURE_TEST_SUITE(ValidationPolicyNdns, ValidationPolicyNdnsFixture)
+
+BOOST_AUTO_TEST_CASE(GetKeyZone)
+{
+  using Policy = ndns::ValidationPolicyNdns;
+  BOOST_CHECK_EQUAL(*Policy::getKeyZone("/ndn/ndnsim/NDNS/KEY/ksk-1", true), "/ndn/ndnsim");
+  BOOST_CHECK_EQUAL(*Policy::getKeyZone("/ndn/NDNS/ndnsim/KEY/dkey-1", false), "/ndn/ndnsim");
+  BOOST_CHECK(!Policy::getKeyZone("/ndn/NDNS/ndnsim/KEY/dkey-1", true));
+  BOOST_CHECK(!Policy::getKeyZone("/ndn/ndnsim/KEY/ksk-1", false));
+  BOOST_CHECK(!Policy::getKeyZone("/ndn/ndnsim/NDNS/KEY", false));
+  BOOST_CHECK(!Policy::getKeyZone("/ndn/ndnsim/NDNS/KEY/ksk-1/CERT", false));
+}
+
+BOOST_AUTO_TEST_CASE(DatabaseRecords)
+{
+  for (const auto& rrset : m_rrsets) {
+    Data data(rrset.getData());
+    checkEquivalence(data);
+  }
+  BOOST_CHECK_GT(m_nAccepted, 0);
+}
+
+BOOST_AUTO_TEST_CASE(GeneratedNames)
+{
+  const std::vector<name::Component> pool{name::Component("a"), name::Component("b"),
+                                          name::Component("NDNS"), name::Component("KEY")};
+
+  // all names of up to maxSize components drawn from pool
+  auto enumerate = [&pool] (size_t maxSize) {
+    std::vector<Name> names{Name()};
+    for (size_t begin = 0, size = 1; size <= maxSize; ++size) {
+      size_t end = names.size();
+      for (size_t i = begin; i < end; ++i) {
+        for (const auto& comp : pool) {
+          names.push_back(Name(names[i]).append(comp));
+        }
+      }
+      begin = end;
+    }
+    return names;
+  };
+
+  auto dataNames = enumerate(6);
+  auto keyNames = enumerate(2);
+  for (const auto& keyName : {"/NDNS/KEY/a", "/a/NDNS/KEY/KEY", "/NDNS/a/KEY/b",
+                              "/a/NDNS/NDNS/KEY/b", "/a/NDNS/KEY/b/c"}) {
+    keyNames.push_back(keyName);
+  }
+
+  for (const auto& dataName : dataNames) {
+    std::vector<Name> keyLocators = keyNames;
+    // keys that would match the zone of dataName
+    for (size_t i = 0; i < dataName.size(); ++i) {
+      if (dataName[i] == label::NDNS_ITERATIVE_QUERY) {
+        Name zone = dataName.getPrefix(i);
+        keyLocators.push_back(Name(zone).append("NDNS").append("KEY").append("k"));
+        if (!zone.empty()) {
+          keyLocators.push_back(zone.getPrefix(-1).append("NDNS").append(zone.get(-1))
+                                .append("KEY").append("k"));
+          keyLocators.push_back(Name(zone).append("NDNS").append("a").append("KEY").append("k"));
+        }
+        break;
+      }
+    }
+
+    for (const auto& keyLocator : keyLocators) {
+      checkEquivalence(makeData(dataName, keyLocator));
+    }
+  }
+
+  // signature types other than ECDSA, and missing key locators
+  Name dataName("/a/NDNS/b/TXT/v");
+  checkEquivalence(makeData(dataName, "/a/NDNS/KEY/k", ndn::tlv::SignatureSha256WithRsa));
+  checkEquivalence(makeData(dataName, "/a/NDNS/KEY/k", ndn::tlv::SignatureHmacWithSha256));
+  checkEquivalence(makeData(dataName, Name()));
+
+  BOOST_TEST_MESSAGE(m_nChecked << " packets checked, " << m_nAccepted << " accepted");
+  BOOST_CHECK_GT(m_nAccepted, 0);
+}
+
+BOOST_AUTO_TEST_CASE(LoadErrors)
+{
+  auto& policy = static_cast<ndns::ValidationPolicyNdns&>(m_ndnsValidator.getPolicy());
+
+  std::istringstream unknownSection("foo\n{\n}\n");
+  BOOST_CHECK_THROW(policy.load(unknownSection, "test.conf"), ndns::ValidationPolicyNdns::Error);
+
+  std::istringstream unknownAnchor("trust-anchor\n{\n  type bar\n}\n");
+  BOOST_CHECK_THROW(policy.load(unknownAnchor, "test.conf"), ndns::ValidationPolicyNdns::Error);
+
+  std::istringstream badRefresh("trust-anchor\n{\n  type file\n  file-name x.cert\n  refresh 1x\n}\n");
+  BOOST_CHECK_THROW(policy.load(badRefresh, "test.conf"), ndns::ValidationPolicyNdns::Error);
+
+  // everything is accepted with an "any" trust anchor
+  std::istringstream any("trust-anchor\n{\n  type any\n}\n");
+  policy.load(any, "test.conf");
+  BOOST_CHECK(checkPolicy(policy, makeData("/a/b", "/c/KEY/k")));
+}
+
+BOOST_AUTO_TEST_CASE(AnchorRefreshPeriod)
+{
+  auto& policy = static_cast<ndns::ValidationPolicyNdns&>(m_ndnsValidator.getPolicy());
+  // the fixture loads a file trust anchor without refresh
+  BOOST_CHECK(policy.getAnchorRefreshPeriod() == time::nanoseconds::max());
+
+  boost::filesystem::create_directories(UNIT_TESTS_TMPDIR "/anchors-a");
+  boost::filesystem::create_directories(UNIT_TESTS_TMPDIR "/anchors-b");
+  std::istringstream dirs("trust-anchor\n{\n  type dir\n  dir anchors-a\n  refresh 1h\n}\n"
+                          "trust-anchor\n{\n  type dir\n  dir anchors-b\n  refresh 10m\n}\n");
+  policy.load(dirs, UNIT_TESTS_TMPDIR "/test.conf");
+  BOOST_CHECK_EQUAL(policy.getAnchorRefreshPeriod(), 10_min);
+
+  std::istringstream any("trust-anchor\n{\n  type any\n}\n");
+  policy.load(any, "test.conf");
+  BOOST_CHECK(policy.getAnchorRefreshPeriod() == time::nanoseconds::max());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace tests
+} // namespace ndns
+} // namespace ndn
@@ -18,6 +18,7 @@
  */
 
 #include "validator/validator.hpp"
+#include "validator/certificate-fetcher-ndns-cert.hpp"
 #include "ndns-label.hpp"
 #include "daemon/name-server.hpp"
 #include "util/cert-helper.hpp"
@@ -27,6 +28,8 @@
 
 #include <ndn-cxx/util/dummy-client-face.hpp>
 
+#include <algorithm>
+
 namespace ndn {
 namespace ndns {
 namespace tests {
@@ -163,6 +166,116 @@ BOOST_FIXTURE_TEST_CASE(Basic, ValidatorTestFixture)
   BOOST_CHECK_EQUAL(hasValidated, true);
 }
 
+BOOST_FIXTURE_TEST_CASE(ConcurrentFetches, ValidatorTestFixture)
+{
+  auto makeData = [this] (const std::string& label) {
+    auto data = make_shared<Data>(Name(m_ndnsimName).append("NDNS").append(label)
+                                  .append("TXT").appendVersion());
+    m_keyChain.sign(*data, signingByCertificate(m_ndnsimCert));
+    return data;
+  };
+
+  // Interests needed to validate one packet with an empty certificate cache
+  auto validator = NdnsValidatorBuilder::create(m_validatorFace, 500, 0,
+                                                UNIT_TESTS_TMPDIR "/validator.conf");
+  size_t nValidated = 0;
+  validator->validate(*makeData("a"),
+                      [&] (const Data&) { ++nValidated; },
+                      [] (const Data&, const security::ValidationError&) { BOOST_ERROR("failed"); });
+  advanceClocks(10_ms, 100);
+  BOOST_CHECK_EQUAL(nValidated, 1);
+  size_t nInterestsForOne = m_validatorFace.sentInterests.size();
+  BOOST_CHECK_GT(nInterestsForOne, 0);
+
+  // packets signed by the same key share the certificate fetches
+  m_validatorFace.sentInterests.clear();
+  nValidated = 0;
+  for (const auto& label : {"b", "c", "d"}) {
+    m_validator->validate(*makeData(label),
+                          [&] (const Data&) { ++nValidated; },
+                          [] (const Data&, const security::ValidationError&) { BOOST_ERROR("failed"); });
+  }
+  advanceClocks(10_ms, 100);
+  BOOST_CHECK_EQUAL(nValidated, 3);
+  BOOST_CHECK_EQUAL(m_validatorFace.sentInterests.size(), nInterestsForOne);
+}
+
+BOOST_FIXTURE_TEST_CASE(CertificateBundle, ValidatorTestFixture)
+{
+  Name dataName = Name(m_ndnsimName).append("NDNS").append("www").append("TXT").appendVersion();
+  auto data = make_shared<Data>(dataName);
+  m_keyChain.sign(*data, signingByCertificate(m_ndnsimCert));
+
+  auto countCertificateInterests = [&] (bool isBundleEnabled) {
+    auto validator = NdnsValidatorBuilder::create(m_validatorFace, 500, 0,
+                                                  UNIT_TESTS_TMPDIR "/validator.conf");
+    dynamic_cast<CertificateFetcherNdnsCert&>(validator->getFetcher())
+      .setCertificateBundleEnabled(isBundleEnabled);
+
+    m_validatorFace.sentInterests.clear();
+    bool isValidated = false;
+    validator->validate(*data,
+                        [&] (const Data&) { isValidated = true; },
+                        [] (const Data&, const security::ValidationError& error) {
+                          BOOST_ERROR("validation failed: " << error);
+                        });
+    advanceClocks(10_ms, 100);
+    BOOST_CHECK(isValidated);
+    return m_validatorFace.sentInterests.size();
+  };
+
+  // zones without bundles: the fetcher falls back to one query per certificate
+  size_t nInterestsWithoutBundles = countCertificateInterests(false);
+  BOOST_CHECK_GT(countCertificateInterests(true), nInterestsWithoutBundles);
+
+  for (auto& server : m_servers) {
+    server->setCertificateBundleEnabled(true);
+  }
+  BOOST_CHECK_EQUAL(countCertificateInterests(false), nInterestsWithoutBundles);
+  BOOST_CHECK_LT(countCertificateInterests(true), nInterestsWithoutBundles);
+}
+
+BOOST_FIXTURE_TEST_CASE(ZoneWithoutBundle, ValidatorTestFixture)
+{
+  Name dataName = Name(m_ndnsimName).append("NDNS").append("www").append("TXT").appendVersion();
+  auto data = make_shared<Data>(dataName);
+  m_keyChain.sign(*data, signingByCertificate(m_ndnsimCert));
+
+  auto validator = NdnsValidatorBuilder::create(m_validatorFace, 500, 0,
+                                                UNIT_TESTS_TMPDIR "/validator.conf");
+  dynamic_cast<CertificateFetcherNdnsCert&>(validator->getFetcher())
+    .setCertificateBundleEnabled(true);
+
+  auto countBundleInterests = [&] {
+    validator->resetVerifiedCertificates();
+    m_validatorFace.sentInterests.clear();
+    bool isValidated = false;
+    validator->validate(*data,
+                        [&] (const Data&) { isValidated = true; },
+                        [] (const Data&, const security::ValidationError& error) {
+                          BOOST_ERROR("validation failed: " << error);
+                        });
+    advanceClocks(10_ms, 100);
+    BOOST_CHECK(isValidated);
+    return std::count_if(m_validatorFace.sentInterests.begin(),
+                         m_validatorFace.sentInterests.end(),
+                         [] (const Interest& interest) {
+                           return interest.getName().get(-1) == label::BUNDLE_RR_TYPE;
+                         });
+  };
+
+  // the zones do not serve bundles yet
+  BOOST_CHECK_GT(countBundleInterests(), 0);
+  for (auto& server : m_servers) {
+    server->setCertificateBundleEnabled(true);
+  }
+  BOOST_CHECK_EQUAL(countBundleInterests(), 0);
+
+  // the bundles are tried again after a while
+  advanceClocks(1_min, 10);
+  BOOST_CHECK_GT(countBundleInterests(), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace tests
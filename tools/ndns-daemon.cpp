@@ -20,16 +20,23 @@
 #include "logger.hpp"
 #include "daemon/config-file.hpp"
 #include "daemon/name-server.hpp"
+#include "daemon/status-server.hpp"
 #include "util/cert-helper.hpp"
 #include "util/util.hpp"
+#include "validator/certificate-fetcher-ndns-cert.hpp"
+#include "validator/validation-policy-ndns.hpp"
 
 #include <ndn-cxx/face.hpp>
 #include <ndn-cxx/security/key-chain.hpp>
+#include <ndn-cxx/util/scheduler.hpp>
 
 #include <boost/asio/io_service.hpp>
+#include <boost/asio/signal_set.hpp>
 #include <boost/program_options.hpp>
 
+#include <algorithm>
 #include <iostream>
+#include <thread>
 
 NDNS_LOG_INIT(NdnsDaemon);
 
@@ -49,11 +56,25 @@ public:
   NdnsDaemon(const std::string& configFile, Face& face, Face& validatorFace)
     : m_face(face)
     , m_validatorFace(validatorFace)
+    , m_scheduler(face.getIoContext())
+    , m_reloadSignals(face.getIoContext(), SIGHUP)
   {
     NDNS_LOG_INFO("ConfigFile = " << configFile);
     ConfigFile config;
     config.addSectionHandler("zones", bind(&NdnsDaemon::processZonesSection, this, _1));
     config.parse(configFile, false);
+
+    m_statusServer = make_unique<StatusServer>(m_face, m_keyChain);
+    for (const auto& server : m_servers) {
+      m_statusServer->addNameServer(*server);
+    }
+    if (m_validator != nullptr) {
+      // the validator is created with the zones section, a daemon without zones has none
+      m_statusServer->setUpdateVerifier(m_updateVerifier.get());
+      m_statusServer->setValidationCache(&m_validationCache);
+      m_statusServer->setNsCache(
+        dynamic_cast<CertificateFetcherNdnsCert&>(m_validator->getFetcher()).getNsCache());
+    }
   }
 
   void
@@ -77,7 +98,35 @@ public:
       validatorConfigFile = item->second.get_value<std::string>();
     }
     NDNS_LOG_INFO("ValidatorConfigFile = " << validatorConfigFile);
-    m_validator = NdnsValidatorBuilder::create(m_validatorFace, 500, 0, validatorConfigFile);
+    // certificates of the zones in the database are retrieved locally
+    m_validator = NdnsValidatorBuilder::create(m_validatorFace, 500, 0, validatorConfigFile,
+                                               nullptr, m_dbMgr.get());
+    m_validatorConfigFile = validatorConfigFile;
+    m_validationCache.scheduleEpochBumps(m_scheduler,
+                                         getValidationPolicy().getAnchorRefreshPeriod());
+    waitForReloadSignal();
+
+    size_t nVerifierThreads = std::max(1U, std::thread::hardware_concurrency());
+    item = section.find("verifierThreads");
+    if (item != section.not_found()) {
+      nVerifierThreads = item->second.get_value<size_t>();
+    }
+    NDNS_LOG_INFO("VerifierThreads = " << nVerifierThreads);
+    if (nVerifierThreads > 0) {
+      m_updateVerifier = make_unique<UpdateVerifier>(*m_validator, m_face.getIoContext(),
+                                                     nVerifierThreads);
+      m_updateVerifier->setValidationCache(&m_validationCache);
+    }
+
+    item = section.find("queryLog");
+    if (item != section.not_found()) {
+      QueryLog::Options options;
+      options.path = item->second.get_value<std::string>();
+      options.maxFileSize = section.get<size_t>("queryLogMaxFileSize", options.maxFileSize);
+      options.maxFiles = section.get<size_t>("queryLogMaxFiles", options.maxFiles);
+      NDNS_LOG_INFO("QueryLog = " << options.path);
+      m_queryLog = make_unique<QueryLog>(options);
+    }
 
     for (const auto& option : section) {
       Name name;
@@ -118,17 +167,68 @@ public:
         NDNS_LOG_TRACE("name = " << name << " cert = " << cert);
         m_servers.push_back(make_shared<NameServer>(name, cert, m_face, *m_dbMgr,
                                                     m_keyChain, *m_validator));
+        m_servers.back()->setValidationCache(&m_validationCache);
+        m_servers.back()->setUpdateVerifier(m_updateVerifier.get());
+        m_servers.back()->setQueryLog(m_queryLog.get());
+        m_servers.back()->setCertificateBundleEnabled(
+          option.second.get<std::string>("certBundle", "no") == "yes");
+        auto segmentSize = option.second.get<size_t>("segmentSize", DEFAULT_SEGMENT_SIZE);
+        if (segmentSize == 0) {
+          NDN_THROW(Error("segmentSize of zone " + name.toUri() + " must be positive"));
+        }
+        m_servers.back()->setSegmentSize(segmentSize);
+        m_servers.back()->setStageHistogramsEnabled(
+          option.second.get<std::string>("stageHistograms", "no") == "yes");
       }
     } // for
   }
 
+private:
+  ValidationPolicyNdns&
+  getValidationPolicy()
+  {
+    return dynamic_cast<ValidationPolicyNdns&>(m_validator->getPolicy());
+  }
+
+  /**
+   * @brief reload the trust anchors of the validator when SIGHUP is received
+   */
+  void
+  waitForReloadSignal()
+  {
+    m_reloadSignals.async_wait([this] (const boost::system::error_code& error, int) {
+      if (error) {
+        return;
+      }
+      NDNS_LOG_INFO("reload " << m_validatorConfigFile);
+      try {
+        getValidationPolicy().load(m_validatorConfigFile);
+      }
+      catch (const std::exception& e) {
+        NDNS_LOG_ERROR("cannot reload " << m_validatorConfigFile << ": " << e.what());
+      }
+      // results validated with the previous trust anchors must be validated again
+      m_validationCache.bumpEpoch();
+      m_validationCache.scheduleEpochBumps(m_scheduler,
+                                           getValidationPolicy().getAnchorRefreshPeriod());
+      waitForReloadSignal();
+    });
+  }
+
 private:
   Face& m_face;
   Face& m_validatorFace;
+  Scheduler m_scheduler;
+  boost::asio::signal_set m_reloadSignals;
+  std::string m_validatorConfigFile;
   unique_ptr<security::Validator> m_validator;
+  ValidationCache m_validationCache;
+  unique_ptr<UpdateVerifier> m_updateVerifier;
   unique_ptr<DbMgr> m_dbMgr;
+  unique_ptr<QueryLog> m_queryLog;
   std::vector<shared_ptr<NameServer>> m_servers;
   KeyChain m_keyChain;
+  unique_ptr<StatusServer> m_statusServer;
 };
 
 } // namespace ndns
@@ -179,7 +279,7 @@ main(int argc, char* argv[])
     // For now, two faces are used here.
 
     // refs: https://redmine.named-data.net/issues/2206
-    // @TODO enhance validator to get the certificate from the local db if present
+    // Certificates stored in the local database do not need the second face.
 
     ndn::ndns::NdnsDaemon daemon(configFile, face, validatorFace);
     face.processEvents();
@@ -20,8 +20,11 @@
 #include "ndns-label.hpp"
 #include "logger.hpp"
 #include "clients/response.hpp"
+#include "clients/multi-response.hpp"
 #include "clients/query.hpp"
 #include "clients/iterative-query-controller.hpp"
+#include "clients/resolver-cache.hpp"
+#include "validator/certificate-fetcher-ndns-cert.hpp"
 #include "validator/validator.hpp"
 #include "util/util.hpp"
 
@@ -33,6 +36,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <sstream>
 
 NDNS_LOG_INIT(Dig);
 
@@ -43,11 +47,15 @@ class NdnsDig
 {
 public:
   NdnsDig(const Name& dstLabel,
-          const name::Component& rrType, bool shouldValidateIntermediate)
+          const name::Component& rrType, bool shouldValidateIntermediate,
+          const std::string& cacheFile)
     : m_dstLabel(dstLabel)
     , m_rrType(rrType)
     , m_interestLifetime(DEFAULT_INTEREST_LIFETIME)
-    , m_validator(NdnsValidatorBuilder::create(m_face))
+    , m_resolverCache(cacheFile.empty() ? nullptr : make_unique<ResolverCache>(cacheFile))
+    , m_validator(NdnsValidatorBuilder::create(m_face, 500, 0,
+                                               NdnsValidatorBuilder::VALIDATOR_CONF_FILE,
+                                               m_resolverCache.get()))
     , m_shouldValidateIntermediate(shouldValidateIntermediate)
     , m_hasError(false)
   {
@@ -63,6 +71,9 @@ public:
                                       bind(&NdnsDig::onSucceed, this, _1, _2),
                                       bind(&NdnsDig::onFail, this, _1, _2),
                                       m_face, nullptr));
+
+    m_ctr->setTimelineObserver(bind(&NdnsDig::onTimeline, this, _1));
+    m_ctr->setResolverCache(m_resolverCache.get());
   }
 
   void
@@ -97,6 +108,17 @@ public:
   }
 
 private:
+  void
+  onTimeline(const ResolutionTimeline& timeline)
+  {
+    auto breakdown = timeline.getBreakdown();
+    NDNS_LOG_INFO("resolution time: " << breakdown);
+    if (m_shouldPrintTimeline) {
+      std::cout << "; resolution timeline\n" << timeline
+                << "; " << breakdown << std::endl;
+    }
+  }
+
   void
   onSucceed(const Data& data, const Response& response)
   {
@@ -107,6 +129,10 @@ private:
                     << " and NdnsType=" << response.getContentType()
                     << ". It contains " << response.getRrs().size() << " RR(s)");
 
+      if (response.getContentType() == NDNS_MULTI) {
+        printMultiResponse(response);
+      }
+
       std::string msg;
       size_t i = 0;
       for (const auto& rr : response.getRrs()) {
@@ -151,6 +177,26 @@ private:
   }
 
 
+  void
+  printMultiResponse(const Response& response)
+  {
+    try {
+      MultiResponse multi(response);
+      for (const auto& record : multi.getRecords()) {
+        if (record.exists) {
+          std::cout << "; " << record.rrType << " record " << record.data.getName() << std::endl;
+        }
+        else {
+          std::cout << "; " << record.rrType << " does not exist, proven by "
+                    << record.data.getName() << std::endl;
+        }
+      }
+    }
+    catch (const std::exception& e) {
+      NDNS_LOG_WARN("malformed multi-type answer: " << e.what());
+    }
+  }
+
   void
   onFail(uint32_t errCode, const std::string& errMsg)
   {
@@ -193,6 +239,22 @@ public:
     m_dstFile = dstFile;
   }
 
+  void
+  setShouldPrintTimeline(bool shouldPrint)
+  {
+    m_shouldPrintTimeline = shouldPrint;
+  }
+
+  /**
+   * @brief retrieve the certificate chains of zones as bundles, when they are served
+   */
+  void
+  setCertificateBundleEnabled(bool isEnabled)
+  {
+    dynamic_cast<CertificateFetcherNdnsCert&>(m_validator->getFetcher())
+      .setCertificateBundleEnabled(isEnabled);
+  }
+
 private:
   Name m_dstLabel;
   name::Component m_rrType;
@@ -202,12 +264,14 @@ private:
 
   Face m_face;
 
+  unique_ptr<ResolverCache> m_resolverCache;
   unique_ptr<security::Validator> m_validator;
   bool m_shouldValidateIntermediate;
-  std::unique_ptr<QueryController> m_ctr;
+  std::unique_ptr<IterativeQueryController> m_ctr;
 
   bool m_hasError;
   std::string m_dstFile;
+  bool m_shouldPrintTimeline = false;
 };
 
 } // namespace ndns
@@ -224,7 +288,10 @@ main(int argc, char* argv[])
   int ttl = 4;
   string rrType = "TXT";
   string dstFile;
+  string cacheFile;
   bool shouldValidateIntermediate = true;
+  bool shouldPrintTimeline = false;
+  bool shouldUseBundles = false;
   Name start("/ndn");
 
   try {
@@ -237,11 +304,19 @@ main(int argc, char* argv[])
     po::options_description config("Configuration");
     config.add_options()
       ("timeout,T", po::value<int>(&ttl), "query timeout. default: 4 sec")
-      ("rrtype,t", po::value<std::string>(&rrType), "set request RR Type. default: TXT")
+      ("rrtype,t", po::value<std::string>(&rrType), "set request RR Type. default: TXT. "
+       "several comma-separated types, e.g., TXT,APPCERT, are resolved with one query")
       ("dstFile,d", po::value<std::string>(&dstFile), "set output file of the received Data. "
        "if omitted, not print; if set to be -, print to stdout; else print to file")
       ("start,s", po::value<Name>(&start)->default_value("/ndn"), "set first zone to query")
       ("not-validate,n", "trigger not validate intermediate results")
+      ("timeline,l", "print the timeline of the resolution and the time spent in network, "
+       "validation, and cache")
+      ("bundle,b", "fetch the certificate chain of each zone with a single query, "
+       "from zones that serve certificate bundles")
+      ("cache,c", po::value<std::string>(&cacheFile)->implicit_value(""),
+       "use a persistent resolver cache shared with other processes. "
+       "default: $HOME/.ndn/ndns-resolver-cache.db")
       ;
 
     po::options_description hidden("Hidden Options");
@@ -258,7 +333,7 @@ main(int argc, char* argv[])
     config_file_options.add(config).add(hidden);
 
     po::options_description visible("Usage: ndns-dig /name/to/be/resolved [-t rrType] [-T ttl]"
-                                    "[-d dstFile] [-s startZone] [-n]\n"
+                                    "[-d dstFile] [-s startZone] [-n] [-l] [-b] [-c [cacheFile]]\n"
                                     "Allowed options");
 
     visible.add(generic).add(config);
@@ -290,6 +365,13 @@ main(int argc, char* argv[])
       shouldValidateIntermediate = false;
     }
 
+    shouldPrintTimeline = vm.count("timeline") > 0;
+    shouldUseBundles = vm.count("bundle") > 0;
+
+    if (vm.count("cache") && cacheFile.empty()) {
+      cacheFile = ndn::ndns::ResolverCache::getDefaultPath();
+    }
+
     if (ttl < 0) {
       std::cerr << "Error: ttl parameter cannot be negative" << std::endl;
       return 1;
@@ -301,9 +383,22 @@ main(int argc, char* argv[])
   }
 
   try {
-    ndn::ndns::NdnsDig dig(dstLabel, ndn::name::Component(rrType), shouldValidateIntermediate);
+    ndn::name::Component rrTypeComponent(rrType);
+    if (rrType.find(',') != std::string::npos) {
+      // several types, e.g., TXT,APPCERT, are resolved with one multi-type query
+      std::vector<ndn::name::Component> rrTypes;
+      std::istringstream is(rrType);
+      for (std::string type; std::getline(is, type, ',');) {
+        rrTypes.emplace_back(type);
+      }
+      rrTypeComponent = ndn::ndns::label::makeMultiRrType(rrTypes);
+    }
+
+    ndn::ndns::NdnsDig dig(dstLabel, rrTypeComponent, shouldValidateIntermediate, cacheFile);
     dig.setInterestLifetime(ndn::time::seconds(ttl));
     dig.setDstFile(dstFile);
+    dig.setShouldPrintTimeline(shouldPrintTimeline);
+    dig.setCertificateBundleEnabled(shouldUseBundles);
 
     // Due to ndn testbed does not contain the root zone
     // dig here starts from the TLD (Top-level Domain)
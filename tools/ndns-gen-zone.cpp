@@ -0,0 +1,185 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "ndns-label.hpp"
+#include "mgmt/zone-generator.hpp"
+#include "util/util.hpp"
+
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/program_options.hpp>
+
+#include <iostream>
+
+using ndn::ndns::ZoneGenerator;
+
+static std::vector<std::pair<ndn::name::Component, double>>
+parseTypeMix(const std::string& str)
+{
+  std::vector<std::string> items;
+  boost::split(items, str, boost::is_any_of(","));
+  std::vector<std::pair<ndn::name::Component, double>> typeMix;
+  for (const auto& item : items) {
+    auto eq = item.find('=');
+    if (eq == std::string::npos) {
+      typeMix.emplace_back(ndn::name::Component(item), 1.0);
+    }
+    else {
+      typeMix.emplace_back(ndn::name::Component(item.substr(0, eq)),
+                           std::stod(item.substr(eq + 1)));
+    }
+  }
+  return typeMix;
+}
+
+int
+main(int argc, char* argv[])
+{
+  using std::string;
+  using namespace ndn;
+
+  ZoneGenerator::Options options;
+  string zoneStr;
+  string parentStr;
+  string distribution = "uniform";
+  string recordSize = "32-256";
+  string types = "TXT";
+  int cacheTtlInt = -1;
+  string db = ndns::getDefaultDatabaseFile();
+  try {
+    namespace po = boost::program_options;
+    po::variables_map vm;
+
+    po::options_description generic("Generic Options");
+    generic.add_options()
+      ("help,h", "print this help message and exit")
+      ("db,b",   po::value<std::string>(&db)->default_value(db), "path to NDNS database file")
+      ;
+
+    po::options_description config("Zone Options");
+    config.add_options()
+      ("parent,p", po::value<std::string>(&parentStr), "parent zone of the zone to be "
+       "generated. Default: the zone name without its last component")
+      ("cacheTtl,a", po::value<int>(&cacheTtlInt), "ttl of the records. Default: 3600 seconds")
+      ("records,n", po::value<size_t>(&options.nRecords)->default_value(options.nRecords),
+       "number of records of the zone, AUTH and DoE records excluded")
+      ("depth,d", po::value<size_t>(&options.maxDepth)->default_value(options.maxDepth),
+       "maximum number of components of a label")
+      ("fanout,f", po::value<size_t>(&options.fanout)->default_value(options.fanout),
+       "number of values of each intermediate label component")
+      ("distribution", po::value<string>(&distribution)->default_value(distribution),
+       "distribution of the intermediate label components: uniform or zipf")
+      ("zipf-exponent", po::value<double>(&options.zipfExponent)
+                          ->default_value(options.zipfExponent),
+       "exponent of the zipf distribution")
+      ("record-size,s", po::value<string>(&recordSize)->default_value(recordSize),
+       "size of the payload of TXT records in octets, as <size> or <min>-<max>")
+      ("types,t", po::value<string>(&types)->default_value(types),
+       "record types and their weights, e.g., TXT=0.9,NS=0.1")
+      ("child-zones,c", po::value<size_t>(&options.nChildZones)->default_value(0),
+       "number of child zones delegated by each zone")
+      ("zone-levels,l", po::value<size_t>(&options.zoneLevels)->default_value(2),
+       "number of levels of zones, when child zones are generated")
+      ("child-records", po::value<size_t>(&options.nChildRecords)
+                          ->default_value(options.nChildRecords),
+       "number of records of each child zone")
+      ("batch-size", po::value<size_t>(&options.batchSize)->default_value(options.batchSize),
+       "number of records written in one database transaction")
+      ("seed", po::value<uint32_t>(&options.seed)->default_value(options.seed),
+       "seed of the generator")
+      ;
+
+    po::options_description hidden("Hidden Options");
+    hidden.add_options()
+      ("zone", po::value<string>(&zoneStr), "name of the zone to be generated")
+      ;
+
+    po::positional_options_description postion;
+    postion.add("zone", 1);
+
+    po::options_description cmdlineOptions;
+    cmdlineOptions.add(generic).add(config).add(hidden);
+
+    po::options_description visibleOptions;
+    visibleOptions.add(generic).add(config);
+
+    po::parsed_options parsed =
+      po::command_line_parser(argc, argv).options(cmdlineOptions).positional(postion).run();
+
+    po::store(parsed, vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+      std::cout << "Usage: ndns-gen-zone [-b db] zone [-p parent] [-n records] [-d depth] "
+        "[-f fanout] [-s recordSize] [-t types] [-c childZones] [-l zoneLevels]" << std::endl;
+      std::cout << visibleOptions << std::endl;
+      return 0;
+    }
+
+    if (vm.count("zone") == 0) {
+      std::cerr << "Error: zone must be specified" << std::endl;
+      return 1;
+    }
+
+    if (distribution == "uniform") {
+      options.labelDistribution = ZoneGenerator::LabelDistribution::UNIFORM;
+    }
+    else if (distribution == "zipf") {
+      options.labelDistribution = ZoneGenerator::LabelDistribution::ZIPF;
+    }
+    else {
+      std::cerr << "Error: distribution must be uniform or zipf" << std::endl;
+      return 1;
+    }
+
+    auto dash = recordSize.find('-');
+    options.minRecordSize = std::stoul(recordSize.substr(0, dash));
+    options.maxRecordSize = dash == string::npos ? options.minRecordSize :
+                                                   std::stoul(recordSize.substr(dash + 1));
+    options.typeMix = parseTypeMix(types);
+    if (options.nChildZones == 0) {
+      options.zoneLevels = 1;
+    }
+    if (cacheTtlInt != -1) {
+      options.ttl = time::seconds(cacheTtlInt);
+    }
+  }
+  catch (const std::exception& ex) {
+    std::cerr << "Parameter Error: " << ex.what() << std::endl;
+    return 1;
+  }
+
+  try {
+    Name zone(zoneStr);
+    Name parent(parentStr);
+    if (!zone.empty() && parentStr.empty())
+      parent = zone.getPrefix(-1);
+
+    KeyChain keyChain;
+    ZoneGenerator generator(db, keyChain, options);
+    auto summary = generator.generate(zone, parent);
+    std::cout << "Generated " << summary.nZones << " zones with " << summary.nRecords
+              << " records and " << summary.nAuthRecords << " AUTH records in " << db << std::endl;
+  }
+  catch (const std::exception& ex) {
+    std::cerr << "Error: " << ex.what() << std::endl;
+    return 1;
+  }
+}
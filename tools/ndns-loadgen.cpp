@@ -0,0 +1,522 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "ndns-label.hpp"
+#include "ndns-enum.hpp"
+#include "ndns-tlv.hpp"
+#include "logger.hpp"
+#include "clients/query.hpp"
+#include "clients/response.hpp"
+#include "util/cert-helper.hpp"
+#include "util/latency-histogram.hpp"
+
+#include <ndn-cxx/face.hpp>
+#include <ndn-cxx/encoding/block-helpers.hpp>
+#include <ndn-cxx/security/key-chain.hpp>
+#include <ndn-cxx/security/signing-helpers.hpp>
+#include <ndn-cxx/util/scheduler.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+NDNS_LOG_INIT(LoadGen);
+
+namespace ndn {
+namespace ndns {
+
+/**
+ * @brief sends queries and updates to a name server at a fixed rate
+ *
+ * The load is open-loop: Interests are sent on schedule whether or not the previous ones were
+ * answered, so a slow name server does not lower the offered load. Interests that would exceed
+ * the concurrency limit are not sent and are counted as skipped.
+ */
+class NdnsLoadGen : boost::noncopyable
+{
+public:
+  enum class Distribution {
+    UNIFORM, ///< labels of the listing are equally likely
+    ZIPF, ///< the i-th label of the listing has a weight of 1/i^s
+    NONEXISTENT, ///< random labels that do not exist in the zone
+  };
+
+  struct Options
+  {
+    Name zone;
+    std::vector<Name> labels; ///< labels of the zone, relative to the zone
+    Distribution distribution = Distribution::UNIFORM;
+    double zipfExponent = 1.0;
+    name::Component rrType{"TXT"};
+    double rate = 100; ///< Interests per second
+    time::nanoseconds duration = 10_s;
+    size_t concurrency = 1000; ///< maximum number of outstanding Interests
+    time::milliseconds interestLifetime = DEFAULT_INTEREST_LIFETIME;
+    double updateRatio = 0; ///< fraction of the Interests that are updates
+    Name certName; ///< certificate that signs updates
+    uint32_t seed = 1;
+  };
+
+  struct Stats
+  {
+    size_t nSent = 0;
+    size_t nAnswers = 0; ///< Data other than NDNS NACK
+    size_t nNdnsNacks = 0; ///< Data of NDNS NACK content type
+    size_t nRejected = 0; ///< updates answered with a failure return code
+    size_t nNacks = 0; ///< network Nacks
+    size_t nTimeouts = 0;
+    size_t nSkipped = 0; ///< not sent because of the concurrency limit
+    LatencyHistogram latency; ///< time to Data or network Nack
+  };
+
+  explicit
+  NdnsLoadGen(const Options& options)
+    : m_options(options)
+    , m_scheduler(m_face.getIoContext())
+    , m_rng(options.seed)
+  {
+    if (m_options.distribution == Distribution::ZIPF) {
+      std::vector<double> weights(m_options.labels.size());
+      for (size_t i = 0; i < weights.size(); ++i) {
+        weights[i] = 1.0 / std::pow(i + 1, m_options.zipfExponent);
+      }
+      m_zipf = std::discrete_distribution<size_t>(weights.begin(), weights.end());
+    }
+
+    // versions of updates must increase across runs of the generator
+    m_nextVersion = time::toUnixTimestamp(time::system_clock::now()).count() * 1000;
+  }
+
+  void
+  run()
+  {
+    NDNS_LOG_INFO("send " << m_options.rate << " Interests/s to " << m_options.zone
+                  << " for " << time::duration_cast<time::milliseconds>(m_options.duration));
+    m_startTime = time::steady_clock::now();
+    m_lastReport = m_startTime;
+    onTick();
+    m_face.processEvents();
+  }
+
+  const Stats&
+  getQueryStats() const
+  {
+    return m_queries;
+  }
+
+  const Stats&
+  getUpdateStats() const
+  {
+    return m_updates;
+  }
+
+  time::nanoseconds
+  getElapsedTime() const
+  {
+    return m_endTime - m_startTime;
+  }
+
+private:
+  void
+  onTick()
+  {
+    auto now = time::steady_clock::now();
+    auto elapsed = std::min<time::nanoseconds>(now - m_startTime, m_options.duration);
+    auto target = static_cast<size_t>(time::duration_cast<time::duration<double>>(elapsed).count() *
+                                      m_options.rate);
+    while (m_nScheduled < target) {
+      ++m_nScheduled;
+      sendOne();
+    }
+
+    if (now - m_lastReport >= 1_s) {
+      m_lastReport = now;
+      std::cerr << time::duration_cast<time::seconds>(elapsed).count() << "s: sent="
+                << m_queries.nSent + m_updates.nSent << " outstanding=" << m_nOutstanding
+                << " skipped=" << m_queries.nSkipped + m_updates.nSkipped << std::endl;
+    }
+
+    if (elapsed < m_options.duration) {
+      m_tickEvent = m_scheduler.schedule(1_ms, [this] { onTick(); });
+    }
+    else {
+      m_isSending = false;
+      checkFinished();
+    }
+  }
+
+  void
+  sendOne()
+  {
+    bool isUpdate = m_options.updateRatio > 0 &&
+                    std::bernoulli_distribution(m_options.updateRatio)(m_rng);
+    Stats& stats = isUpdate ? m_updates : m_queries;
+    if (m_nOutstanding >= m_options.concurrency) {
+      ++stats.nSkipped;
+      return;
+    }
+
+    Name label = pickLabel();
+    Interest interest = isUpdate ? makeUpdateInterest(label) : makeQueryInterest(label);
+    NDNS_LOG_TRACE("send " << interest.getName());
+
+    ++stats.nSent;
+    ++m_nOutstanding;
+    auto sendTime = time::steady_clock::now();
+    m_face.expressInterest(interest,
+      [this, &stats, sendTime, isUpdate] (const Interest&, const Data& data) {
+        stats.latency.add(time::steady_clock::now() - sendTime);
+        if (data.getContentType() == NDNS_NACK) {
+          ++stats.nNdnsNacks;
+        }
+        else if (isUpdate && getUpdateReturnCode(data) != UPDATE_OK) {
+          ++stats.nRejected;
+        }
+        else {
+          ++stats.nAnswers;
+        }
+        onCompleted();
+      },
+      [this, &stats, sendTime] (const Interest&, const lp::Nack& nack) {
+        NDNS_LOG_DEBUG("Nack " << nack.getReason());
+        stats.latency.add(time::steady_clock::now() - sendTime);
+        ++stats.nNacks;
+        onCompleted();
+      },
+      [this, &stats] (const Interest&) {
+        ++stats.nTimeouts;
+        onCompleted();
+      });
+  }
+
+  Name
+  pickLabel()
+  {
+    switch (m_options.distribution) {
+      case Distribution::UNIFORM:
+        return m_options.labels[std::uniform_int_distribution<size_t>(
+                                  0, m_options.labels.size() - 1)(m_rng)];
+      case Distribution::ZIPF:
+        return m_options.labels[m_zipf(m_rng)];
+      case Distribution::NONEXISTENT:
+      default:
+        return Name().append("nx-" + to_string(m_rng()));
+    }
+  }
+
+  Interest
+  makeQueryInterest(const Name& label) const
+  {
+    Query query(m_options.zone, label::NDNS_ITERATIVE_QUERY);
+    query.setRrLabel(label);
+    query.setRrType(m_options.rrType);
+    query.setInterestLifetime(m_options.interestLifetime);
+    return query.toInterest();
+  }
+
+  /**
+   * @brief make an update that replaces the TXT record of @p label, as ndns-update does
+   */
+  Interest
+  makeUpdateInterest(const Name& label)
+  {
+    Response response;
+    response.setZone(m_options.zone);
+    response.setRrLabel(label);
+    response.setQueryType(label::NDNS_ITERATIVE_QUERY);
+    response.setRrType(label::TXT_RR_TYPE);
+    response.setContentType(NDNS_RESP);
+    response.setVersion(name::Component::fromVersion(m_nextVersion++));
+    response.addRr(makeStringBlock(tlv::RrData, "loadgen " + to_string(m_nextVersion)));
+    shared_ptr<Data> update = response.toData();
+    m_keyChain.sign(*update, security::signingByCertificate(m_options.certName));
+
+    Query query(m_options.zone, label::NDNS_ITERATIVE_QUERY);
+    query.setRrLabel(Name().append(ndn::tlv::GenericNameComponent, update->wireEncode()));
+    query.setRrType(label::NDNS_UPDATE_LABEL);
+    query.setInterestLifetime(m_options.interestLifetime);
+    return query.toInterest();
+  }
+
+  static int
+  getUpdateReturnCode(const Data& data)
+  {
+    try {
+      Block content = data.getContent();
+      content.parse();
+      Block block = content.blockFromValue();
+      block.parse();
+      auto code = block.find(tlv::UpdateReturnCode);
+      if (code != block.elements_end()) {
+        return static_cast<int>(readNonNegativeInteger(*code));
+      }
+    }
+    catch (const ndn::tlv::Error& e) {
+      NDNS_LOG_DEBUG("malformed update response " << data.getName() << ": " << e.what());
+    }
+    return -1;
+  }
+
+  void
+  onCompleted()
+  {
+    --m_nOutstanding;
+    checkFinished();
+  }
+
+  void
+  checkFinished()
+  {
+    if (!m_isSending && m_nOutstanding == 0) {
+      m_endTime = time::steady_clock::now();
+      m_face.getIoContext().stop();
+    }
+  }
+
+private:
+  const Options m_options;
+  Face m_face;
+  Scheduler m_scheduler;
+  KeyChain m_keyChain;
+  std::mt19937 m_rng;
+  std::discrete_distribution<size_t> m_zipf;
+  uint64_t m_nextVersion = 0;
+
+  time::steady_clock::time_point m_startTime;
+  time::steady_clock::time_point m_endTime;
+  time::steady_clock::time_point m_lastReport;
+  scheduler::ScopedEventId m_tickEvent;
+  size_t m_nScheduled = 0;
+  size_t m_nOutstanding = 0;
+  bool m_isSending = true;
+
+  Stats m_queries;
+  Stats m_updates;
+};
+
+static void
+printStats(const std::string& title, const NdnsLoadGen::Stats& stats, time::nanoseconds elapsed,
+           bool shouldPrintBuckets)
+{
+  if (stats.nSent + stats.nSkipped == 0) {
+    return;
+  }
+
+  double seconds = time::duration_cast<time::duration<double>>(elapsed).count();
+  size_t nCompleted = stats.nAnswers + stats.nNdnsNacks + stats.nRejected;
+  std::cout << title << ": sent=" << stats.nSent
+            << " answers=" << stats.nAnswers
+            << " ndnsNacks=" << stats.nNdnsNacks;
+  if (stats.nRejected > 0) {
+    std::cout << " rejected=" << stats.nRejected;
+  }
+  std::cout << " nacks=" << stats.nNacks
+            << " timeouts=" << stats.nTimeouts
+            << " skipped=" << stats.nSkipped << "\n"
+            << "  throughput=" << (seconds > 0 ? nCompleted / seconds : 0) << " responses/s\n"
+            << "  " << stats.latency << std::endl;
+  if (shouldPrintBuckets) {
+    stats.latency.printBuckets(std::cout);
+  }
+}
+
+/**
+ * @brief read the labels listed in @p file
+ *
+ * Each line starting with a label, e.g., /www, contributes its label, so that both plain lists
+ * and the output of ndns-list-zone are accepted. Comments and continuation lines are ignored.
+ */
+static std::vector<Name>
+loadLabels(const std::string& file)
+{
+  std::ifstream is(file);
+  if (!is) {
+    NDN_THROW(std::runtime_error("cannot open " + file));
+  }
+
+  std::vector<Name> labels;
+  for (std::string line; std::getline(is, line);) {
+    if (line.empty() || line[0] != '/') {
+      continue;
+    }
+    Name label(line.substr(0, line.find_first_of(" \t")));
+    if (labels.empty() || labels.back() != label) {
+      labels.push_back(std::move(label));
+    }
+  }
+  return labels;
+}
+
+} // namespace ndns
+} // namespace ndn
+
+int
+main(int argc, char* argv[])
+{
+  using std::string;
+  using namespace ndn;
+  using ndn::ndns::NdnsLoadGen;
+
+  NdnsLoadGen::Options options;
+  string zoneStr;
+  string namesFile;
+  string distribution = "uniform";
+  string rrType = "TXT";
+  double duration = 10;
+  int lifetime = static_cast<int>(options.interestLifetime.count());
+  bool shouldPrintBuckets = false;
+  try {
+    namespace po = boost::program_options;
+    po::variables_map vm;
+
+    po::options_description generic("Generic Options");
+    generic.add_options()("help,h", "print help message");
+
+    po::options_description config("Load Options");
+    config.add_options()
+      ("names,f", po::value<string>(&namesFile), "file listing the labels of the zone to query, "
+       "one label relative to the zone per line, e.g., the output of ndns-list-zone")
+      ("distribution,D", po::value<string>(&distribution)->default_value(distribution),
+       "distribution of the queried labels: uniform or zipf over the listed labels, or "
+       "nonexistent for random labels that are absent from the zone")
+      ("zipf-exponent", po::value<double>(&options.zipfExponent)
+                          ->default_value(options.zipfExponent),
+       "exponent of the zipf distribution; labels listed first are the most popular")
+      ("rrtype,t", po::value<string>(&rrType)->default_value(rrType), "queried RR type")
+      ("rate,r", po::value<double>(&options.rate)->default_value(options.rate),
+       "Interests sent per second")
+      ("duration,d", po::value<double>(&duration)->default_value(duration),
+       "duration of the load in seconds")
+      ("concurrency,c", po::value<size_t>(&options.concurrency)
+                          ->default_value(options.concurrency),
+       "maximum number of outstanding Interests; Interests beyond it are skipped")
+      ("lifetime,l", po::value<int>(&lifetime)->default_value(lifetime),
+       "Interest lifetime in milliseconds")
+      ("update-ratio,u", po::value<double>(&options.updateRatio)->default_value(0),
+       "fraction of the Interests that update the TXT record of the picked label")
+      ("cert", po::value<Name>(&options.certName), "certificate that signs updates. "
+       "Default: the default certificate of the zone's DSK identity")
+      ("seed", po::value<uint32_t>(&options.seed)->default_value(options.seed),
+       "seed of the label and update choices")
+      ("histogram", "print the latency histogram")
+      ;
+
+    po::options_description hidden("Hidden Options");
+    hidden.add_options()
+      ("zone", po::value<string>(&zoneStr), "zone served by the name server under load")
+      ;
+    po::positional_options_description postion;
+    postion.add("zone", 1);
+
+    po::options_description cmdlineOptions;
+    cmdlineOptions.add(generic).add(config).add(hidden);
+
+    po::options_description visible("Usage: ndns-loadgen zone [-f namesFile] [-D distribution] "
+                                    "[-r rate] [-d duration] [-c concurrency] [-l lifetime] "
+                                    "[-u updateRatio]\nAllowed options");
+    visible.add(generic).add(config);
+
+    po::parsed_options parsed =
+      po::command_line_parser(argc, argv).options(cmdlineOptions).positional(postion).run();
+
+    po::store(parsed, vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+      std::cout << visible << std::endl;
+      return 0;
+    }
+
+    if (vm.count("zone") == 0) {
+      std::cerr << "Error: zone must be specified" << std::endl;
+      return 1;
+    }
+    options.zone = Name(zoneStr);
+
+    if (distribution == "uniform") {
+      options.distribution = NdnsLoadGen::Distribution::UNIFORM;
+    }
+    else if (distribution == "zipf") {
+      options.distribution = NdnsLoadGen::Distribution::ZIPF;
+    }
+    else if (distribution == "nonexistent") {
+      options.distribution = NdnsLoadGen::Distribution::NONEXISTENT;
+    }
+    else {
+      std::cerr << "Error: distribution must be uniform, zipf, or nonexistent" << std::endl;
+      return 1;
+    }
+
+    if (options.distribution != NdnsLoadGen::Distribution::NONEXISTENT) {
+      if (namesFile.empty()) {
+        std::cerr << "Error: -f namesFile is required by the " << distribution
+                  << " distribution" << std::endl;
+        return 1;
+      }
+      options.labels = ndns::loadLabels(namesFile);
+      if (options.labels.empty()) {
+        std::cerr << "Error: " << namesFile << " does not list any label" << std::endl;
+        return 1;
+      }
+    }
+
+    if (options.rate <= 0 || duration <= 0 || options.concurrency == 0 || lifetime <= 0) {
+      std::cerr << "Error: rate, duration, concurrency, and lifetime must be positive"
+                << std::endl;
+      return 1;
+    }
+    if (options.updateRatio < 0 || options.updateRatio > 1) {
+      std::cerr << "Error: update ratio must be between 0 and 1" << std::endl;
+      return 1;
+    }
+    options.rrType = name::Component(rrType);
+    options.duration = time::duration_cast<time::nanoseconds>(time::duration<double>(duration));
+    options.interestLifetime = time::milliseconds(lifetime);
+    shouldPrintBuckets = vm.count("histogram") > 0;
+  }
+  catch (const std::exception& ex) {
+    std::cerr << "Parameter Error: " << ex.what() << std::endl;
+    return 1;
+  }
+
+  try {
+    if (options.updateRatio > 0 && options.certName.empty()) {
+      KeyChain keyChain;
+      Name zoneIdentity = Name(options.zone).append(ndns::label::NDNS_ITERATIVE_QUERY);
+      options.certName = ndns::CertHelper::getDefaultCertificateNameOfIdentity(keyChain,
+                                                                              zoneIdentity);
+    }
+
+    NdnsLoadGen loadGen(options);
+    loadGen.run();
+
+    ndns::printStats("queries", loadGen.getQueryStats(), loadGen.getElapsedTime(),
+                     shouldPrintBuckets);
+    ndns::printStats("updates", loadGen.getUpdateStats(), loadGen.getElapsedTime(),
+                     shouldPrintBuckets);
+  }
+  catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+}
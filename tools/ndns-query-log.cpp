@@ -0,0 +1,136 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "daemon/query-log.hpp"
+
+#include <boost/program_options.hpp>
+
+#include <iostream>
+
+using ndn::ndns::QueryLog;
+using ndn::ndns::QueryLogEntry;
+
+static std::string
+quoteCsv(const std::string& field)
+{
+  if (field.find_first_of(",\"\n") == std::string::npos) {
+    return field;
+  }
+  std::string quoted = "\"";
+  for (char c : field) {
+    quoted += c == '"' ? std::string("\"\"") : std::string(1, c);
+  }
+  return quoted + "\"";
+}
+
+static void
+printText(const QueryLogEntry& entry)
+{
+  std::cout << ndn::time::toIsoExtendedString(entry.getTimestamp())
+            << " " << toString(QueryLogEntry::Kind(entry.kind))
+            << " " << entry.getZone()
+            << " " << entry.getLabel()
+            << " " << entry.getRrType()
+            << " " << toString(QueryLogEntry::Outcome(entry.outcome))
+            << " " << entry.latency / 1000 << "us"
+            << ((entry.flags & QueryLogEntry::TRUNCATED) != 0 ? " truncated" : "") << "\n";
+}
+
+static void
+printCsv(const QueryLogEntry& entry)
+{
+  std::cout << entry.timestamp
+            << "," << toString(QueryLogEntry::Kind(entry.kind))
+            << "," << quoteCsv(entry.getZone().toUri())
+            << "," << quoteCsv(entry.getLabel().toUri())
+            << "," << quoteCsv(entry.getRrType().toUri())
+            << "," << toString(QueryLogEntry::Outcome(entry.outcome))
+            << "," << entry.latency
+            << "," << ((entry.flags & QueryLogEntry::TRUNCATED) != 0) << "\n";
+}
+
+int
+main(int argc, char* argv[])
+{
+  std::string format = "text";
+  std::vector<std::string> files;
+
+  namespace po = boost::program_options;
+  po::options_description visible("Usage: ndns-query-log [-f text|csv] file...\n"
+                                  "Print the entries of query logs written by ndns-daemon\n"
+                                  "Options");
+  visible.add_options()
+    ("help,h", "print this help message and exit")
+    ("format,f", po::value<std::string>(&format)->default_value(format),
+     "output format: text, or csv with a header line")
+    ;
+
+  po::options_description hidden;
+  hidden.add_options()
+    ("file", po::value<std::vector<std::string>>(&files), "query log files")
+    ;
+  po::positional_options_description positional;
+  positional.add("file", -1);
+
+  po::options_description options;
+  options.add(visible).add(hidden);
+
+  try {
+    po::variables_map vm;
+    po::store(po::command_line_parser(argc, argv).options(options).positional(positional).run(),
+              vm);
+    po::notify(vm);
+
+    if (vm.count("help") > 0) {
+      std::cout << visible << std::endl;
+      return 0;
+    }
+    if (files.empty()) {
+      std::cerr << "Error: no query log file is given" << std::endl;
+      return 1;
+    }
+    if (format != "text" && format != "csv") {
+      std::cerr << "Error: format must be text or csv" << std::endl;
+      return 1;
+    }
+  }
+  catch (const std::exception& e) {
+    std::cerr << "Parameter Error: " << e.what() << std::endl;
+    return 1;
+  }
+
+  auto print = format == "csv" ? &printCsv : &printText;
+  if (format == "csv") {
+    std::cout << "timestamp_ns,kind,zone,label,rrtype,outcome,latency_ns,truncated\n";
+  }
+
+  int ret = 0;
+  for (const auto& file : files) {
+    try {
+      QueryLog::readFile(file, print);
+    }
+    catch (const std::exception& e) {
+      std::cerr << "Error: " << e.what() << std::endl;
+      ret = 1;
+    }
+  }
+  std::cout.flush();
+  return ret;
+}
@@ -0,0 +1,371 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "ndns-label.hpp"
+#include "ndns-enum.hpp"
+#include "logger.hpp"
+#include "clients/query.hpp"
+#include "util/latency-histogram.hpp"
+#include "util/query-trace.hpp"
+
+#include <ndn-cxx/face.hpp>
+#include <ndn-cxx/util/scheduler.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <iostream>
+
+NDNS_LOG_INIT(Replay);
+
+namespace ndn {
+namespace ndns {
+
+/**
+ * @brief sends the queries of a trace to name servers, with their original timing
+ *
+ * In timed mode, the i-th query is sent when the time elapsed since the start of the replay
+ * reaches the time between the first and the i-th query of the trace, divided by the speed
+ * factor. As in ndns-loadgen, the replay is open-loop and queries that would exceed the
+ * concurrency limit are skipped. Otherwise, queries are sent as fast as the concurrency limit
+ * allows.
+ */
+class NdnsReplay : boost::noncopyable
+{
+public:
+  struct Options
+  {
+    double speed = 1; ///< speed factor of the timed mode, 0 to send as fast as possible
+    size_t concurrency = 1000; ///< maximum number of outstanding Interests
+    time::milliseconds interestLifetime = DEFAULT_INTEREST_LIFETIME;
+  };
+
+  struct Stats
+  {
+    size_t nSent = 0;
+    size_t nTimeouts = 0;
+    size_t nSkipped = 0; ///< not sent because of the concurrency limit
+    LatencyHistogram answers; ///< latency of Data other than NDNS NACK
+    LatencyHistogram ndnsNacks; ///< latency of Data of NDNS NACK content type
+    LatencyHistogram nacks; ///< latency of network Nacks
+    LatencyHistogram lag; ///< delay between the scheduled and the actual sending of queries
+  };
+
+  NdnsReplay(const std::vector<TracedQuery>& queries, const Options& options)
+    : m_queries(queries)
+    , m_options(options)
+    , m_scheduler(m_face.getIoContext())
+  {
+    BOOST_ASSERT(!m_queries.empty());
+  }
+
+  void
+  run()
+  {
+    NDNS_LOG_INFO("replay " << m_queries.size() << " queries");
+    m_startTime = time::steady_clock::now();
+    m_lastReport = m_startTime;
+    if (m_options.speed > 0) {
+      onTick();
+    }
+    else {
+      fillWindow();
+    }
+    m_face.processEvents();
+  }
+
+  const Stats&
+  getStats() const
+  {
+    return m_stats;
+  }
+
+  time::nanoseconds
+  getElapsedTime() const
+  {
+    return m_endTime - m_startTime;
+  }
+
+private:
+  time::nanoseconds
+  getScheduledTime(size_t index) const
+  {
+    auto offset = m_queries[index].timestamp - m_queries.front().timestamp;
+    return time::nanoseconds(static_cast<time::nanoseconds::rep>(offset / m_options.speed));
+  }
+
+  void
+  onTick()
+  {
+    auto now = time::steady_clock::now();
+    time::nanoseconds elapsed = now - m_startTime;
+    while (m_next < m_queries.size() && getScheduledTime(m_next) <= elapsed) {
+      m_stats.lag.add(elapsed - getScheduledTime(m_next));
+      if (m_nOutstanding < m_options.concurrency) {
+        sendQuery(m_queries[m_next]);
+      }
+      else {
+        ++m_stats.nSkipped;
+      }
+      ++m_next;
+    }
+    report(now);
+
+    if (m_next < m_queries.size()) {
+      // sleep until the next query, waking up every second to report the progress
+      auto delay = std::min<time::nanoseconds>(getScheduledTime(m_next) - elapsed, 1_s);
+      m_tickEvent = m_scheduler.schedule(delay, [this] { onTick(); });
+    }
+    else {
+      m_isSending = false;
+      checkFinished();
+    }
+  }
+
+  void
+  fillWindow()
+  {
+    while (m_nOutstanding < m_options.concurrency && m_next < m_queries.size()) {
+      sendQuery(m_queries[m_next++]);
+    }
+    report(time::steady_clock::now());
+    if (m_next == m_queries.size()) {
+      m_isSending = false;
+    }
+  }
+
+  void
+  report(time::steady_clock::time_point now)
+  {
+    if (now - m_lastReport < 1_s) {
+      return;
+    }
+    m_lastReport = now;
+    std::cerr << time::duration_cast<time::seconds>(now - m_startTime).count() << "s: sent="
+              << m_stats.nSent << "/" << m_queries.size() << " outstanding=" << m_nOutstanding
+              << " skipped=" << m_stats.nSkipped << std::endl;
+  }
+
+  void
+  sendQuery(const TracedQuery& tracedQuery)
+  {
+    Query query(tracedQuery.zone, label::NDNS_ITERATIVE_QUERY);
+    query.setRrLabel(tracedQuery.label);
+    query.setRrType(tracedQuery.rrType);
+    query.setInterestLifetime(m_options.interestLifetime);
+    Interest interest = query.toInterest();
+    NDNS_LOG_TRACE("send " << interest.getName());
+
+    ++m_stats.nSent;
+    ++m_nOutstanding;
+    auto sendTime = time::steady_clock::now();
+    m_face.expressInterest(interest,
+      [this, sendTime] (const Interest&, const Data& data) {
+        auto& histogram = data.getContentType() == NDNS_NACK ? m_stats.ndnsNacks : m_stats.answers;
+        histogram.add(time::steady_clock::now() - sendTime);
+        onCompleted();
+      },
+      [this, sendTime] (const Interest&, const lp::Nack& nack) {
+        NDNS_LOG_DEBUG("Nack " << nack.getReason());
+        m_stats.nacks.add(time::steady_clock::now() - sendTime);
+        onCompleted();
+      },
+      [this] (const Interest&) {
+        ++m_stats.nTimeouts;
+        onCompleted();
+      });
+  }
+
+  void
+  onCompleted()
+  {
+    --m_nOutstanding;
+    if (m_options.speed <= 0 && m_isSending) {
+      fillWindow();
+    }
+    checkFinished();
+  }
+
+  void
+  checkFinished()
+  {
+    if (!m_isSending && m_nOutstanding == 0) {
+      m_endTime = time::steady_clock::now();
+      m_face.getIoContext().stop();
+    }
+  }
+
+private:
+  const std::vector<TracedQuery>& m_queries;
+  const Options m_options;
+  Face m_face;
+  Scheduler m_scheduler;
+
+  time::steady_clock::time_point m_startTime;
+  time::steady_clock::time_point m_endTime;
+  time::steady_clock::time_point m_lastReport;
+  scheduler::ScopedEventId m_tickEvent;
+  size_t m_next = 0;
+  size_t m_nOutstanding = 0;
+  bool m_isSending = true;
+
+  Stats m_stats;
+};
+
+static void
+printHistogram(const std::string& title, const LatencyHistogram& histogram,
+               bool shouldPrintBuckets)
+{
+  if (histogram.getCount() == 0) {
+    return;
+  }
+  std::cout << title << ": " << histogram << std::endl;
+  if (shouldPrintBuckets) {
+    histogram.printBuckets(std::cout);
+  }
+}
+
+} // namespace ndns
+} // namespace ndn
+
+int
+main(int argc, char* argv[])
+{
+  using std::string;
+  using namespace ndn;
+  using ndn::ndns::NdnsReplay;
+
+  NdnsReplay::Options options;
+  string zoneStr;
+  std::vector<string> files;
+  int lifetime = static_cast<int>(options.interestLifetime.count());
+  bool shouldPrintBuckets = false;
+  try {
+    namespace po = boost::program_options;
+    po::variables_map vm;
+
+    po::options_description generic("Generic Options");
+    generic.add_options()("help,h", "print help message");
+
+    po::options_description config("Replay Options");
+    config.add_options()
+      ("zone,z", po::value<string>(&zoneStr), "replay only the queries for this zone; "
+       "names of text traces that lack the NDNS component are relative to it")
+      ("speed,s", po::value<double>(&options.speed)->default_value(options.speed),
+       "speed factor of the replay, e.g., 2 halves the time between queries")
+      ("fast,a", "send queries as fast as the concurrency limit allows, ignoring their timing")
+      ("concurrency,c", po::value<size_t>(&options.concurrency)
+                          ->default_value(options.concurrency),
+       "maximum number of outstanding Interests; in timed mode, queries beyond it are skipped")
+      ("lifetime,l", po::value<int>(&lifetime)->default_value(lifetime),
+       "Interest lifetime in milliseconds")
+      ("histogram", "print the latency histograms")
+      ;
+
+    po::options_description hidden("Hidden Options");
+    hidden.add_options()
+      ("file", po::value<std::vector<string>>(&files), "query logs or text traces")
+      ;
+    po::positional_options_description postion;
+    postion.add("file", -1);
+
+    po::options_description cmdlineOptions;
+    cmdlineOptions.add(generic).add(config).add(hidden);
+
+    po::options_description visible("Usage: ndns-replay [-z zone] [-s speed | -a] "
+                                    "[-c concurrency] [-l lifetime] file...\n"
+                                    "Replay query logs written by ndns-daemon, or text traces "
+                                    "with one 'timestamp name rrType' per line\n"
+                                    "Allowed options");
+    visible.add(generic).add(config);
+
+    po::parsed_options parsed =
+      po::command_line_parser(argc, argv).options(cmdlineOptions).positional(postion).run();
+
+    po::store(parsed, vm);
+    po::notify(vm);
+
+    if (vm.count("help")) {
+      std::cout << visible << std::endl;
+      return 0;
+    }
+
+    if (files.empty()) {
+      std::cerr << "Error: no trace file is given" << std::endl;
+      return 1;
+    }
+    if (vm.count("fast") > 0) {
+      options.speed = 0;
+    }
+    else if (options.speed <= 0) {
+      std::cerr << "Error: speed must be positive" << std::endl;
+      return 1;
+    }
+    if (options.concurrency == 0 || lifetime <= 0) {
+      std::cerr << "Error: concurrency and lifetime must be positive" << std::endl;
+      return 1;
+    }
+    options.interestLifetime = time::milliseconds(lifetime);
+    shouldPrintBuckets = vm.count("histogram") > 0;
+  }
+  catch (const std::exception& ex) {
+    std::cerr << "Parameter Error: " << ex.what() << std::endl;
+    return 1;
+  }
+
+  try {
+    ndns::QueryTrace trace{Name(zoneStr)};
+    for (const auto& file : files) {
+      trace.addFile(file);
+    }
+    if (trace.getQueries().empty()) {
+      std::cerr << "Error: the traces have no query to replay" << std::endl;
+      return 1;
+    }
+    std::cout << "trace: queries=" << trace.getQueries().size()
+              << " skipped=" << trace.getNSkipped()
+              << " duration=" << time::duration_cast<time::milliseconds>(trace.getDuration())
+              << std::endl;
+
+    NdnsReplay replay(trace.getQueries(), options);
+    replay.run();
+
+    const auto& stats = replay.getStats();
+    double seconds = time::duration_cast<time::duration<double>>(replay.getElapsedTime()).count();
+    size_t nResponses = stats.answers.getCount() + stats.ndnsNacks.getCount();
+    std::cout << "replay: sent=" << stats.nSent
+              << " answers=" << stats.answers.getCount()
+              << " ndnsNacks=" << stats.ndnsNacks.getCount()
+              << " nacks=" << stats.nacks.getCount()
+              << " timeouts=" << stats.nTimeouts
+              << " skipped=" << stats.nSkipped
+              << " elapsed=" << time::duration_cast<time::milliseconds>(replay.getElapsedTime())
+              << "\n"
+              << "  throughput=" << (seconds > 0 ? nResponses / seconds : 0) << " responses/s"
+              << std::endl;
+    ndns::printHistogram("answers", stats.answers, shouldPrintBuckets);
+    ndns::printHistogram("ndnsNacks", stats.ndnsNacks, shouldPrintBuckets);
+    ndns::printHistogram("nacks", stats.nacks, shouldPrintBuckets);
+    ndns::printHistogram("lag", stats.lag, false);
+  }
+  catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+}
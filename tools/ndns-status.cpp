@@ -0,0 +1,158 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2014-2024, Regents of the University of California.
+ *
+ * This file is part of NDNS (Named Data Networking Domain Name Service).
+ * See AUTHORS.md for complete list of NDNS authors and contributors.
+ *
+ * NDNS is free software: you can redistribute it and/or modify it under the terms
+ * of the GNU General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * NDNS is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * NDNS, e.g., in COPYING.md file.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "daemon/stage-histograms.hpp"
+#include "daemon/status-server.hpp"
+#include "daemon/zone-status.hpp"
+
+#include <ndn-cxx/face.hpp>
+#include <ndn-cxx/security/validator-null.hpp>
+#include <ndn-cxx/util/segment-fetcher.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <iostream>
+#include <set>
+
+int
+main(int argc, char* argv[])
+{
+  using namespace ndn;
+
+  std::vector<std::string> zoneStrs;
+  int lifetime = 1000;
+  bool shouldPrintStages = false;
+  bool shouldPrintValidator = false;
+
+  namespace po = boost::program_options;
+  po::options_description visible("Usage: ndns-status [-s | -v] [-l lifetime] [zone...]\n"
+                                  "Print the counters of the zones served by the local "
+                                  "ndns-daemon, or of the given zones only\n"
+                                  "Options");
+  visible.add_options()
+    ("help,h", "print this help message and exit")
+    ("stages,s", po::bool_switch(&shouldPrintStages),
+     "print the latency of each stage of query and update handling instead, for the zones "
+     "with stageHistograms enabled")
+    ("validator,v", po::bool_switch(&shouldPrintValidator),
+     "print the counters shared by all zones, about the validation of updates, instead")
+    ("lifetime,l", po::value<int>(&lifetime)->default_value(lifetime),
+     "Interest lifetime in milliseconds")
+    ;
+
+  po::options_description hidden;
+  hidden.add_options()
+    ("zone", po::value<std::vector<std::string>>(&zoneStrs), "zones to print")
+    ;
+  po::positional_options_description positional;
+  positional.add("zone", -1);
+
+  po::options_description options;
+  options.add(visible).add(hidden);
+
+  try {
+    po::variables_map vm;
+    po::store(po::command_line_parser(argc, argv).options(options).positional(positional).run(),
+              vm);
+    po::notify(vm);
+
+    if (vm.count("help") > 0) {
+      std::cout << visible << std::endl;
+      return 0;
+    }
+    if (shouldPrintStages && shouldPrintValidator) {
+      std::cerr << "Error: --stages and --validator cannot be used together" << std::endl;
+      return 1;
+    }
+    if (lifetime <= 0) {
+      std::cerr << "Error: lifetime must be positive" << std::endl;
+      return 1;
+    }
+  }
+  catch (const std::exception& e) {
+    std::cerr << "Parameter Error: " << e.what() << std::endl;
+    return 1;
+  }
+
+  std::set<Name> zones(zoneStrs.begin(), zoneStrs.end());
+  Name datasetName(ndns::StatusServer::DEFAULT_PREFIX);
+  if (shouldPrintValidator) {
+    datasetName.append("validator");
+  }
+  else {
+    datasetName.append("zones").append(shouldPrintStages ? "stages" : "list");
+  }
+  Interest interest(datasetName);
+  interest.setCanBePrefix(true);
+  interest.setMustBeFresh(true);
+  interest.setInterestLifetime(time::milliseconds(lifetime));
+
+  int ret = 0;
+  try {
+    Face face;
+    // the dataset is published under a /localhost prefix, only by a daemon on this host
+    auto fetcher = SegmentFetcher::start(face, interest, security::getAcceptAllValidator());
+    fetcher->onComplete.connect([&] (const ConstBufferPtr& content) {
+      size_t nPrinted = 0;
+      for (size_t offset = 0; offset < content->size();) {
+        auto [isOk, block] = Block::fromBuffer(make_span(*content).subspan(offset));
+        if (!isOk) {
+          std::cerr << "Error: malformed status dataset" << std::endl;
+          ret = 1;
+          return;
+        }
+        offset += block.size();
+
+        if (shouldPrintValidator) {
+          std::cout << ndns::ValidatorStatus(block);
+        }
+        else if (shouldPrintStages) {
+          ndns::ZoneStageStatus status(block);
+          if (zones.empty() || zones.count(status.zone) > 0) {
+            std::cout << status;
+            ++nPrinted;
+          }
+        }
+        else {
+          ndns::ZoneStatus status(block);
+          if (zones.empty() || zones.count(status.zone) > 0) {
+            std::cout << status;
+            ++nPrinted;
+          }
+        }
+      }
+      if (!shouldPrintValidator && nPrinted < zones.size()) {
+        std::cerr << "Error: some zones are not served by ndns-daemon"
+                  << (shouldPrintStages ? " or do not have stage histograms" : "") << std::endl;
+        ret = 1;
+      }
+    });
+    fetcher->onError.connect([&] (uint32_t, const std::string& msg) {
+      std::cerr << "Error: cannot fetch " << datasetName << ": " << msg << std::endl;
+      ret = 1;
+    });
+    face.processEvents();
+  }
+  catch (const std::exception& e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return 1;
+  }
+  return ret;
+}